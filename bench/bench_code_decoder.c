@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "code_decoder.h"
+#include "game_logic.h"
+
+#define NUMBER_OF_CODES 16000000
+#define STRIDE (NUMBER_OF_VALUES_TO_GUESS + 1)
+#define CLASSIC_ALPHABET "ABCDEF"
+
+int random_value(void) {
+  return rand();
+}
+
+static double elapsed_milliseconds(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static char* make_lines(const char *alphabet) {
+  char *text = malloc((size_t) NUMBER_OF_CODES * STRIDE + 1);
+  if (text == NULL) {
+    exit(EXIT_FAILURE);
+  }
+  for (size_t i = 0; i < NUMBER_OF_CODES; i++) {
+    for (size_t peg = 0; peg < NUMBER_OF_VALUES_TO_GUESS; peg++) {
+      text[i * STRIDE + peg] = alphabet[rand() % GAME_VALUE_MAX];
+    }
+    text[i * STRIDE + NUMBER_OF_VALUES_TO_GUESS] = '\n';
+  }
+  text[(size_t) NUMBER_OF_CODES * STRIDE] = '\0';
+  return text;
+}
+
+static uint64_t *codes;
+static uint8_t *is_valid;
+
+// the checksum keeps the work from being optimised away and shows every way decodes the same
+static void report(const char *name, struct timespec start, struct timespec end) {
+  double milliseconds = elapsed_milliseconds(start, end);
+  uint64_t checksum = 0;
+  for (size_t i = 0; i < NUMBER_OF_CODES; i++) {
+    checksum += codes[i] + is_valid[i];
+  }
+  printf("%-20s %8.1f ms %7.1f million codes/s (checksum %llu)\n", name, milliseconds,
+         (double) NUMBER_OF_CODES / (milliseconds * 1e3), (unsigned long long) checksum);
+}
+
+// the search through every value for every character that the console used to do
+static void time_nested_loop(const char *text) {
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < NUMBER_OF_CODES; i++) {
+    uint64_t code = 0;
+    for (size_t peg = 0; peg < NUMBER_OF_VALUES_TO_GUESS; peg++) {
+      for (uint8_t value = 0; value < GAME_VALUE_MAX; value++) {
+        if (CLASSIC_ALPHABET[value] == text[i * STRIDE + peg]) {
+          code = code * GAME_VALUE_MAX + value;
+          break;
+        }
+      }
+    }
+    codes[i] = code;
+    is_valid[i] = 1;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report("nested loop", start, end);
+}
+
+static void time_single(const char *name, const char *alphabet, const char *text) {
+  code_decoder_t decoder;
+  code_decoder_init(&decoder, alphabet, NUMBER_OF_VALUES_TO_GUESS);
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < NUMBER_OF_CODES; i++) {
+    uint8_t values[NUMBER_OF_VALUES_TO_GUESS];
+    code_decoder_error_t error;
+    is_valid[i] = code_decoder_decode(&decoder, &text[i * STRIDE], values, &codes[i], &error) == CODE_DECODER_OK;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report(name, start, end);
+}
+
+static void time_batch(const char *name, const char *alphabet, const char *text) {
+  code_decoder_t decoder;
+  code_decoder_init(&decoder, alphabet, NUMBER_OF_VALUES_TO_GUESS);
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  code_decoder_decode_batch(&decoder, text, STRIDE, NUMBER_OF_CODES, codes, is_valid);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  report(name, start, end);
+}
+
+int main(void) {
+  srand(1);
+  codes = malloc(NUMBER_OF_CODES * sizeof(uint64_t));
+  is_valid = malloc(NUMBER_OF_CODES);
+  if (codes == NULL || is_valid == NULL) {
+    exit(EXIT_FAILURE);
+  }
+  // fault the pages in before anything is timed
+  memset(codes, 0, NUMBER_OF_CODES * sizeof(uint64_t));
+  memset(is_valid, 0, NUMBER_OF_CODES);
+  char *text = make_lines(CLASSIC_ALPHABET);
+  time_nested_loop(text);
+  time_single("table", CLASSIC_ALPHABET, text);
+  time_batch("batch", CLASSIC_ALPHABET, text);
+  free(text);
+  // an alphabet that is not a run of letters costs the same, it is one table either way
+  text = make_lines("RGBYOP");
+  time_single("table colours", "RGBYOP", text);
+  time_batch("batch colours", "RGBYOP", text);
+  free(text);
+  free(codes);
+  free(is_valid);
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include "engine_host.h"
+
+#define NUMBER_OF_GAMES 2000
+#define COMMAND_SIZE 4096
+#define BOT_ARGUMENT "--bot"
+#define INPUT_SIZE 4096
+
+int random_value(void) {
+  return rand();
+}
+
+// answers every go at once with the next code in turn, so all the time that passes is the host's and the
+// pipes'
+static int run_bot(void) {
+  char input[INPUT_SIZE];
+  size_t buffered = 0;
+  uint32_t next = 0;
+  for (;;) {
+    ssize_t got = read(STDIN_FILENO, input + buffered, sizeof(input) - buffered);
+    if (got <= 0) {
+      return EXIT_SUCCESS;
+    }
+    buffered += (size_t) got;
+    char reply[INPUT_SIZE];
+    size_t reply_length = 0;
+    size_t used = 0;
+    char *newline;
+    while ((newline = memchr(input + used, '\n', buffered - used)) != NULL) {
+      const char *line = input + used;
+      if (strncmp(line, "mmp\n", 4) == 0) {
+        memcpy(reply + reply_length, "id name instant\nmmpok\n", 22);
+        reply_length += 22;
+      } else if (strncmp(line, "go", 2) == 0) {
+        uint32_t code = next++;
+        memcpy(reply + reply_length, "guess ", 6);
+        for (int i = 0; i < 4; i++) {
+          reply[reply_length + 9 - i] = (char)('A' + code % 6);
+          code /= 6;
+        }
+        reply[reply_length + 10] = '\n';
+        reply_length += 11;
+      } else if (strncmp(line, "quit\n", 5) == 0) {
+        return EXIT_SUCCESS;
+      }
+      used = (size_t)(newline - input) + 1;
+    }
+    memmove(input, input + used, buffered - used);
+    buffered -= used;
+    if (reply_length > 0 && write(STDOUT_FILENO, reply, reply_length) != (ssize_t) reply_length) {
+      return EXIT_FAILURE;
+    }
+  }
+}
+
+static void time_bots(const char *command, size_t number_of_bots) {
+  const char *commands[ENGINE_HOST_MAXIMUM_BOTS];
+  for (size_t i = 0; i < number_of_bots; i++) {
+    commands[i] = command;
+  }
+  engine_host_options_t options = {
+    .variant = {.number_of_pegs = 4, .number_of_values = 6},
+    .maximum_tries = 8,
+    .number_of_games = NUMBER_OF_GAMES,
+    .move_milliseconds = ENGINE_HOST_DEFAULT_MOVE_MILLISECONDS,
+    .seed = 1
+  };
+  engine_host_result_t results[ENGINE_HOST_MAXIMUM_BOTS];
+  engine_host_stats_t stats;
+  if (!engine_host_run(commands, number_of_bots, &options, results, &stats)) {
+    exit(EXIT_FAILURE);
+  }
+  printf("%2zu bots %8llu guesses %8.1f ms %8.1f thousand guesses/s, host %5.2f us of processor per guess\n",
+         number_of_bots, (unsigned long long) stats.moves, (double) stats.wall_nanoseconds / 1e6,
+         (double) stats.moves / ((double) stats.wall_nanoseconds / 1e6),
+         (double) stats.host_cpu_nanoseconds / (double) stats.moves / 1e3);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc > 1 && strcmp(argv[1], BOT_ARGUMENT) == 0) {
+    return run_bot();
+  }
+  char command[COMMAND_SIZE];
+  snprintf(command, sizeof(command), "exec %s " BOT_ARGUMENT, argv[0]);
+  time_bots(command, 1);
+  time_bots(command, 8);
+  time_bots(command, 32);
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
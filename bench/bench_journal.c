@@ -0,0 +1,85 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include "game_journal.h"
+
+#define NUMBER_OF_WRITERS 4
+#define RUN_MILLISECONDS 500
+#define JOURNAL_PATH "/tmp/bench_journal.bin"
+
+typedef struct {
+  game_journal_writer_t *writer;
+  size_t index;
+  uint64_t appended;
+} writer_thread_t;
+
+static bool is_running;
+
+int random_value(void) {
+  return rand();
+}
+
+static void* run_writer(void *argument) {
+  writer_thread_t *thread = argument;
+  // stands in for a reactor, every event of its sessions goes through its own writer
+  game_journal_record_t record = {
+    .event = GAME_JOURNAL_EVENT_GUESS,
+    .token = thread->index + 1,
+    .time = game_journal_clock()
+  };
+  while (__atomic_load_n(&is_running, __ATOMIC_RELAXED)) {
+    record.game_id = (thread->appended << 8) | thread->index;
+    record.code = (game_logic_code_t)(thread->appended % NUMBER_OF_POSSIBLE_CODES);
+    game_journal_append(thread->writer, &record);
+    thread->appended++;
+  }
+  return NULL;
+}
+
+static void run(const char *label, game_journal_options_t options) {
+  remove(JOURNAL_PATH);
+  game_journal_t *journal = game_journal_open(JOURNAL_PATH, options, NUMBER_OF_WRITERS);
+  if (journal == NULL) {
+    fprintf(stderr, "Could not open %s\n", JOURNAL_PATH);
+    exit(EXIT_FAILURE);
+  }
+  writer_thread_t threads[NUMBER_OF_WRITERS];
+  pthread_t ids[NUMBER_OF_WRITERS];
+  is_running = true;
+  for (size_t i = 0; i < NUMBER_OF_WRITERS; i++) {
+    threads[i] = (writer_thread_t) {.writer = game_journal_get_writer(journal, i), .index = i};
+    pthread_create(&ids[i], NULL, run_writer, &threads[i]);
+  }
+  struct timespec pause = {.tv_sec = RUN_MILLISECONDS / 1000, .tv_nsec = (RUN_MILLISECONDS % 1000) * 1000000L};
+  nanosleep(&pause, NULL);
+  __atomic_store_n(&is_running, false, __ATOMIC_RELAXED);
+  uint64_t appended = 0;
+  for (size_t i = 0; i < NUMBER_OF_WRITERS; i++) {
+    pthread_join(ids[i], NULL);
+    appended += threads[i].appended;
+  }
+  game_journal_sync(journal);
+  game_journal_stats_t stats = game_journal_get_stats(journal);
+  game_journal_close(journal);
+  remove(JOURNAL_PATH);
+  printf("%-28s %12.0f events/s %10.1f events per commit %8.1f MB/s\n", label,
+         (double) appended * 1000 / RUN_MILLISECONDS,
+         stats.commits > 0 ? (double) stats.records / (double) stats.commits : 0.0,
+         (double) stats.bytes / (1024 * 1024) * 1000 / RUN_MILLISECONDS);
+}
+
+int main(void) {
+  printf("%d writers, %zu byte records, %d ms per setting\n", NUMBER_OF_WRITERS, sizeof(game_journal_record_t),
+         RUN_MILLISECONDS);
+  run("fdatasync per event", (game_journal_options_t) {.commit_milliseconds = 0});
+  run("group commit 1 ms", (game_journal_options_t) {.commit_milliseconds = 1});
+  run("group commit 10 ms", (game_journal_options_t) {.commit_milliseconds = 10});
+  run("group commit 10 ms, 1 MB", (game_journal_options_t) {.commit_milliseconds = 10, .commit_bytes = 1024 * 1024});
+  run("page cache only, 10 ms", (game_journal_options_t) {.commit_milliseconds = 10, .is_sync_disabled = true});
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "replay_store.h"
+
+#define NUMBER_OF_GAMES 4000000
+#define STORE_PATH "/tmp/bench_replays.store"
+#define FIRST_START 1700000000000ull
+// a game every 5 ms, so an hour covers a sixth of the file
+#define MILLISECONDS_PER_GAME 5
+#define HOUR_MILLISECONDS 3600000ull
+
+int random_value(void) {
+  return rand();
+}
+
+static double elapsed_milliseconds(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static void run(const replay_store_t *store, const char *name, const replay_store_query_t *query) {
+  struct timespec start, end;
+  replay_store_result_t result;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  if (!replay_store_run(store, query, &result)) {
+    fprintf(stderr, "%s failed\n", name);
+    exit(EXIT_FAILURE);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double milliseconds = elapsed_milliseconds(start, end);
+  printf("%-28s %8.2f ms %8llu selected %3llu blocks skipped %7.2f GB/s\n", name, milliseconds,
+         (unsigned long long) result.games_selected, (unsigned long long) result.blocks_skipped,
+         (double) result.bytes_scanned / (milliseconds * 1e6));
+  replay_store_result_free(&result);
+}
+
+int main(void) {
+  struct timespec start, end;
+  replay_store_writer_t *writer = replay_store_writer_create(STORE_PATH);
+  if (writer == NULL) {
+    return EXIT_FAILURE;
+  }
+  srand(1);
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint64_t i = 0; i < NUMBER_OF_GAMES; i++) {
+    replay_store_game_t game = {
+      .started = FIRST_START + i * MILLISECONDS_PER_GAME,
+      .duration = (uint32_t)(rand() % 300000),
+      .secret = (game_logic_code_t)(rand() % NUMBER_OF_POSSIBLE_CODES),
+      .tries = (uint8_t)(3 + rand() % 6),
+      .outcome = (uint8_t)(rand() % 4),
+      .is_hard_mode = (uint8_t)(rand() % 2)
+    };
+    for (uint8_t move = 0; move < game.tries; move++) {
+      game.guesses[move] = (game_logic_code_t)(rand() % NUMBER_OF_POSSIBLE_CODES);
+      game.feedback[move] = game_logic_score_row(game.guesses[move])[game.secret];
+    }
+    if (!replay_store_writer_add(writer, &game)) {
+      return EXIT_FAILURE;
+    }
+  }
+  if (!replay_store_writer_commit(writer)) {
+    fprintf(stderr, "Could not write %s\n", STORE_PATH);
+    return EXIT_FAILURE;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("build %d games:        %8.1f ms\n", NUMBER_OF_GAMES, elapsed_milliseconds(start, end));
+
+  replay_store_t *store = replay_store_open(STORE_PATH);
+  if (store == NULL) {
+    return EXIT_FAILURE;
+  }
+  replay_store_query_t hard_losses = {
+    .filters = {{REPLAY_STORE_COLUMN_HARD_MODE, 1, 1}, {REPLAY_STORE_COLUMN_OUTCOME, 1, 1}},
+    .number_of_filters = 2,
+    .aggregate = REPLAY_STORE_COUNT
+  };
+  replay_store_query_t one_hour = {
+    .filters = {{REPLAY_STORE_COLUMN_STARTED, FIRST_START, FIRST_START + HOUR_MILLISECONDS - 1},
+                {REPLAY_STORE_COLUMN_TRIES, 7, 8}},
+    .number_of_filters = 2,
+    .aggregate = REPLAY_STORE_COUNT
+  };
+  replay_store_query_t first_guesses = {
+    .filters = {{REPLAY_STORE_COLUMN_OUTCOME, 0, 0}},
+    .number_of_filters = 1,
+    .aggregate = REPLAY_STORE_HISTOGRAM,
+    .column = REPLAY_STORE_COLUMN_GUESS
+  };
+  replay_store_query_t tries_by_secret = {
+    .aggregate = REPLAY_STORE_AVERAGE,
+    .column = REPLAY_STORE_COLUMN_TRIES,
+    .group_by = REPLAY_STORE_COLUMN_SECRET
+  };
+  // the first run pulls the file into the page cache
+  run(store, "warm up", &hard_losses);
+  run(store, "count hard mode losses", &hard_losses);
+  run(store, "count long games in an hour", &one_hour);
+  run(store, "histogram of first guess", &first_guesses);
+  run(store, "average tries by secret", &tries_by_secret);
+  replay_store_close(store);
+  remove(STORE_PATH);
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include "replay_verifier.h"
+#include "game_journal.h"
+
+#define NUMBER_OF_GAMES 4000000
+#define STORE_PATH "/tmp/bench_verified.store"
+// one game in this many is played in hard mode
+#define HARD_MODE_INTERVAL 8
+// random picks before a hard mode game settles for the answer
+#define HARD_MODE_ATTEMPTS 64
+static const size_t thread_counts[] = {1, 2, 4, 8};
+
+int random_value(void) {
+  return rand();
+}
+
+static double elapsed_milliseconds(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static bool is_consistent(const replay_store_game_t *game, game_logic_code_t guess) {
+  for (uint8_t move = 0; move < game->tries; move++) {
+    if (game_logic_score_row(game->guesses[move])[guess] != game->feedback[move]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static replay_store_game_t play_game(uint64_t i) {
+  replay_store_game_t game = {
+    .started = i,
+    .secret = (game_logic_code_t)(rand() % NUMBER_OF_POSSIBLE_CODES),
+    .is_hard_mode = (uint8_t)(i % HARD_MODE_INTERVAL == 0),
+    .outcome = GAME_JOURNAL_END_LOST
+  };
+  while (game.tries < REPLAY_STORE_MAXIMUM_MOVES) {
+    game_logic_code_t guess = (game_logic_code_t)(rand() % NUMBER_OF_POSSIBLE_CODES);
+    for (int attempt = 0; game.is_hard_mode && !is_consistent(&game, guess); attempt++) {
+      guess = attempt < HARD_MODE_ATTEMPTS ? (game_logic_code_t)(rand() % NUMBER_OF_POSSIBLE_CODES) : game.secret;
+    }
+    game.guesses[game.tries] = guess;
+    game.feedback[game.tries++] = game_logic_score_row(guess)[game.secret];
+    if (guess == game.secret) {
+      game.outcome = GAME_JOURNAL_END_WON;
+      break;
+    }
+  }
+  return game;
+}
+
+int main(void) {
+  replay_store_writer_t *writer = replay_store_writer_create(STORE_PATH);
+  if (writer == NULL) {
+    return EXIT_FAILURE;
+  }
+  srand(1);
+  for (uint64_t i = 0; i < NUMBER_OF_GAMES; i++) {
+    replay_store_game_t game = play_game(i);
+    if (!replay_store_writer_add(writer, &game)) {
+      return EXIT_FAILURE;
+    }
+  }
+  if (!replay_store_writer_commit(writer)) {
+    fprintf(stderr, "Could not write %s\n", STORE_PATH);
+    return EXIT_FAILURE;
+  }
+  replay_store_t *store = replay_store_open(STORE_PATH);
+  replay_verifier_result_t *result = malloc(sizeof(replay_verifier_result_t));
+  if (store == NULL || result == NULL) {
+    return EXIT_FAILURE;
+  }
+  long number_of_processors = sysconf(_SC_NPROCESSORS_ONLN);
+  printf("%d games, %ld processors\n", NUMBER_OF_GAMES, number_of_processors);
+  for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (!replay_verifier_run(store, thread_counts[i], result)) {
+      return EXIT_FAILURE;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double milliseconds = elapsed_milliseconds(start, end);
+    printf("%zu threads: %8.1f ms %6.2f million games/s %6.2f million moves/s, %llu diverged\n", thread_counts[i],
+           milliseconds, (double) result->games / (milliseconds * 1e3), (double) result->moves / (milliseconds * 1e3),
+           (unsigned long long) result->games_diverged);
+  }
+  free(result);
+  replay_store_close(store);
+  remove(STORE_PATH);
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
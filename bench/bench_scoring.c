@@ -0,0 +1,63 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "game_logic.h"
+#include "black_peg.h"
+
+#define NUMBER_OF_ROUNDS 200
+
+int random_value(void) {
+  return rand();
+}
+
+static double elapsed_nanoseconds(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) * 1e9 + (double)(end.tv_nsec - start.tv_nsec);
+}
+
+int main(void) {
+  static game_logic_values_t codes[NUMBER_OF_POSSIBLE_CODES][NUMBER_OF_VALUES_TO_GUESS];
+  static uint32_t packed_codes[NUMBER_OF_POSSIBLE_CODES];
+  static uint8_t placements[NUMBER_OF_POSSIBLE_CODES];
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    game_logic_unpack_code(i, codes[i]);
+    packed_codes[i] = black_peg_pack(codes[i]);
+  }
+  const double number_of_scores = (double) NUMBER_OF_ROUNDS * NUMBER_OF_POSSIBLE_CODES * NUMBER_OF_POSSIBLE_CODES;
+  struct timespec start, end;
+  volatile uint32_t sink = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int round = 0; round < NUMBER_OF_ROUNDS; round++) {
+    for (size_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+      for (size_t j = 0; j < NUMBER_OF_POSSIBLE_CODES; j++) {
+        sink += game_logic_score(codes[j], codes[i]).number_of_correct_value_and_placement;
+      }
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("histogram score:       %6.2f ns/score\n", elapsed_nanoseconds(start, end) / number_of_scores);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int round = 0; round < NUMBER_OF_ROUNDS; round++) {
+    for (size_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+      black_peg_score_batch(packed_codes[i], packed_codes, NUMBER_OF_POSSIBLE_CODES, placements);
+      sink += placements[i];
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("black peg batch score: %6.2f ns/score\n", elapsed_nanoseconds(start, end) / number_of_scores);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (int round = 0; round < NUMBER_OF_ROUNDS / 20; round++) {
+    game_logic_move_t history[1];
+    game_logic_unpack_code((game_logic_code_t)(rand() % NUMBER_OF_POSSIBLE_CODES), history[0].guess);
+    history[0].feedback = game_logic_score(codes[rand() % NUMBER_OF_POSSIBLE_CODES], history[0].guess);
+    history[0].feedback.number_of_correct_value_only = 0;
+    sink += black_peg_get_hint(history, 1).best_guess;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("black peg hint:        %6.2f ms/hint\n", elapsed_nanoseconds(start, end) / 1e6 / (NUMBER_OF_ROUNDS / 20));
+
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
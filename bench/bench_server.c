@@ -0,0 +1,238 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "game_server.h"
+#include "server_session.h"
+#include "shm_ipc.h"
+
+// every connection keeps one request in flight, alternating NEW and GIVEUP so each gets one reply.
+// Binary connections send a pipelined batch of frames as their request instead
+#define NUMBER_OF_CONNECTIONS 64
+#define REQUESTS_PER_CONNECTION 2000
+#define FRAMES_PER_BATCH 32
+#define BENCH_PORT 9900
+#define BENCH_SHARED_MEMORY_NAME "/mastermind-bench"
+#define SHARED_MEMORY_REQUESTS 200000
+#define RESPONSE_BUFFER_SIZE 256
+
+int random_value(void) {
+  return rand();
+}
+
+typedef struct {
+  int fd;
+  size_t requests_sent;
+  size_t bytes_awaited;
+  struct timespec sent_at;
+} connection_t;
+
+static const char *requests[] = {"NEW\n", "GIVEUP\n"};
+static uint8_t batch[FRAMES_PER_BATCH * SERVER_SESSION_FRAME_SIZE];
+
+static uint64_t elapsed_nanoseconds(struct timespec start, struct timespec end) {
+  return (uint64_t)((end.tv_sec - start.tv_sec) * 1000000000LL + (end.tv_nsec - start.tv_nsec));
+}
+
+static int compare_latencies(const void *a, const void *b) {
+  uint64_t left = *(const uint64_t *) a;
+  uint64_t right = *(const uint64_t *) b;
+  return (left > right) - (left < right);
+}
+
+static int connect_with_retry(uint16_t port) {
+  struct sockaddr_in address = {.sin_family = AF_INET, .sin_port = htons(port), .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+  for (int attempt = 0; attempt < 100; attempt++) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (connect(fd, (struct sockaddr *) &address, sizeof(address)) == 0) {
+      int enable = 1;
+      setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+      return fd;
+    }
+    close(fd);
+    usleep(10000);
+  }
+  return -1;
+}
+
+static bool negotiate_binary(int fd) {
+  const char request[] = "PROTOCOL BINARY\n";
+  char response[RESPONSE_BUFFER_SIZE];
+  size_t length = 0;
+  if (send(fd, request, sizeof(request) - 1, MSG_NOSIGNAL) < 0) {
+    return false;
+  }
+  while (length == 0 || response[length - 1] != '\n') {
+    ssize_t received = recv(fd, response + length, sizeof(response) - length, 0);
+    if (received <= 0) {
+      return false;
+    }
+    length += (size_t) received;
+  }
+  return strncmp(response, "BINARY", 6) == 0;
+}
+
+static void send_request(connection_t *connection, bool is_binary) {
+  const void *request = is_binary ? (const void *) batch : requests[connection->requests_sent % 2];
+  size_t length = is_binary ? sizeof(batch) : strlen(request);
+  // text replies end in a newline, binary ones are a byte per frame
+  connection->bytes_awaited = is_binary ? FRAMES_PER_BATCH : 1;
+  clock_gettime(CLOCK_MONOTONIC, &connection->sent_at);
+  if (send(connection->fd, request, length, MSG_NOSIGNAL) < 0) {
+    perror("send");
+    exit(EXIT_FAILURE);
+  }
+  connection->requests_sent++;
+}
+
+static bool run_client(uint16_t port, bool is_binary, uint64_t latencies[], double *seconds) {
+  static connection_t connections[NUMBER_OF_CONNECTIONS];
+  int epoll_fd = epoll_create1(0);
+  for (size_t i = 0; i < NUMBER_OF_CONNECTIONS; i++) {
+    connections[i].fd = connect_with_retry(port);
+    connections[i].requests_sent = 0;
+    if (connections[i].fd < 0 || (is_binary && !negotiate_binary(connections[i].fd))) {
+      return false;
+    }
+    struct epoll_event event = {.events = EPOLLIN, .data.ptr = &connections[i]};
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, connections[i].fd, &event);
+  }
+
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < NUMBER_OF_CONNECTIONS; i++) {
+    send_request(&connections[i], is_binary);
+  }
+  size_t completed = 0;
+  struct epoll_event events[NUMBER_OF_CONNECTIONS];
+  while (completed < (size_t) NUMBER_OF_CONNECTIONS * REQUESTS_PER_CONNECTION) {
+    int number_of_events = epoll_wait(epoll_fd, events, NUMBER_OF_CONNECTIONS, -1);
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    for (int i = 0; i < number_of_events; i++) {
+      connection_t *connection = events[i].data.ptr;
+      char response[RESPONSE_BUFFER_SIZE];
+      // one request in flight means a read holds at most one short line or one batch of replies
+      ssize_t received = recv(connection->fd, response, sizeof(response), 0);
+      if (received <= 0) {
+        return false;
+      }
+      bool is_complete = is_binary ? (connection->bytes_awaited -= (size_t) received) == 0 :
+                                     response[received - 1] == '\n';
+      if (!is_complete) {
+        continue;
+      }
+      latencies[completed++] = elapsed_nanoseconds(connection->sent_at, now);
+      if (connection->requests_sent < REQUESTS_PER_CONNECTION) {
+        send_request(connection, is_binary);
+      }
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  *seconds = (double) elapsed_nanoseconds(start, end) / 1e9;
+  for (size_t i = 0; i < NUMBER_OF_CONNECTIONS; i++) {
+    close(connections[i].fd);
+  }
+  close(epoll_fd);
+  return true;
+}
+
+static void bench_backend(const char *name, game_server_backend_t backend, bool is_binary, uint16_t port) {
+  fflush(stdout);
+  pid_t server = fork();
+  if (server == 0) {
+    // the server reports its own stats on exit, keep them out of the results
+    if (freopen("/dev/null", "w", stdout) == NULL) {
+      _exit(EXIT_FAILURE);
+    }
+    game_server_options_t options = {.idle_seconds = GAME_SERVER_DEFAULT_IDLE_SECONDS};
+    _exit(game_server_main(port, 1, backend, options));
+  }
+  static uint64_t latencies[(size_t) NUMBER_OF_CONNECTIONS * REQUESTS_PER_CONNECTION];
+  size_t number_of_requests = (size_t) NUMBER_OF_CONNECTIONS * REQUESTS_PER_CONNECTION;
+  double seconds = 0;
+  bool is_done = run_client(port, is_binary, latencies, &seconds);
+  kill(server, SIGTERM);
+  waitpid(server, NULL, 0);
+  if (!is_done) {
+    printf("%-9s failed\n", name);
+    return;
+  }
+  qsort(latencies, number_of_requests, sizeof(uint64_t), compare_latencies);
+  // a binary request is a whole batch, its latency is the time until the last reply of the batch
+  double frames_per_request = is_binary ? FRAMES_PER_BATCH : 1;
+  printf("%-9s %-6s %10.0f requests/s, p50 %6.1f us, p99 %6.1f us\n", name, is_binary ? "binary" : "text",
+         (double) number_of_requests * frames_per_request / seconds,
+         (double) latencies[number_of_requests / 2] / 1e3, (double) latencies[number_of_requests * 99 / 100] / 1e3);
+}
+
+// one client with one frame in flight, the latency floor of a local bot
+static void bench_shared_memory(void) {
+  fflush(stdout);
+  pid_t server = fork();
+  if (server == 0) {
+    if (freopen("/dev/null", "w", stdout) == NULL) {
+      _exit(EXIT_FAILURE);
+    }
+    _exit(shm_ipc_server_main(BENCH_SHARED_MEMORY_NAME));
+  }
+  shm_ipc_client_t *client = NULL;
+  for (int attempt = 0; attempt < 100 && client == NULL; attempt++) {
+    usleep(10000);
+    client = shm_ipc_client_connect(BENCH_SHARED_MEMORY_NAME);
+  }
+  if (client == NULL) {
+    printf("shm       failed\n");
+    kill(server, SIGTERM);
+    waitpid(server, NULL, 0);
+    return;
+  }
+  static uint64_t latencies[SHARED_MEMORY_REQUESTS];
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (size_t i = 0; i < SHARED_MEMORY_REQUESTS; i++) {
+    uint8_t frame[SERVER_SESSION_FRAME_SIZE] = {i % 2 == 0 ? SERVER_SESSION_OPERATION_NEW : SERVER_SESSION_OPERATION_GIVEUP};
+    uint8_t reply;
+    struct timespec sent_at, replied_at;
+    clock_gettime(CLOCK_MONOTONIC, &sent_at);
+    shm_ipc_client_submit(client, frame);
+    shm_ipc_client_receive(client, &reply, 1, true);
+    clock_gettime(CLOCK_MONOTONIC, &replied_at);
+    latencies[i] = elapsed_nanoseconds(sent_at, replied_at);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  shm_ipc_client_disconnect(client);
+  kill(server, SIGTERM);
+  waitpid(server, NULL, 0);
+  qsort(latencies, SHARED_MEMORY_REQUESTS, sizeof(uint64_t), compare_latencies);
+  printf("%-9s %-6s %10.0f requests/s, p50 %6.1f us, p99 %6.1f us (one client, one frame in flight)\n", "shm",
+         "binary", SHARED_MEMORY_REQUESTS / ((double) elapsed_nanoseconds(start, end) / 1e9),
+         (double) latencies[SHARED_MEMORY_REQUESTS / 2] / 1e3, (double) latencies[SHARED_MEMORY_REQUESTS * 99 / 100] / 1e3);
+}
+
+int main(void) {
+  for (size_t i = 0; i < FRAMES_PER_BATCH; i++) {
+    batch[i * SERVER_SESSION_FRAME_SIZE] = i % 2 == 0 ? SERVER_SESSION_OPERATION_NEW : SERVER_SESSION_OPERATION_GIVEUP;
+  }
+  printf("%d connections, %d requests each, one reactor, binary requests are batches of %d frames\n",
+         NUMBER_OF_CONNECTIONS, REQUESTS_PER_CONNECTION, FRAMES_PER_BATCH);
+  bench_backend("epoll", GAME_SERVER_BACKEND_EPOLL, false, BENCH_PORT);
+  bench_backend("epoll", GAME_SERVER_BACKEND_EPOLL, true, BENCH_PORT + 1);
+  // a backend without kernel support serves on epoll and says so on stderr
+  bench_backend("io_uring", GAME_SERVER_BACKEND_IO_URING, false, BENCH_PORT + 2);
+  bench_backend("io_uring", GAME_SERVER_BACKEND_IO_URING, true, BENCH_PORT + 3);
+  bench_shared_memory();
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
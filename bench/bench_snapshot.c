@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include "session_snapshot.h"
+
+#define NUMBER_OF_GAMES 1000000
+#define SNAPSHOT_PATH "/tmp/bench_snapshot.bin"
+
+int random_value(void) {
+  return rand();
+}
+
+static double elapsed_milliseconds(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+int main(void) {
+  struct timespec start, end;
+  session_snapshot_writer_t *writer = session_snapshot_writer_create();
+  if (writer == NULL) {
+    return EXIT_FAILURE;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint64_t i = 1; i <= NUMBER_OF_GAMES; i++) {
+    session_snapshot_game_t game = {
+      .token = i * 0x9E3779B97F4A7C15ull,
+      .idle_milliseconds = (uint32_t)(i % 60000),
+      .tries = (uint8_t)(i % SESSION_SNAPSHOT_MAXIMUM_HISTORY),
+      .answer = (game_logic_code_t)(i % NUMBER_OF_POSSIBLE_CODES)
+    };
+    if (!session_snapshot_writer_add(writer, &game)) {
+      return EXIT_FAILURE;
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("collect %d games: %8.1f ms\n", NUMBER_OF_GAMES, elapsed_milliseconds(start, end));
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  if (!session_snapshot_writer_commit(writer, SNAPSHOT_PATH)) {
+    fprintf(stderr, "Could not write %s\n", SNAPSHOT_PATH);
+    return EXIT_FAILURE;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("write and sync:        %8.1f ms\n", elapsed_milliseconds(start, end));
+  session_snapshot_writer_destroy(writer);
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  session_snapshot_t *snapshot = session_snapshot_open(SNAPSHOT_PATH);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  if (snapshot == NULL) {
+    return EXIT_FAILURE;
+  }
+  printf("restore:               %8.1f ms\n", elapsed_milliseconds(start, end));
+
+  // every player coming back, the worst case for the lazily claimed table
+  size_t number_of_claims = 0;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (uint64_t i = 1; i <= NUMBER_OF_GAMES; i++) {
+    number_of_claims += session_snapshot_claim(snapshot, i * 0x9E3779B97F4A7C15ull, 0) != NULL;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("claim all %zu games: %8.1f ms\n", number_of_claims, elapsed_milliseconds(start, end));
+  session_snapshot_close(snapshot);
+  unlink(SNAPSHOT_PATH);
+  return number_of_claims == NUMBER_OF_GAMES ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "stream_evaluator.h"
+
+#define NUMBER_OF_LINES 8000000
+#define NUMBER_OF_SESSIONS 100000
+#define LINE_SIZE 32
+#define OUTPUT_CHUNK (1 << 20)
+
+static const char value_characters[GAME_VALUE_MAX] = {'A', 'B', 'C', 'D', 'E', 'F'};
+
+int random_value(void) {
+  return rand();
+}
+
+static double elapsed_milliseconds(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static size_t format_code(game_logic_code_t code, char text[]) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_unpack_code(code, values);
+  for (size_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    text[i] = value_characters[values[i]];
+  }
+  return NUMBER_OF_VALUES_TO_GUESS;
+}
+
+static char* make_lines(bool is_session, size_t *length) {
+  char *input = malloc((size_t) NUMBER_OF_LINES * LINE_SIZE);
+  if (input == NULL) {
+    exit(EXIT_FAILURE);
+  }
+  size_t used = 0;
+  for (size_t i = 0; i < NUMBER_OF_LINES; i++) {
+    if (is_session) {
+      used += (size_t) sprintf(input + used, "%d ", rand() % NUMBER_OF_SESSIONS);
+    } else {
+      used += format_code((game_logic_code_t)(rand() % NUMBER_OF_POSSIBLE_CODES), input + used);
+      input[used++] = ' ';
+    }
+    used += format_code((game_logic_code_t)(rand() % NUMBER_OF_POSSIBLE_CODES), input + used);
+    input[used++] = '\n';
+  }
+  *length = used;
+  return input;
+}
+
+static void time_lines(const char *name, bool is_session) {
+  size_t length;
+  char *input = make_lines(is_session, &length);
+  char *output = malloc(OUTPUT_CHUNK);
+  stream_evaluator_t *evaluator = stream_evaluator_create(1);
+  if (output == NULL || evaluator == NULL) {
+    exit(EXIT_FAILURE);
+  }
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  size_t used = 0;
+  while (used < length) {
+    size_t output_length;
+    used += stream_evaluator_evaluate_lines(evaluator, input + used, length - used, output, OUTPUT_CHUNK,
+                                            &output_length);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double milliseconds = elapsed_milliseconds(start, end);
+  printf("%-16s %8.1f ms %7.1f MB/s %6.1f million lines/s\n", name, milliseconds, (double) length / (milliseconds * 1e3),
+         (double) NUMBER_OF_LINES / (milliseconds * 1e3));
+  stream_evaluator_destroy(evaluator);
+  free(input);
+  free(output);
+}
+
+static void time_frames(void) {
+  size_t length = (size_t) NUMBER_OF_LINES * STREAM_EVALUATOR_FRAME_SIZE;
+  uint8_t *input = malloc(length);
+  uint8_t *output = malloc(NUMBER_OF_LINES);
+  stream_evaluator_t *evaluator = stream_evaluator_create(1);
+  if (input == NULL || output == NULL || evaluator == NULL) {
+    exit(EXIT_FAILURE);
+  }
+  for (size_t i = 0; i < length; i += 2) {
+    game_logic_code_t code = (game_logic_code_t)(rand() % NUMBER_OF_POSSIBLE_CODES);
+    input[i] = (uint8_t)(code & 0xFF);
+    input[i + 1] = (uint8_t)(code >> 8);
+  }
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  stream_evaluator_evaluate_frames(evaluator, input, length, output);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double milliseconds = elapsed_milliseconds(start, end);
+  printf("%-16s %8.1f ms %7.1f MB/s %6.1f million frames/s\n", "binary frames", milliseconds,
+         (double) length / (milliseconds * 1e3), (double) NUMBER_OF_LINES / (milliseconds * 1e3));
+  stream_evaluator_destroy(evaluator);
+  free(input);
+  free(output);
+}
+
+int main(void) {
+  srand(1);
+  game_logic_score_row(0);
+  time_lines("secret lines", false);
+  time_lines("session lines", true);
+  time_frames();
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include "tournament.h"
+
+#define CHECKPOINT_PATH "/tmp/bench_tournament.checkpoint"
+// far more often than a real run, to show what checkpoints cost
+#define CHECKPOINT_MILLISECONDS 10
+static const size_t thread_counts[] = {1, 2, 4, 8};
+
+int random_value(void) {
+  return rand();
+}
+
+// minimax games cost a thousand times what first-consistent ones do, the shares only even out by stealing
+static tournament_options_t bench_options(size_t number_of_threads) {
+  tournament_options_t options = {
+    .variant = {.number_of_pegs = 4, .number_of_values = 6},
+    .maximum_tries = 8,
+    .seed = 1,
+    .number_of_threads = number_of_threads
+  };
+  const tournament_strategy_t *strategies;
+  options.number_of_strategies = tournament_get_strategies(&strategies);
+  for (size_t i = 0; i < options.number_of_strategies; i++) {
+    options.strategies[i] = &strategies[i];
+  }
+  return options;
+}
+
+static void report(const char *label, const tournament_stats_t *stats) {
+  printf("%-28s %9.1f ms %9.0f games/s %6llu steals\n", label, (double) stats->wall_nanoseconds / 1e6,
+         (double) stats->games_played / ((double) stats->wall_nanoseconds / 1e9), (unsigned long long) stats->steals);
+}
+
+int main(void) {
+  tournament_result_t results[TOURNAMENT_MAXIMUM_STRATEGIES];
+  tournament_stats_t stats;
+  long number_of_processors = sysconf(_SC_NPROCESSORS_ONLN);
+  printf("%d secrets, every strategy, %ld processors\n", NUMBER_OF_POSSIBLE_CODES, number_of_processors);
+  for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+    tournament_options_t options = bench_options(thread_counts[i]);
+    if (!tournament_run(&options, results, &stats)) {
+      return EXIT_FAILURE;
+    }
+    char label[32];
+    snprintf(label, sizeof(label), "%zu threads", thread_counts[i]);
+    report(label, &stats);
+  }
+  tournament_options_t options = bench_options(1);
+  options.checkpoint_path = CHECKPOINT_PATH;
+  options.checkpoint_milliseconds = CHECKPOINT_MILLISECONDS;
+  remove(CHECKPOINT_PATH);
+  bool is_run = tournament_run(&options, results, &stats);
+  remove(CHECKPOINT_PATH);
+  if (!is_run) {
+    return EXIT_FAILURE;
+  }
+  report("1 thread, checkpoint 10 ms", &stats);
+  for (size_t i = 0; i < options.number_of_strategies; i++) {
+    printf("%-20s %.3f guesses, %.1f us per move\n", results[i].name,
+           (double) results[i].tries_to_win / (double)(results[i].games - results[i].failures),
+           (double) results[i].cpu_nanoseconds / (double) results[i].moves / 1e3);
+  }
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef BLACK_PEG_H
+#define BLACK_PEG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+#include "solver.h"
+
+// black peg only variant, feedback reports correct value and placement and nothing else
+
+// one value per byte so a whole code is compared with a single xor
+uint32_t black_peg_pack(const game_logic_values_t values[]);
+
+uint8_t black_peg_score(uint32_t answer, uint32_t guess);
+
+void black_peg_score_batch(uint32_t guess, const uint32_t answers[], size_t number_of_answers, uint8_t placements[]);
+
+game_logic_feedback_t black_peg_get_feedback(game_logic_values_t guess[]);
+
+// history feedback must come from this variant, value only counts are ignored
+solver_hint_t black_peg_get_hint(const game_logic_move_t history[], size_t history_length);
+
+#endif /* BLACK_PEG_H */
\ No newline at end of file
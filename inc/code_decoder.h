@@ -0,0 +1,56 @@
+#ifndef CODE_DECODER_H
+#define CODE_DECODER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// turns typed guesses into values with one table lookup per character. The alphabet names the values
+// in order, lower case letters stand for their upper case ones unless the alphabet has both
+#define CODE_DECODER_MAXIMUM_PEGS 16
+#define CODE_DECODER_MAXIMUM_VALUES 16
+// marks characters outside the alphabet in the table
+#define CODE_DECODER_INVALID UINT8_MAX
+
+typedef enum {
+  CODE_DECODER_OK,
+  // the line ended before every peg had a value
+  CODE_DECODER_TOO_SHORT,
+  // more characters followed the last peg
+  CODE_DECODER_TOO_LONG,
+  CODE_DECODER_INVALID_CHARACTER
+} code_decoder_status_t;
+
+typedef struct {
+  uint8_t values[UINT8_MAX + 1];
+  char alphabet[CODE_DECODER_MAXIMUM_VALUES + 1];
+  uint8_t number_of_pegs;
+  uint8_t number_of_values;
+  // the alphabet is a run of consecutive characters, which messages shorten to e.g. A-F
+  bool is_contiguous;
+} code_decoder_t;
+
+typedef struct {
+  code_decoder_status_t status;
+  // of the first character that is not a value, or where the line ended too soon or went on too long
+  size_t position;
+} code_decoder_error_t;
+
+// false when the alphabet repeats a character or a size is out of range
+bool code_decoder_init(code_decoder_t *decoder, const char *alphabet, uint8_t number_of_pegs);
+
+// decodes a line, which may end in a newline, into values and, when code is not NULL, packs them with the
+// first peg as the most significant digit, as game_logic_pack_code does for the classic game
+code_decoder_status_t code_decoder_decode(const code_decoder_t *decoder, const char *line, uint8_t values[],
+                                          uint64_t *code, code_decoder_error_t *error);
+
+// decodes guesses laid out stride bytes apart, e.g. the fixed width lines of a file, into packed codes.
+// Each is_valid byte is 1 when every peg of that guess is in the alphabet, what follows the pegs is not read
+void code_decoder_decode_batch(const code_decoder_t *decoder, const char *text, size_t stride,
+                               size_t number_of_codes, uint64_t codes[], uint8_t is_valid[]);
+
+// a sentence for the player, e.g. "'G' at position 3 is not one of A-F"
+void code_decoder_describe_error(const code_decoder_t *decoder, const char *line, const code_decoder_error_t *error,
+                                 char *message, size_t size);
+
+#endif /* CODE_DECODER_H */
\ No newline at end of file
@@ -1,6 +1,18 @@
 #ifndef CONSOLE_APP_H
 #define CONSOLE_APP_H
 
-int console_main(void);
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_mode.h"
+
+// hard mode refuses guesses that contradict earlier feedback
+int console_main(game_mode_t mode, bool is_hard_mode);
+
+int console_multi_board_main(size_t number_of_boards);
+
+int console_large_space_main(uint8_t number_of_pegs, uint8_t number_of_values);
+
+int console_word_main(const char *index_path);
 
 #endif /* CONSOLE_APP_H */
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef ENGINE_BOT_H
+#define ENGINE_BOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "engine_protocol.h"
+
+// our own solver behind the engine protocol, a reference for bot authors and an opponent to check the
+// host against. The standard game is played with the minimax solver, larger ones with sampling
+#define ENGINE_BOT_NAME "mastermind minimax"
+#define ENGINE_BOT_AUTHOR "Master Mind Game"
+// room for the longest reply, the answer to mmp
+#define ENGINE_BOT_MAXIMUM_REPLY 128
+
+typedef struct engine_bot engine_bot_t;
+
+engine_bot_t* engine_bot_create(void);
+
+void engine_bot_destroy(engine_bot_t *bot);
+
+// handles one line from the host, without its newline, and writes the reply lines into reply, which must
+// hold ENGINE_BOT_MAXIMUM_REPLY bytes. Returns the length of the reply, zero when there is none
+size_t engine_bot_handle_line(engine_bot_t *bot, const char *line, size_t length, char *reply);
+
+// true once the host said quit
+bool engine_bot_is_finished(const engine_bot_t *bot);
+
+// plays over stdin and stdout until quit or the end of the input
+int engine_bot_main(void);
+
+#endif /* ENGINE_BOT_H */
\ No newline at end of file
@@ -0,0 +1,66 @@
+#ifndef ENGINE_HOST_H
+#define ENGINE_HOST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "engine_protocol.h"
+#include "large_space.h"
+
+// plays external codebreaker bots over the engine protocol, each a process started from a shell command
+// with its stdin and stdout on pipes. Every bot plays the same secrets, drawn from the seed, and all of
+// them run at once behind a single poll loop so the host's own share of the time stays small
+#define ENGINE_HOST_MAXIMUM_BOTS 64
+#define ENGINE_HOST_NAME_SIZE 64
+// how long a bot may take to answer mmp or isready before it is dropped
+#define ENGINE_HOST_HANDSHAKE_MILLISECONDS 5000
+// how long a bot may take to exit after quit before it is killed
+#define ENGINE_HOST_QUIT_MILLISECONDS 1000
+#define ENGINE_HOST_DEFAULT_GAMES 100
+#define ENGINE_HOST_DEFAULT_MOVE_MILLISECONDS 10000
+// as many as the console allows for the standard game and for larger ones
+#define ENGINE_HOST_DEFAULT_TRIES 8
+#define ENGINE_HOST_DEFAULT_LARGE_SPACE_TRIES 16
+
+typedef struct {
+  large_space_variant_t variant;
+  bool is_hard_mode;
+  uint8_t maximum_tries;
+  uint32_t number_of_games;
+  // the clock of a whole game and the most a single guess may take, zero for no limit
+  uint32_t game_milliseconds;
+  uint32_t move_milliseconds;
+  uint64_t seed;
+} engine_host_options_t;
+
+typedef struct {
+  // from id name, the command until the bot sends one
+  char name[ENGINE_HOST_NAME_SIZE];
+  uint32_t games;
+  uint32_t outcomes[ENGINE_PROTOCOL_NUMBER_OF_OUTCOMES];
+  // summed over the games won
+  uint64_t tries_to_win;
+  uint64_t moves;
+  // from sending go to reading the guess
+  uint64_t think_nanoseconds;
+  uint64_t info_lines;
+  // the bot exited, stopped answering or could not be started before all its games were played
+  bool is_dropped;
+} engine_host_result_t;
+
+typedef struct {
+  uint64_t moves;
+  uint64_t wall_nanoseconds;
+  // processor time of the host itself, to set against the bots' thinking
+  uint64_t host_cpu_nanoseconds;
+} engine_host_stats_t;
+
+// plays options->number_of_games with every bot, results has one entry per command. False when the
+// options are not a playable game
+bool engine_host_run(const char *const commands[], size_t number_of_bots, const engine_host_options_t *options,
+                     engine_host_result_t results[], engine_host_stats_t *stats);
+
+// runs the bots and prints a table of their results
+int engine_host_main(const char *const commands[], size_t number_of_bots, const engine_host_options_t *options);
+
+#endif /* ENGINE_HOST_H */
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef ENGINE_PROTOCOL_H
+#define ENGINE_PROTOCOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "code_decoder.h"
+#include "game_logic.h"
+#include "large_space.h"
+
+// a line based text protocol between the host, which holds the secret, and an engine that breaks codes,
+// in the spirit of UCI for chess engines. Words are separated by spaces and lines end with a newline.
+//   host                                           engine
+//   mmp                                            id name <text>, id author <text>, then mmpok
+//   isready                                        readyok, once everything sent before is done
+//   newgame pegs <n> values <n> tries <n> [hard]
+//   go [time <ms>] [movetime <ms>]                 any number of info <text>, then guess <code>
+//   feedback <placement> <value only>
+//   result win|loss|timeout|illegal <secret>
+//   quit
+// codes are one letter per peg counting from A, e.g. ABCF. time is what is left on the game's clock and
+// movetime the most this move may take, either left out means no limit. hard asks for every guess to
+// agree with all the feedback so far. Words either side does not know are ignored so both can grow
+#define ENGINE_PROTOCOL_ALPHABET "ABCDEFGHIJKLMNOP"
+// longer lines are cut short
+#define ENGINE_PROTOCOL_MAXIMUM_LINE 1024
+
+typedef enum {
+  ENGINE_PROTOCOL_UNKNOWN,
+  // a known word with missing or bad arguments
+  ENGINE_PROTOCOL_MALFORMED,
+  ENGINE_PROTOCOL_MMP,
+  ENGINE_PROTOCOL_ISREADY,
+  ENGINE_PROTOCOL_NEWGAME,
+  ENGINE_PROTOCOL_GO,
+  ENGINE_PROTOCOL_FEEDBACK,
+  ENGINE_PROTOCOL_RESULT,
+  ENGINE_PROTOCOL_QUIT,
+  ENGINE_PROTOCOL_ID,
+  ENGINE_PROTOCOL_MMPOK,
+  ENGINE_PROTOCOL_READYOK,
+  ENGINE_PROTOCOL_INFO,
+  ENGINE_PROTOCOL_GUESS
+} engine_protocol_type_t;
+
+typedef enum {
+  ENGINE_PROTOCOL_WIN,
+  ENGINE_PROTOCOL_LOSS,
+  // the engine ran out of time
+  ENGINE_PROTOCOL_TIMEOUT,
+  // the engine sent something other than a code, or broke the hard mode rule
+  ENGINE_PROTOCOL_ILLEGAL,
+  ENGINE_PROTOCOL_NUMBER_OF_OUTCOMES
+} engine_protocol_outcome_t;
+
+typedef struct {
+  engine_protocol_type_t type;
+  // newgame
+  large_space_variant_t variant;
+  uint8_t maximum_tries;
+  bool is_hard_mode;
+  // go, zero when there is no limit
+  uint32_t game_milliseconds;
+  uint32_t move_milliseconds;
+  game_logic_feedback_t feedback;
+  engine_protocol_outcome_t outcome;
+  // the guess, or the secret of a result
+  large_space_code_t code;
+  // what follows id or info, it points into the line
+  const char *text;
+  size_t text_length;
+} engine_protocol_message_t;
+
+// a decoder for the codes of the variant
+bool engine_protocol_init_decoder(code_decoder_t *decoder, const large_space_variant_t *variant);
+
+// parses a line without its newline. Codes are decoded with the decoder of the game being played, guesses
+// and results are malformed while it is NULL
+engine_protocol_type_t engine_protocol_parse(const char *line, size_t length, const code_decoder_t *decoder,
+                                             engine_protocol_message_t *message);
+
+// writes the code's letters, not terminated, and returns how many
+size_t engine_protocol_format_code(const large_space_variant_t *variant, const large_space_code_t *code, char *text);
+
+const char* engine_protocol_outcome_name(engine_protocol_outcome_t outcome);
+
+#endif /* ENGINE_PROTOCOL_H */
\ No newline at end of file
@@ -0,0 +1,19 @@
+#ifndef EVIL_CODEMAKER_H
+#define EVIL_CODEMAKER_H
+
+#include <stddef.h>
+#include "game_logic.h"
+
+// an adversarial codemaker which never commits to an answer, every guess is answered with
+// the feedback that keeps the largest set of answers consistent with the game so far
+
+void evil_codemaker_start(void);
+
+game_logic_feedback_t evil_codemaker_get_feedback(game_logic_values_t guess[]);
+
+// any answer still consistent with the game, only meaningful to reveal once the game is over
+game_logic_values_t* evil_codemaker_get_answer(void);
+
+size_t evil_codemaker_get_remaining_candidates(void);
+
+#endif /* EVIL_CODEMAKER_H */
\ No newline at end of file
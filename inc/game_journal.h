@@ -0,0 +1,142 @@
+#ifndef GAME_JOURNAL_H
+#define GAME_JOURNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+#include "session_snapshot.h"
+
+// append only log of every game event for auditing and crash recovery. Records are fixed size and carry
+// their own crc32c so a torn tail is found and cut off. Every reactor fills its own buffer and a committer
+// thread writes all of them with one writev and one fdatasync, so syncs are shared by every session
+#define GAME_JOURNAL_MAGIC 0x4C4E524A
+#define GAME_JOURNAL_VERSION 1
+#define GAME_JOURNAL_DEFAULT_COMMIT_MILLISECONDS 5
+#define GAME_JOURNAL_DEFAULT_COMMIT_BYTES (64 * 1024)
+
+typedef enum {
+  GAME_JOURNAL_EVENT_NEW = 1,
+  GAME_JOURNAL_EVENT_GUESS,
+  GAME_JOURNAL_EVENT_END
+} game_journal_event_t;
+
+typedef enum {
+  GAME_JOURNAL_END_WON,
+  GAME_JOURNAL_END_LOST,
+  GAME_JOURNAL_END_GAVE_UP,
+  GAME_JOURNAL_END_TIMED_OUT,
+  // replaced by a new game or dropped with its connection
+  GAME_JOURNAL_END_ABANDONED
+} game_journal_end_t;
+
+typedef struct {
+  // crc32c of every byte after it, filled in by game_journal_append
+  uint32_t crc;
+  uint8_t event;
+  uint8_t slot;
+  uint8_t is_hard_mode;
+  // game_journal_end_t of an END
+  uint8_t end_reason;
+  uint64_t game_id;
+  // of the session when the record was written, 0 until it asks for one
+  uint64_t token;
+  // unix milliseconds
+  uint64_t time;
+  // the answer of NEW and END, the guess of GUESS
+  game_logic_code_t code;
+  uint8_t correct_value_and_placement;
+  uint8_t correct_value_only;
+  uint8_t reserved[4];
+} game_journal_record_t;
+
+typedef struct {
+  // records wait at most this long for their commit, 0 writes and syncs every record before append returns
+  uint32_t commit_milliseconds;
+  // a buffer this full is committed without waiting for the interval
+  size_t commit_bytes;
+  // leaves durability to the page cache, for when losing the last records in a power cut is acceptable
+  bool is_sync_disabled;
+} game_journal_options_t;
+
+typedef struct {
+  uint64_t records;
+  uint64_t commits;
+  uint64_t bytes;
+  // records in the largest single commit
+  uint64_t largest_commit;
+  uint64_t failures;
+} game_journal_stats_t;
+
+typedef struct {
+  uint64_t records;
+  uint64_t games_in_progress;
+  // in progress games with a session token, only those can be resumed
+  uint64_t games_recovered;
+  // bytes after the last intact record
+  uint64_t torn_bytes;
+} game_journal_recovery_t;
+
+// one game rebuilt from its records
+typedef struct {
+  uint64_t game_id;
+  // the last one any of its records carried
+  uint64_t token;
+  // unix milliseconds of its first and last record
+  uint64_t started;
+  uint64_t last_time;
+  uint8_t slot;
+  uint8_t is_hard_mode;
+  uint8_t tries;
+  // game_journal_end_t, only meaningful once the game has ended
+  uint8_t end_reason;
+  game_logic_code_t answer;
+  game_logic_code_t guesses[SESSION_SNAPSHOT_MAXIMUM_HISTORY];
+  // game_logic_feedback_to_class of every guess
+  uint8_t feedback[SESSION_SNAPSHOT_MAXIMUM_HISTORY];
+} game_journal_game_t;
+
+typedef struct game_journal game_journal_t;
+// one per appending thread, appends to different writers never wait for each other
+typedef struct game_journal_writer game_journal_writer_t;
+
+typedef void (*game_journal_visit_t)(const game_journal_record_t *record, void *argument);
+typedef void (*game_journal_game_visit_t)(const game_journal_game_t *game, void *argument);
+
+// creates the file if it is missing and cuts off a torn tail before appending. NULL when the file cannot be
+// opened or is not a journal
+game_journal_t* game_journal_open(const char *path, game_journal_options_t options, size_t number_of_writers);
+
+// commits whatever is buffered and stops the committer, no writer may append any more
+void game_journal_close(game_journal_t *journal);
+
+// commits everything appended before the call without waiting for the interval
+void game_journal_sync(game_journal_t *journal);
+
+game_journal_writer_t* game_journal_get_writer(game_journal_t *journal, size_t index);
+
+// only blocks when the committer has fallen a whole buffer behind, or on every call without a commit interval
+void game_journal_append(game_journal_writer_t *writer, game_journal_record_t *record);
+
+// safe to call from any thread while the journal is in use
+game_journal_stats_t game_journal_get_stats(const game_journal_t *journal);
+
+// calls visit for every intact record in order and stops at the first torn or corrupt one. Returns false
+// when the file cannot be read or is not a journal, a missing file is an empty journal
+bool game_journal_replay(const char *path, game_journal_visit_t visit, void *argument,
+                         game_journal_recovery_t *recovery);
+
+// calls visit for every game that ended, in the order they ended. Games still in play when the journal ends
+// are only counted
+bool game_journal_replay_games(const char *path, game_journal_game_visit_t visit, void *argument,
+                               game_journal_recovery_t *recovery);
+
+// rebuilds the games that were in play when the journal ends and adds the resumable ones to writer. Games
+// idle for longer than maximum_idle_milliseconds by now (unix milliseconds) are left out, 0 keeps them all
+bool game_journal_recover(const char *path, session_snapshot_writer_t *writer, uint64_t now,
+                          uint32_t maximum_idle_milliseconds, game_journal_recovery_t *recovery);
+
+// unix milliseconds, the clock records are stamped with
+uint64_t game_journal_clock(void);
+
+#endif /* GAME_JOURNAL_H */
\ No newline at end of file
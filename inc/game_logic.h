@@ -7,6 +7,8 @@
 #include "random.h"
 
 #define NUMBER_OF_VALUES_TO_GUESS 4
+#define NUMBER_OF_POSSIBLE_CODES (GAME_VALUE_MAX * GAME_VALUE_MAX * GAME_VALUE_MAX * GAME_VALUE_MAX)
+#define NUMBER_OF_FEEDBACK_CLASSES ((NUMBER_OF_VALUES_TO_GUESS + 1) * (NUMBER_OF_VALUES_TO_GUESS + 1))
 
 typedef enum {
   GAME_VALUE_ONE,
@@ -24,10 +26,73 @@ typedef struct {
   bool is_guess_correct;
 } game_logic_feedback_t;
 
+// index of a code in the code space, position 0 is the most significant digit
+typedef uint16_t game_logic_code_t;
+
+typedef struct {
+  game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_feedback_t feedback;
+} game_logic_move_t;
+
+#define GAME_LOGIC_CODE_SET_WORDS ((NUMBER_OF_POSSIBLE_CODES + 63) / 64)
+
+// one game in progress, each server session or front end can own one
+typedef struct {
+  game_logic_values_t answer[NUMBER_OF_VALUES_TO_GUESS];
+  uint_fast8_t answer_bins[GAME_VALUE_MAX];
+  // bit per code, set while the code agrees with every feedback recorded so far
+  uint64_t consistent_codes[GAME_LOGIC_CODE_SET_WORDS];
+  // guesses outside the consistent set are refused before they are scored
+  bool is_hard_mode;
+} game_logic_context_t;
+
+typedef enum {
+  GAME_LOGIC_GUESS_ACCEPTED,
+  GAME_LOGIC_GUESS_INCONSISTENT
+} game_logic_guess_status_t;
+
 void game_logic_generate_random_answer(void);
 
 game_logic_feedback_t game_logic_get_feedback(game_logic_values_t guess[]);
 
 game_logic_values_t* game_logic_get_answer(void);
 
+// installs an answer chosen elsewhere, e.g. by a non uniform secret distribution
+void game_logic_set_answer(const game_logic_values_t values[]);
+
+// scores a guess against any answer without touching the game state
+game_logic_feedback_t game_logic_score(const game_logic_values_t answer[], const game_logic_values_t guess[]);
+
+// packs feedback into a single byte, (placement * (NUMBER_OF_VALUES_TO_GUESS + 1)) + value only
+uint8_t game_logic_feedback_to_class(game_logic_feedback_t feedback);
+
+game_logic_feedback_t game_logic_feedback_from_class(uint8_t feedback_class);
+
+// feedback classes of a guess against every answer, indexed by answer code, the table is built once on first use
+const uint8_t* game_logic_score_row(game_logic_code_t guess);
+
+game_logic_code_t game_logic_pack_code(const game_logic_values_t values[]);
+
+void game_logic_unpack_code(game_logic_code_t code, game_logic_values_t values[]);
+
+// picks a random answer and resets the consistent set
+void game_logic_context_start(game_logic_context_t *context, bool is_hard_mode);
+
+void game_logic_context_set_answer(game_logic_context_t *context, const game_logic_values_t values[]);
+
+// a single bit lookup, the set is narrowed as moves are recorded rather than rescoring the history
+bool game_logic_context_is_consistent(const game_logic_context_t *context, const game_logic_values_t guess[]);
+
+// narrows the consistent set, also used on its own when another codemaker gave the feedback
+void game_logic_context_record_move(game_logic_context_t *context, const game_logic_values_t guess[],
+                                    game_logic_feedback_t feedback);
+
+// scores and records the guess, feedback is only written when the guess is accepted
+game_logic_guess_status_t game_logic_context_guess(game_logic_context_t *context, const game_logic_values_t guess[],
+                                                   game_logic_feedback_t *feedback);
+
+// index of the first move the guess could not be the answer to, history_length when there is none
+size_t game_logic_find_contradicted_move(const game_logic_move_t history[], size_t history_length,
+                                         const game_logic_values_t guess[]);
+
 #endif /* GAME_LOGIC_H */
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef GAME_MODE_H
+#define GAME_MODE_H
+
+#include "game_logic.h"
+#include "solver.h"
+
+typedef enum {
+  GAME_MODE_CLASSIC,
+  GAME_MODE_EVIL,
+  GAME_MODE_BLACK_PEG,
+  GAME_MODE_LIAR,
+  GAME_MODE_NO_DUPLICATES,
+  GAME_MODE_CUSTOM_SECRETS,
+  GAME_MODE_MAX
+} game_mode_t;
+
+// the front ends only talk to the codemaker through this table so every mode plays the same way
+typedef struct {
+  const char *name;
+  void (*start)(void);
+  game_logic_feedback_t (*get_feedback)(game_logic_values_t guess[]);
+  game_logic_values_t* (*get_answer)(void);
+  // NULL when the standard feedback applies and hints can come from the shared solver
+  solver_hint_t (*get_hint)(const game_logic_move_t history[], size_t history_length);
+  // hard mode needs truthful standard feedback to tell which guesses are still consistent
+  bool supports_hard_mode;
+} game_mode_codemaker_t;
+
+const game_mode_codemaker_t* game_mode_get_codemaker(game_mode_t mode);
+
+#endif /* GAME_MODE_H */
\ No newline at end of file
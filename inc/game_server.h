@@ -0,0 +1,41 @@
+#ifndef GAME_SERVER_H
+#define GAME_SERVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_journal.h"
+#include "server_session.h"
+
+// connections beyond this are accepted and closed straight away so memory stays bounded,
+// the limit is split evenly between the reactors
+#define GAME_SERVER_MAXIMUM_SESSIONS 16384
+#define GAME_SERVER_MAXIMUM_REACTORS 64
+#define GAME_SERVER_DEFAULT_IDLE_SECONDS 300
+
+typedef enum {
+  GAME_SERVER_BACKEND_EPOLL,
+  // falls back to epoll when the kernel lacks io_uring or a feature the backend needs
+  GAME_SERVER_BACKEND_IO_URING
+} game_server_backend_t;
+
+typedef struct {
+  // seconds without input before a session is closed, 0 keeps idle sessions forever
+  uint32_t idle_seconds;
+  // seconds a game waits for its next guess before it is lost, 0 turns the move clock off
+  uint32_t move_seconds;
+  // games in flight are saved here on SIGUSR2 and on shutdown and restored at startup, NULL turns it off
+  const char *snapshot_path;
+  // every game event is appended here and games in play are recovered from it at startup, NULL turns it off
+  const char *journal_path;
+  game_journal_options_t journal;
+} game_server_options_t;
+
+// serves the line protocol from server_session.h on 127.0.0.1:port. Every reactor thread has its
+// own SO_REUSEPORT listener, epoll set or io_uring, sessions and random stream so nothing is shared on
+// the request path. Timeouts run on a timer wheel per reactor that the event loop sleeps on.
+// SIGUSR1 prints the merged stats, SIGUSR2 writes a snapshot, SIGINT or SIGTERM writes one, commits the
+// journal, prints the stats and stops the server. 0 reactors means one per online cpu
+int game_server_main(uint16_t port, size_t number_of_reactors, game_server_backend_t backend,
+                     game_server_options_t options);
+
+#endif /* GAME_SERVER_H */
\ No newline at end of file
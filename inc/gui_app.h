@@ -1,6 +1,12 @@
 #ifndef GUI_APP_H
 #define GUI_APP_H
 
-int gui_main(void);
+#include <stdbool.h>
+#include <stddef.h>
+#include "game_mode.h"
+
+int gui_main(game_mode_t mode, bool is_hard_mode);
+
+int gui_multi_board_main(size_t number_of_boards);
 
 #endif /* GUI_APP_H */
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef HINT_CACHE_H
+#define HINT_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+#include "solver.h"
+
+#define HINT_CACHE_MAXIMUM_HISTORY_LENGTH 16
+
+typedef struct hint_cache hint_cache_t;
+
+typedef struct {
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t insertions;
+  uint64_t evictions;
+  size_t capacity;
+  size_t memory_used;
+} hint_cache_stats_t;
+
+// the cache never grows past memory_budget bytes, returns NULL when the budget cannot hold a single set of entries
+hint_cache_t* hint_cache_create(size_t memory_budget);
+
+void hint_cache_destroy(hint_cache_t *cache);
+
+// looks the history up under its colour canonical form and falls back to the solver on a miss,
+// histories longer than HINT_CACHE_MAXIMUM_HISTORY_LENGTH bypass the cache
+solver_hint_t hint_cache_get_hint(hint_cache_t *cache, const game_logic_move_t history[], size_t history_length);
+
+hint_cache_stats_t hint_cache_get_stats(hint_cache_t *cache);
+
+#endif /* HINT_CACHE_H */
\ No newline at end of file
@@ -0,0 +1,78 @@
+#ifndef LARGE_SPACE_H
+#define LARGE_SPACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+// variants with more values and placements than the standard game, where the code space is far too
+// large to hold, candidates are only ever produced one at a time or as a bounded random sample
+#define LARGE_SPACE_MAXIMUM_PEGS 10
+#define LARGE_SPACE_MAXIMUM_VALUES 16
+#define LARGE_SPACE_MAXIMUM_HISTORY 32
+
+typedef struct {
+  uint8_t number_of_pegs;
+  uint8_t number_of_values;
+} large_space_variant_t;
+
+typedef struct {
+  uint8_t values[LARGE_SPACE_MAXIMUM_PEGS];
+} large_space_code_t;
+
+typedef struct {
+  large_space_code_t guess;
+  game_logic_feedback_t feedback;
+} large_space_move_t;
+
+// depth first search over placements, pruned with per move bounds on placements and total matches
+typedef struct {
+  large_space_variant_t variant;
+  const large_space_move_t *history;
+  size_t history_length;
+  uint8_t guess_bins[LARGE_SPACE_MAXIMUM_HISTORY][LARGE_SPACE_MAXIMUM_VALUES];
+  uint16_t domains[LARGE_SPACE_MAXIMUM_PEGS];
+  uint8_t placed[LARGE_SPACE_MAXIMUM_PEGS + 1][LARGE_SPACE_MAXIMUM_HISTORY];
+  uint8_t matched[LARGE_SPACE_MAXIMUM_PEGS + 1][LARGE_SPACE_MAXIMUM_HISTORY];
+  uint8_t code_bins[LARGE_SPACE_MAXIMUM_VALUES];
+  uint8_t value_order[LARGE_SPACE_MAXIMUM_PEGS][LARGE_SPACE_MAXIMUM_VALUES];
+  uint8_t next_choice[LARGE_SPACE_MAXIMUM_PEGS + 1];
+  large_space_code_t code;
+  int depth;
+  // xorshift32 stream for the random orders, NULL draws from random_value()
+  uint32_t *random_state;
+  bool is_randomised;
+  bool is_exhausted;
+} large_space_enumerator_t;
+
+// same scoring rules as game_logic_get_feedback() for any variant size
+game_logic_feedback_t large_space_score(const large_space_variant_t *variant, const large_space_code_t *answer,
+                                        const large_space_code_t *guess);
+
+void large_space_random_code(const large_space_variant_t *variant, large_space_code_t *code);
+
+// the history must outlive the enumerator, randomised enumerators try values in a fresh random order per
+// placement. False when the history is longer than LARGE_SPACE_MAXIMUM_HISTORY, the enumerator then yields nothing
+bool large_space_enumerator_init(large_space_enumerator_t *enumerator, const large_space_variant_t *variant,
+                                 const large_space_move_t history[], size_t history_length, bool is_randomised);
+
+bool large_space_enumerator_next(large_space_enumerator_t *enumerator, large_space_code_t *code);
+
+// collects up to sample_size distinct consistent codes, each from a fresh randomised descent, returns the count,
+// 0 when the history is longer than LARGE_SPACE_MAXIMUM_HISTORY
+size_t large_space_sample(const large_space_variant_t *variant, const large_space_move_t history[], size_t history_length,
+                          large_space_code_t sample[], size_t sample_size);
+
+// picks the sampled code that leaves the smallest expected partition of the sample, false when nothing is
+// consistent or the history is longer than LARGE_SPACE_MAXIMUM_HISTORY
+bool large_space_best_guess(const large_space_variant_t *variant, const large_space_move_t history[], size_t history_length,
+                            size_t sample_size, large_space_code_t *guess);
+
+// as above but every draw comes from the caller's non zero xorshift32 state, so the same state always
+// gives the same guess whatever other threads are doing
+bool large_space_best_guess_seeded(const large_space_variant_t *variant, const large_space_move_t history[],
+                                   size_t history_length, size_t sample_size, uint32_t *random_state,
+                                   large_space_code_t *guess);
+
+#endif /* LARGE_SPACE_H */
\ No newline at end of file
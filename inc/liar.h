@@ -0,0 +1,36 @@
+#ifndef LIAR_H
+#define LIAR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+#include "solver.h"
+
+// liar variant, the codemaker may answer up to LIAR_MAXIMUM_LIES guesses with wrong feedback,
+// a correct guess is always reported truthfully and a lie never claims the guess is correct
+#define LIAR_MAXIMUM_LIES 1
+#define LIAR_LIE_PROBABILITY 0.2f
+
+typedef struct {
+  float weights[NUMBER_OF_POSSIBLE_CODES];
+  uint8_t lies[NUMBER_OF_POSSIBLE_CODES];
+  uint8_t maximum_lies;
+  float lie_probability;
+} liar_solver_t;
+
+void liar_codemaker_start(void);
+
+game_logic_feedback_t liar_codemaker_get_feedback(game_logic_values_t guess[]);
+
+void liar_solver_init(liar_solver_t *solver, uint8_t maximum_lies, float lie_probability);
+
+// bayesian update of every answer's weight, answers needing more than maximum_lies lies drop to zero
+void liar_solver_update(liar_solver_t *solver, const game_logic_values_t guess[], game_logic_feedback_t feedback);
+
+// the guess whose feedback, under the noise model, carries the most information about the answer
+game_logic_code_t liar_solver_best_guess(const liar_solver_t *solver);
+
+// remaining_candidates counts answers with non zero weight
+solver_hint_t liar_get_hint(const game_logic_move_t history[], size_t history_length);
+
+#endif /* LIAR_H */
\ No newline at end of file
@@ -0,0 +1,46 @@
+#ifndef MULTI_BOARD_H
+#define MULTI_BOARD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+// multi board variant, every guess is scored against up to MULTI_BOARD_MAXIMUM_BOARDS independent answers
+#define MULTI_BOARD_MAXIMUM_BOARDS 32
+#define MULTI_BOARD_EXTRA_TRIES 5
+
+typedef struct {
+  size_t number_of_boards;
+  game_logic_code_t answers[MULTI_BOARD_MAXIMUM_BOARDS];
+  uint32_t solved_boards;
+} multi_board_game_t;
+
+typedef struct {
+  size_t number_of_boards;
+  uint16_t number_of_candidates[MULTI_BOARD_MAXIMUM_BOARDS];
+  game_logic_code_t candidates[MULTI_BOARD_MAXIMUM_BOARDS][NUMBER_OF_POSSIBLE_CODES];
+  uint32_t solved_boards;
+} multi_board_solver_t;
+
+// number_of_boards is clamped to 1..MULTI_BOARD_MAXIMUM_BOARDS
+void multi_board_start(multi_board_game_t *game, size_t number_of_boards);
+
+// feedback classes of one guess against every answer in a single pass over the score table row
+void multi_board_score(game_logic_code_t guess, const game_logic_code_t answers[], size_t number_of_answers, uint8_t classes[]);
+
+// scores every board, boards solved by an earlier guess keep reporting a correct guess
+void multi_board_get_feedback(multi_board_game_t *game, const game_logic_values_t guess[], game_logic_feedback_t feedback[]);
+
+bool multi_board_is_solved(const multi_board_game_t *game);
+
+size_t multi_board_get_maximum_number_of_tries(const multi_board_game_t *game);
+
+void multi_board_solver_init(multi_board_solver_t *solver, size_t number_of_boards);
+
+void multi_board_solver_update(multi_board_solver_t *solver, const game_logic_values_t guess[], const game_logic_feedback_t feedback[]);
+
+// finishes any board that is down to one answer, otherwise minimises the expected number of answers left summed over all boards
+game_logic_code_t multi_board_solver_best_guess(const multi_board_solver_t *solver);
+
+#endif /* MULTI_BOARD_H */
\ No newline at end of file
@@ -0,0 +1,16 @@
+#ifndef REPLAY_QUERY_APP_H
+#define REPLAY_QUERY_APP_H
+
+#include <stddef.h>
+
+// stores the finished games of a game journal in a replay store
+int replay_query_app_build(const char *journal_path, const char *store_path);
+
+// runs the query given by the arguments after the store's path, e.g. tries<=3 histogram guess1
+int replay_query_app_main(const char *store_path, int argc, char *argv[]);
+
+// replays every game of the store through the engine on a thread per processor unless told otherwise,
+// fails when any of them plays out differently
+int replay_query_app_verify(const char *store_path, size_t number_of_threads);
+
+#endif /* REPLAY_QUERY_APP_H */
\ No newline at end of file
@@ -0,0 +1,131 @@
+#ifndef REPLAY_STORE_H
+#define REPLAY_STORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+// columnar file of finished games for analysis. Games are stored in blocks, inside a block every column
+// is one contiguous array, and an index at the end keeps the minimum and maximum of every column of every
+// block. The file is mapped and queries only touch the columns and blocks their filters cannot rule out
+#define REPLAY_STORE_MAGIC 0x59414C50
+#define REPLAY_STORE_VERSION 1
+#define REPLAY_STORE_BLOCK_GAMES 65536
+#define REPLAY_STORE_MAXIMUM_MOVES 8
+#define REPLAY_STORE_NO_GUESS UINT16_MAX
+#define REPLAY_STORE_NO_FEEDBACK UINT8_MAX
+#define REPLAY_STORE_MAXIMUM_FILTERS 16
+// histogram and group by columns hold values below this
+#define REPLAY_STORE_MAXIMUM_GROUPS 65536
+
+// in order of decreasing width, so every column of a block starts aligned
+typedef enum {
+  // unix milliseconds of the first move, 8 bytes
+  REPLAY_STORE_COLUMN_STARTED,
+  // milliseconds from the start to the end of the game, 4 bytes
+  REPLAY_STORE_COLUMN_DURATION,
+  // packed codes, 2 bytes
+  REPLAY_STORE_COLUMN_SECRET,
+  REPLAY_STORE_COLUMN_GUESS,
+  // one byte each from here on
+  REPLAY_STORE_COLUMN_TRIES = REPLAY_STORE_COLUMN_GUESS + REPLAY_STORE_MAXIMUM_MOVES,
+  // game_journal_end_t
+  REPLAY_STORE_COLUMN_OUTCOME,
+  REPLAY_STORE_COLUMN_HARD_MODE,
+  // guesses that could not have been the answer given the feedback so far
+  REPLAY_STORE_COLUMN_BLUNDERS,
+  // move number of the first blunder, 0 without one
+  REPLAY_STORE_COLUMN_FIRST_BLUNDER,
+  // game_logic_feedback_to_class of each guess
+  REPLAY_STORE_COLUMN_FEEDBACK,
+  REPLAY_STORE_NUMBER_OF_COLUMNS = REPLAY_STORE_COLUMN_FEEDBACK + REPLAY_STORE_MAXIMUM_MOVES
+} replay_store_column_t;
+
+typedef struct {
+  uint64_t started;
+  uint32_t duration;
+  game_logic_code_t secret;
+  // REPLAY_STORE_NO_GUESS after the last one
+  game_logic_code_t guesses[REPLAY_STORE_MAXIMUM_MOVES];
+  uint8_t tries;
+  uint8_t outcome;
+  uint8_t is_hard_mode;
+  uint8_t feedback[REPLAY_STORE_MAXIMUM_MOVES];
+} replay_store_game_t;
+
+typedef enum {
+  REPLAY_STORE_COUNT,
+  // games per value of a column
+  REPLAY_STORE_HISTOGRAM,
+  // average of a column per value of another one
+  REPLAY_STORE_AVERAGE
+} replay_store_aggregate_t;
+
+// keeps the games whose column lies in [low, high]
+typedef struct {
+  replay_store_column_t column;
+  uint64_t low;
+  uint64_t high;
+} replay_store_filter_t;
+
+typedef struct {
+  replay_store_filter_t filters[REPLAY_STORE_MAXIMUM_FILTERS];
+  size_t number_of_filters;
+  replay_store_aggregate_t aggregate;
+  // the histogram's column and the averaged one, at most 4 bytes wide
+  replay_store_column_t column;
+  // at most 2 bytes wide
+  replay_store_column_t group_by;
+} replay_store_query_t;
+
+typedef struct {
+  uint64_t games_scanned;
+  uint64_t games_selected;
+  uint64_t blocks_scanned;
+  // ruled out by the block index without reading the block
+  uint64_t blocks_skipped;
+  // of column data the filters and aggregates read
+  uint64_t bytes_scanned;
+  // REPLAY_STORE_MAXIMUM_GROUPS entries for histograms and averages, NULL for counts
+  uint64_t *counts;
+  uint64_t *sums;
+} replay_store_result_t;
+
+typedef struct replay_store_writer replay_store_writer_t;
+typedef struct replay_store replay_store_t;
+
+// games are streamed to a temporary file next to path a block at a time
+replay_store_writer_t* replay_store_writer_create(const char *path);
+
+// the blunder columns are worked out from the moves, false when the block cannot be written
+bool replay_store_writer_add(replay_store_writer_t *writer, const replay_store_game_t *game);
+
+// writes the index and replaces path with the finished file, the writer is destroyed either way
+bool replay_store_writer_commit(replay_store_writer_t *writer);
+
+// drops everything written so far
+void replay_store_writer_destroy(replay_store_writer_t *writer);
+
+// NULL when the file is missing, truncated or from another version
+replay_store_t* replay_store_open(const char *path);
+
+void replay_store_close(replay_store_t *store);
+
+uint64_t replay_store_number_of_games(const replay_store_t *store);
+
+uint64_t replay_store_number_of_blocks(const replay_store_t *store);
+
+// decodes the games of a block into games, which holds REPLAY_STORE_BLOCK_GAMES, and returns how many
+// there are. Only the columns a game was written from are read back
+size_t replay_store_read_block(const replay_store_t *store, uint64_t block, replay_store_game_t games[]);
+
+// width of a column in bytes
+size_t replay_store_column_width(replay_store_column_t column);
+
+// false when the query asks for an aggregate the columns cannot hold or memory runs out
+bool replay_store_run(const replay_store_t *store, const replay_store_query_t *query, replay_store_result_t *result);
+
+void replay_store_result_free(replay_store_result_t *result);
+
+#endif /* REPLAY_STORE_H */
\ No newline at end of file
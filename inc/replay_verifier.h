@@ -0,0 +1,61 @@
+#ifndef REPLAY_VERIFIER_H
+#define REPLAY_VERIFIER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+#include "replay_store.h"
+
+// replays recorded games through the engine's scoring and hard mode rules to catch an engine change
+// that would alter the outcome of games already played
+#define REPLAY_VERIFIER_MAXIMUM_THREADS 64
+// only the first divergences by game are kept, all of them are counted
+#define REPLAY_VERIFIER_MAXIMUM_DIVERGENCES 1000
+
+typedef enum {
+  REPLAY_VERIFIER_AGREES,
+  // the engine scored a guess differently from the recording
+  REPLAY_VERIFIER_FEEDBACK,
+  // the score table and the scorer disagree on a guess
+  REPLAY_VERIFIER_SCORE_TABLE,
+  // hard mode refuses a guess the recording accepted
+  REPLAY_VERIFIER_REFUSED,
+  // a win without the answer as the last guess, or the answer guessed in a game that was not won
+  REPLAY_VERIFIER_OUTCOME,
+  // a code or feedback out of range, or more moves than the recording holds
+  REPLAY_VERIFIER_MALFORMED
+} replay_verifier_kind_t;
+
+// the first divergence of one game
+typedef struct {
+  // position of the game in the store
+  uint64_t game;
+  replay_verifier_kind_t kind;
+  // from 0, the last move for outcomes
+  uint8_t move;
+  // feedback classes, where the table's class stands in for the recorded one on score table divergences,
+  // or game_journal_end_t values for outcomes
+  uint8_t recorded;
+  uint8_t replayed;
+} replay_verifier_divergence_t;
+
+typedef struct {
+  uint64_t games;
+  uint64_t moves;
+  uint64_t games_diverged;
+  // the lowest numbered games that diverged, in order
+  replay_verifier_divergence_t divergences[REPLAY_VERIFIER_MAXIMUM_DIVERGENCES];
+  size_t number_of_divergences;
+} replay_verifier_result_t;
+
+// REPLAY_VERIFIER_AGREES when the engine plays the game out as recorded, otherwise fills divergence
+// with everything but the game's position
+replay_verifier_kind_t replay_verifier_check_game(const replay_store_game_t *game,
+                                                  replay_verifier_divergence_t *divergence);
+
+// checks every game of the store, blocks are shared out between the threads and the result does not
+// depend on how many there are or how they were scheduled. False when no memory is left for a thread
+bool replay_verifier_run(const replay_store_t *store, size_t number_of_threads, replay_verifier_result_t *result);
+
+#endif /* REPLAY_VERIFIER_H */
\ No newline at end of file
@@ -0,0 +1,31 @@
+#ifndef SECRET_DISTRIBUTION_H
+#define SECRET_DISTRIBUTION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "game_logic.h"
+#include "solver.h"
+
+// answers drawn from something other than independent uniform values, either without repeated
+// values or from per code weights, the active distribution also limits the hint solver's answers
+
+void secret_distribution_use_no_duplicates(void);
+
+// weights are indexed by code and must not be negative, codes with zero weight are never drawn
+bool secret_distribution_use_weights(const double weights[NUMBER_OF_POSSIBLE_CODES]);
+
+// one code per line written with the letters A-F, optionally followed by a positive weight which defaults
+// to 1, blank lines and lines starting with # are skipped. Anything else on a line or a line longer than 62
+// characters fails the whole file
+bool secret_distribution_load_file(const char *path);
+
+void secret_distribution_generate_answer(void);
+
+void secret_distribution_start_no_duplicates(void);
+
+// codes that can be drawn under the active distribution
+size_t secret_distribution_get_codes(const game_logic_code_t **codes_out);
+
+solver_hint_t secret_distribution_get_hint(const game_logic_move_t history[], size_t history_length);
+
+#endif /* SECRET_DISTRIBUTION_H */
\ No newline at end of file
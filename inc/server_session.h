@@ -0,0 +1,162 @@
+#ifndef SERVER_SESSION_H
+#define SERVER_SESSION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_journal.h"
+#include "game_logic.h"
+#include "session_snapshot.h"
+#include "timer_wheel.h"
+
+// one connection to the game server, the transport fills input and drains output so the
+// protocol can be driven by any event loop
+#define SERVER_SESSION_INPUT_SIZE 256
+#define SERVER_SESSION_OUTPUT_SIZE 512
+// room a line needs in the output before it is handled, the longest response is well under this
+#define SERVER_SESSION_MAXIMUM_RESPONSE 32
+#define SERVER_SESSION_MAXIMUM_NUMBER_OF_TRIES 8
+// games a binary connection can play at once, text connections only use the first
+#define SERVER_SESSION_MAXIMUM_GAMES 8
+
+// line protocol, one command per line and one response line per command:
+//   NEW [HARD]   -> READY <tries>
+//   GUESS ABCD   -> FEEDBACK <placement> <value only> | WON <tries> | LOST <answer> | TIMEOUT <answer>
+//   GIVEUP       -> ANSWER <answer>
+//   QUIT         -> BYE, the connection is closed once the output is flushed
+//   PROTOCOL BINARY -> BINARY <frame size>, every byte after the line is a binary frame
+//   TOKEN        -> TOKEN <16 hex digits>, names the session's games in snapshots
+//   RESUME <token> -> RESUMED <games>, takes back the games a restarted server saved under the token
+// errors are reported as ERR <reason> and leave the game as it was. With a move clock a game that waits
+// too long for a guess is lost, the next guess learns about it with TIMEOUT
+
+// binary protocol for bots, requests are fixed size frames that can be pipelined:
+//   byte 0 operation, byte 1 game slot below SERVER_SESSION_MAXIMUM_GAMES, bytes 2-3 the packed code
+//   of a guess, little endian, zero otherwise
+// every request is answered by one byte, the feedback class of a guess or one of the codes below.
+// The answer is never sent back, bots that want it should use the text protocol
+#define SERVER_SESSION_FRAME_SIZE 4
+#define SERVER_SESSION_REPLY_READY 0xF0
+#define SERVER_SESSION_REPLY_GAVE_UP 0xF1
+#define SERVER_SESSION_REPLY_BYE 0xF2
+#define SERVER_SESSION_REPLY_TIMED_OUT 0xF3
+#define SERVER_SESSION_REPLY_NO_GAME 0xE0
+#define SERVER_SESSION_REPLY_BAD_GUESS 0xE1
+#define SERVER_SESSION_REPLY_HARD_MODE 0xE2
+#define SERVER_SESSION_REPLY_BAD_REQUEST 0xE3
+
+typedef enum {
+  SERVER_SESSION_OPERATION_NEW = 1,
+  SERVER_SESSION_OPERATION_NEW_HARD,
+  SERVER_SESSION_OPERATION_GUESS,
+  SERVER_SESSION_OPERATION_GIVEUP,
+  SERVER_SESSION_OPERATION_QUIT
+} server_session_operation_t;
+
+typedef enum {
+  SERVER_SESSION_PROTOCOL_TEXT,
+  SERVER_SESSION_PROTOCOL_BINARY
+} server_session_protocol_t;
+
+// counters have a single writer, other threads may read them with __atomic_load_n at any time
+#define SERVER_SESSION_COUNT(counter) __atomic_store_n(&(counter), (counter) + 1, __ATOMIC_RELAXED)
+
+// the transport counts sessions, the protocol counts everything else
+typedef struct {
+  uint64_t sessions_accepted;
+  uint64_t sessions_refused;
+  uint64_t sessions_closed;
+  uint64_t games_started;
+  uint64_t games_won;
+  uint64_t guesses;
+  uint64_t errors;
+  uint64_t idle_timeouts;
+  uint64_t move_timeouts;
+} server_session_stats_t;
+
+typedef struct server_session server_session_t;
+
+// state shared by every session of one thread, so sessions never touch another thread's memory
+typedef struct {
+  // xorshift32 stream for answers, zero falls back to random_value()
+  uint32_t random_state;
+  server_session_stats_t stats;
+  // ticked in milliseconds of server_session_clock(), NULL leaves sessions without timeouts
+  timer_wheel_t *timers;
+  // milliseconds, 0 disables the timeout
+  uint32_t idle_timeout;
+  uint32_t move_timeout;
+  // filled by server_session_run_timers
+  server_session_t *timed_out;
+  // games saved by the previous run, shared by every shard, NULL when there are none
+  session_snapshot_t *restored;
+  // NULL leaves games out of the journal
+  game_journal_writer_t *journal;
+  // advanced by the stride so the shards of one server never hand out the same game id
+  uint64_t next_game_id;
+  uint32_t game_id_stride;
+} server_session_shard_t;
+
+typedef struct {
+  game_logic_context_t context;
+  timer_wheel_timer_t move_timer;
+  // names the game in the journal
+  uint64_t id;
+  game_logic_code_t history[SERVER_SESSION_MAXIMUM_NUMBER_OF_TRIES];
+  // index in the session's games, lets the move clock find its session
+  uint8_t slot;
+  uint8_t tries;
+  bool is_playing;
+  // lost to the move clock, cleared once the next guess has been told
+  bool is_timed_out;
+} server_session_game_t;
+
+struct server_session {
+  int fd;
+  // 0 until the client asks for one, only sessions with a token are saved in snapshots
+  uint64_t token;
+  server_session_shard_t *shard;
+  server_session_protocol_t protocol;
+  server_session_game_t games[SERVER_SESSION_MAXIMUM_GAMES];
+  bool is_closing;
+  // set after an overlong line until its end is seen
+  bool is_discarding;
+  // the idle timer is only moved when it fires, input just stamps the time
+  timer_wheel_timer_t idle_timer;
+  uint64_t last_active;
+  server_session_t *next_timed_out;
+  size_t input_length;
+  size_t output_length;
+  char input[SERVER_SESSION_INPUT_SIZE];
+  char output[SERVER_SESSION_OUTPUT_SIZE];
+};
+
+void server_session_init(server_session_t *session, int fd, server_session_shard_t *shard);
+
+// disarms the session's timers, the transport calls it before the session's memory is reused
+void server_session_release(server_session_t *session);
+
+// handles every complete line or frame in the input while the output has room for the response, the
+// responses of one call are left together in the output so the transport can send them in one write
+void server_session_process_input(server_session_t *session);
+
+// drops bytes the transport has written from the front of the output
+void server_session_consume_output(server_session_t *session, size_t length);
+
+// false when the input is full and waiting for the output to drain, the transport should stop reading
+bool server_session_wants_input(const server_session_t *session);
+
+// fills one entry per game in play and returns how many, for a session whose thread is paused
+size_t server_session_save(const server_session_t *session, session_snapshot_game_t games[]);
+
+// milliseconds on the monotonic clock
+uint64_t server_session_clock(void);
+
+// milliseconds the transport may wait before server_session_run_timers has work, -1 when nothing is armed
+int server_session_timer_wait(const server_session_shard_t *shard, uint64_t now);
+
+// expires the move clocks and idle timers due by now. Idle sessions are marked closing and returned
+// linked through next_timed_out, the transport should close them
+server_session_t* server_session_run_timers(server_session_shard_t *shard, uint64_t now);
+
+#endif /* SERVER_SESSION_H */
\ No newline at end of file
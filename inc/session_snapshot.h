@@ -0,0 +1,75 @@
+#ifndef SESSION_SNAPSHOT_H
+#define SESSION_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+// on disk copy of the games in flight so a restarted server can hand them back to their players. The file
+// is a header followed by an open addressing table of games keyed by session token and game slot, written
+// in one sequential write and used in place through mmap after a restart, nothing is rebuilt on load
+#define SESSION_SNAPSHOT_MAGIC 0x50414E53
+#define SESSION_SNAPSHOT_VERSION 2
+// at least SERVER_SESSION_MAXIMUM_NUMBER_OF_TRIES
+#define SESSION_SNAPSHOT_MAXIMUM_HISTORY 8
+#define SESSION_SNAPSHOT_MAXIMUM_RANDOM_STATES 64
+
+typedef struct {
+  // 0 marks an empty table entry
+  uint64_t token;
+  // names the game in the journal, 0 when it was not journaled
+  uint64_t game_id;
+  // set once the game has been handed back after a restart
+  uint32_t is_claimed;
+  // since the session's last input when the snapshot was taken
+  uint32_t idle_milliseconds;
+  // left on the move clock, 0 when it was not running
+  uint32_t move_milliseconds;
+  uint8_t slot;
+  uint8_t tries;
+  uint8_t is_hard_mode;
+  uint8_t reserved;
+  game_logic_code_t answer;
+  game_logic_code_t history[SESSION_SNAPSHOT_MAXIMUM_HISTORY];
+} session_snapshot_game_t;
+
+typedef struct session_snapshot_writer session_snapshot_writer_t;
+typedef struct session_snapshot session_snapshot_t;
+
+session_snapshot_writer_t* session_snapshot_writer_create(void);
+
+void session_snapshot_writer_destroy(session_snapshot_writer_t *writer);
+
+// false when out of memory, a game with token 0 is ignored
+bool session_snapshot_writer_add(session_snapshot_writer_t *writer, const session_snapshot_game_t *game);
+
+// answer streams of the reactors, restored so a restart does not replay or skip answers
+void session_snapshot_writer_set_random_states(session_snapshot_writer_t *writer, const uint32_t states[],
+                                               size_t number_of_states);
+
+// builds the table and replaces path with it through a temporary file, so a crash never leaves a torn snapshot
+bool session_snapshot_writer_commit(session_snapshot_writer_t *writer, const char *path);
+
+size_t session_snapshot_writer_number_of_games(const session_snapshot_writer_t *writer);
+
+// NULL when the file is missing, truncated, from another version or its table has no empty bucket
+session_snapshot_t* session_snapshot_open(const char *path);
+
+void session_snapshot_close(session_snapshot_t *snapshot);
+
+// hands a game back at most once, safe to call from any number of threads
+const session_snapshot_game_t* session_snapshot_claim(session_snapshot_t *snapshot, uint64_t token, uint8_t slot);
+
+// 0 when the snapshot has no state for the index
+uint32_t session_snapshot_random_state(const session_snapshot_t *snapshot, size_t index);
+
+size_t session_snapshot_number_of_games(const session_snapshot_t *snapshot);
+
+// carries games nobody came back for into the next snapshot, unless they have been idle for longer than
+// maximum_idle_milliseconds counting the time since the snapshot was taken (0 keeps them all). Claiming
+// must be stopped while this runs
+bool session_snapshot_add_unclaimed(const session_snapshot_t *snapshot, session_snapshot_writer_t *writer,
+                                    uint32_t maximum_idle_milliseconds);
+
+#endif /* SESSION_SNAPSHOT_H */
\ No newline at end of file
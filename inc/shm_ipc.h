@@ -0,0 +1,53 @@
+#ifndef SHM_IPC_H
+#define SHM_IPC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "server_session.h"
+
+// shared memory front end for bots on the same host. Every client claims a slot holding a request
+// ring and a reply ring, each with a single producer and a single consumer, carrying the binary frames
+// and reply bytes from server_session.h. Submitting and reading never make a syscall while the other
+// side is busy, a side that has gone idle sleeps on a futex and is only woken when it asked to be
+#define SHM_IPC_MAXIMUM_CLIENTS 64
+// power of two, ring positions wrap with a mask
+#define SHM_IPC_REQUEST_RING_SIZE 4096
+#define SHM_IPC_REPLY_RING_SIZE 1024
+// polls of an empty ring before going to sleep, none on a single cpu where spinning only delays the other side
+#define SHM_IPC_SPIN_ITERATIONS 4096
+
+typedef struct shm_ipc_server shm_ipc_server_t;
+typedef struct shm_ipc_client shm_ipc_client_t;
+
+// creates the shared memory object /dev/shm/<name>, name has to start with a slash
+shm_ipc_server_t* shm_ipc_server_create(const char *name);
+
+// one pass over every slot, returns whether any request or reply moved
+bool shm_ipc_server_poll(shm_ipc_server_t *server);
+
+// polls until shm_ipc_server_stop(), sleeping on a futex while every client is idle
+void shm_ipc_server_run(shm_ipc_server_t *server);
+
+// safe to call from another thread
+void shm_ipc_server_stop(shm_ipc_server_t *server);
+
+// unmaps and unlinks the shared memory object
+void shm_ipc_server_destroy(shm_ipc_server_t *server);
+
+// serves until SIGINT or SIGTERM
+int shm_ipc_server_main(const char *name);
+
+// NULL when there is no server or every slot is taken
+shm_ipc_client_t* shm_ipc_client_connect(const char *name);
+
+// queues one frame, false when the request ring is full
+bool shm_ipc_client_submit(shm_ipc_client_t *client, const uint8_t frame[SERVER_SESSION_FRAME_SIZE]);
+
+// reads up to maximum reply bytes, with wait set it blocks until there is at least one
+size_t shm_ipc_client_receive(shm_ipc_client_t *client, uint8_t replies[], size_t maximum, bool wait);
+
+// frees the slot for another client
+void shm_ipc_client_disconnect(shm_ipc_client_t *client);
+
+#endif /* SHM_IPC_H */
\ No newline at end of file
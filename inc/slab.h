@@ -0,0 +1,56 @@
+#ifndef SLAB_H
+#define SLAB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// fixed size object pool, every object is reserved and faulted in up front so taking and returning one
+// never reaches malloc or the kernel. A slab belongs to a single thread, each reactor owns its own and
+// its free list needs no lock. Only the stats may be read from another thread
+typedef struct slab slab_t;
+
+// names an object across reuse, generation in the high half and index in the low half. Handles of
+// freed objects go stale instead of silently naming whatever object took the slot next
+typedef uint64_t slab_handle_t;
+// never handed out, callers can use it as a sentinel
+#define SLAB_INVALID_HANDLE 0
+#define SLAB_NAME_SIZE 32
+
+typedef struct {
+  char name[SLAB_NAME_SIZE];
+  // rounded up to a cache line
+  size_t object_size;
+  size_t capacity;
+  size_t in_use;
+  size_t high_water;
+  uint64_t allocations;
+  // allocations refused because every object was in use
+  uint64_t exhausted;
+  size_t memory_reserved;
+} slab_stats_t;
+
+// NULL when the memory cannot be reserved, capacity is capped at UINT32_MAX objects
+slab_t* slab_create(const char *name, size_t object_size, size_t capacity);
+
+void slab_destroy(slab_t *slab);
+
+// NULL once every object is in use, handle may be NULL. The object is not cleared
+void* slab_alloc(slab_t *slab, slab_handle_t *handle);
+
+// returns false for a stale or invalid handle and leaves the slab untouched
+bool slab_free(slab_t *slab, slab_handle_t handle);
+
+// NULL for a stale or invalid handle
+void* slab_get(const slab_t *slab, slab_handle_t handle);
+
+// handle of an object currently handed out by this slab
+slab_handle_t slab_handle_of(const slab_t *slab, const void *object);
+
+// the object at an index below the capacity, NULL while it is free. For walking every object of a slab
+// from another thread while its owner is paused
+void* slab_object_at(const slab_t *slab, size_t index);
+
+slab_stats_t slab_get_stats(const slab_t *slab);
+
+#endif /* SLAB_H */
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+typedef struct {
+  game_logic_code_t best_guess;
+  uint16_t remaining_candidates;
+} solver_hint_t;
+
+// writes every code consistent with the history into candidates (NUMBER_OF_POSSIBLE_CODES long) and returns the count
+size_t solver_filter_candidates(const game_logic_move_t history[], size_t history_length, game_logic_code_t candidates[]);
+
+// as above but only answers in space are considered, for modes that never draw some codes
+size_t solver_filter_candidates_in_space(const game_logic_code_t space[], size_t space_size,
+                                         const game_logic_move_t history[], size_t history_length,
+                                         game_logic_code_t candidates[]);
+
+// minimax (Knuth) choice over the whole code space, ties are broken in favour of codes that are still candidates
+game_logic_code_t solver_best_guess(const game_logic_code_t candidates[], size_t number_of_candidates);
+
+solver_hint_t solver_get_hint(const game_logic_move_t history[], size_t history_length);
+
+solver_hint_t solver_get_hint_in_space(const game_logic_code_t space[], size_t space_size,
+                                       const game_logic_move_t history[], size_t history_length);
+
+#endif /* SOLVER_H */
\ No newline at end of file
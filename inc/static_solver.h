@@ -0,0 +1,40 @@
+#ifndef STATIC_SOLVER_H
+#define STATIC_SOLVER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+// 5 bits per feedback class packed into a 64 bit signature
+#define STATIC_SOLVER_MAXIMUM_GUESSES 12
+
+typedef struct {
+  uint64_t signature;
+  game_logic_code_t secret;
+} static_solver_certificate_entry_t;
+
+typedef struct {
+  game_logic_code_t guesses[STATIC_SOLVER_MAXIMUM_GUESSES];
+  size_t number_of_guesses;
+  // every secret with the feedback signature it produces, sorted by signature
+  static_solver_certificate_entry_t certificate[NUMBER_OF_POSSIBLE_CODES];
+} static_solver_result_t;
+
+typedef struct {
+  size_t number_of_threads;
+  uint32_t iterations_per_size;
+  uint32_t seed;
+} static_solver_config_t;
+
+// finds a set of guesses whose feedback alone identifies every secret, starting from a greedy
+// set and shrinking it with a parallel local search until a size cannot be reached
+bool static_solver_solve(const static_solver_config_t *config, static_solver_result_t *result);
+
+// true when no two secrets share a feedback signature for these guesses
+bool static_solver_verify(const game_logic_code_t guesses[], size_t number_of_guesses);
+
+bool static_solver_decode(const static_solver_result_t *result, const game_logic_feedback_t feedback[],
+                          game_logic_code_t *secret);
+
+#endif /* STATIC_SOLVER_H */
\ No newline at end of file
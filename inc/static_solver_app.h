@@ -0,0 +1,6 @@
+#ifndef STATIC_SOLVER_APP_H
+#define STATIC_SOLVER_APP_H
+
+int static_solver_app_main(void);
+
+#endif /* STATIC_SOLVER_APP_H */
\ No newline at end of file
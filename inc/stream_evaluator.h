@@ -0,0 +1,57 @@
+#ifndef STREAM_EVALUATOR_H
+#define STREAM_EVALUATOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+// scores a stream of requests for batch jobs and shell pipelines, one reply per request:
+//   <secret> <guess>      e.g. AABB ABCD -> <placement> <value only>, e.g. 1 1
+//   <session> <guess>     e.g. 42 ABCD   -> the same, against the secret of the session's game
+//   anything else                        -> ERR
+// a session is any decimal number. Its game starts with its first guess, a secret drawn from the seed,
+// the session and how many games it played before, and ends when it is won or after
+// STREAM_EVALUATOR_MAXIMUM_NUMBER_OF_TRIES guesses, the next guess starts another one.
+// The binary stream is made of frames of the secret's and the guess's packed codes, two bytes each and
+// little endian, each answered by the feedback class byte or STREAM_EVALUATOR_BAD_FRAME
+#define STREAM_EVALUATOR_FRAME_SIZE 4
+#define STREAM_EVALUATOR_BAD_FRAME 0xE1
+#define STREAM_EVALUATOR_MAXIMUM_NUMBER_OF_TRIES 8
+// the longest reply, the output needs this much room left for a request to be handled
+#define STREAM_EVALUATOR_MAXIMUM_REPLY 4
+// reads and writes of the stream main, lines longer than this are errors
+#define STREAM_EVALUATOR_BUFFER_SIZE (1 << 20)
+
+typedef struct {
+  uint64_t requests;
+  uint64_t errors;
+  uint64_t sessions;
+  uint64_t bytes_read;
+  uint64_t bytes_written;
+} stream_evaluator_stats_t;
+
+typedef struct stream_evaluator stream_evaluator_t;
+
+stream_evaluator_t* stream_evaluator_create(uint64_t seed);
+
+void stream_evaluator_destroy(stream_evaluator_t *evaluator);
+
+// handles every complete line of input while the output has room for the reply, returns how many bytes
+// of input it used, always up to the end of a line
+size_t stream_evaluator_evaluate_lines(stream_evaluator_t *evaluator, const char *input, size_t length,
+                                       char *output, size_t output_capacity, size_t *output_length);
+
+// handles every complete frame, each adds one byte to the output, returns how many bytes of input it used
+size_t stream_evaluator_evaluate_frames(stream_evaluator_t *evaluator, const uint8_t *input, size_t length,
+                                        uint8_t *output);
+
+const stream_evaluator_stats_t* stream_evaluator_get_stats(const stream_evaluator_t *evaluator);
+
+// evaluates input_fd into output_fd until the end of the input, false on a read or write error
+bool stream_evaluator_run(stream_evaluator_t *evaluator, int input_fd, int output_fd, bool is_binary);
+
+// evaluates stdin into stdout and prints the stats on stderr
+int stream_evaluator_main(bool is_binary, uint64_t seed);
+
+#endif /* STREAM_EVALUATOR_H */
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// hierarchical timing wheel, TIMER_WHEEL_LEVELS levels of 64 slots where every slot of a level spans a
+// whole turn of the level below. Arming and cancelling link or unlink an intrusive timer, expiring walks
+// one slot, and an occupancy bitmap per level lets the wheel jump over empty slots. Ticks are whatever
+// unit the caller advances the wheel in, a wheel belongs to a single thread
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_SLOTS 64
+// timers further out wait in the top level and are placed again when it comes round
+#define TIMER_WHEEL_RANGE ((uint64_t) 1 << (6 * TIMER_WHEEL_LEVELS))
+
+typedef struct timer_wheel timer_wheel_t;
+typedef struct timer_wheel_timer timer_wheel_timer_t;
+
+// called with the argument given to timer_wheel_advance, the timer is disarmed and may be armed again
+typedef void (*timer_wheel_callback_t)(timer_wheel_timer_t *timer, void *argument);
+
+// embedded in the object it times, find the object back with offsetof
+struct timer_wheel_timer {
+  timer_wheel_timer_t *next;
+  timer_wheel_timer_t *previous;
+  timer_wheel_callback_t callback;
+  uint64_t expires;
+  uint8_t level;
+  uint8_t slot;
+  bool is_armed;
+};
+
+timer_wheel_t* timer_wheel_create(uint64_t now);
+
+void timer_wheel_destroy(timer_wheel_t *wheel);
+
+void timer_wheel_timer_init(timer_wheel_timer_t *timer, timer_wheel_callback_t callback);
+
+// expires in the first advance that reaches the given tick, arming an armed timer moves it
+void timer_wheel_arm(timer_wheel_t *wheel, timer_wheel_timer_t *timer, uint64_t expires);
+
+// does nothing for a timer that is not armed
+void timer_wheel_cancel(timer_wheel_t *wheel, timer_wheel_timer_t *timer);
+
+// runs the callback of every timer that expires up to and including now, returns how many ran
+size_t timer_wheel_advance(timer_wheel_t *wheel, uint64_t now, void *argument);
+
+// first tick not yet advanced over
+uint64_t timer_wheel_now(const timer_wheel_t *wheel);
+
+// ticks until the next advance can have work, 0 when some is due and UINT64_MAX when nothing is armed.
+// A timer beyond the bottom level may only be moved down at that point, the wait is never too long
+uint64_t timer_wheel_ticks_until_next(const timer_wheel_t *wheel);
+
+size_t timer_wheel_number_of_timers(const timer_wheel_t *wheel);
+
+#endif /* TIMER_WHEEL_H */
\ No newline at end of file
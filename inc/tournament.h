@@ -0,0 +1,99 @@
+#ifndef TOURNAMENT_H
+#define TOURNAMENT_H
+
+#include <signal.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "large_space.h"
+
+// plays codebreaking strategies against the same secrets, every code of the variant or a sample drawn
+// from the seed, and scores them side by side. Each game is a task, workers take tasks from the front
+// of their own share and steal half of another's when theirs runs out. Finished games are checkpointed
+// so an interrupted run picks up where it stopped
+#define TOURNAMENT_MAXIMUM_STRATEGIES 8
+#define TOURNAMENT_MAXIMUM_THREADS 256
+#define TOURNAMENT_STRATEGY_NAME_SIZE 32
+// variants with more codes than this play a sample of them
+#define TOURNAMENT_MAXIMUM_SECRETS (1u << 20)
+#define TOURNAMENT_DEFAULT_SAMPLE_SIZE 10000
+#define TOURNAMENT_DEFAULT_CHECKPOINT_MILLISECONDS 5000
+#define TOURNAMENT_CHECKPOINT_MAGIC 0x4E525554
+#define TOURNAMENT_CHECKPOINT_VERSION 1
+
+typedef struct {
+  const char *name;
+  // exact strategies go through every code and can only play the standard game
+  bool is_standard_only;
+  // the same history always gets the same guess, so the opening is worked out once for every game
+  bool is_deterministic;
+  // the next guess, the history is shorter than LARGE_SPACE_MAXIMUM_HISTORY. Random choices draw from
+  // random_state, a non zero xorshift32 state seeded for every game, never from rand()
+  void (*choose)(const large_space_variant_t *variant, const large_space_move_t history[], size_t history_length,
+                 uint32_t *random_state, large_space_code_t *guess);
+} tournament_strategy_t;
+
+typedef struct {
+  large_space_variant_t variant;
+  uint8_t maximum_tries;
+  // secrets drawn from the seed, with replacement. 0 plays every code of variants that have at most
+  // TOURNAMENT_MAXIMUM_SECRETS of them and TOURNAMENT_DEFAULT_SAMPLE_SIZE of larger ones
+  uint32_t sample_size;
+  // draws the sample and seeds every game's random choices, a checkpoint's own seed is used when resuming
+  uint64_t seed;
+  // 0 for one per processor
+  size_t number_of_threads;
+  const tournament_strategy_t *strategies[TOURNAMENT_MAXIMUM_STRATEGIES];
+  size_t number_of_strategies;
+  // NULL for no checkpoints
+  const char *checkpoint_path;
+  uint32_t checkpoint_milliseconds;
+  // the run stops early, after a checkpoint, when one of these is delivered. They must be blocked in
+  // every thread, NULL for none
+  const sigset_t *stop_signals;
+  // stops after this many games, 0 for no limit
+  uint64_t maximum_games;
+} tournament_options_t;
+
+typedef struct {
+  const char *name;
+  uint64_t games;
+  // games the strategy ran out of tries in
+  uint64_t failures;
+  uint64_t tries_to_win;
+  // the most tries any won game took
+  uint8_t worst_case;
+  uint64_t moves;
+  // processor time spent choosing guesses, an opening shared by every game is counted once
+  uint64_t cpu_nanoseconds;
+} tournament_result_t;
+
+typedef struct {
+  uint64_t number_of_secrets;
+  uint64_t seed;
+  size_t number_of_threads;
+  // played in this run and taken over from the checkpoint
+  uint64_t games_played;
+  uint64_t games_resumed;
+  uint64_t steals;
+  uint64_t wall_nanoseconds;
+  uint64_t checkpoint_failures;
+  // every game has been played
+  bool is_complete;
+} tournament_stats_t;
+
+// the strategies built in, returns how many
+size_t tournament_get_strategies(const tournament_strategy_t **strategies);
+
+// NULL when there is none by that name
+const tournament_strategy_t* tournament_find_strategy(const char *name);
+
+// plays the games the checkpoint does not have yet and fills one result per strategy in from all of them.
+// False when the options are not a playable tournament or the checkpoint belongs to a different one
+bool tournament_run(const tournament_options_t *options, tournament_result_t results[], tournament_stats_t *stats);
+
+// strategy_names is a comma separated list, NULL for every strategy that can play the variant. Stops
+// early with a checkpoint on SIGINT or SIGTERM
+int tournament_main(const char *strategy_names, tournament_options_t *options);
+
+#endif /* TOURNAMENT_H */
\ No newline at end of file
@@ -0,0 +1,26 @@
+#ifndef URING_REACTOR_H
+#define URING_REACTOR_H
+
+#include <stddef.h>
+#include "server_session.h"
+#include "slab.h"
+
+// io_uring backend for one game server reactor: a multishot accept on the listener, a multishot recv
+// per session into a ring of provided buffers registered with the kernel, and every submission of a
+// loop iteration batched into the io_uring_enter that waits for the next completions
+typedef struct uring_reactor uring_reactor_t;
+
+// called on the reactor thread between batches of completions, while every session is at rest
+typedef void (*uring_reactor_hook_t)(void *argument);
+
+// NULL when the kernel lacks io_uring or provided buffer rings, the caller should use epoll instead.
+// Writing to the wake_fd eventfd makes the reactor go round its loop and call its hook
+uring_reactor_t* uring_reactor_create(int listen_fd, int wake_fd, size_t maximum_sessions, server_session_shard_t *shard);
+
+// the sessions of this reactor, every object starts with its server_session_t
+slab_t* uring_reactor_get_sessions(uring_reactor_t *reactor);
+
+// only returns on an unrecoverable ring error
+void uring_reactor_run(uring_reactor_t *reactor, uring_reactor_hook_t hook, void *argument);
+
+#endif /* URING_REACTOR_H */
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef WORD_LIST_H
+#define WORD_LIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "game_logic.h"
+
+// word variant, answers and guesses are dictionary words scored with the same placement / value only
+// split as the standard game over a 26 letter alphabet
+#define WORD_LIST_ALPHABET_SIZE 26
+#define WORD_LIST_MAXIMUM_WORD_LENGTH 12
+#define WORD_LIST_BITS_PER_LETTER 5
+
+// index file layout: header, sorted packed words, then a bitmap over the words per (position, letter)
+typedef struct {
+  char magic[4];
+  uint32_t version;
+  uint32_t word_length;
+  uint32_t reserved;
+  uint64_t number_of_words;
+  uint64_t bitmap_stride;
+} word_list_header_t;
+
+typedef struct {
+  void *map;
+  size_t map_size;
+  const word_list_header_t *header;
+  const uint64_t *words;
+  const uint64_t *bitmaps;
+} word_list_t;
+
+typedef struct {
+  uint64_t guess;
+  game_logic_feedback_t feedback;
+} word_list_move_t;
+
+// reads one word per line, keeps words of word_length letters a-z (any case), sorts and deduplicates them
+bool word_list_build_index(const char *dictionary_path, const char *index_path, uint8_t word_length);
+
+// maps the index read only, nothing is parsed or copied so opening costs the same for any dictionary size
+bool word_list_open(word_list_t *list, const char *index_path);
+
+void word_list_close(word_list_t *list);
+
+size_t word_list_get_size(const word_list_t *list);
+
+uint8_t word_list_get_word_length(const word_list_t *list);
+
+uint64_t word_list_get_word(const word_list_t *list, size_t index);
+
+// false when the word has the wrong length or characters outside a-z, letters pack first letter highest
+bool word_list_pack(uint8_t word_length, const char *word, uint64_t *packed);
+
+void word_list_unpack(uint8_t word_length, uint64_t packed, char word[]);
+
+// binary search over the sorted words
+bool word_list_contains(const word_list_t *list, uint64_t packed);
+
+const uint64_t* word_list_get_bitmap(const word_list_t *list, uint8_t position, uint8_t letter);
+
+game_logic_feedback_t word_list_score(uint8_t word_length, uint64_t answer, uint64_t guess);
+
+// sets a bit per word consistent with the history, bitmaps rule whole groups out before words are scored,
+// candidates needs bitmap_stride words, returns the count
+size_t word_list_filter(const word_list_t *list, const word_list_move_t history[], size_t history_length, uint64_t candidates[]);
+
+#endif /* WORD_LIST_H */
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "black_peg.h"
+#include <stdbool.h>
+#include <pthread.h>
+
+#define LOW_SEVEN_BITS 0x7F7F7F7Fu
+#define HIGH_BITS 0x80808080u
+#define BYTE_SUM 0x01010101u
+
+static uint32_t all_codes[NUMBER_OF_POSSIBLE_CODES];
+static pthread_once_t all_codes_once = PTHREAD_ONCE_INIT;
+
+static void init_all_codes(void) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    game_logic_unpack_code(i, values);
+    all_codes[i] = black_peg_pack(values);
+  }
+}
+
+uint32_t black_peg_pack(const game_logic_values_t values[]) {
+  uint32_t packed = 0;
+  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    packed |= (uint32_t) values[i] << (i * 8);
+  }
+  return packed;
+}
+
+uint8_t black_peg_score(uint32_t answer, uint32_t guess) {
+  uint32_t difference = answer ^ guess;
+  // the high bit of each byte ends up set exactly when that position differs
+  uint32_t differing = (((difference & LOW_SEVEN_BITS) + LOW_SEVEN_BITS) | difference) & HIGH_BITS;
+  // adding the flags up with a multiply keeps the loop free of popcount so it vectorises
+  return (uint8_t)(NUMBER_OF_VALUES_TO_GUESS - (((differing >> 7) * BYTE_SUM) >> 24));
+}
+
+void black_peg_score_batch(uint32_t guess, const uint32_t answers[], size_t number_of_answers, uint8_t placements[]) {
+  for (size_t i = 0; i < number_of_answers; i++) {
+    placements[i] = black_peg_score(answers[i], guess);
+  }
+}
+
+game_logic_feedback_t black_peg_get_feedback(game_logic_values_t guess[]) {
+  game_logic_feedback_t feedback = {0};
+  feedback.number_of_correct_value_and_placement = black_peg_score(black_peg_pack(game_logic_get_answer()), black_peg_pack(guess));
+  feedback.is_guess_correct = (bool)(feedback.number_of_correct_value_and_placement == NUMBER_OF_VALUES_TO_GUESS);
+  return feedback;
+}
+
+solver_hint_t black_peg_get_hint(const game_logic_move_t history[], size_t history_length) {
+  pthread_once(&all_codes_once, init_all_codes);
+  uint32_t candidates[NUMBER_OF_POSSIBLE_CODES];
+  game_logic_code_t candidate_codes[NUMBER_OF_POSSIBLE_CODES];
+  bool is_candidate[NUMBER_OF_POSSIBLE_CODES] = {0};
+  uint8_t placements[NUMBER_OF_POSSIBLE_CODES];
+  size_t number_of_candidates = NUMBER_OF_POSSIBLE_CODES;
+
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    candidates[i] = all_codes[i];
+    candidate_codes[i] = i;
+  }
+  for (size_t i = 0; i < history_length; i++) {
+    black_peg_score_batch(black_peg_pack(history[i].guess), candidates, number_of_candidates, placements);
+    size_t kept = 0;
+    for (size_t j = 0; j < number_of_candidates; j++) {
+      if (placements[j] == history[i].feedback.number_of_correct_value_and_placement) {
+        candidates[kept] = candidates[j];
+        candidate_codes[kept++] = candidate_codes[j];
+      }
+    }
+    number_of_candidates = kept;
+  }
+
+  solver_hint_t hint = {
+    .best_guess = number_of_candidates > 0 ? candidate_codes[0] : 0,
+    .remaining_candidates = (uint16_t) number_of_candidates
+  };
+  if (number_of_candidates <= 2) {
+    return hint;
+  }
+
+  for (size_t i = 0; i < number_of_candidates; i++) {
+    is_candidate[candidate_codes[i]] = true;
+  }
+  size_t best_worst_case = SIZE_MAX;
+  bool best_is_candidate = false;
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    uint16_t partition_sizes[NUMBER_OF_VALUES_TO_GUESS + 1] = {0};
+    black_peg_score_batch(all_codes[i], candidates, number_of_candidates, placements);
+    size_t worst_case = 0;
+    for (size_t j = 0; j < number_of_candidates; j++) {
+      if (++partition_sizes[placements[j]] > worst_case) {
+        worst_case = partition_sizes[placements[j]];
+      }
+    }
+    if (worst_case < best_worst_case || (worst_case == best_worst_case && is_candidate[i] && !best_is_candidate)) {
+      hint.best_guess = i;
+      best_worst_case = worst_case;
+      best_is_candidate = is_candidate[i];
+    }
+  }
+  return hint;
+}
\ No newline at end of file
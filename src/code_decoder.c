@@ -0,0 +1,119 @@
+#include "code_decoder.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+
+bool code_decoder_init(code_decoder_t *decoder, const char *alphabet, uint8_t number_of_pegs) {
+  size_t number_of_values = strlen(alphabet);
+  if (number_of_values < 2 || number_of_values > CODE_DECODER_MAXIMUM_VALUES || number_of_pegs == 0 ||
+      number_of_pegs > CODE_DECODER_MAXIMUM_PEGS) {
+    return false;
+  }
+  memset(decoder->values, CODE_DECODER_INVALID, sizeof(decoder->values));
+  decoder->is_contiguous = true;
+  for (size_t i = 0; i < number_of_values; i++) {
+    uint8_t character = (uint8_t) alphabet[i];
+    if (decoder->values[character] != CODE_DECODER_INVALID || character == '\n' || character == '\r') {
+      return false;
+    }
+    decoder->values[character] = (uint8_t) i;
+    decoder->is_contiguous = decoder->is_contiguous && character == (uint8_t) alphabet[0] + i;
+  }
+  for (size_t i = 0; i < number_of_values; i++) {
+    uint8_t lower = (uint8_t) tolower((uint8_t) alphabet[i]);
+    if (decoder->values[lower] == CODE_DECODER_INVALID) {
+      decoder->values[lower] = (uint8_t) i;
+    }
+  }
+  memcpy(decoder->alphabet, alphabet, number_of_values + 1);
+  decoder->number_of_pegs = number_of_pegs;
+  decoder->number_of_values = (uint8_t) number_of_values;
+  return true;
+}
+
+static bool is_end_of_line(char character) {
+  return character == '\0' || character == '\n' || character == '\r';
+}
+
+code_decoder_status_t code_decoder_decode(const code_decoder_t *decoder, const char *line, uint8_t values[],
+                                          uint64_t *code, code_decoder_error_t *error) {
+  uint64_t packed = 0;
+  for (size_t i = 0; i < decoder->number_of_pegs; i++) {
+    uint8_t value = decoder->values[(uint8_t) line[i]];
+    // the end of the line is not in the table either, so a short line stops here before reading past it
+    if (value == CODE_DECODER_INVALID) {
+      error->status = is_end_of_line(line[i]) ? CODE_DECODER_TOO_SHORT : CODE_DECODER_INVALID_CHARACTER;
+      error->position = i;
+      return error->status;
+    }
+    values[i] = value;
+    packed = packed * decoder->number_of_values + value;
+  }
+  if (!is_end_of_line(line[decoder->number_of_pegs])) {
+    error->status = CODE_DECODER_TOO_LONG;
+    error->position = decoder->number_of_pegs;
+    return error->status;
+  }
+  if (code != NULL) {
+    *code = packed;
+  }
+  error->status = CODE_DECODER_OK;
+  error->position = 0;
+  return CODE_DECODER_OK;
+}
+
+// no early exit and no error to fill in, so the loop carries no branches that depend on the text and the
+// lookups of neighbouring guesses overlap
+void code_decoder_decode_batch(const code_decoder_t *decoder, const char *text, size_t stride,
+                               size_t number_of_codes, uint64_t codes[], uint8_t is_valid[]) {
+  const uint8_t *bytes = (const uint8_t *) text;
+  const uint8_t number_of_values = decoder->number_of_values;
+  for (size_t i = 0; i < number_of_codes; i++) {
+    const uint8_t *guess = bytes + i * stride;
+    uint64_t packed = 0;
+    uint8_t invalid = 0;
+    for (size_t peg = 0; peg < decoder->number_of_pegs; peg++) {
+      uint8_t value = decoder->values[guess[peg]];
+      invalid |= (uint8_t)(value == CODE_DECODER_INVALID);
+      packed = packed * number_of_values + value;
+    }
+    codes[i] = invalid ? 0 : packed;
+    is_valid[i] = (uint8_t) !invalid;
+  }
+}
+
+static void describe_alphabet(const code_decoder_t *decoder, char *text, size_t size) {
+  if (decoder->is_contiguous) {
+    snprintf(text, size, "%c-%c", decoder->alphabet[0], decoder->alphabet[decoder->number_of_values - 1]);
+  } else {
+    snprintf(text, size, "%s", decoder->alphabet);
+  }
+}
+
+void code_decoder_describe_error(const code_decoder_t *decoder, const char *line, const code_decoder_error_t *error,
+                                 char *message, size_t size) {
+  char alphabet[CODE_DECODER_MAXIMUM_VALUES + 1];
+  describe_alphabet(decoder, alphabet, sizeof(alphabet));
+  uint8_t character = (uint8_t) line[error->position];
+  switch (error->status) {
+  case CODE_DECODER_OK:
+    snprintf(message, size, "No error");
+    break;
+  case CODE_DECODER_TOO_SHORT:
+    snprintf(message, size, "Only %zu of %d values, enter %d values ranging from %s", error->position,
+             decoder->number_of_pegs, decoder->number_of_pegs, alphabet);
+    break;
+  case CODE_DECODER_TOO_LONG:
+    snprintf(message, size, "More than %d values, enter %d values ranging from %s", decoder->number_of_pegs,
+             decoder->number_of_pegs, alphabet);
+    break;
+  case CODE_DECODER_INVALID_CHARACTER:
+    if (isprint(character)) {
+      snprintf(message, size, "'%c' at position %zu is not one of %s", character, error->position + 1, alphabet);
+    } else {
+      snprintf(message, size, "Character 0x%02X at position %zu is not one of %s", character, error->position + 1,
+               alphabet);
+    }
+    break;
+  }
+}
\ No newline at end of file
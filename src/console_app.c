@@ -4,75 +4,407 @@
 #include <stdint.h>
 #include <time.h>
 #include "game_logic.h"
+#include "hint_cache.h"
+#include "console_app.h"
+#include "liar.h"
+#include "multi_board.h"
+#include "large_space.h"
+#include "word_list.h"
+#include "code_decoder.h"
 
 #define MAXIMUM_NUMBER_OF_TRIES 8
+#define HINT_CACHE_MEMORY_BUDGET (256 * 1024)
+#define HINT_REQUEST '?'
+#define BOARDS_PER_LINE 8
+#define LARGE_SPACE_SAMPLE_SIZE 256
+#define LARGE_SPACE_MAXIMUM_NUMBER_OF_TRIES 16
+#define WORD_MAXIMUM_NUMBER_OF_TRIES 6
+#define CLASSIC_ALPHABET "ABCDEF"
+#define LARGE_SPACE_ALPHABET "ABCDEFGHIJKLMNOP"
+// roomy enough that a mistyped guess is reported as too long rather than split across lines
+#define LINE_BUFFER_SIZE 64
+#define MESSAGE_SIZE 128
 
-static const struct {
-  char character;
-  game_logic_values_t game_input_value;
-} conversion_table[] = {
-  {'A', GAME_VALUE_ONE},
-  {'B', GAME_VALUE_TWO},
-  {'C', GAME_VALUE_THREE},
-  {'D', GAME_VALUE_FOUR},
-  {'E', GAME_VALUE_FIVE},
-  {'F', GAME_VALUE_SIX},
-};
-
-static void convert_string_input_to_game_input(const char *char_buffer, game_logic_values_t *game_buffer) {
+// the rest of a line too long for the buffer is dropped so it is not read as the next guess
+static bool read_line(char *line, size_t size) {
+  if (fgets(line, (int) size, stdin) == NULL) {
+    return false;
+  }
+  size_t length = strlen(line);
+  if (length == size - 1 && line[length - 1] != '\n') {
+    int character;
+    do {
+      character = getchar();
+    } while (character != '\n' && character != EOF);
+  }
+  return true;
+}
+
+// false after telling the player what is wrong with the guess
+static bool decode_guess(const code_decoder_t *decoder, const char *line, uint8_t values[], uint64_t *code) {
+  code_decoder_error_t error;
+  if (code_decoder_decode(decoder, line, values, code, &error) == CODE_DECODER_OK) {
+    return true;
+  }
+  char message[MESSAGE_SIZE];
+  code_decoder_describe_error(decoder, line, &error, message, sizeof(message));
+  printf("%s\n", message);
+  return false;
+}
+
+static bool decode_classic_guess(const code_decoder_t *decoder, const char *line, game_logic_values_t game_buffer[]) {
+  uint8_t values[NUMBER_OF_VALUES_TO_GUESS];
+  uint64_t code;
+  if (!decode_guess(decoder, line, values, &code)) {
+    return false;
+  }
+  game_logic_unpack_code((game_logic_code_t) code, game_buffer);
+  return true;
+}
+
+static void print_feedback(game_logic_feedback_t feedback) {
+  for (uint_fast8_t i = 0; i < feedback.number_of_correct_value_only; i++) {
+    printf("-");
+  }
+
+  for (uint_fast8_t i = 0; i < feedback.number_of_correct_value_and_placement; i++) {
+    printf("+");
+  }
+}
+
+static void print_values(const game_logic_values_t values[]) {
   for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
-    for (uint_fast8_t j = 0; j < GAME_VALUE_MAX; j++) {
-      if (conversion_table[j].character == char_buffer[i]) {
-        game_buffer[i] = conversion_table[j].game_input_value;
-        break;
-      }
-    }
+    printf("%c", CLASSIC_ALPHABET[values[i]]);
   }
 }
 
-int console_main(void) {
+int console_main(game_mode_t mode, bool is_hard_mode) {
+  const game_mode_codemaker_t *codemaker = game_mode_get_codemaker(mode);
   srand(time(NULL));
-  game_logic_generate_random_answer();
+  codemaker->start();
+  // only the consistent set is used, the codemaker keeps its own answer
+  game_logic_context_t hard_mode_context;
+  game_logic_context_start(&hard_mode_context, is_hard_mode);
   game_logic_feedback_t feedback = {0};
   uint8_t tries = 0;
+  game_logic_move_t history[MAXIMUM_NUMBER_OF_TRIES];
+  hint_cache_t *hint_cache = hint_cache_create(HINT_CACHE_MEMORY_BUDGET);
+  code_decoder_t decoder;
+  code_decoder_init(&decoder, CLASSIC_ALPHABET, NUMBER_OF_VALUES_TO_GUESS);
 
+  if (mode == GAME_MODE_EVIL) {
+    printf("Beware! The codemaker picks the answer as you go and will dodge your guesses\n");
+  }
   printf("Start guessing?\n");
   printf("Enter 4 values ranging from A-F?\n");
-  printf("NOTE: The value can contain duplicates E.g. AAFB\n");
+  if (mode == GAME_MODE_NO_DUPLICATES) {
+    printf("NOTE: The answer never repeats a value E.g. AEFB\n");
+  } else {
+    printf("NOTE: The value can contain duplicates E.g. AAFB\n");
+  }
+  if (mode == GAME_MODE_LIAR) {
+    printf("Careful! The codemaker may lie about %d of your guesses\n", LIAR_MAXIMUM_LIES);
+  }
+  if (is_hard_mode) {
+    printf("Hard mode! Every guess has to agree with all the feedback so far\n");
+  }
+  if (mode == GAME_MODE_BLACK_PEG) {
+    printf("Only correct values in the correct placement are reported\n");
+  }
   printf("For ever correct value a - will appear\n");
-  printf("For ever correct value and correct placement in the order a + will appear\n\n");
+  printf("For ever correct value and correct placement in the order a + will appear\n");
+  printf("Enter %c for a hint\n\n", HINT_REQUEST);
   
   while (!feedback.is_guess_correct) {
     if (tries == MAXIMUM_NUMBER_OF_TRIES) {
       printf("Oh No! You Failed To Guess The Correct Answer In 8 Goes!\n");
-      game_logic_values_t* ans = game_logic_get_answer();
-      printf("The correct answer is: %c%c%c%c\n", conversion_table[ans[0]].character,
-        conversion_table[ans[1]].character, conversion_table[ans[2]].character, conversion_table[ans[3]].character);
+      game_logic_values_t* ans = codemaker->get_answer();
+      printf("The correct answer is: ");
+      print_values(ans);
+      printf("\n");
       printf("Still Have A Nice Day!\n");
+      hint_cache_destroy(hint_cache);
       return EXIT_SUCCESS;
     }
 
     printf("> ");
-    char char_buffer[NUMBER_OF_VALUES_TO_GUESS + 2];  // +2 for null terminator and newline
-    fgets(char_buffer, sizeof(char_buffer), stdin);
+    char char_buffer[LINE_BUFFER_SIZE];
+    if (!read_line(char_buffer, sizeof(char_buffer))) {
+      hint_cache_destroy(hint_cache);
+      return EXIT_FAILURE;
+    }
+    if (char_buffer[0] == HINT_REQUEST) {
+      // without the cache, because it did not fit in memory, hints are worked out from scratch
+      solver_hint_t hint = codemaker->get_hint != NULL ? codemaker->get_hint(history, tries) :
+                           hint_cache != NULL ? hint_cache_get_hint(hint_cache, history, tries) :
+                                                solver_get_hint(history, tries);
+      game_logic_values_t hint_values[NUMBER_OF_VALUES_TO_GUESS];
+      game_logic_unpack_code(hint.best_guess, hint_values);
+      if (is_hard_mode && !game_logic_context_is_consistent(&hard_mode_context, hint_values)) {
+        // the minimax guess may be a probe that hard mode would refuse, fall back to a possible answer
+        game_logic_code_t candidates[NUMBER_OF_POSSIBLE_CODES];
+        if (solver_filter_candidates(history, tries, candidates) > 0) {
+          game_logic_unpack_code(candidates[0], hint_values);
+        }
+      }
+      printf("Try ");
+      print_values(hint_values);
+      printf(", %d possible answers remain\n", hint.remaining_candidates);
+      continue;
+    }
+
+    game_logic_values_t game_buffer[NUMBER_OF_VALUES_TO_GUESS];
+    if (!decode_classic_guess(&decoder, char_buffer, game_buffer)) {
+      continue;
+    }
+    if (is_hard_mode && !game_logic_context_is_consistent(&hard_mode_context, game_buffer)) {
+      size_t move = game_logic_find_contradicted_move(history, tries, game_buffer);
+      if (move < tries) {
+        printf("Not allowed in hard mode, ");
+        print_values(game_buffer);
+        printf(" cannot be the answer: guess %zu ", move + 1);
+        print_values(history[move].guess);
+        printf(" got [");
+        print_feedback(history[move].feedback);
+        printf("] but would have got [");
+        print_feedback(game_logic_score(game_buffer, history[move].guess));
+        printf("]\n");
+      }
+      continue;
+    }
+
+    feedback = codemaker->get_feedback(game_buffer);
+    game_logic_context_record_move(&hard_mode_context, game_buffer, feedback);
+    memcpy(history[tries].guess, game_buffer, sizeof(game_buffer));
+    history[tries].feedback = feedback;
     tries++;
+    print_feedback(feedback);
+    printf("\n");
+  }
+
+  printf("Well Done! You Guessed it %d tries!\n", tries);
+  printf("Have A Nice Day!\n");
+  hint_cache_destroy(hint_cache);
+  return EXIT_SUCCESS;
+}
+
+static void print_code(game_logic_code_t code) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_unpack_code(code, values);
+  print_values(values);
+}
+
+int console_multi_board_main(size_t number_of_boards) {
+  srand(time(NULL));
+  multi_board_game_t game;
+  multi_board_start(&game, number_of_boards);
+  multi_board_solver_t *solver = malloc(sizeof(multi_board_solver_t));
+  if (solver != NULL) {
+    multi_board_solver_init(solver, game.number_of_boards);
+  }
+  size_t maximum_number_of_tries = multi_board_get_maximum_number_of_tries(&game);
+  size_t tries = 0;
+  code_decoder_t decoder;
+  code_decoder_init(&decoder, CLASSIC_ALPHABET, NUMBER_OF_VALUES_TO_GUESS);
+
+  printf("Start guessing?\n");
+  printf("Every guess is scored against %zu boards, solve them all in %zu goes\n", game.number_of_boards, maximum_number_of_tries);
+  printf("Enter 4 values ranging from A-F?\n");
+  printf("For ever correct value a - will appear\n");
+  printf("For ever correct value and correct placement in the order a + will appear\n");
+  printf("Enter %c for a hint\n\n", HINT_REQUEST);
+
+  while (!multi_board_is_solved(&game)) {
+    if (tries == maximum_number_of_tries) {
+      printf("Oh No! You Failed To Solve Every Board In %zu Goes!\n", maximum_number_of_tries);
+      printf("The correct answers are:");
+      for (size_t board = 0; board < game.number_of_boards; board++) {
+        printf(" ");
+        print_code(game.answers[board]);
+      }
+      printf("\nStill Have A Nice Day!\n");
+      free(solver);
+      return EXIT_SUCCESS;
+    }
+
+    printf("> ");
+    char char_buffer[LINE_BUFFER_SIZE];
+    if (!read_line(char_buffer, sizeof(char_buffer))) {
+      free(solver);
+      return EXIT_FAILURE;
+    }
+    if (char_buffer[0] == HINT_REQUEST && solver != NULL) {
+      printf("Try ");
+      print_code(multi_board_solver_best_guess(solver));
+      printf("\n");
+      continue;
+    }
 
     game_logic_values_t game_buffer[NUMBER_OF_VALUES_TO_GUESS];
-    convert_string_input_to_game_input(char_buffer, game_buffer);
+    if (!decode_classic_guess(&decoder, char_buffer, game_buffer)) {
+      continue;
+    }
+    uint32_t previously_solved = game.solved_boards;
+    game_logic_feedback_t feedback[MULTI_BOARD_MAXIMUM_BOARDS];
+    multi_board_get_feedback(&game, game_buffer, feedback);
+    if (solver != NULL) {
+      multi_board_solver_update(solver, game_buffer, feedback);
+    }
+    tries++;
+
+    for (size_t board = 0; board < game.number_of_boards; board++) {
+      if ((previously_solved >> board) & 1u) {
+        printf("[done]");
+      } else {
+        char pegs[NUMBER_OF_VALUES_TO_GUESS + 1] = "    ";
+        uint_fast8_t peg = 0;
+        for (uint_fast8_t i = 0; i < feedback[board].number_of_correct_value_only; i++) {
+          pegs[peg++] = '-';
+        }
+        for (uint_fast8_t i = 0; i < feedback[board].number_of_correct_value_and_placement; i++) {
+          pegs[peg++] = '+';
+        }
+        printf("[%s]", pegs);
+      }
+      printf((board + 1) % BOARDS_PER_LINE == 0 || board + 1 == game.number_of_boards ? "\n" : " ");
+    }
+  }
+
+  printf("Well Done! You Solved Every Board In %zu tries!\n", tries);
+  printf("Have A Nice Day!\n");
+  free(solver);
+  return EXIT_SUCCESS;
+}
+
+static void print_large_space_code(const large_space_variant_t *variant, const large_space_code_t *code) {
+  for (uint_fast8_t i = 0; i < variant->number_of_pegs; i++) {
+    printf("%c", LARGE_SPACE_ALPHABET[code->values[i]]);
+  }
+}
+
+int console_large_space_main(uint8_t number_of_pegs, uint8_t number_of_values) {
+  if (number_of_pegs == 0 || number_of_pegs > LARGE_SPACE_MAXIMUM_PEGS ||
+      number_of_values < 2 || number_of_values > LARGE_SPACE_MAXIMUM_VALUES) {
+    printf("Games can have 1-%d values to guess, each one of 2-%d values\n", LARGE_SPACE_MAXIMUM_PEGS, LARGE_SPACE_MAXIMUM_VALUES);
+    return EXIT_FAILURE;
+  }
+  srand(time(NULL));
+  large_space_variant_t variant = {.number_of_pegs = number_of_pegs, .number_of_values = number_of_values};
+  large_space_code_t answer;
+  large_space_random_code(&variant, &answer);
+  large_space_move_t history[LARGE_SPACE_MAXIMUM_NUMBER_OF_TRIES];
+  game_logic_feedback_t feedback = {0};
+  uint8_t tries = 0;
+  // the first number_of_values letters of the alphabet
+  char alphabet[LARGE_SPACE_MAXIMUM_VALUES + 1];
+  snprintf(alphabet, sizeof(alphabet), "%.*s", number_of_values, LARGE_SPACE_ALPHABET);
+  code_decoder_t decoder;
+  code_decoder_init(&decoder, alphabet, number_of_pegs);
+
+  printf("Start guessing?\n");
+  printf("Enter %d values ranging from A-%c?\n", number_of_pegs, 'A' + number_of_values - 1);
+  printf("For ever correct value a - will appear\n");
+  printf("For ever correct value and correct placement in the order a + will appear\n");
+  printf("Enter %c for a hint\n\n", HINT_REQUEST);
+
+  while (!feedback.is_guess_correct) {
+    if (tries == LARGE_SPACE_MAXIMUM_NUMBER_OF_TRIES) {
+      printf("Oh No! You Failed To Guess The Correct Answer In %d Goes!\n", LARGE_SPACE_MAXIMUM_NUMBER_OF_TRIES);
+      printf("The correct answer is: ");
+      print_large_space_code(&variant, &answer);
+      printf("\nStill Have A Nice Day!\n");
+      return EXIT_SUCCESS;
+    }
+
+    printf("> ");
+    char char_buffer[LINE_BUFFER_SIZE];
+    if (!read_line(char_buffer, sizeof(char_buffer))) {
+      return EXIT_FAILURE;
+    }
+    if (char_buffer[0] == HINT_REQUEST) {
+      large_space_code_t hint;
+      if (large_space_best_guess(&variant, history, tries, LARGE_SPACE_SAMPLE_SIZE, &hint)) {
+        printf("Try ");
+        print_large_space_code(&variant, &hint);
+        printf("\n");
+      }
+      continue;
+    }
+
+    large_space_move_t *move = &history[tries];
+    if (!decode_guess(&decoder, char_buffer, move->guess.values, NULL)) {
+      continue;
+    }
+    feedback = move->feedback = large_space_score(&variant, &answer, &move->guess);
+    tries++;
 
-    feedback = game_logic_get_feedback(game_buffer);
     for (uint_fast8_t i = 0; i < feedback.number_of_correct_value_only; i++) {
       printf("-");
     }
-
     for (uint_fast8_t i = 0; i < feedback.number_of_correct_value_and_placement; i++) {
       printf("+");
     }
+    printf("\n");
+  }
+
+  printf("Well Done! You Guessed it %d tries!\n", tries);
+  printf("Have A Nice Day!\n");
+  return EXIT_SUCCESS;
+}
+
+int console_word_main(const char *index_path) {
+  word_list_t list;
+  if (!word_list_open(&list, index_path)) {
+    printf("Could not open word index %s\n", index_path);
+    return EXIT_FAILURE;
+  }
+  srand(time(NULL));
+  const uint8_t word_length = word_list_get_word_length(&list);
+  const uint64_t answer = word_list_get_word(&list, (size_t) rand() % word_list_get_size(&list));
+  char word[WORD_LIST_MAXIMUM_WORD_LENGTH + 1];
+  game_logic_feedback_t feedback = {0};
+  uint8_t tries = 0;
+
+  printf("Start guessing?\n");
+  printf("Enter a %d letter word from the %zu word dictionary\n", word_length, word_list_get_size(&list));
+  printf("For ever correct letter a - will appear\n");
+  printf("For ever correct letter and correct placement in the order a + will appear\n\n");
+
+  while (!feedback.is_guess_correct) {
+    if (tries == WORD_MAXIMUM_NUMBER_OF_TRIES) {
+      word_list_unpack(word_length, answer, word);
+      printf("Oh No! You Failed To Guess The Correct Answer In %d Goes!\n", WORD_MAXIMUM_NUMBER_OF_TRIES);
+      printf("The correct answer is: %s\n", word);
+      printf("Still Have A Nice Day!\n");
+      word_list_close(&list);
+      return EXIT_SUCCESS;
+    }
 
+    printf("> ");
+    char char_buffer[WORD_LIST_MAXIMUM_WORD_LENGTH + 2];  // +2 for null terminator and newline
+    if (fgets(char_buffer, sizeof(char_buffer), stdin) == NULL) {
+      word_list_close(&list);
+      return EXIT_FAILURE;
+    }
+    uint64_t guess;
+    if (!word_list_pack(word_length, char_buffer, &guess) || !word_list_contains(&list, guess)) {
+      printf("Not a word in the dictionary\n");
+      continue;
+    }
+    feedback = word_list_score(word_length, answer, guess);
+    tries++;
+
+    for (uint_fast8_t i = 0; i < feedback.number_of_correct_value_only; i++) {
+      printf("-");
+    }
+    for (uint_fast8_t i = 0; i < feedback.number_of_correct_value_and_placement; i++) {
+      printf("+");
+    }
     printf("\n");
   }
 
   printf("Well Done! You Guessed it %d tries!\n", tries);
   printf("Have A Nice Day!\n");
+  word_list_close(&list);
   return EXIT_SUCCESS;
 }
\ No newline at end of file
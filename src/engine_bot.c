@@ -0,0 +1,182 @@
+#define _POSIX_C_SOURCE 200809L
+#include "engine_bot.h"
+#include "solver.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LARGE_SPACE_SAMPLE_SIZE 256
+#define INPUT_SIZE (64 * 1024)
+
+struct engine_bot {
+  code_decoder_t decoder;
+  bool has_game;
+  large_space_variant_t variant;
+  bool is_hard_mode;
+  large_space_move_t history[LARGE_SPACE_MAXIMUM_HISTORY];
+  size_t number_of_moves;
+  large_space_code_t guess;
+  bool is_guess_pending;
+  bool is_finished;
+};
+
+engine_bot_t* engine_bot_create(void) {
+  return calloc(1, sizeof(engine_bot_t));
+}
+
+void engine_bot_destroy(engine_bot_t *bot) {
+  free(bot);
+}
+
+static bool is_standard_game(const large_space_variant_t *variant) {
+  return variant->number_of_pegs == NUMBER_OF_VALUES_TO_GUESS && variant->number_of_values == GAME_VALUE_MAX;
+}
+
+// the standard game is small enough for the exact solver, returns how many answers remain
+static size_t choose_standard_guess(engine_bot_t *bot) {
+  game_logic_move_t history[LARGE_SPACE_MAXIMUM_HISTORY];
+  for (size_t i = 0; i < bot->number_of_moves; i++) {
+    for (uint_fast8_t peg = 0; peg < NUMBER_OF_VALUES_TO_GUESS; peg++) {
+      history[i].guess[peg] = (game_logic_values_t) bot->history[i].guess.values[peg];
+    }
+    history[i].feedback = bot->history[i].feedback;
+  }
+  game_logic_code_t candidates[NUMBER_OF_POSSIBLE_CODES];
+  size_t number_of_candidates = solver_filter_candidates(history, bot->number_of_moves, candidates);
+  game_logic_code_t best = 0;
+  if (number_of_candidates > 0) {
+    // the minimax guess may be a probe that hard mode would refuse, fall back to a possible answer
+    best = bot->is_hard_mode ? candidates[0] : solver_best_guess(candidates, number_of_candidates);
+  }
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_unpack_code(best, values);
+  memset(&bot->guess, 0, sizeof(bot->guess));
+  for (uint_fast8_t peg = 0; peg < NUMBER_OF_VALUES_TO_GUESS; peg++) {
+    bot->guess.values[peg] = (uint8_t) values[peg];
+  }
+  return number_of_candidates;
+}
+
+static size_t reply_to_go(engine_bot_t *bot, char *reply) {
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  size_t number_of_candidates = 0;
+  if (is_standard_game(&bot->variant)) {
+    number_of_candidates = choose_standard_guess(bot);
+  } else if (!large_space_best_guess(&bot->variant, bot->history, bot->number_of_moves, LARGE_SPACE_SAMPLE_SIZE,
+                                     &bot->guess)) {
+    // nothing agrees with the feedback, any code will do
+    memset(&bot->guess, 0, sizeof(bot->guess));
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  long milliseconds = (long)(end.tv_sec - start.tv_sec) * 1000 + (end.tv_nsec - start.tv_nsec) / 1000000;
+  int length = is_standard_game(&bot->variant) ?
+               snprintf(reply, ENGINE_BOT_MAXIMUM_REPLY, "info candidates %zu time %ld\nguess ",
+                        number_of_candidates, milliseconds) :
+               snprintf(reply, ENGINE_BOT_MAXIMUM_REPLY, "info time %ld\nguess ", milliseconds);
+  size_t used = (size_t) length;
+  used += engine_protocol_format_code(&bot->variant, &bot->guess, reply + used);
+  reply[used++] = '\n';
+  bot->is_guess_pending = true;
+  return used;
+}
+
+size_t engine_bot_handle_line(engine_bot_t *bot, const char *line, size_t length, char *reply) {
+  engine_protocol_message_t message;
+  switch (engine_protocol_parse(line, length, bot->has_game ? &bot->decoder : NULL, &message)) {
+  case ENGINE_PROTOCOL_MMP:
+    return (size_t) snprintf(reply, ENGINE_BOT_MAXIMUM_REPLY, "id name %s\nid author %s\nmmpok\n",
+                             ENGINE_BOT_NAME, ENGINE_BOT_AUTHOR);
+  case ENGINE_PROTOCOL_ISREADY:
+    return (size_t) snprintf(reply, ENGINE_BOT_MAXIMUM_REPLY, "readyok\n");
+  case ENGINE_PROTOCOL_NEWGAME:
+    bot->has_game = engine_protocol_init_decoder(&bot->decoder, &message.variant);
+    bot->variant = message.variant;
+    bot->is_hard_mode = message.is_hard_mode;
+    bot->number_of_moves = 0;
+    bot->is_guess_pending = false;
+    return 0;
+  case ENGINE_PROTOCOL_GO:
+    return bot->has_game ? reply_to_go(bot, reply) : 0;
+  case ENGINE_PROTOCOL_FEEDBACK:
+    if (bot->is_guess_pending && bot->number_of_moves < LARGE_SPACE_MAXIMUM_HISTORY) {
+      bot->history[bot->number_of_moves].guess = bot->guess;
+      bot->history[bot->number_of_moves].feedback = message.feedback;
+      bot->number_of_moves++;
+    }
+    bot->is_guess_pending = false;
+    return 0;
+  case ENGINE_PROTOCOL_RESULT:
+    bot->number_of_moves = 0;
+    bot->is_guess_pending = false;
+    return 0;
+  case ENGINE_PROTOCOL_QUIT:
+    bot->is_finished = true;
+    return 0;
+  default:
+    return 0;
+  }
+}
+
+bool engine_bot_is_finished(const engine_bot_t *bot) {
+  return bot->is_finished;
+}
+
+static bool write_all(int fd, const char *data, size_t length) {
+  while (length > 0) {
+    ssize_t written = write(fd, data, length);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    data += written;
+    length -= (size_t) written;
+  }
+  return true;
+}
+
+int engine_bot_main(void) {
+  engine_bot_t *bot = engine_bot_create();
+  char *input = malloc(INPUT_SIZE);
+  if (bot == NULL || input == NULL) {
+    engine_bot_destroy(bot);
+    free(input);
+    return EXIT_FAILURE;
+  }
+  // the score table is built before the first clock starts
+  game_logic_score_row(0);
+  size_t buffered = 0;
+  bool is_open = true;
+  while (is_open && !engine_bot_is_finished(bot)) {
+    ssize_t got = read(STDIN_FILENO, input + buffered, INPUT_SIZE - buffered);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got <= 0) {
+      break;
+    }
+    buffered += (size_t) got;
+    size_t used = 0;
+    char *newline;
+    while (!engine_bot_is_finished(bot) && (newline = memchr(input + used, '\n', buffered - used)) != NULL) {
+      char reply[ENGINE_BOT_MAXIMUM_REPLY];
+      size_t reply_length = engine_bot_handle_line(bot, input + used, (size_t)(newline - (input + used)), reply);
+      is_open = is_open && write_all(STDOUT_FILENO, reply, reply_length);
+      used = (size_t)(newline - input) + 1;
+    }
+    // a line longer than the buffer is cut short
+    if (used == 0 && buffered == INPUT_SIZE) {
+      used = buffered;
+    }
+    memmove(input, input + used, buffered - used);
+    buffered -= used;
+  }
+  engine_bot_destroy(bot);
+  free(input);
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,526 @@
+#define _GNU_SOURCE
+#include "engine_host.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#define INPUT_SIZE (4 * ENGINE_PROTOCOL_MAXIMUM_LINE)
+// far more than the few lines queued between two reads, a bot that lets it fill up has stopped reading
+#define OUTPUT_SIZE 4096
+#define LINE_SIZE 128
+#define NANOSECONDS_PER_MILLISECOND UINT64_C(1000000)
+#define NO_DEADLINE UINT64_MAX
+
+typedef enum {
+  // waiting for mmpok
+  BOT_STARTING,
+  // waiting for readyok after a timeout, the late guess may still come before it
+  BOT_SYNCING,
+  BOT_THINKING,
+  // quit was sent or the bot was dropped
+  BOT_FINISHED
+} bot_state_t;
+
+typedef struct {
+  pid_t pid;
+  int to_bot;
+  int from_bot;
+  bot_state_t state;
+  char input[INPUT_SIZE];
+  size_t input_length;
+  // the rest of a line that was cut short is skipped
+  bool is_skipping_line;
+  char output[OUTPUT_SIZE];
+  size_t output_start;
+  size_t output_length;
+  uint64_t deadline;
+  uint64_t go_time;
+  // what is left of the game's clock, in nanoseconds
+  uint64_t clock_left;
+  large_space_code_t secret;
+  large_space_move_t history[LARGE_SPACE_MAXIMUM_HISTORY];
+  size_t number_of_moves;
+  engine_host_result_t *result;
+} bot_t;
+
+typedef struct {
+  const engine_host_options_t *options;
+  code_decoder_t decoder;
+  engine_host_stats_t *stats;
+} host_t;
+
+static uint64_t now_nanoseconds(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+static uint64_t mix(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xBF58476D1CE4E5B9ull;
+  value ^= value >> 27;
+  value *= 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+// the same game number gets the same secret for every bot
+static void draw_secret(const engine_host_options_t *options, uint32_t game, large_space_code_t *secret) {
+  uint64_t draw = mix(options->seed ^ mix(UINT64_C(0x9E3779B97F4A7C15) * (game + 1)));
+  memset(secret, 0, sizeof(*secret));
+  // the variant was checked before play, the second bound spells that out for the compiler
+  for (uint_fast8_t i = 0; i < options->variant.number_of_pegs && i < LARGE_SPACE_MAXIMUM_PEGS; i++) {
+    secret->values[i] = (uint8_t)(draw % options->variant.number_of_values);
+    draw /= options->variant.number_of_values;
+  }
+}
+
+static bool spawn(bot_t *bot, const char *command) {
+  int to_bot[2];
+  int from_bot[2];
+  if (pipe2(to_bot, O_CLOEXEC) != 0) {
+    return false;
+  }
+  if (pipe2(from_bot, O_CLOEXEC) != 0) {
+    close(to_bot[0]);
+    close(to_bot[1]);
+    return false;
+  }
+  pid_t pid = fork();
+  if (pid == 0) {
+    // the host ignores SIGPIPE and an ignored signal stays ignored across exec
+    signal(SIGPIPE, SIG_DFL);
+    dup2(to_bot[0], STDIN_FILENO);
+    dup2(from_bot[1], STDOUT_FILENO);
+    execl("/bin/sh", "sh", "-c", command, (char *) NULL);
+    _exit(127);
+  }
+  close(to_bot[0]);
+  close(from_bot[1]);
+  if (pid < 0) {
+    close(to_bot[1]);
+    close(from_bot[0]);
+    return false;
+  }
+  fcntl(to_bot[1], F_SETFL, fcntl(to_bot[1], F_GETFL) | O_NONBLOCK);
+  fcntl(from_bot[0], F_SETFL, fcntl(from_bot[0], F_GETFL) | O_NONBLOCK);
+  bot->pid = pid;
+  bot->to_bot = to_bot[1];
+  bot->from_bot = from_bot[0];
+  return true;
+}
+
+static void finish(bot_t *bot, bool is_dropped) {
+  if (bot->to_bot >= 0) {
+    close(bot->to_bot);
+  }
+  if (bot->from_bot >= 0) {
+    close(bot->from_bot);
+  }
+  bot->to_bot = -1;
+  bot->from_bot = -1;
+  bot->state = BOT_FINISHED;
+  if (is_dropped) {
+    bot->result->is_dropped = true;
+    if (bot->pid > 0) {
+      kill(bot->pid, SIGKILL);
+    }
+  }
+}
+
+// false when the bot stopped reading or its pipe is closed
+static bool flush(bot_t *bot) {
+  while (bot->output_length > 0) {
+    ssize_t written = write(bot->to_bot, bot->output + bot->output_start, bot->output_length);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return true;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    bot->output_start += (size_t) written;
+    bot->output_length -= (size_t) written;
+  }
+  bot->output_start = 0;
+  return true;
+}
+
+static bool queue(bot_t *bot, const char *text, size_t length) {
+  if (bot->output_start + bot->output_length + length > OUTPUT_SIZE) {
+    memmove(bot->output, bot->output + bot->output_start, bot->output_length);
+    bot->output_start = 0;
+  }
+  if (bot->output_length + length > OUTPUT_SIZE) {
+    return false;
+  }
+  memcpy(bot->output + bot->output_start + bot->output_length, text, length);
+  bot->output_length += length;
+  return true;
+}
+
+// lines are written once per round of the poll loop, so the feedback and the next go share a write
+static void send_line(bot_t *bot, const char *text, size_t length) {
+  if (bot->state != BOT_FINISHED && !queue(bot, text, length)) {
+    finish(bot, true);
+  }
+}
+
+static void send_go(const host_t *host, bot_t *bot, uint64_t now) {
+  const engine_host_options_t *options = host->options;
+  char line[LINE_SIZE];
+  size_t length = (size_t) snprintf(line, sizeof(line), "go");
+  bot->deadline = NO_DEADLINE;
+  if (options->game_milliseconds > 0) {
+    length += (size_t) snprintf(line + length, sizeof(line) - length, " time %llu",
+                                (unsigned long long)(bot->clock_left / NANOSECONDS_PER_MILLISECOND));
+    bot->deadline = now + bot->clock_left;
+  }
+  if (options->move_milliseconds > 0) {
+    length += (size_t) snprintf(line + length, sizeof(line) - length, " movetime %u", options->move_milliseconds);
+    uint64_t move_deadline = now + options->move_milliseconds * NANOSECONDS_PER_MILLISECOND;
+    bot->deadline = move_deadline < bot->deadline ? move_deadline : bot->deadline;
+  }
+  line[length++] = '\n';
+  bot->state = BOT_THINKING;
+  bot->go_time = now;
+  send_line(bot, line, length);
+}
+
+static void start_game(const host_t *host, bot_t *bot, uint64_t now) {
+  const engine_host_options_t *options = host->options;
+  if (bot->result->games == options->number_of_games) {
+    send_line(bot, "quit\n", 5);
+    if (bot->state != BOT_FINISHED) {
+      flush(bot);
+      finish(bot, false);
+    }
+    return;
+  }
+  draw_secret(options, bot->result->games, &bot->secret);
+  bot->number_of_moves = 0;
+  bot->clock_left = (uint64_t) options->game_milliseconds * NANOSECONDS_PER_MILLISECOND;
+  char line[LINE_SIZE];
+  int length = snprintf(line, sizeof(line), "newgame pegs %d values %d tries %d%s\n",
+                        options->variant.number_of_pegs, options->variant.number_of_values,
+                        options->maximum_tries, options->is_hard_mode ? " hard" : "");
+  send_line(bot, line, (size_t) length);
+  send_go(host, bot, now);
+}
+
+static void end_game(const host_t *host, bot_t *bot, engine_protocol_outcome_t outcome, uint64_t now) {
+  engine_host_result_t *result = bot->result;
+  result->games++;
+  result->outcomes[outcome]++;
+  if (outcome == ENGINE_PROTOCOL_WIN) {
+    result->tries_to_win += bot->number_of_moves;
+  }
+  char line[LINE_SIZE];
+  size_t length = (size_t) snprintf(line, sizeof(line), "result %s ", engine_protocol_outcome_name(outcome));
+  length += engine_protocol_format_code(&host->options->variant, &bot->secret, line + length);
+  line[length++] = '\n';
+  send_line(bot, line, length);
+  if (outcome == ENGINE_PROTOCOL_TIMEOUT) {
+    // the bot may still be thinking, whatever it sends before readyok belongs to the lost game
+    bot->state = BOT_SYNCING;
+    bot->deadline = now + ENGINE_HOST_HANDSHAKE_MILLISECONDS * NANOSECONDS_PER_MILLISECOND;
+    send_line(bot, "isready\n", 8);
+  } else {
+    start_game(host, bot, now);
+  }
+}
+
+// the guess must agree with the feedback every earlier guess got had it been the secret
+static bool is_consistent(const large_space_variant_t *variant, const bot_t *bot, const large_space_code_t *guess) {
+  for (size_t i = 0; i < bot->number_of_moves; i++) {
+    game_logic_feedback_t feedback = large_space_score(variant, guess, &bot->history[i].guess);
+    if (feedback.number_of_correct_value_and_placement !=
+        bot->history[i].feedback.number_of_correct_value_and_placement ||
+        feedback.number_of_correct_value_only != bot->history[i].feedback.number_of_correct_value_only) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void handle_guess(const host_t *host, bot_t *bot, const engine_protocol_message_t *message, uint64_t now) {
+  const engine_host_options_t *options = host->options;
+  uint64_t elapsed = now - bot->go_time;
+  bot->result->think_nanoseconds += elapsed;
+  bot->result->moves++;
+  host->stats->moves++;
+  if (options->game_milliseconds > 0) {
+    if (elapsed >= bot->clock_left) {
+      end_game(host, bot, ENGINE_PROTOCOL_TIMEOUT, now);
+      return;
+    }
+    bot->clock_left -= elapsed;
+  }
+  if (message->type != ENGINE_PROTOCOL_GUESS ||
+      (options->is_hard_mode && !is_consistent(&options->variant, bot, &message->code))) {
+    end_game(host, bot, ENGINE_PROTOCOL_ILLEGAL, now);
+    return;
+  }
+  game_logic_feedback_t feedback = large_space_score(&options->variant, &bot->secret, &message->code);
+  bot->history[bot->number_of_moves].guess = message->code;
+  bot->history[bot->number_of_moves].feedback = feedback;
+  bot->number_of_moves++;
+  if (feedback.is_guess_correct) {
+    end_game(host, bot, ENGINE_PROTOCOL_WIN, now);
+  } else if (bot->number_of_moves == options->maximum_tries) {
+    end_game(host, bot, ENGINE_PROTOCOL_LOSS, now);
+  } else {
+    char line[LINE_SIZE];
+    int length = snprintf(line, sizeof(line), "feedback %d %d\n", feedback.number_of_correct_value_and_placement,
+                          feedback.number_of_correct_value_only);
+    send_line(bot, line, (size_t) length);
+    send_go(host, bot, now);
+  }
+}
+
+static void handle_line(const host_t *host, bot_t *bot, const char *line, size_t length, uint64_t now) {
+  engine_protocol_message_t message;
+  switch (engine_protocol_parse(line, length, &host->decoder, &message)) {
+  case ENGINE_PROTOCOL_ID:
+    if (message.text_length > 5 && memcmp(message.text, "name ", 5) == 0) {
+      size_t name_length = message.text_length - 5;
+      name_length = name_length < ENGINE_HOST_NAME_SIZE - 1 ? name_length : ENGINE_HOST_NAME_SIZE - 1;
+      memcpy(bot->result->name, message.text + 5, name_length);
+      bot->result->name[name_length] = '\0';
+    }
+    break;
+  case ENGINE_PROTOCOL_INFO:
+    bot->result->info_lines++;
+    break;
+  case ENGINE_PROTOCOL_MMPOK:
+    if (bot->state == BOT_STARTING) {
+      start_game(host, bot, now);
+    }
+    break;
+  case ENGINE_PROTOCOL_READYOK:
+    if (bot->state == BOT_SYNCING) {
+      start_game(host, bot, now);
+    }
+    break;
+  case ENGINE_PROTOCOL_GUESS:
+  case ENGINE_PROTOCOL_MALFORMED:
+    if (bot->state == BOT_THINKING) {
+      handle_guess(host, bot, &message, now);
+    }
+    break;
+  default:
+    break;
+  }
+}
+
+static void read_from_bot(const host_t *host, bot_t *bot, uint64_t now) {
+  ssize_t got = read(bot->from_bot, bot->input + bot->input_length, INPUT_SIZE - bot->input_length);
+  if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+    return;
+  }
+  if (got <= 0) {
+    finish(bot, true);
+    return;
+  }
+  bot->input_length += (size_t) got;
+  size_t used = 0;
+  char *newline;
+  while (bot->state != BOT_FINISHED &&
+         (newline = memchr(bot->input + used, '\n', bot->input_length - used)) != NULL) {
+    size_t length = (size_t)(newline - (bot->input + used));
+    if (!bot->is_skipping_line) {
+      handle_line(host, bot, bot->input + used, length, now);
+    }
+    bot->is_skipping_line = false;
+    used += length + 1;
+  }
+  if (bot->state == BOT_FINISHED) {
+    return;
+  }
+  if (!bot->is_skipping_line && bot->input_length - used >= ENGINE_PROTOCOL_MAXIMUM_LINE) {
+    handle_line(host, bot, bot->input + used, ENGINE_PROTOCOL_MAXIMUM_LINE, now);
+    bot->is_skipping_line = true;
+  }
+  if (bot->is_skipping_line) {
+    used = bot->input_length;
+  }
+  memmove(bot->input, bot->input + used, bot->input_length - used);
+  bot->input_length -= used;
+}
+
+static void check_deadline(const host_t *host, bot_t *bot, uint64_t now) {
+  if (bot->state == BOT_FINISHED || now < bot->deadline) {
+    return;
+  }
+  if (bot->state == BOT_THINKING) {
+    end_game(host, bot, ENGINE_PROTOCOL_TIMEOUT, now);
+  } else {
+    finish(bot, true);
+  }
+}
+
+// bots are given a moment to exit after quit, then killed
+static void reap(bot_t bots[], size_t number_of_bots) {
+  uint64_t deadline = now_nanoseconds() + ENGINE_HOST_QUIT_MILLISECONDS * NANOSECONDS_PER_MILLISECOND;
+  for (size_t i = 0; i < number_of_bots; i++) {
+    if (bots[i].pid <= 0) {
+      continue;
+    }
+    while (waitpid(bots[i].pid, NULL, WNOHANG) == 0) {
+      if (now_nanoseconds() >= deadline) {
+        kill(bots[i].pid, SIGKILL);
+        waitpid(bots[i].pid, NULL, 0);
+        break;
+      }
+      struct timespec pause = {.tv_nsec = NANOSECONDS_PER_MILLISECOND};
+      nanosleep(&pause, NULL);
+    }
+  }
+}
+
+static uint64_t cpu_nanoseconds(void) {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return ((uint64_t) usage.ru_utime.tv_sec + (uint64_t) usage.ru_stime.tv_sec) * 1000000000u +
+         ((uint64_t) usage.ru_utime.tv_usec + (uint64_t) usage.ru_stime.tv_usec) * 1000u;
+}
+
+static void play(const host_t *host, bot_t bots[], size_t number_of_bots) {
+  struct pollfd fds[2 * ENGINE_HOST_MAXIMUM_BOTS];
+  bot_t *fd_bots[2 * ENGINE_HOST_MAXIMUM_BOTS];
+  for (;;) {
+    size_t number_of_fds = 0;
+    uint64_t deadline = NO_DEADLINE;
+    for (size_t i = 0; i < number_of_bots; i++) {
+      bot_t *bot = &bots[i];
+      if (bot->state == BOT_FINISHED) {
+        continue;
+      }
+      fds[number_of_fds] = (struct pollfd) {.fd = bot->from_bot, .events = POLLIN};
+      fd_bots[number_of_fds++] = bot;
+      if (bot->output_length > 0) {
+        fds[number_of_fds] = (struct pollfd) {.fd = bot->to_bot, .events = POLLOUT};
+        fd_bots[number_of_fds++] = bot;
+      }
+      deadline = bot->deadline < deadline ? bot->deadline : deadline;
+    }
+    if (number_of_fds == 0) {
+      return;
+    }
+    int timeout = -1;
+    if (deadline != NO_DEADLINE) {
+      uint64_t now = now_nanoseconds();
+      uint64_t wait = deadline > now ? deadline - now : 0;
+      // rounded up so the deadline has passed when poll returns
+      timeout = (int)((wait + NANOSECONDS_PER_MILLISECOND - 1) / NANOSECONDS_PER_MILLISECOND);
+    }
+    if (poll(fds, number_of_fds, timeout) < 0 && errno != EINTR) {
+      return;
+    }
+    uint64_t now = now_nanoseconds();
+    for (size_t i = 0; i < number_of_fds; i++) {
+      bot_t *bot = fd_bots[i];
+      if (fds[i].revents == 0 || bot->state == BOT_FINISHED) {
+        continue;
+      }
+      if (fds[i].fd == bot->to_bot) {
+        if (!flush(bot)) {
+          finish(bot, true);
+        }
+      } else {
+        read_from_bot(host, bot, now);
+      }
+    }
+    for (size_t i = 0; i < number_of_bots; i++) {
+      check_deadline(host, &bots[i], now);
+      if (bots[i].state != BOT_FINISHED && bots[i].output_length > 0 && !flush(&bots[i])) {
+        finish(&bots[i], true);
+      }
+    }
+  }
+}
+
+bool engine_host_run(const char *const commands[], size_t number_of_bots, const engine_host_options_t *options,
+                     engine_host_result_t results[], engine_host_stats_t *stats) {
+  host_t host = {.options = options, .stats = stats};
+  if (number_of_bots == 0 || number_of_bots > ENGINE_HOST_MAXIMUM_BOTS || options->maximum_tries == 0 ||
+      options->maximum_tries > LARGE_SPACE_MAXIMUM_HISTORY ||
+      !engine_protocol_init_decoder(&host.decoder, &options->variant)) {
+    return false;
+  }
+  bot_t *bots = calloc(number_of_bots, sizeof(bot_t));
+  if (bots == NULL) {
+    return false;
+  }
+  memset(stats, 0, sizeof(*stats));
+  // a bot that exits is noticed through its pipes rather than a signal that would end the host
+  struct sigaction ignore = {.sa_handler = SIG_IGN};
+  struct sigaction previous;
+  sigaction(SIGPIPE, &ignore, &previous);
+  uint64_t start = now_nanoseconds();
+  uint64_t start_cpu = cpu_nanoseconds();
+
+  for (size_t i = 0; i < number_of_bots; i++) {
+    bot_t *bot = &bots[i];
+    memset(&results[i], 0, sizeof(results[i]));
+    snprintf(results[i].name, sizeof(results[i].name), "%s", commands[i]);
+    bot->result = &results[i];
+    bot->to_bot = -1;
+    bot->from_bot = -1;
+    if (!spawn(bot, commands[i])) {
+      finish(bot, true);
+      continue;
+    }
+    bot->state = BOT_STARTING;
+    bot->deadline = start + ENGINE_HOST_HANDSHAKE_MILLISECONDS * NANOSECONDS_PER_MILLISECOND;
+    send_line(bot, "mmp\n", 4);
+  }
+  play(&host, bots, number_of_bots);
+  reap(bots, number_of_bots);
+
+  stats->host_cpu_nanoseconds = cpu_nanoseconds() - start_cpu;
+  stats->wall_nanoseconds = now_nanoseconds() - start;
+  sigaction(SIGPIPE, &previous, NULL);
+  free(bots);
+  return true;
+}
+
+int engine_host_main(const char *const commands[], size_t number_of_bots, const engine_host_options_t *options) {
+  engine_host_result_t *results = calloc(number_of_bots > 0 ? number_of_bots : 1, sizeof(engine_host_result_t));
+  engine_host_stats_t stats;
+  if (results == NULL || !engine_host_run(commands, number_of_bots, options, results, &stats)) {
+    fprintf(stderr, "Could not host %zu bots, up to %d can play games of 1-%d pegs, 2-%d values and 1-%d tries\n",
+            number_of_bots, ENGINE_HOST_MAXIMUM_BOTS, LARGE_SPACE_MAXIMUM_PEGS, LARGE_SPACE_MAXIMUM_VALUES,
+            LARGE_SPACE_MAXIMUM_HISTORY);
+    free(results);
+    return EXIT_FAILURE;
+  }
+  uint64_t think_nanoseconds = 0;
+  printf("%-32s %6s %6s %6s %8s %8s %9s %13s %8s\n", "bot", "games", "wins", "losses", "timeouts", "illegal",
+         "avg tries", "ms per guess", "info");
+  for (size_t i = 0; i < number_of_bots; i++) {
+    const engine_host_result_t *result = &results[i];
+    uint32_t wins = result->outcomes[ENGINE_PROTOCOL_WIN];
+    think_nanoseconds += result->think_nanoseconds;
+    printf("%-32s %6u %6u %6u %8u %8u %9.2f %13.3f %8llu%s\n", result->name, result->games, wins,
+           result->outcomes[ENGINE_PROTOCOL_LOSS], result->outcomes[ENGINE_PROTOCOL_TIMEOUT],
+           result->outcomes[ENGINE_PROTOCOL_ILLEGAL], wins > 0 ? (double) result->tries_to_win / wins : 0.0,
+           result->moves > 0 ? (double) result->think_nanoseconds / (double) result->moves / 1e6 : 0.0,
+           (unsigned long long) result->info_lines, result->is_dropped ? "  dropped" : "");
+  }
+  printf("%llu guesses in %.1f ms, the host used %.1f us of processor per guess, %.2f%% of the bots' thinking\n",
+         (unsigned long long) stats.moves, (double) stats.wall_nanoseconds / 1e6,
+         stats.moves > 0 ? (double) stats.host_cpu_nanoseconds / (double) stats.moves / 1e3 : 0.0,
+         think_nanoseconds > 0 ? 100.0 * (double) stats.host_cpu_nanoseconds / (double) think_nanoseconds : 0.0);
+  free(results);
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
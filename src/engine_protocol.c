@@ -0,0 +1,238 @@
+#include "engine_protocol.h"
+#include <string.h>
+
+// times are in milliseconds, 32 bits last about 49 days
+#define MAXIMUM_NUMBER UINT32_MAX
+
+static const struct {
+  const char *word;
+  engine_protocol_type_t type;
+} commands[] = {
+  {"mmp", ENGINE_PROTOCOL_MMP},
+  {"isready", ENGINE_PROTOCOL_ISREADY},
+  {"newgame", ENGINE_PROTOCOL_NEWGAME},
+  {"go", ENGINE_PROTOCOL_GO},
+  {"feedback", ENGINE_PROTOCOL_FEEDBACK},
+  {"result", ENGINE_PROTOCOL_RESULT},
+  {"quit", ENGINE_PROTOCOL_QUIT},
+  {"id", ENGINE_PROTOCOL_ID},
+  {"mmpok", ENGINE_PROTOCOL_MMPOK},
+  {"readyok", ENGINE_PROTOCOL_READYOK},
+  {"info", ENGINE_PROTOCOL_INFO},
+  {"guess", ENGINE_PROTOCOL_GUESS},
+};
+
+static const char *outcome_names[ENGINE_PROTOCOL_NUMBER_OF_OUTCOMES] = {"win", "loss", "timeout", "illegal"};
+
+typedef struct {
+  const char *cursor;
+  const char *end;
+} words_t;
+
+static bool is_space(char character) {
+  return character == ' ' || character == '\t';
+}
+
+static bool next_word(words_t *words, const char **word, size_t *length) {
+  while (words->cursor < words->end && is_space(*words->cursor)) {
+    words->cursor++;
+  }
+  if (words->cursor == words->end) {
+    return false;
+  }
+  *word = words->cursor;
+  while (words->cursor < words->end && !is_space(*words->cursor)) {
+    words->cursor++;
+  }
+  *length = (size_t)(words->cursor - *word);
+  return true;
+}
+
+static bool is_word(const char *word, size_t length, const char *expected) {
+  return strlen(expected) == length && memcmp(word, expected, length) == 0;
+}
+
+static bool next_number(words_t *words, uint32_t maximum, uint32_t *number) {
+  const char *word;
+  size_t length;
+  if (!next_word(words, &word, &length)) {
+    return false;
+  }
+  uint64_t value = 0;
+  for (size_t i = 0; i < length; i++) {
+    if (word[i] < '0' || word[i] > '9') {
+      return false;
+    }
+    value = value * 10 + (uint64_t)(word[i] - '0');
+    if (value > maximum) {
+      return false;
+    }
+  }
+  *number = (uint32_t) value;
+  return true;
+}
+
+static bool next_code(words_t *words, const code_decoder_t *decoder, large_space_code_t *code) {
+  const char *word;
+  size_t length;
+  if (decoder == NULL || !next_word(words, &word, &length) || length != decoder->number_of_pegs) {
+    return false;
+  }
+  // the decoder reads up to the end of a line, the code may be followed by more words
+  char text[CODE_DECODER_MAXIMUM_PEGS + 1];
+  memcpy(text, word, length);
+  text[length] = '\0';
+  memset(code, 0, sizeof(*code));
+  code_decoder_error_t error;
+  return code_decoder_decode(decoder, text, code->values, NULL, &error) == CODE_DECODER_OK;
+}
+
+bool engine_protocol_init_decoder(code_decoder_t *decoder, const large_space_variant_t *variant) {
+  if (variant->number_of_pegs == 0 || variant->number_of_pegs > LARGE_SPACE_MAXIMUM_PEGS ||
+      variant->number_of_values < 2 || variant->number_of_values > LARGE_SPACE_MAXIMUM_VALUES) {
+    return false;
+  }
+  char alphabet[LARGE_SPACE_MAXIMUM_VALUES + 1];
+  memcpy(alphabet, ENGINE_PROTOCOL_ALPHABET, variant->number_of_values);
+  alphabet[variant->number_of_values] = '\0';
+  return code_decoder_init(decoder, alphabet, variant->number_of_pegs);
+}
+
+static engine_protocol_type_t parse_newgame(words_t *words, engine_protocol_message_t *message) {
+  uint32_t pegs = 0;
+  uint32_t values = 0;
+  uint32_t tries = 0;
+  const char *word;
+  size_t length;
+  while (next_word(words, &word, &length)) {
+    bool is_parsed = true;
+    if (is_word(word, length, "pegs")) {
+      is_parsed = next_number(words, LARGE_SPACE_MAXIMUM_PEGS, &pegs);
+    } else if (is_word(word, length, "values")) {
+      is_parsed = next_number(words, LARGE_SPACE_MAXIMUM_VALUES, &values);
+    } else if (is_word(word, length, "tries")) {
+      is_parsed = next_number(words, LARGE_SPACE_MAXIMUM_HISTORY, &tries);
+    } else if (is_word(word, length, "hard")) {
+      message->is_hard_mode = true;
+    }
+    if (!is_parsed) {
+      return ENGINE_PROTOCOL_MALFORMED;
+    }
+  }
+  if (pegs == 0 || values < 2 || tries == 0) {
+    return ENGINE_PROTOCOL_MALFORMED;
+  }
+  message->variant.number_of_pegs = (uint8_t) pegs;
+  message->variant.number_of_values = (uint8_t) values;
+  message->maximum_tries = (uint8_t) tries;
+  return ENGINE_PROTOCOL_NEWGAME;
+}
+
+static engine_protocol_type_t parse_go(words_t *words, engine_protocol_message_t *message) {
+  const char *word;
+  size_t length;
+  while (next_word(words, &word, &length)) {
+    bool is_parsed = true;
+    if (is_word(word, length, "time")) {
+      is_parsed = next_number(words, MAXIMUM_NUMBER, &message->game_milliseconds);
+    } else if (is_word(word, length, "movetime")) {
+      is_parsed = next_number(words, MAXIMUM_NUMBER, &message->move_milliseconds);
+    }
+    if (!is_parsed) {
+      return ENGINE_PROTOCOL_MALFORMED;
+    }
+  }
+  return ENGINE_PROTOCOL_GO;
+}
+
+static engine_protocol_type_t parse_feedback(words_t *words, const code_decoder_t *decoder,
+                                             engine_protocol_message_t *message) {
+  uint32_t placement;
+  uint32_t value_only;
+  uint32_t number_of_pegs = decoder != NULL ? decoder->number_of_pegs : CODE_DECODER_MAXIMUM_PEGS;
+  if (!next_number(words, number_of_pegs, &placement) || !next_number(words, number_of_pegs, &value_only) ||
+      placement + value_only > number_of_pegs) {
+    return ENGINE_PROTOCOL_MALFORMED;
+  }
+  message->feedback.number_of_correct_value_and_placement = (uint8_t) placement;
+  message->feedback.number_of_correct_value_only = (uint8_t) value_only;
+  message->feedback.is_guess_correct = decoder != NULL && placement == number_of_pegs;
+  return ENGINE_PROTOCOL_FEEDBACK;
+}
+
+static engine_protocol_type_t parse_result(words_t *words, const code_decoder_t *decoder,
+                                           engine_protocol_message_t *message) {
+  const char *word;
+  size_t length;
+  if (!next_word(words, &word, &length)) {
+    return ENGINE_PROTOCOL_MALFORMED;
+  }
+  for (size_t i = 0; i < ENGINE_PROTOCOL_NUMBER_OF_OUTCOMES; i++) {
+    if (is_word(word, length, outcome_names[i])) {
+      message->outcome = (engine_protocol_outcome_t) i;
+      return next_code(words, decoder, &message->code) ? ENGINE_PROTOCOL_RESULT : ENGINE_PROTOCOL_MALFORMED;
+    }
+  }
+  return ENGINE_PROTOCOL_MALFORMED;
+}
+
+engine_protocol_type_t engine_protocol_parse(const char *line, size_t length, const code_decoder_t *decoder,
+                                             engine_protocol_message_t *message) {
+  memset(message, 0, sizeof(*message));
+  // engines written on other systems may end their lines with \r\n
+  if (length > 0 && line[length - 1] == '\r') {
+    length--;
+  }
+  words_t words = {.cursor = line, .end = line + length};
+  const char *word;
+  size_t word_length;
+  if (!next_word(&words, &word, &word_length)) {
+    return message->type = ENGINE_PROTOCOL_UNKNOWN;
+  }
+  engine_protocol_type_t type = ENGINE_PROTOCOL_UNKNOWN;
+  for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++) {
+    if (is_word(word, word_length, commands[i].word)) {
+      type = commands[i].type;
+      break;
+    }
+  }
+  switch (type) {
+  case ENGINE_PROTOCOL_NEWGAME:
+    type = parse_newgame(&words, message);
+    break;
+  case ENGINE_PROTOCOL_GO:
+    type = parse_go(&words, message);
+    break;
+  case ENGINE_PROTOCOL_FEEDBACK:
+    type = parse_feedback(&words, decoder, message);
+    break;
+  case ENGINE_PROTOCOL_RESULT:
+    type = parse_result(&words, decoder, message);
+    break;
+  case ENGINE_PROTOCOL_GUESS:
+    type = next_code(&words, decoder, &message->code) ? ENGINE_PROTOCOL_GUESS : ENGINE_PROTOCOL_MALFORMED;
+    break;
+  case ENGINE_PROTOCOL_ID:
+  case ENGINE_PROTOCOL_INFO:
+    while (words.cursor < words.end && is_space(*words.cursor)) {
+      words.cursor++;
+    }
+    message->text = words.cursor;
+    message->text_length = (size_t)(words.end - words.cursor);
+    break;
+  default:
+    break;
+  }
+  return message->type = type;
+}
+
+size_t engine_protocol_format_code(const large_space_variant_t *variant, const large_space_code_t *code, char *text) {
+  for (uint_fast8_t i = 0; i < variant->number_of_pegs; i++) {
+    text[i] = ENGINE_PROTOCOL_ALPHABET[code->values[i]];
+  }
+  return variant->number_of_pegs;
+}
+
+const char* engine_protocol_outcome_name(engine_protocol_outcome_t outcome) {
+  return outcome < ENGINE_PROTOCOL_NUMBER_OF_OUTCOMES ? outcome_names[outcome] : "unknown";
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "evil_codemaker.h"
+#include <string.h>
+
+static game_logic_values_t candidates[NUMBER_OF_POSSIBLE_CODES][NUMBER_OF_VALUES_TO_GUESS];
+static uint8_t candidate_classes[NUMBER_OF_POSSIBLE_CODES];
+static size_t number_of_candidates = 0;
+
+void evil_codemaker_start(void) {
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    game_logic_unpack_code(i, candidates[i]);
+  }
+  number_of_candidates = NUMBER_OF_POSSIBLE_CODES;
+}
+
+game_logic_feedback_t evil_codemaker_get_feedback(game_logic_values_t guess[]) {
+  uint16_t partition_sizes[NUMBER_OF_FEEDBACK_CLASSES] = {0};
+  for (size_t i = 0; i < number_of_candidates; i++) {
+    candidate_classes[i] = game_logic_feedback_to_class(game_logic_score(candidates[i], guess));
+    partition_sizes[candidate_classes[i]]++;
+  }
+
+  // the winning class is the last one, so on a tie any other class is preferred over conceding
+  uint8_t chosen_class = 0;
+  for (uint8_t i = 1; i < NUMBER_OF_FEEDBACK_CLASSES; i++) {
+    if (partition_sizes[i] > partition_sizes[chosen_class]) {
+      chosen_class = i;
+    }
+  }
+
+  size_t kept = 0;
+  for (size_t i = 0; i < number_of_candidates; i++) {
+    if (candidate_classes[i] == chosen_class) {
+      memmove(candidates[kept++], candidates[i], sizeof(candidates[i]));
+    }
+  }
+  number_of_candidates = kept;
+  return game_logic_feedback_from_class(chosen_class);
+}
+
+game_logic_values_t* evil_codemaker_get_answer(void) {
+  return candidates[0];
+}
+
+size_t evil_codemaker_get_remaining_candidates(void) {
+  return number_of_candidates;
+}
\ No newline at end of file
@@ -0,0 +1,582 @@
+#define _GNU_SOURCE
+#include "game_journal.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#define CACHE_LINE_SIZE 64
+#define READ_RECORDS 4096
+#define INITIAL_GAMES 1024
+#define CRC32C_POLYNOMIAL 0x82F63B78u
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t record_size;
+  uint32_t reserved;
+} header_t;
+
+struct game_journal_writer {
+  pthread_mutex_t lock;
+  // signalled by the committer when it takes a full buffer away
+  pthread_cond_t has_room;
+  game_journal_record_t *records;
+  size_t number_of_records;
+  game_journal_t *journal;
+} __attribute__((aligned(CACHE_LINE_SIZE)));
+
+struct game_journal {
+  int fd;
+  game_journal_options_t options;
+  // records per buffer, a commit is requested at half of it
+  size_t capacity;
+  size_t commit_records;
+  pthread_t committer;
+  // held for a whole commit so records of one writer reach the file in the order they were appended
+  pthread_mutex_t commit_lock;
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+  bool is_commit_requested;
+  bool is_closing;
+  game_journal_stats_t stats;
+  // the buffers the committer is writing, swapped with the writers' ones on every commit
+  game_journal_record_t **spares;
+  struct iovec *batches;
+  size_t number_of_writers;
+  game_journal_writer_t *writers;
+};
+
+// the games in play while the journal is replayed, keyed by game id
+typedef struct {
+  game_journal_game_t *games;
+  // power of two
+  size_t number_of_buckets;
+  size_t number_of_games;
+  bool is_out_of_memory;
+  game_journal_game_visit_t finished;
+  void *argument;
+} game_table_t;
+
+static uint32_t crc_table[256];
+static pthread_once_t crc_table_once = PTHREAD_ONCE_INIT;
+
+static void build_crc_table(void) {
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (CRC32C_POLYNOMIAL & (0u - (crc & 1)));
+    }
+    crc_table[i] = crc;
+  }
+}
+
+static uint32_t record_crc(const game_journal_record_t *record) {
+  const uint8_t *bytes = (const uint8_t *) record + sizeof(record->crc);
+  uint32_t crc = UINT32_MAX;
+  for (size_t i = 0; i < sizeof(*record) - sizeof(record->crc); i++) {
+    crc = (crc >> 8) ^ crc_table[(crc ^ bytes[i]) & 0xFF];
+  }
+  return ~crc;
+}
+
+static void count(uint64_t *counter, uint64_t amount) {
+  __atomic_fetch_add(counter, amount, __ATOMIC_RELAXED);
+}
+
+// a missing or cut off header reads as an empty journal, anything else that does not match is refused
+static bool scan(int fd, game_journal_visit_t visit, void *argument, game_journal_recovery_t *recovery,
+                 off_t *valid_length) {
+  pthread_once(&crc_table_once, build_crc_table);
+  memset(recovery, 0, sizeof(*recovery));
+  *valid_length = 0;
+  struct stat status;
+  if (fstat(fd, &status) < 0) {
+    return false;
+  }
+  header_t header;
+  if (status.st_size < (off_t) sizeof(header)) {
+    recovery->torn_bytes = (uint64_t) status.st_size;
+    return true;
+  }
+  if (pread(fd, &header, sizeof(header), 0) != sizeof(header) || header.magic != GAME_JOURNAL_MAGIC ||
+      header.version != GAME_JOURNAL_VERSION || header.record_size != sizeof(game_journal_record_t)) {
+    return false;
+  }
+  game_journal_record_t *records = malloc(READ_RECORDS * sizeof(game_journal_record_t));
+  if (records == NULL) {
+    return false;
+  }
+  off_t offset = sizeof(header);
+  bool is_intact = true;
+  while (is_intact) {
+    ssize_t length = pread(fd, records, READ_RECORDS * sizeof(game_journal_record_t), offset);
+    if (length < 0) {
+      free(records);
+      return false;
+    }
+    size_t number_of_records = (size_t) length / sizeof(game_journal_record_t);
+    for (size_t i = 0; i < number_of_records && is_intact; i++) {
+      is_intact = records[i].crc == record_crc(&records[i]);
+      if (is_intact) {
+        if (visit != NULL) {
+          visit(&records[i], argument);
+        }
+        recovery->records++;
+        offset += sizeof(game_journal_record_t);
+      }
+    }
+    is_intact = is_intact && number_of_records == READ_RECORDS;
+  }
+  free(records);
+  *valid_length = offset;
+  recovery->torn_bytes = (uint64_t)(status.st_size - offset);
+  return true;
+}
+
+static bool write_vector(int fd, struct iovec *batches, int number_of_batches) {
+  while (number_of_batches > 0) {
+    ssize_t written = writev(fd, batches, number_of_batches);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return false;
+    }
+    // a short write leaves the rest of the batches for the next call
+    while (number_of_batches > 0 && (size_t) written >= batches->iov_len) {
+      written -= (ssize_t) batches->iov_len;
+      batches++;
+      number_of_batches--;
+    }
+    if (number_of_batches > 0) {
+      batches->iov_base = (char *) batches->iov_base + written;
+      batches->iov_len -= (size_t) written;
+    }
+  }
+  return true;
+}
+
+static void commit(game_journal_t *journal) {
+  pthread_mutex_lock(&journal->commit_lock);
+  int number_of_batches = 0;
+  size_t number_of_records = 0;
+  for (size_t i = 0; i < journal->number_of_writers; i++) {
+    game_journal_writer_t *writer = &journal->writers[i];
+    pthread_mutex_lock(&writer->lock);
+    game_journal_record_t *records = writer->records;
+    size_t length = writer->number_of_records;
+    writer->records = journal->spares[i];
+    writer->number_of_records = 0;
+    pthread_mutex_unlock(&writer->lock);
+    pthread_cond_signal(&writer->has_room);
+    journal->spares[i] = records;
+    if (length > 0) {
+      journal->batches[number_of_batches].iov_base = records;
+      journal->batches[number_of_batches].iov_len = length * sizeof(game_journal_record_t);
+      number_of_batches++;
+      number_of_records += length;
+    }
+  }
+  if (number_of_batches == 0) {
+    pthread_mutex_unlock(&journal->commit_lock);
+    return;
+  }
+  // every writer's records go out in one system call and share one sync
+  if (!write_vector(journal->fd, journal->batches, number_of_batches) ||
+      (!journal->options.is_sync_disabled && fdatasync(journal->fd) < 0)) {
+    fprintf(stderr, "Could not commit %zu journal records: %s\n", number_of_records, strerror(errno));
+    count(&journal->stats.failures, 1);
+    pthread_mutex_unlock(&journal->commit_lock);
+    return;
+  }
+  count(&journal->stats.records, number_of_records);
+  count(&journal->stats.bytes, number_of_records * sizeof(game_journal_record_t));
+  count(&journal->stats.commits, 1);
+  if (number_of_records > __atomic_load_n(&journal->stats.largest_commit, __ATOMIC_RELAXED)) {
+    __atomic_store_n(&journal->stats.largest_commit, number_of_records, __ATOMIC_RELAXED);
+  }
+  pthread_mutex_unlock(&journal->commit_lock);
+}
+
+static void* run_committer(void *argument) {
+  game_journal_t *journal = argument;
+  bool is_closing = false;
+  while (!is_closing) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_nsec += (long) journal->options.commit_milliseconds * 1000000;
+    deadline.tv_sec += deadline.tv_nsec / 1000000000;
+    deadline.tv_nsec %= 1000000000;
+    pthread_mutex_lock(&journal->lock);
+    while (!journal->is_commit_requested && !journal->is_closing &&
+           pthread_cond_timedwait(&journal->wake, &journal->lock, &deadline) == 0) {
+    }
+    journal->is_commit_requested = false;
+    is_closing = journal->is_closing;
+    pthread_mutex_unlock(&journal->lock);
+    commit(journal);
+  }
+  return NULL;
+}
+
+static void request_commit(game_journal_t *journal) {
+  pthread_mutex_lock(&journal->lock);
+  journal->is_commit_requested = true;
+  pthread_cond_signal(&journal->wake);
+  pthread_mutex_unlock(&journal->lock);
+}
+
+static void destroy(game_journal_t *journal) {
+  for (size_t i = 0; journal->writers != NULL && i < journal->number_of_writers; i++) {
+    free(journal->writers[i].records);
+    pthread_mutex_destroy(&journal->writers[i].lock);
+    pthread_cond_destroy(&journal->writers[i].has_room);
+  }
+  for (size_t i = 0; journal->spares != NULL && i < journal->number_of_writers; i++) {
+    free(journal->spares[i]);
+  }
+  free(journal->writers);
+  free(journal->spares);
+  free(journal->batches);
+  pthread_mutex_destroy(&journal->commit_lock);
+  pthread_mutex_destroy(&journal->lock);
+  pthread_cond_destroy(&journal->wake);
+  if (journal->fd >= 0) {
+    close(journal->fd);
+  }
+  free(journal);
+}
+
+static bool create_buffers(game_journal_t *journal) {
+  if (posix_memalign((void **) &journal->writers, CACHE_LINE_SIZE,
+                     journal->number_of_writers * sizeof(game_journal_writer_t)) != 0) {
+    journal->writers = NULL;
+    return false;
+  }
+  journal->spares = calloc(journal->number_of_writers, sizeof(game_journal_record_t *));
+  journal->batches = calloc(journal->number_of_writers, sizeof(struct iovec));
+  bool is_created = journal->spares != NULL && journal->batches != NULL;
+  for (size_t i = 0; i < journal->number_of_writers; i++) {
+    game_journal_writer_t *writer = &journal->writers[i];
+    memset(writer, 0, sizeof(*writer));
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->has_room, NULL);
+    writer->journal = journal;
+    if (is_created) {
+      writer->records = malloc(journal->capacity * sizeof(game_journal_record_t));
+      journal->spares[i] = malloc(journal->capacity * sizeof(game_journal_record_t));
+      is_created = writer->records != NULL && journal->spares[i] != NULL;
+    }
+  }
+  return is_created;
+}
+
+game_journal_t* game_journal_open(const char *path, game_journal_options_t options, size_t number_of_writers) {
+  game_journal_t *journal = calloc(1, sizeof(game_journal_t));
+  if (journal == NULL) {
+    return NULL;
+  }
+  pthread_mutex_init(&journal->commit_lock, NULL);
+  pthread_mutex_init(&journal->lock, NULL);
+  pthread_condattr_t attributes;
+  pthread_condattr_init(&attributes);
+  pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+  pthread_cond_init(&journal->wake, &attributes);
+  pthread_condattr_destroy(&attributes);
+  journal->options = options;
+  journal->number_of_writers = number_of_writers;
+  if (journal->options.commit_bytes == 0) {
+    journal->options.commit_bytes = GAME_JOURNAL_DEFAULT_COMMIT_BYTES;
+  }
+  journal->commit_records = journal->options.commit_bytes / sizeof(game_journal_record_t);
+  if (journal->commit_records == 0) {
+    journal->commit_records = 1;
+  }
+  journal->capacity = 2 * journal->commit_records;
+
+  // appends from several writers without a committer rely on O_APPEND to never overlap
+  journal->fd = open(path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  game_journal_recovery_t recovery;
+  off_t valid_length;
+  if (journal->fd < 0 || !scan(journal->fd, NULL, NULL, &recovery, &valid_length) ||
+      ftruncate(journal->fd, valid_length) < 0) {
+    destroy(journal);
+    return NULL;
+  }
+  if (valid_length == 0) {
+    header_t header = {
+      .magic = GAME_JOURNAL_MAGIC,
+      .version = GAME_JOURNAL_VERSION,
+      .record_size = sizeof(game_journal_record_t)
+    };
+    if (write(journal->fd, &header, sizeof(header)) != sizeof(header) || fdatasync(journal->fd) < 0) {
+      destroy(journal);
+      return NULL;
+    }
+  }
+  if (!create_buffers(journal)) {
+    destroy(journal);
+    return NULL;
+  }
+  if (options.commit_milliseconds > 0 && pthread_create(&journal->committer, NULL, run_committer, journal) != 0) {
+    destroy(journal);
+    return NULL;
+  }
+  return journal;
+}
+
+void game_journal_close(game_journal_t *journal) {
+  if (journal->options.commit_milliseconds > 0) {
+    pthread_mutex_lock(&journal->lock);
+    journal->is_closing = true;
+    pthread_cond_signal(&journal->wake);
+    pthread_mutex_unlock(&journal->lock);
+    // the committer's last round takes whatever the writers left behind
+    pthread_join(journal->committer, NULL);
+  }
+  destroy(journal);
+}
+
+void game_journal_sync(game_journal_t *journal) {
+  if (journal->options.commit_milliseconds > 0) {
+    commit(journal);
+  }
+}
+
+game_journal_writer_t* game_journal_get_writer(game_journal_t *journal, size_t index) {
+  return &journal->writers[index];
+}
+
+void game_journal_append(game_journal_writer_t *writer, game_journal_record_t *record) {
+  game_journal_t *journal = writer->journal;
+  record->crc = record_crc(record);
+  if (journal->options.commit_milliseconds == 0) {
+    if (write(journal->fd, record, sizeof(*record)) != sizeof(*record) ||
+        (!journal->options.is_sync_disabled && fdatasync(journal->fd) < 0)) {
+      count(&journal->stats.failures, 1);
+      return;
+    }
+    count(&journal->stats.records, 1);
+    count(&journal->stats.bytes, sizeof(*record));
+    count(&journal->stats.commits, 1);
+    __atomic_store_n(&journal->stats.largest_commit, 1, __ATOMIC_RELAXED);
+    return;
+  }
+  pthread_mutex_lock(&writer->lock);
+  while (writer->number_of_records == journal->capacity) {
+    pthread_cond_wait(&writer->has_room, &writer->lock);
+  }
+  writer->records[writer->number_of_records++] = *record;
+  bool is_commit_due = writer->number_of_records == journal->commit_records;
+  pthread_mutex_unlock(&writer->lock);
+  if (is_commit_due) {
+    request_commit(journal);
+  }
+}
+
+game_journal_stats_t game_journal_get_stats(const game_journal_t *journal) {
+  game_journal_stats_t stats = {
+    .records = __atomic_load_n(&journal->stats.records, __ATOMIC_RELAXED),
+    .commits = __atomic_load_n(&journal->stats.commits, __ATOMIC_RELAXED),
+    .bytes = __atomic_load_n(&journal->stats.bytes, __ATOMIC_RELAXED),
+    .largest_commit = __atomic_load_n(&journal->stats.largest_commit, __ATOMIC_RELAXED),
+    .failures = __atomic_load_n(&journal->stats.failures, __ATOMIC_RELAXED)
+  };
+  return stats;
+}
+
+bool game_journal_replay(const char *path, game_journal_visit_t visit, void *argument,
+                         game_journal_recovery_t *recovery) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    memset(recovery, 0, sizeof(*recovery));
+    return errno == ENOENT;
+  }
+  off_t valid_length;
+  bool is_read = scan(fd, visit, argument, recovery, &valid_length);
+  close(fd);
+  return is_read;
+}
+
+static size_t bucket_of(const game_table_t *table, uint64_t game_id) {
+  uint64_t x = game_id * 0x9E3779B97F4A7C15u;
+  return (size_t)(x ^ (x >> 32)) & (table->number_of_buckets - 1);
+}
+
+static game_journal_game_t* find_game(game_table_t *table, uint64_t game_id) {
+  for (size_t i = bucket_of(table, game_id);; i = (i + 1) & (table->number_of_buckets - 1)) {
+    if (table->games[i].game_id == game_id) {
+      return &table->games[i];
+    }
+    if (table->games[i].game_id == 0) {
+      return NULL;
+    }
+  }
+}
+
+static bool grow_table(game_table_t *table) {
+  game_table_t grown = {.number_of_buckets = table->number_of_buckets * 2};
+  grown.games = calloc(grown.number_of_buckets, sizeof(game_journal_game_t));
+  if (grown.games == NULL) {
+    return false;
+  }
+  for (size_t i = 0; i < table->number_of_buckets; i++) {
+    if (table->games[i].game_id == 0) {
+      continue;
+    }
+    size_t bucket = bucket_of(&grown, table->games[i].game_id);
+    while (grown.games[bucket].game_id != 0) {
+      bucket = (bucket + 1) & (grown.number_of_buckets - 1);
+    }
+    grown.games[bucket] = table->games[i];
+  }
+  free(table->games);
+  table->games = grown.games;
+  table->number_of_buckets = grown.number_of_buckets;
+  return true;
+}
+
+static game_journal_game_t* insert_game(game_table_t *table, uint64_t game_id) {
+  game_journal_game_t *game = find_game(table, game_id);
+  if (game != NULL) {
+    return game;
+  }
+  if (2 * (table->number_of_games + 1) > table->number_of_buckets && !grow_table(table)) {
+    table->is_out_of_memory = true;
+    return NULL;
+  }
+  size_t bucket = bucket_of(table, game_id);
+  while (table->games[bucket].game_id != 0) {
+    bucket = (bucket + 1) & (table->number_of_buckets - 1);
+  }
+  table->number_of_games++;
+  table->games[bucket].game_id = game_id;
+  return &table->games[bucket];
+}
+
+// finished games leave the table so it only ever holds the games in play, entries behind the hole are
+// moved up so every probe sequence stays unbroken
+static void remove_game(game_table_t *table, game_journal_game_t *game) {
+  size_t mask = table->number_of_buckets - 1;
+  size_t hole = (size_t)(game - table->games);
+  for (size_t i = (hole + 1) & mask; table->games[i].game_id != 0; i = (i + 1) & mask) {
+    size_t home = bucket_of(table, table->games[i].game_id);
+    // the entry may fill the hole unless its home lies cyclically in (hole, i]
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      table->games[hole] = table->games[i];
+      hole = i;
+    }
+  }
+  memset(&table->games[hole], 0, sizeof(table->games[hole]));
+  table->number_of_games--;
+}
+
+static void replay_record(const game_journal_record_t *record, void *argument) {
+  game_table_t *table = argument;
+  if (record->game_id == 0) {
+    return;
+  }
+  game_journal_game_t *game = record->event == GAME_JOURNAL_EVENT_NEW ? insert_game(table, record->game_id)
+                                                                       : find_game(table, record->game_id);
+  // records of a game whose start was never journaled cannot rebuild it
+  if (game == NULL) {
+    return;
+  }
+  switch (record->event) {
+  case GAME_JOURNAL_EVENT_NEW:
+    memset(game, 0, sizeof(*game));
+    game->game_id = record->game_id;
+    game->slot = record->slot;
+    game->is_hard_mode = record->is_hard_mode;
+    game->answer = record->code;
+    game->started = record->time;
+    break;
+  case GAME_JOURNAL_EVENT_GUESS:
+    if (game->tries < SESSION_SNAPSHOT_MAXIMUM_HISTORY) {
+      game_logic_feedback_t feedback = {
+        .number_of_correct_value_and_placement = record->correct_value_and_placement,
+        .number_of_correct_value_only = record->correct_value_only
+      };
+      game->feedback[game->tries] = game_logic_feedback_to_class(feedback);
+      game->guesses[game->tries++] = record->code;
+    }
+    break;
+  case GAME_JOURNAL_EVENT_END:
+    game->end_reason = record->end_reason;
+    game->last_time = record->time;
+    if (table->finished != NULL) {
+      table->finished(game, table->argument);
+    }
+    remove_game(table, game);
+    return;
+  default:
+    return;
+  }
+  // a session may ask for its token after its games have started
+  if (record->token != 0) {
+    game->token = record->token;
+  }
+  game->last_time = record->time;
+}
+
+static bool replay_games(const char *path, game_table_t *table, game_journal_recovery_t *recovery) {
+  table->number_of_buckets = INITIAL_GAMES;
+  table->games = calloc(table->number_of_buckets, sizeof(game_journal_game_t));
+  if (table->games == NULL) {
+    return false;
+  }
+  if (!game_journal_replay(path, replay_record, table, recovery) || table->is_out_of_memory) {
+    return false;
+  }
+  recovery->games_in_progress = table->number_of_games;
+  return true;
+}
+
+bool game_journal_replay_games(const char *path, game_journal_game_visit_t visit, void *argument,
+                               game_journal_recovery_t *recovery) {
+  game_table_t table = {.finished = visit, .argument = argument};
+  bool is_replayed = replay_games(path, &table, recovery);
+  free(table.games);
+  return is_replayed;
+}
+
+bool game_journal_recover(const char *path, session_snapshot_writer_t *writer, uint64_t now,
+                          uint32_t maximum_idle_milliseconds, game_journal_recovery_t *recovery) {
+  game_table_t table = {0};
+  bool is_recovered = replay_games(path, &table, recovery);
+  for (size_t i = 0; is_recovered && i < table.number_of_buckets; i++) {
+    const game_journal_game_t *game = &table.games[i];
+    uint64_t idle = now > game->last_time ? now - game->last_time : 0;
+    if (game->game_id == 0 || game->token == 0 ||
+        (maximum_idle_milliseconds > 0 && idle > maximum_idle_milliseconds)) {
+      continue;
+    }
+    session_snapshot_game_t saved = {
+      .token = game->token,
+      .game_id = game->game_id,
+      .idle_milliseconds = idle > UINT32_MAX ? UINT32_MAX : (uint32_t) idle,
+      .slot = game->slot,
+      .tries = game->tries,
+      .is_hard_mode = game->is_hard_mode,
+      .answer = game->answer
+    };
+    memcpy(saved.history, game->guesses, sizeof(saved.history));
+    is_recovered = session_snapshot_writer_add(writer, &saved);
+    recovery->games_recovered++;
+  }
+  free(table.games);
+  return is_recovered;
+}
+
+uint64_t game_journal_clock(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_REALTIME, &now);
+  return (uint64_t) now.tv_sec * 1000 + (uint64_t) now.tv_nsec / 1000000;
+}
\ No newline at end of file
@@ -2,34 +2,30 @@
 #include "stdint.h"
 #include "random.h"
 #include <string.h>
+#include <pthread.h>
 
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 
-static game_logic_values_t answer[NUMBER_OF_VALUES_TO_GUESS] = {0};
-static uint_fast8_t answer_bins[GAME_VALUE_MAX] = {0};
+// drives the single game behind the free functions, sessions keep their own contexts
+static game_logic_context_t default_context;
+static uint8_t score_table[NUMBER_OF_POSSIBLE_CODES][NUMBER_OF_POSSIBLE_CODES];
+static pthread_once_t score_table_once = PTHREAD_ONCE_INIT;
 
-void game_logic_generate_random_answer(void) {
-  memset(answer_bins, 0, sizeof(answer_bins));
-  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
-    game_logic_values_t value = (game_logic_values_t) (random_value() % GAME_VALUE_MAX);
-    answer[i] = value;
-    answer_bins[value]++;
-  }
-}
-
-game_logic_feedback_t game_logic_get_feedback(game_logic_values_t guess[]) {
+static game_logic_feedback_t score_against_bins(const game_logic_values_t answer_values[],
+                                                const uint_fast8_t answer_value_bins[],
+                                                const game_logic_values_t guess[]) {
   game_logic_feedback_t feedback = {0};
   uint_fast8_t guess_bins[GAME_VALUE_MAX] = {0};
 
   for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
     guess_bins[guess[i]]++;
-    if (guess[i] == answer[i]) {
+    if (guess[i] == answer_values[i]) {
       feedback.number_of_correct_value_and_placement++;
     }
   }
 
   for (uint_fast8_t i = 0; i < GAME_VALUE_MAX; i++) {
-    feedback.number_of_correct_value_only += MIN(guess_bins[i], answer_bins[i]);
+    feedback.number_of_correct_value_only += MIN(guess_bins[i], answer_value_bins[i]);
   }
 
   feedback.number_of_correct_value_only -= feedback.number_of_correct_value_and_placement;
@@ -37,6 +33,139 @@ game_logic_feedback_t game_logic_get_feedback(game_logic_values_t guess[]) {
   return feedback;
 }
 
+void game_logic_generate_random_answer(void) {
+  game_logic_context_start(&default_context, false);
+}
+
+game_logic_feedback_t game_logic_get_feedback(game_logic_values_t guess[]) {
+  return score_against_bins(default_context.answer, default_context.answer_bins, guess);
+}
+
 game_logic_values_t* game_logic_get_answer(void) {
-  return answer;
+  return default_context.answer;
+}
+
+void game_logic_set_answer(const game_logic_values_t values[]) {
+  game_logic_context_set_answer(&default_context, values);
+}
+
+game_logic_feedback_t game_logic_score(const game_logic_values_t answer_values[], const game_logic_values_t guess[]) {
+  uint_fast8_t answer_value_bins[GAME_VALUE_MAX] = {0};
+  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    answer_value_bins[answer_values[i]]++;
+  }
+  return score_against_bins(answer_values, answer_value_bins, guess);
+}
+
+uint8_t game_logic_feedback_to_class(game_logic_feedback_t feedback) {
+  return (uint8_t)(feedback.number_of_correct_value_and_placement * (NUMBER_OF_VALUES_TO_GUESS + 1) +
+                   feedback.number_of_correct_value_only);
+}
+
+game_logic_feedback_t game_logic_feedback_from_class(uint8_t feedback_class) {
+  game_logic_feedback_t feedback = {0};
+  feedback.number_of_correct_value_and_placement = feedback_class / (NUMBER_OF_VALUES_TO_GUESS + 1);
+  feedback.number_of_correct_value_only = feedback_class % (NUMBER_OF_VALUES_TO_GUESS + 1);
+  feedback.is_guess_correct = (bool)(feedback.number_of_correct_value_and_placement == NUMBER_OF_VALUES_TO_GUESS);
+  return feedback;
+}
+
+static void build_score_table(void) {
+  static game_logic_values_t codes[NUMBER_OF_POSSIBLE_CODES][NUMBER_OF_VALUES_TO_GUESS];
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    game_logic_unpack_code(i, codes[i]);
+  }
+  // scoring is symmetric so only the upper triangle needs computing
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    for (game_logic_code_t j = i; j < NUMBER_OF_POSSIBLE_CODES; j++) {
+      uint8_t feedback_class = game_logic_feedback_to_class(game_logic_score(codes[j], codes[i]));
+      score_table[i][j] = feedback_class;
+      score_table[j][i] = feedback_class;
+    }
+  }
+}
+
+const uint8_t* game_logic_score_row(game_logic_code_t guess) {
+  pthread_once(&score_table_once, build_score_table);
+  return score_table[guess];
+}
+
+game_logic_code_t game_logic_pack_code(const game_logic_values_t values[]) {
+  game_logic_code_t code = 0;
+  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    code = (game_logic_code_t)(code * GAME_VALUE_MAX + values[i]);
+  }
+  return code;
+}
+
+void game_logic_unpack_code(game_logic_code_t code, game_logic_values_t values[]) {
+  for (int_fast8_t i = NUMBER_OF_VALUES_TO_GUESS - 1; i >= 0; i--) {
+    values[i] = (game_logic_values_t)(code % GAME_VALUE_MAX);
+    code /= GAME_VALUE_MAX;
+  }
+}
+
+void game_logic_context_set_answer(game_logic_context_t *context, const game_logic_values_t values[]) {
+  memset(context->answer_bins, 0, sizeof(context->answer_bins));
+  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    context->answer[i] = values[i];
+    context->answer_bins[values[i]]++;
+  }
+  // every code is consistent before the first move, the bits past the last code stay clear
+  memset(context->consistent_codes, 0xFF, sizeof(context->consistent_codes));
+  if (NUMBER_OF_POSSIBLE_CODES % 64 != 0) {
+    context->consistent_codes[GAME_LOGIC_CODE_SET_WORDS - 1] = (UINT64_C(1) << (NUMBER_OF_POSSIBLE_CODES % 64)) - 1;
+  }
+}
+
+void game_logic_context_start(game_logic_context_t *context, bool is_hard_mode) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    values[i] = (game_logic_values_t) (random_value() % GAME_VALUE_MAX);
+  }
+  game_logic_context_set_answer(context, values);
+  context->is_hard_mode = is_hard_mode;
+}
+
+bool game_logic_context_is_consistent(const game_logic_context_t *context, const game_logic_values_t guess[]) {
+  game_logic_code_t code = game_logic_pack_code(guess);
+  return (context->consistent_codes[code / 64] >> (code % 64)) & 1u;
+}
+
+void game_logic_context_record_move(game_logic_context_t *context, const game_logic_values_t guess[],
+                                    game_logic_feedback_t feedback) {
+  const uint8_t *row = game_logic_score_row(game_logic_pack_code(guess));
+  uint8_t feedback_class = game_logic_feedback_to_class(feedback);
+  for (size_t i = 0; i < GAME_LOGIC_CODE_SET_WORDS; i++) {
+    // only codes still in the set can drop out, so the work shrinks as the game goes on
+    uint64_t remaining = context->consistent_codes[i];
+    while (remaining != 0) {
+      size_t code = i * 64 + (size_t) __builtin_ctzll(remaining);
+      if (row[code] != feedback_class) {
+        context->consistent_codes[i] &= ~(UINT64_C(1) << (code % 64));
+      }
+      remaining &= remaining - 1;
+    }
+  }
+}
+
+game_logic_guess_status_t game_logic_context_guess(game_logic_context_t *context, const game_logic_values_t guess[],
+                                                   game_logic_feedback_t *feedback) {
+  if (context->is_hard_mode && !game_logic_context_is_consistent(context, guess)) {
+    return GAME_LOGIC_GUESS_INCONSISTENT;
+  }
+  *feedback = score_against_bins(context->answer, context->answer_bins, guess);
+  game_logic_context_record_move(context, guess, *feedback);
+  return GAME_LOGIC_GUESS_ACCEPTED;
+}
+
+size_t game_logic_find_contradicted_move(const game_logic_move_t history[], size_t history_length,
+                                         const game_logic_values_t guess[]) {
+  for (size_t i = 0; i < history_length; i++) {
+    game_logic_feedback_t feedback = game_logic_score(guess, history[i].guess);
+    if (game_logic_feedback_to_class(feedback) != game_logic_feedback_to_class(history[i].feedback)) {
+      return i;
+    }
+  }
+  return history_length;
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "game_mode.h"
+#include "evil_codemaker.h"
+#include "black_peg.h"
+#include "liar.h"
+#include "secret_distribution.h"
+
+static const game_mode_codemaker_t codemakers[GAME_MODE_MAX] = {
+  [GAME_MODE_CLASSIC] = {
+    .name = "classic",
+    .start = game_logic_generate_random_answer,
+    .get_feedback = game_logic_get_feedback,
+    .get_answer = game_logic_get_answer,
+    .supports_hard_mode = true
+  },
+  [GAME_MODE_EVIL] = {
+    .name = "evil",
+    .start = evil_codemaker_start,
+    .get_feedback = evil_codemaker_get_feedback,
+    .get_answer = evil_codemaker_get_answer,
+    .supports_hard_mode = true
+  },
+  [GAME_MODE_BLACK_PEG] = {
+    .name = "black peg",
+    .start = game_logic_generate_random_answer,
+    .get_feedback = black_peg_get_feedback,
+    .get_answer = game_logic_get_answer,
+    .get_hint = black_peg_get_hint
+  },
+  [GAME_MODE_LIAR] = {
+    .name = "liar",
+    .start = liar_codemaker_start,
+    .get_feedback = liar_codemaker_get_feedback,
+    .get_answer = game_logic_get_answer,
+    .get_hint = liar_get_hint
+  },
+  [GAME_MODE_NO_DUPLICATES] = {
+    .name = "no duplicates",
+    .start = secret_distribution_start_no_duplicates,
+    .get_feedback = game_logic_get_feedback,
+    .get_answer = game_logic_get_answer,
+    .get_hint = secret_distribution_get_hint,
+    .supports_hard_mode = true
+  },
+  // the distribution has to be loaded with secret_distribution_load_file() before starting
+  [GAME_MODE_CUSTOM_SECRETS] = {
+    .name = "custom secrets",
+    .start = secret_distribution_generate_answer,
+    .get_feedback = game_logic_get_feedback,
+    .get_answer = game_logic_get_answer,
+    .get_hint = secret_distribution_get_hint,
+    .supports_hard_mode = true
+  },
+};
+
+const game_mode_codemaker_t* game_mode_get_codemaker(game_mode_t mode) {
+  return &codemakers[mode < GAME_MODE_MAX ? mode : GAME_MODE_CLASSIC];
+}
\ No newline at end of file
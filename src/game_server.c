@@ -0,0 +1,505 @@
+#define _GNU_SOURCE
+#include "game_server.h"
+#include "game_journal.h"
+#include "server_session.h"
+#include "session_snapshot.h"
+#include "slab.h"
+#include "uring_reactor.h"
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+
+#define MAXIMUM_EVENTS 256
+#define LISTEN_BACKLOG 4096
+
+#define CACHE_LINE_SIZE 64
+// epoll registration of the wake eventfd, no slab hands out this handle
+#define WAKE_HANDLE UINT64_MAX
+#define PATH_SIZE 4096
+// game ids start from the startup time shifted by this, so ids of earlier runs are never handed out again
+#define GAME_ID_TIME_SHIFT 16
+
+// lets the main thread stop every reactor between events while it reads their sessions
+typedef struct {
+  bool is_pause_requested;
+  // the reactors and the main thread, waited on once to stop and once to go again
+  pthread_barrier_t barrier;
+} pause_control_t;
+
+// everything a reactor thread touches on the request path, padded so reactors never share a cache line
+typedef struct {
+  pthread_t thread;
+  int epoll_fd;
+  int listen_fd;
+  // written by the main thread to get a reactor out of its wait when it asks for a pause
+  int wake_fd;
+  pause_control_t *pause;
+  size_t maximum_sessions;
+  // owned by the reactor thread, with io_uring it is the uring reactor's own slab
+  slab_t *sessions;
+  server_session_shard_t shard;
+  // NULL when the reactor runs on epoll
+  uring_reactor_t *uring;
+} __attribute__((aligned(CACHE_LINE_SIZE))) game_server_t;
+
+static int open_listener(uint16_t port) {
+  int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    return -1;
+  }
+  int enable = 1;
+  // every reactor binds the same port and the kernel spreads new connections between them
+  struct sockaddr_in address = {
+    .sin_family = AF_INET,
+    .sin_port = htons(port),
+    .sin_addr.s_addr = htonl(INADDR_LOOPBACK)
+  };
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable)) < 0 ||
+      setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0 ||
+      bind(fd, (struct sockaddr *) &address, sizeof(address)) < 0 ||
+      listen(fd, LISTEN_BACKLOG) < 0) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+// the default soft limit of 1024 descriptors is far below the number of sessions we want
+static void raise_descriptor_limit(void) {
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+  }
+}
+
+static void close_session(game_server_t *server, slab_handle_t handle, server_session_t *session) {
+  server_session_release(session);
+  close(session->fd);
+  slab_free(server->sessions, handle);
+  SERVER_SESSION_COUNT(server->shard.stats.sessions_closed);
+}
+
+// false when the registration could not be changed, the session would never hear from epoll again
+static bool update_interest(game_server_t *server, slab_handle_t handle, server_session_t *session) {
+  struct epoll_event event = {.data.u64 = handle};
+  event.events = (server_session_wants_input(session) ? EPOLLIN : 0) | (session->output_length > 0 ? EPOLLOUT : 0);
+  return epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, session->fd, &event) == 0;
+}
+
+static void accept_sessions(game_server_t *server) {
+  for (;;) {
+    int fd = accept4(server->listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd < 0) {
+      // EAGAIN once the backlog is drained, anything else (e.g. out of descriptors) waits for the next wakeup
+      return;
+    }
+    slab_handle_t handle;
+    server_session_t *session = slab_alloc(server->sessions, &handle);
+    if (session == NULL) {
+      SERVER_SESSION_COUNT(server->shard.stats.sessions_refused);
+      close(fd);
+      continue;
+    }
+    server_session_init(session, fd, &server->shard);
+    // registered by handle, a stale event can never reach a session that took over the slot
+    struct epoll_event event = {.events = EPOLLIN, .data.u64 = handle};
+    if (epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+      close(fd);
+      slab_free(server->sessions, handle);
+      continue;
+    }
+    SERVER_SESSION_COUNT(server->shard.stats.sessions_accepted);
+  }
+}
+
+// returns false once the session should be closed
+static bool flush_output(server_session_t *session) {
+  while (session->output_length > 0) {
+    ssize_t written = send(session->fd, session->output, session->output_length, MSG_NOSIGNAL);
+    if (written < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    server_session_consume_output(session, (size_t) written);
+  }
+  return !session->is_closing;
+}
+
+static bool read_input(server_session_t *session) {
+  while (server_session_wants_input(session)) {
+    ssize_t received = recv(session->fd, session->input + session->input_length,
+                            SERVER_SESSION_INPUT_SIZE - session->input_length, 0);
+    if (received == 0) {
+      return false;
+    }
+    if (received < 0) {
+      return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    session->input_length += (size_t) received;
+    server_session_process_input(session);
+  }
+  return true;
+}
+
+static void handle_session_event(game_server_t *server, slab_handle_t handle, uint32_t events) {
+  server_session_t *session = slab_get(server->sessions, handle);
+  if (session == NULL) {
+    return;
+  }
+  bool is_open = (events & (EPOLLERR | EPOLLHUP)) == 0 || (events & EPOLLIN) != 0;
+  if (is_open && (events & EPOLLIN)) {
+    is_open = read_input(session);
+  }
+  // output that drains may free room for input that was waiting on it
+  if (is_open) {
+    is_open = flush_output(session);
+    server_session_process_input(session);
+    is_open = is_open && flush_output(session);
+  }
+  if (!is_open || !update_interest(server, handle, session)) {
+    close_session(server, handle, session);
+  }
+}
+
+// called between batches of events when no session is half way through a request
+static void pause_point(void *argument) {
+  game_server_t *server = argument;
+  if (__atomic_load_n(&server->pause->is_pause_requested, __ATOMIC_ACQUIRE)) {
+    pthread_barrier_wait(&server->pause->barrier);
+    pthread_barrier_wait(&server->pause->barrier);
+  }
+}
+
+static void drain_wake(game_server_t *server) {
+  uint64_t count;
+  if (read(server->wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+    fprintf(stderr, "Could not read the wake eventfd: %s\n", strerror(errno));
+  }
+}
+
+static void* run_reactor(void *argument) {
+  game_server_t *server = argument;
+  if (server->uring != NULL) {
+    uring_reactor_run(server->uring, pause_point, server);
+    return NULL;
+  }
+  struct epoll_event events[MAXIMUM_EVENTS];
+  for (;;) {
+    pause_point(server);
+    int timeout = server_session_timer_wait(&server->shard, server_session_clock());
+    int number_of_events = epoll_wait(server->epoll_fd, events, MAXIMUM_EVENTS, timeout);
+    if (number_of_events < 0 && errno != EINTR) {
+      fprintf(stderr, "epoll_wait failed: %s\n", strerror(errno));
+      break;
+    }
+    // the wheel's clock is what new deadlines count from, so it is brought up to date before any event
+    server_session_t *session = server_session_run_timers(&server->shard, server_session_clock());
+    while (session != NULL) {
+      server_session_t *next = session->next_timed_out;
+      close_session(server, slab_handle_of(server->sessions, session), session);
+      session = next;
+    }
+    for (int i = 0; i < number_of_events; i++) {
+      if (events[i].data.u64 == SLAB_INVALID_HANDLE) {
+        accept_sessions(server);
+      } else if (events[i].data.u64 == WAKE_HANDLE) {
+        drain_wake(server);
+      } else {
+        handle_session_event(server, events[i].data.u64, events[i].events);
+      }
+    }
+  }
+  return NULL;
+}
+
+static bool start_reactor(game_server_t *server, uint16_t port, game_server_backend_t backend) {
+  server->listen_fd = open_listener(port);
+  if (server->listen_fd < 0) {
+    fprintf(stderr, "Could not listen on port %d: %s\n", port, strerror(errno));
+    return false;
+  }
+  server->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (server->wake_fd < 0) {
+    fprintf(stderr, "Could not create an eventfd: %s\n", strerror(errno));
+    return false;
+  }
+  if (backend == GAME_SERVER_BACKEND_IO_URING) {
+    server->uring = uring_reactor_create(server->listen_fd, server->wake_fd, server->maximum_sessions, &server->shard);
+    if (server->uring != NULL) {
+      server->sessions = uring_reactor_get_sessions(server->uring);
+      return pthread_create(&server->thread, NULL, run_reactor, server) == 0;
+    }
+    fprintf(stderr, "io_uring is not available, falling back to epoll\n");
+  }
+  server->sessions = slab_create("epoll sessions", sizeof(server_session_t), server->maximum_sessions);
+  if (server->sessions == NULL) {
+    fprintf(stderr, "Could not reserve memory for %zu sessions\n", server->maximum_sessions);
+    return false;
+  }
+  server->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  // the listener is the only registration with the invalid handle
+  struct epoll_event listen_event = {.events = EPOLLIN, .data.u64 = SLAB_INVALID_HANDLE};
+  struct epoll_event wake_event = {.events = EPOLLIN, .data.u64 = WAKE_HANDLE};
+  if (server->epoll_fd < 0 || epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->listen_fd, &listen_event) < 0 ||
+      epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, server->wake_fd, &wake_event) < 0) {
+    fprintf(stderr, "Could not set up epoll: %s\n", strerror(errno));
+    return false;
+  }
+  return pthread_create(&server->thread, NULL, run_reactor, server) == 0;
+}
+
+// reads every reactor's counters without stopping them, each value is exact for its own reactor
+static void merge_stats(const game_server_t servers[], size_t number_of_reactors, server_session_stats_t *stats) {
+  memset(stats, 0, sizeof(*stats));
+  for (size_t i = 0; i < number_of_reactors; i++) {
+    const server_session_stats_t *reactor_stats = &servers[i].shard.stats;
+    stats->sessions_accepted += __atomic_load_n(&reactor_stats->sessions_accepted, __ATOMIC_RELAXED);
+    stats->sessions_refused += __atomic_load_n(&reactor_stats->sessions_refused, __ATOMIC_RELAXED);
+    stats->sessions_closed += __atomic_load_n(&reactor_stats->sessions_closed, __ATOMIC_RELAXED);
+    stats->games_started += __atomic_load_n(&reactor_stats->games_started, __ATOMIC_RELAXED);
+    stats->games_won += __atomic_load_n(&reactor_stats->games_won, __ATOMIC_RELAXED);
+    stats->guesses += __atomic_load_n(&reactor_stats->guesses, __ATOMIC_RELAXED);
+    stats->errors += __atomic_load_n(&reactor_stats->errors, __ATOMIC_RELAXED);
+    stats->idle_timeouts += __atomic_load_n(&reactor_stats->idle_timeouts, __ATOMIC_RELAXED);
+    stats->move_timeouts += __atomic_load_n(&reactor_stats->move_timeouts, __ATOMIC_RELAXED);
+  }
+}
+
+static void print_stats(const game_server_t servers[], size_t number_of_reactors, const game_journal_t *journal) {
+  server_session_stats_t stats;
+  merge_stats(servers, number_of_reactors, &stats);
+  printf("reactors %zu, sessions %llu accepted %llu refused %llu open, games %llu started %llu won, "
+         "guesses %llu, errors %llu, timeouts %llu idle %llu move\n", number_of_reactors,
+         (unsigned long long) stats.sessions_accepted, (unsigned long long) stats.sessions_refused,
+         (unsigned long long) (stats.sessions_accepted - stats.sessions_closed),
+         (unsigned long long) stats.games_started, (unsigned long long) stats.games_won,
+         (unsigned long long) stats.guesses, (unsigned long long) stats.errors,
+         (unsigned long long) stats.idle_timeouts, (unsigned long long) stats.move_timeouts);
+  for (size_t i = 0; i < number_of_reactors; i++) {
+    slab_stats_t slab_stats = slab_get_stats(servers[i].sessions);
+    printf("reactor %zu %s: %zu of %zu in use, high water %zu, %llu allocations %llu refused, %zu bytes each, "
+           "%.1f MB reserved\n", i, slab_stats.name, slab_stats.in_use, slab_stats.capacity, slab_stats.high_water,
+           (unsigned long long) slab_stats.allocations, (unsigned long long) slab_stats.exhausted,
+           slab_stats.object_size, (double) slab_stats.memory_reserved / (1024 * 1024));
+  }
+  if (journal != NULL) {
+    game_journal_stats_t journal_stats = game_journal_get_stats(journal);
+    printf("journal: %llu records in %llu commits, %.1f records per commit, largest %llu, %llu failed\n",
+           (unsigned long long) journal_stats.records, (unsigned long long) journal_stats.commits,
+           journal_stats.commits > 0 ? (double) journal_stats.records / (double) journal_stats.commits : 0.0,
+           (unsigned long long) journal_stats.largest_commit, (unsigned long long) journal_stats.failures);
+  }
+  fflush(stdout);
+}
+
+// returns once every reactor is waiting at the barrier, their sessions can then be read from this thread
+static void pause_reactors(game_server_t servers[], size_t number_of_reactors, pause_control_t *pause) {
+  __atomic_store_n(&pause->is_pause_requested, true, __ATOMIC_RELEASE);
+  uint64_t one = 1;
+  for (size_t i = 0; i < number_of_reactors; i++) {
+    if (write(servers[i].wake_fd, &one, sizeof(one)) < 0) {
+      fprintf(stderr, "Could not wake reactor %zu: %s\n", i, strerror(errno));
+    }
+  }
+  pthread_barrier_wait(&pause->barrier);
+}
+
+static void resume_reactors(pause_control_t *pause) {
+  __atomic_store_n(&pause->is_pause_requested, false, __ATOMIC_RELEASE);
+  pthread_barrier_wait(&pause->barrier);
+}
+
+// the reactors must be paused. Games nobody has claimed back from the restored snapshot are carried over
+// unless they would have timed out by now
+static void save_snapshot(const game_server_t servers[], size_t number_of_reactors, const char *path,
+                          const session_snapshot_t *restored) {
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  session_snapshot_writer_t *writer = session_snapshot_writer_create();
+  if (writer == NULL) {
+    fprintf(stderr, "Could not allocate a snapshot\n");
+    return;
+  }
+  uint32_t random_states[GAME_SERVER_MAXIMUM_REACTORS];
+  bool is_saved = true;
+  for (size_t i = 0; i < number_of_reactors; i++) {
+    random_states[i] = servers[i].shard.random_state;
+    slab_stats_t slab_stats = slab_get_stats(servers[i].sessions);
+    for (size_t index = 0; index < slab_stats.capacity; index++) {
+      // both backends keep the server_session_t at the start of their slab objects
+      const server_session_t *session = slab_object_at(servers[i].sessions, index);
+      if (session == NULL) {
+        continue;
+      }
+      session_snapshot_game_t games[SERVER_SESSION_MAXIMUM_GAMES];
+      size_t number_of_games = server_session_save(session, games);
+      for (size_t game = 0; game < number_of_games; game++) {
+        is_saved = is_saved && session_snapshot_writer_add(writer, &games[game]);
+      }
+    }
+  }
+  session_snapshot_writer_set_random_states(writer, random_states, number_of_reactors);
+  if (restored != NULL) {
+    is_saved = is_saved && session_snapshot_add_unclaimed(restored, writer, servers[0].shard.idle_timeout);
+  }
+  is_saved = is_saved && session_snapshot_writer_commit(writer, path);
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  if (is_saved) {
+    printf("Saved %zu games to %s in %.1f ms\n", session_snapshot_writer_number_of_games(writer), path,
+           (double) (end.tv_sec - start.tv_sec) * 1e3 + (double) (end.tv_nsec - start.tv_nsec) / 1e6);
+  } else {
+    fprintf(stderr, "Could not save the snapshot to %s: %s\n", path, strerror(errno));
+  }
+  fflush(stdout);
+  session_snapshot_writer_destroy(writer);
+}
+
+// the games in play when the journal ends are rebuilt into a snapshot so they are resumed like saved ones,
+// the journal is more recent than any snapshot. Returns the snapshot path to restore from
+static const char* recover_journal(const game_server_options_t *options, char recovered_path[]) {
+  const char *path = options->snapshot_path;
+  if (path == NULL) {
+    snprintf(recovered_path, PATH_SIZE, "%s.recovered", options->journal_path);
+    path = recovered_path;
+  }
+  session_snapshot_writer_t *writer = session_snapshot_writer_create();
+  game_journal_recovery_t recovery;
+  if (writer == NULL || !game_journal_recover(options->journal_path, writer, game_journal_clock(),
+                                               options->idle_seconds * 1000, &recovery) ||
+      !session_snapshot_writer_commit(writer, path)) {
+    fprintf(stderr, "Could not recover the games in %s\n", options->journal_path);
+    session_snapshot_writer_destroy(writer);
+    return options->snapshot_path;
+  }
+  session_snapshot_writer_destroy(writer);
+  printf("Recovered %llu of %llu games in play from %llu journal records, %llu torn bytes dropped\n",
+         (unsigned long long) recovery.games_recovered, (unsigned long long) recovery.games_in_progress,
+         (unsigned long long) recovery.records, (unsigned long long) recovery.torn_bytes);
+  return path;
+}
+
+int game_server_main(uint16_t port, size_t number_of_reactors, game_server_backend_t backend,
+                     game_server_options_t options) {
+  if (number_of_reactors == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    number_of_reactors = online > 0 ? (size_t) online : 1;
+  }
+  if (number_of_reactors > GAME_SERVER_MAXIMUM_REACTORS) {
+    number_of_reactors = GAME_SERVER_MAXIMUM_REACTORS;
+  }
+  raise_descriptor_limit();
+  game_server_t *servers = NULL;
+  if (posix_memalign((void **) &servers, CACHE_LINE_SIZE, number_of_reactors * sizeof(game_server_t)) != 0) {
+    return EXIT_FAILURE;
+  }
+  memset(servers, 0, number_of_reactors * sizeof(game_server_t));
+
+  // the reactors inherit the blocked signals so only this thread waits for them
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGUSR1);
+  sigaddset(&signals, SIGUSR2);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+  // games restored from the snapshot are claimed lazily by their tokens, so startup does not depend on its size
+  char recovered_path[PATH_SIZE];
+  const char *restore_path = options.snapshot_path;
+  game_journal_t *journal = NULL;
+  if (options.journal_path != NULL) {
+    restore_path = recover_journal(&options, recovered_path);
+    journal = game_journal_open(options.journal_path, options.journal, number_of_reactors);
+    if (journal == NULL) {
+      fprintf(stderr, "Could not open the journal %s: %s\n", options.journal_path, strerror(errno));
+      return EXIT_FAILURE;
+    }
+  }
+  session_snapshot_t *restored = NULL;
+  if (restore_path != NULL) {
+    restored = session_snapshot_open(restore_path);
+    if (restored != NULL) {
+      printf("Restored %zu games from %s\n", session_snapshot_number_of_games(restored), restore_path);
+    }
+  }
+  pause_control_t pause = {.is_pause_requested = false};
+  pthread_barrier_init(&pause.barrier, NULL, (unsigned) number_of_reactors + 1);
+
+  uint32_t seed = (uint32_t) time(NULL);
+  uint64_t first_game_id = game_journal_clock() << GAME_ID_TIME_SHIFT;
+  for (size_t i = 0; i < number_of_reactors; i++) {
+    servers[i].maximum_sessions = GAME_SERVER_MAXIMUM_SESSIONS / number_of_reactors;
+    servers[i].pause = &pause;
+    servers[i].shard.restored = restored;
+    servers[i].shard.journal = journal != NULL ? game_journal_get_writer(journal, i) : NULL;
+    servers[i].shard.next_game_id = first_game_id + i;
+    servers[i].shard.game_id_stride = (uint32_t) number_of_reactors;
+    // distinct non zero streams per reactor, carried on from the snapshot when it has one
+    uint32_t restored_state = restored != NULL ? session_snapshot_random_state(restored, i) : 0;
+    servers[i].shard.random_state = restored_state != 0 ? restored_state : (seed ^ (uint32_t)((i + 1) * 0x9E3779B9u)) | 1u;
+    servers[i].shard.timers = timer_wheel_create(server_session_clock());
+    if (servers[i].shard.timers == NULL) {
+      return EXIT_FAILURE;
+    }
+    servers[i].shard.idle_timeout = options.idle_seconds * 1000;
+    servers[i].shard.move_timeout = options.move_seconds * 1000;
+    if (!start_reactor(&servers[i], port, backend)) {
+      return EXIT_FAILURE;
+    }
+  }
+  size_t number_of_uring_reactors = 0;
+  for (size_t i = 0; i < number_of_reactors; i++) {
+    number_of_uring_reactors += servers[i].uring != NULL;
+  }
+  printf("Serving games on 127.0.0.1:%d with %zu reactors, %zu on io_uring\n", port, number_of_reactors,
+         number_of_uring_reactors);
+  fflush(stdout);
+
+  for (;;) {
+    int signal_number;
+    if (sigwait(&signals, &signal_number) != 0) {
+      continue;
+    }
+    bool is_stopping = signal_number == SIGINT || signal_number == SIGTERM;
+    if (signal_number == SIGUSR2 && options.snapshot_path != NULL) {
+      pause_reactors(servers, number_of_reactors, &pause);
+      save_snapshot(servers, number_of_reactors, options.snapshot_path, restored);
+      resume_reactors(&pause);
+    }
+    if (signal_number == SIGUSR1) {
+      print_stats(servers, number_of_reactors, journal);
+    }
+    if (is_stopping) {
+      // stopped reactors are left waiting at the barrier until the process exits
+      if (options.snapshot_path != NULL || journal != NULL) {
+        pause_reactors(servers, number_of_reactors, &pause);
+      }
+      if (options.snapshot_path != NULL) {
+        save_snapshot(servers, number_of_reactors, options.snapshot_path, restored);
+      }
+      if (journal != NULL) {
+        game_journal_sync(journal);
+      }
+      print_stats(servers, number_of_reactors, journal);
+      if (journal != NULL) {
+        game_journal_close(journal);
+      }
+      break;
+    }
+  }
+  // sessions are left for the os to clean up, the reactors never return on their own
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
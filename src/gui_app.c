@@ -8,6 +8,7 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include "game_logic.h"
+#include "multi_board.h"
 
 #define SDL_COLOUR(colour) (((colour) >> 3 * 8) & 0xFF), (((colour) >> 2 * 8) & 0xFF), (((colour) >> 1 * 8) & 0xFF), (((colour) >> 0 * 8) & 0xFF)
 #define BACKGROUND_COLOUR 0x1E1E1EFF
@@ -22,6 +23,10 @@
 #define PADDING 20
 #define SMALL_PADDING 5
 #define MAXIMUM_NUMBER_OF_TRIES 8
+#define REFUSAL_SIZE 64
+#define MULTI_BOARD_COLUMNS 8
+#define MULTI_BOARD_MAXIMUM_CELL 12
+#define MULTI_BOARD_MAXIMUM_TRIES (MULTI_BOARD_MAXIMUM_BOARDS + MULTI_BOARD_EXTRA_TRIES)
 
 typedef enum {
   RED = 0,
@@ -132,11 +137,30 @@ static circle_t* check_mouse_click(int x, int y) {
   return NULL;
 }
 
-int gui_main(void) {
+// names the earlier guess whose clue a refused hard mode guess breaks, as the console does
+static SDL_Surface* render_refusal(TTF_Font *font, const game_logic_move_t history[], size_t tries,
+                                   const game_logic_values_t guess[]) {
+  char refusal[REFUSAL_SIZE] = "Must fit clues!";
+  size_t move = game_logic_find_contradicted_move(history, tries, guess);
+  if (move < tries) {
+    snprintf(refusal, sizeof(refusal), "Guess %zu rules it out!", move + 1);
+  }
+  SDL_Surface *surface = TTF_RenderText_Solid(font, refusal, (SDL_Colour) {SDL_COLOUR(FOREGROUND_COLOUR)});
+  error_check(surface == NULL, "TTF failed to render text!");
+  return surface;
+}
+
+int gui_main(game_mode_t mode, bool is_hard_mode) {
+  const game_mode_codemaker_t *codemaker = game_mode_get_codemaker(mode);
   srand(time(NULL));
-  game_logic_generate_random_answer();
+  codemaker->start();
+  // only the consistent set is used, the codemaker keeps its own answer
+  game_logic_context_t hard_mode_context;
+  game_logic_context_start(&hard_mode_context, is_hard_mode);
   game_logic_feedback_t feedback = {0};
   game_logic_values_t game_buffer[NUMBER_OF_VALUES_TO_GUESS] = {0};
+  game_logic_move_t history[MAXIMUM_NUMBER_OF_TRIES];
+  size_t tries = 0;
 
   init_circles();
 
@@ -166,6 +190,10 @@ int gui_main(void) {
   SDL_Texture *lose_text_texture = SDL_CreateTextureFromSurface(renderer, lose_text_surface);
   error_check(lose_text_texture == NULL, "failed to create text texture from surface!");
 
+  // shown in place of submit when hard mode refuses a guess, until the guess is changed
+  SDL_Surface *hard_mode_text_surface = NULL;
+  SDL_Texture *hard_mode_text_texture = NULL;
+
   SDL_Texture *active_text_texture = submit_text_texture;
   int text_x = guess_sets[active_idx].result[1].x + SMALL_CIRCLE_DIAMETER + 4 * PADDING;
   SDL_Rect text_dest = {text_x, (guess_sets[active_idx].result[0].y - SMALL_PADDING), submit_text_surface->w, submit_text_surface->h};
@@ -192,7 +220,7 @@ int gui_main(void) {
       if (draw_answer) {
         for (int i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
           circle_t circle = {
-            .colour = (colour_label_t) game_logic_get_answer()[i],
+            .colour = (colour_label_t) codemaker->get_answer()[i],
             .islarge = true,
             .x = guess_sets[MAXIMUM_NUMBER_OF_TRIES - 1].guess[i].x,
             .y = guess_sets[MAXIMUM_NUMBER_OF_TRIES - 1].guess[i].y + LARGE_CIRCLE_DIAMETER + PADDING
@@ -219,6 +247,8 @@ int gui_main(void) {
             if (circle != NULL) {
               redraw = true;
               circle->colour = ((int)circle->colour + 1) % COLOUR_COUNT;
+              active_text_texture = submit_text_texture;
+              text_dest.w = submit_text_surface->w;
             }
             if (SDL_PointInRect(&(SDL_Point) {e.button.x, e.button.y}, &text_dest)) {
               bool is_selection_valid = true;
@@ -230,7 +260,23 @@ int gui_main(void) {
               for (int i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
                 game_buffer[i] = (game_logic_values_t) guess_sets[active_idx].guess[i].colour;
               }
-              feedback = game_logic_get_feedback(game_buffer);
+              if (is_hard_mode && !game_logic_context_is_consistent(&hard_mode_context, game_buffer)) {
+                // the refusal names a different guess each time, the last one is replaced
+                if (hard_mode_text_texture != NULL) {
+                  SDL_FreeSurface(hard_mode_text_surface);
+                  SDL_DestroyTexture(hard_mode_text_texture);
+                }
+                hard_mode_text_surface = render_refusal(font, history, tries, game_buffer);
+                hard_mode_text_texture = SDL_CreateTextureFromSurface(renderer, hard_mode_text_surface);
+                error_check(hard_mode_text_texture == NULL, "failed to create text texture from surface!");
+                active_text_texture = hard_mode_text_texture;
+                text_dest.w = hard_mode_text_surface->w;
+                break;
+              }
+              feedback = codemaker->get_feedback(game_buffer);
+              game_logic_context_record_move(&hard_mode_context, game_buffer, feedback);
+              memcpy(history[tries].guess, game_buffer, sizeof(history[tries].guess));
+              history[tries++].feedback = feedback;
               for (int i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
                 if (feedback.number_of_correct_value_and_placement > 0) {
                   feedback.number_of_correct_value_and_placement--;
@@ -269,5 +315,187 @@ int gui_main(void) {
   TTF_Quit();
   SDL_Quit();
 
+  return EXIT_SUCCESS;
+}
+
+static void draw_square(SDL_Renderer *renderer, int x, int y, int size, int colour) {
+  SDL_Rect square = {x, y, size, size};
+  error_check(SDL_SetRenderDrawColor(renderer, SDL_COLOUR(colour)) < 0, "Render draw colour error!");
+  error_check(SDL_RenderFillRect(renderer, &square) < 0, "Render fill rect error!");
+}
+
+static SDL_Texture* create_text_texture(SDL_Renderer *renderer, TTF_Font *font, const char *text, SDL_Rect *size) {
+  SDL_Surface *surface = TTF_RenderText_Solid(font, text, (SDL_Colour) {SDL_COLOUR(FOREGROUND_COLOUR)});
+  error_check(surface == NULL, "TTF failed to render text!");
+  SDL_Texture *texture = SDL_CreateTextureFromSurface(renderer, surface);
+  error_check(texture == NULL, "failed to create text texture from surface!");
+  size->w = surface->w;
+  size->h = surface->h;
+  SDL_FreeSurface(surface);
+  return texture;
+}
+
+int gui_multi_board_main(size_t number_of_boards) {
+  srand(time(NULL));
+  multi_board_game_t game;
+  multi_board_start(&game, number_of_boards);
+  int maximum_number_of_tries = (int) multi_board_get_maximum_number_of_tries(&game);
+  int number_of_tries = 0;
+  game_logic_values_t guesses[MULTI_BOARD_MAXIMUM_TRIES][NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_feedback_t feedback[MULTI_BOARD_MAXIMUM_TRIES][MULTI_BOARD_MAXIMUM_BOARDS];
+  // the try on which each board was solved, boards stop drawing rows after it
+  int solved_on_try[MULTI_BOARD_MAXIMUM_BOARDS];
+  for (size_t board = 0; board < game.number_of_boards; board++) {
+    solved_on_try[board] = maximum_number_of_tries;
+  }
+
+  circle_t input_row[NUMBER_OF_VALUES_TO_GUESS];
+  int input_offset_width = SCREEN_WIDTH / 2 - (NUMBER_OF_VALUES_TO_GUESS * (LARGE_CIRCLE_DIAMETER + PADDING)) / 2 - 2 * PADDING;
+  for (int i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    input_row[i] = (circle_t) {
+      .x = i * (LARGE_CIRCLE_DIAMETER + PADDING) + input_offset_width,
+      .y = PADDING,
+      .colour = NONE,
+      .islarge = true
+    };
+  }
+
+  // every board shows its rows of guess and feedback squares, sized to fit the longest possible game
+  int board_rows = ((int) game.number_of_boards + MULTI_BOARD_COLUMNS - 1) / MULTI_BOARD_COLUMNS;
+  int board_top = LARGE_CIRCLE_DIAMETER + 2 * PADDING;
+  int board_width = SCREEN_WIDTH / MULTI_BOARD_COLUMNS;
+  int board_height = (SCREEN_HEIGHT - board_top) / board_rows;
+  int cell = (board_height - PADDING) / maximum_number_of_tries;
+  if (cell > MULTI_BOARD_MAXIMUM_CELL) {
+    cell = MULTI_BOARD_MAXIMUM_CELL;
+  }
+  if (cell > (board_width - SMALL_PADDING) / (2 * NUMBER_OF_VALUES_TO_GUESS + 1)) {
+    cell = (board_width - SMALL_PADDING) / (2 * NUMBER_OF_VALUES_TO_GUESS + 1);
+  }
+  int square = cell > 1 ? cell - 1 : 1;
+
+  SDL_Window *window = NULL;
+  SDL_Renderer *renderer = NULL;
+  TTF_Font *font = NULL;
+
+  error_check(SDL_Init(SDL_INIT_VIDEO) < 0, "SDL could not initialize!");
+  error_check(TTF_Init() < 0, "TTF could not initialize!");
+  error_check(SDL_CreateWindowAndRenderer(SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN, &window, &renderer) < 0, "window could not be created!");
+
+  font = TTF_OpenFont("./Roboto-Medium.ttf", 36);
+  error_check(font == NULL, "TTF failed to load font!");
+
+  SDL_Rect text_dest = {input_row[NUMBER_OF_VALUES_TO_GUESS - 1].x + LARGE_CIRCLE_DIAMETER + 2 * PADDING, PADDING, 0, 0};
+  SDL_Texture *submit_text_texture = create_text_texture(renderer, font, "Submit", &text_dest);
+  SDL_Texture *win_text_texture = create_text_texture(renderer, font, "You Win!", &(SDL_Rect) {0});
+  SDL_Texture *lose_text_texture = create_text_texture(renderer, font, "You Lose!", &(SDL_Rect) {0});
+
+  SDL_Texture *active_text_texture = submit_text_texture;
+
+  SDL_Event e;
+  bool game_active = true;
+  bool redraw = true;
+  bool quit = false;
+  while (quit == false) {
+    if (redraw) {
+      error_check(SDL_SetRenderDrawColor(renderer, SDL_COLOUR(BACKGROUND_COLOUR)) < 0, "Render draw colour error!");
+      error_check(SDL_RenderClear(renderer) < 0, "Render clear error!");
+
+      for (int i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+        draw_circle(renderer, &input_row[i]);
+      }
+
+      for (size_t board = 0; board < game.number_of_boards; board++) {
+        int x = (int)(board % MULTI_BOARD_COLUMNS) * board_width + SMALL_PADDING;
+        int y = (int)(board / MULTI_BOARD_COLUMNS) * board_height + board_top;
+        for (int try = 0; try < number_of_tries && try <= solved_on_try[board]; try++) {
+          int row_y = y + try * cell;
+          for (int i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+            draw_square(renderer, x + i * cell, row_y, square, colour_choices[guesses[try][i]]);
+          }
+          uint8_t placed = feedback[try][board].number_of_correct_value_and_placement;
+          uint8_t value_only = feedback[try][board].number_of_correct_value_only;
+          for (int i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+            int colour = i < placed ? colour_choices[GREEN] : i < placed + value_only ? colour_choices[ORANGE] : (int) FOREGROUND_COLOUR;
+            draw_square(renderer, x + (NUMBER_OF_VALUES_TO_GUESS + 1 + i) * cell, row_y, square, colour);
+          }
+        }
+        if (!game_active && solved_on_try[board] == maximum_number_of_tries) {
+          game_logic_values_t answer[NUMBER_OF_VALUES_TO_GUESS];
+          game_logic_unpack_code(game.answers[board], answer);
+          for (int i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+            draw_square(renderer, x + i * cell, y + number_of_tries * cell + SMALL_PADDING, square, colour_choices[answer[i]]);
+          }
+        }
+      }
+
+      error_check(SDL_RenderCopy(renderer, active_text_texture, NULL, &text_dest) < 0, "Render copy error!");
+
+      SDL_RenderPresent(renderer);
+      redraw = false;
+    }
+
+    if (SDL_WaitEvent(&e)) {
+      switch (e.type) {
+      case SDL_QUIT:
+        quit = true;
+        break;
+      case SDL_MOUSEBUTTONUP:
+        if (!game_active || e.button.button != SDL_BUTTON_LEFT) {
+          break;
+        }
+        for (int i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+          int dy = e.button.y - (input_row[i].y + LARGE_CIRCLE_RADIUS);
+          int dx = e.button.x - (input_row[i].x + LARGE_CIRCLE_RADIUS);
+          if (dx*dx + dy*dy < LARGE_CIRCLE_RADIUS*LARGE_CIRCLE_RADIUS) {
+            redraw = true;
+            input_row[i].colour = ((int)input_row[i].colour + 1) % COLOUR_COUNT;
+          }
+        }
+        if (SDL_PointInRect(&(SDL_Point) {e.button.x, e.button.y}, &text_dest)) {
+          bool is_selection_valid = true;
+          for (int i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+            if (input_row[i].colour == NONE) {
+              is_selection_valid = false;
+            }
+          }
+          if (!is_selection_valid) {
+            break;
+          }
+          redraw = true;
+          for (int i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+            guesses[number_of_tries][i] = (game_logic_values_t) input_row[i].colour;
+          }
+          multi_board_get_feedback(&game, guesses[number_of_tries], feedback[number_of_tries]);
+          for (size_t board = 0; board < game.number_of_boards; board++) {
+            if (feedback[number_of_tries][board].is_guess_correct && solved_on_try[board] > number_of_tries) {
+              solved_on_try[board] = number_of_tries;
+            }
+          }
+          number_of_tries++;
+          if (multi_board_is_solved(&game)) {
+            active_text_texture = win_text_texture;
+            game_active = false;
+          } else if (number_of_tries == maximum_number_of_tries) {
+            active_text_texture = lose_text_texture;
+            game_active = false;
+          }
+        }
+        break;
+      default:
+        break;
+      }
+    }
+  }
+
+  SDL_DestroyTexture(submit_text_texture);
+  SDL_DestroyTexture(win_text_texture);
+  SDL_DestroyTexture(lose_text_texture);
+  SDL_DestroyRenderer(renderer);
+  SDL_DestroyWindow(window);
+  TTF_CloseFont(font);
+  TTF_Quit();
+  SDL_Quit();
+
   return EXIT_SUCCESS;
 }
\ No newline at end of file
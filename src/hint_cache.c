@@ -0,0 +1,221 @@
+#include "hint_cache.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#define NUMBER_OF_STRIPES 16
+#define NUMBER_OF_WAYS 8
+#define FNV_OFFSET_BASIS 0xCBF29CE484222325ULL
+#define FNV_PRIME 0x100000001B3ULL
+
+// histories are stored after relabelling colours in order of first appearance,
+// so games that only differ in colour labelling share one entry
+typedef struct {
+  game_logic_code_t guesses[HINT_CACHE_MAXIMUM_HISTORY_LENGTH];
+  uint8_t feedback_classes[HINT_CACHE_MAXIMUM_HISTORY_LENGTH];
+  uint8_t length;
+} canonical_key_t;
+
+typedef struct {
+  uint64_t hash;
+  canonical_key_t key;
+  solver_hint_t hint;
+  bool is_occupied;
+  bool is_referenced;
+} entry_t;
+
+typedef struct {
+  entry_t ways[NUMBER_OF_WAYS];
+  uint8_t clock_hand;
+} set_t;
+
+typedef struct {
+  pthread_mutex_t lock;
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t insertions;
+  uint64_t evictions;
+} stripe_t;
+
+struct hint_cache {
+  stripe_t stripes[NUMBER_OF_STRIPES];
+  set_t *sets;
+  size_t number_of_sets;
+};
+
+static uint64_t canonicalise(const game_logic_move_t history[], size_t history_length,
+                             canonical_key_t *key, game_logic_values_t original_value[GAME_VALUE_MAX]) {
+  int_fast8_t canonical_value[GAME_VALUE_MAX];
+  memset(canonical_value, -1, sizeof(canonical_value));
+  uint_fast8_t next_label = 0;
+
+  memset(key, 0, sizeof(*key));
+  key->length = (uint8_t) history_length;
+  for (size_t i = 0; i < history_length; i++) {
+    game_logic_values_t relabelled[NUMBER_OF_VALUES_TO_GUESS];
+    for (uint_fast8_t j = 0; j < NUMBER_OF_VALUES_TO_GUESS; j++) {
+      game_logic_values_t value = history[i].guess[j];
+      if (canonical_value[value] < 0) {
+        original_value[next_label] = value;
+        canonical_value[value] = (int_fast8_t) next_label++;
+      }
+      relabelled[j] = (game_logic_values_t) canonical_value[value];
+    }
+    key->guesses[i] = game_logic_pack_code(relabelled);
+    key->feedback_classes[i] = game_logic_feedback_to_class(history[i].feedback);
+  }
+
+  // colours never guessed are interchangeable, hand them the remaining labels in order
+  for (uint_fast8_t value = 0; value < GAME_VALUE_MAX; value++) {
+    if (canonical_value[value] < 0) {
+      original_value[next_label] = (game_logic_values_t) value;
+      canonical_value[value] = (int_fast8_t) next_label++;
+    }
+  }
+
+  uint64_t hash = FNV_OFFSET_BASIS;
+  const uint8_t *bytes = (const uint8_t *) key;
+  for (size_t i = 0; i < sizeof(*key); i++) {
+    hash = (hash ^ bytes[i]) * FNV_PRIME;
+  }
+  return hash;
+}
+
+static game_logic_code_t restore_labels(game_logic_code_t canonical_code, const game_logic_values_t original_value[GAME_VALUE_MAX]) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_unpack_code(canonical_code, values);
+  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    values[i] = original_value[values[i]];
+  }
+  return game_logic_pack_code(values);
+}
+
+static entry_t* find_entry(set_t *set, uint64_t hash, const canonical_key_t *key) {
+  for (uint_fast8_t i = 0; i < NUMBER_OF_WAYS; i++) {
+    entry_t *entry = &set->ways[i];
+    if (entry->is_occupied && entry->hash == hash && memcmp(&entry->key, key, sizeof(*key)) == 0) {
+      return entry;
+    }
+  }
+  return NULL;
+}
+
+// second chance sweep, referenced entries get their bit cleared and are skipped once
+static entry_t* claim_entry(set_t *set, bool *is_eviction) {
+  for (uint_fast8_t i = 0; i < NUMBER_OF_WAYS; i++) {
+    if (!set->ways[i].is_occupied) {
+      *is_eviction = false;
+      return &set->ways[i];
+    }
+  }
+  while (set->ways[set->clock_hand].is_referenced) {
+    set->ways[set->clock_hand].is_referenced = false;
+    set->clock_hand = (set->clock_hand + 1) % NUMBER_OF_WAYS;
+  }
+  entry_t *victim = &set->ways[set->clock_hand];
+  set->clock_hand = (set->clock_hand + 1) % NUMBER_OF_WAYS;
+  *is_eviction = true;
+  return victim;
+}
+
+hint_cache_t* hint_cache_create(size_t memory_budget) {
+  if (memory_budget < sizeof(hint_cache_t) + sizeof(set_t)) {
+    return NULL;
+  }
+  hint_cache_t *cache = malloc(sizeof(hint_cache_t));
+  if (cache == NULL) {
+    return NULL;
+  }
+  cache->number_of_sets = (memory_budget - sizeof(hint_cache_t)) / sizeof(set_t);
+  cache->sets = calloc(cache->number_of_sets, sizeof(set_t));
+  if (cache->sets == NULL) {
+    free(cache);
+    return NULL;
+  }
+  for (size_t i = 0; i < NUMBER_OF_STRIPES; i++) {
+    stripe_t *stripe = &cache->stripes[i];
+    pthread_mutex_init(&stripe->lock, NULL);
+    stripe->hits = stripe->misses = stripe->insertions = stripe->evictions = 0;
+  }
+  return cache;
+}
+
+void hint_cache_destroy(hint_cache_t *cache) {
+  if (cache == NULL) {
+    return;
+  }
+  for (size_t i = 0; i < NUMBER_OF_STRIPES; i++) {
+    pthread_mutex_destroy(&cache->stripes[i].lock);
+  }
+  free(cache->sets);
+  free(cache);
+}
+
+solver_hint_t hint_cache_get_hint(hint_cache_t *cache, const game_logic_move_t history[], size_t history_length) {
+  if (history_length > HINT_CACHE_MAXIMUM_HISTORY_LENGTH) {
+    return solver_get_hint(history, history_length);
+  }
+
+  canonical_key_t key;
+  game_logic_values_t original_value[GAME_VALUE_MAX];
+  uint64_t hash = canonicalise(history, history_length, &key, original_value);
+  size_t set_index = (size_t)(hash % cache->number_of_sets);
+  set_t *set = &cache->sets[set_index];
+  stripe_t *stripe = &cache->stripes[set_index % NUMBER_OF_STRIPES];
+
+  pthread_mutex_lock(&stripe->lock);
+  entry_t *entry = find_entry(set, hash, &key);
+  if (entry != NULL) {
+    entry->is_referenced = true;
+    solver_hint_t hint = entry->hint;
+    stripe->hits++;
+    pthread_mutex_unlock(&stripe->lock);
+    hint.best_guess = restore_labels(hint.best_guess, original_value);
+    return hint;
+  }
+  stripe->misses++;
+  pthread_mutex_unlock(&stripe->lock);
+
+  // solve outside the lock, the canonical history is a valid history in its own right
+  game_logic_move_t canonical_history[HINT_CACHE_MAXIMUM_HISTORY_LENGTH];
+  for (size_t i = 0; i < history_length; i++) {
+    game_logic_unpack_code(key.guesses[i], canonical_history[i].guess);
+    canonical_history[i].feedback = history[i].feedback;
+  }
+  solver_hint_t hint = solver_get_hint(canonical_history, history_length);
+
+  pthread_mutex_lock(&stripe->lock);
+  if (find_entry(set, hash, &key) == NULL) {
+    bool is_eviction;
+    entry = claim_entry(set, &is_eviction);
+    entry->hash = hash;
+    memcpy(&entry->key, &key, sizeof(key));
+    entry->hint = hint;
+    entry->is_occupied = true;
+    entry->is_referenced = false;
+    stripe->insertions++;
+    stripe->evictions += is_eviction;
+  }
+  pthread_mutex_unlock(&stripe->lock);
+
+  hint.best_guess = restore_labels(hint.best_guess, original_value);
+  return hint;
+}
+
+hint_cache_stats_t hint_cache_get_stats(hint_cache_t *cache) {
+  hint_cache_stats_t stats = {
+    .capacity = cache->number_of_sets * NUMBER_OF_WAYS,
+    .memory_used = sizeof(hint_cache_t) + cache->number_of_sets * sizeof(set_t)
+  };
+  for (size_t i = 0; i < NUMBER_OF_STRIPES; i++) {
+    stripe_t *stripe = &cache->stripes[i];
+    pthread_mutex_lock(&stripe->lock);
+    stats.hits += stripe->hits;
+    stats.misses += stripe->misses;
+    stats.insertions += stripe->insertions;
+    stats.evictions += stripe->evictions;
+    pthread_mutex_unlock(&stripe->lock);
+  }
+  return stats;
+}
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include "large_space.h"
+#include <string.h>
+#include "random.h"
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAXIMUM_SAMPLE_SIZE 1024
+
+game_logic_feedback_t large_space_score(const large_space_variant_t *variant, const large_space_code_t *answer,
+                                        const large_space_code_t *guess) {
+  game_logic_feedback_t feedback = {0};
+  uint_fast8_t answer_bins[LARGE_SPACE_MAXIMUM_VALUES] = {0};
+  uint_fast8_t guess_bins[LARGE_SPACE_MAXIMUM_VALUES] = {0};
+
+  for (uint_fast8_t i = 0; i < variant->number_of_pegs; i++) {
+    answer_bins[answer->values[i]]++;
+    guess_bins[guess->values[i]]++;
+    if (guess->values[i] == answer->values[i]) {
+      feedback.number_of_correct_value_and_placement++;
+    }
+  }
+
+  for (uint_fast8_t i = 0; i < variant->number_of_values; i++) {
+    feedback.number_of_correct_value_only += MIN(guess_bins[i], answer_bins[i]);
+  }
+
+  feedback.number_of_correct_value_only -= feedback.number_of_correct_value_and_placement;
+  feedback.is_guess_correct = (bool)(feedback.number_of_correct_value_and_placement == variant->number_of_pegs);
+  return feedback;
+}
+
+// xorshift32 when the caller owns a stream, so threads never share rand()
+static uint32_t next_random(uint32_t *random_state) {
+  if (random_state == NULL) {
+    return (uint32_t) random_value();
+  }
+  uint32_t x = *random_state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *random_state = x;
+}
+
+static void random_code(const large_space_variant_t *variant, uint32_t *random_state, large_space_code_t *code) {
+  memset(code, 0, sizeof(*code));
+  for (uint_fast8_t i = 0; i < variant->number_of_pegs; i++) {
+    code->values[i] = (uint8_t)(next_random(random_state) % variant->number_of_values);
+  }
+}
+
+void large_space_random_code(const large_space_variant_t *variant, large_space_code_t *code) {
+  random_code(variant, NULL, code);
+}
+
+static void shuffle_values(large_space_enumerator_t *enumerator, int depth) {
+  uint8_t *order = enumerator->value_order[depth];
+  for (uint_fast8_t i = 0; i < enumerator->variant.number_of_values; i++) {
+    order[i] = (uint8_t) i;
+  }
+  if (!enumerator->is_randomised) {
+    return;
+  }
+  for (uint_fast8_t i = enumerator->variant.number_of_values - 1; i > 0; i--) {
+    uint_fast8_t j = (uint_fast8_t)(next_random(enumerator->random_state) % (i + 1));
+    uint8_t swap = order[i];
+    order[i] = order[j];
+    order[j] = swap;
+  }
+}
+
+static bool init_enumerator(large_space_enumerator_t *enumerator, const large_space_variant_t *variant,
+                            const large_space_move_t history[], size_t history_length, bool is_randomised,
+                            uint32_t *random_state) {
+  memset(enumerator, 0, sizeof(*enumerator));
+  if (history_length > LARGE_SPACE_MAXIMUM_HISTORY) {
+    // dropping moves would hand out codes the rest of the history rules out
+    enumerator->is_exhausted = true;
+    return false;
+  }
+  enumerator->variant = *variant;
+  enumerator->history = history;
+  enumerator->history_length = history_length;
+  enumerator->is_randomised = is_randomised;
+  enumerator->random_state = random_state;
+
+  // propagate the moves that rule values out on their own before searching
+  uint16_t all_values = (uint16_t)((1u << variant->number_of_values) - 1);
+  for (uint_fast8_t i = 0; i < variant->number_of_pegs; i++) {
+    enumerator->domains[i] = all_values;
+  }
+  for (size_t m = 0; m < enumerator->history_length; m++) {
+    const large_space_move_t *move = &history[m];
+    uint_fast8_t matched = move->feedback.number_of_correct_value_and_placement + move->feedback.number_of_correct_value_only;
+    for (uint_fast8_t i = 0; i < variant->number_of_pegs; i++) {
+      uint8_t value = move->guess.values[i];
+      enumerator->guess_bins[m][value]++;
+      if (matched == 0) {
+        for (uint_fast8_t j = 0; j < variant->number_of_pegs; j++) {
+          enumerator->domains[j] &= (uint16_t) ~(1u << value);
+        }
+      } else if (move->feedback.number_of_correct_value_and_placement == 0) {
+        enumerator->domains[i] &= (uint16_t) ~(1u << value);
+      }
+    }
+  }
+
+  shuffle_values(enumerator, 0);
+  return true;
+}
+
+bool large_space_enumerator_init(large_space_enumerator_t *enumerator, const large_space_variant_t *variant,
+                                 const large_space_move_t history[], size_t history_length, bool is_randomised) {
+  return init_enumerator(enumerator, variant, history, history_length, is_randomised, NULL);
+}
+
+// true when placing value at the current depth keeps every move reachable
+static bool place_value(large_space_enumerator_t *enumerator, uint8_t value) {
+  int depth = enumerator->depth;
+  uint_fast8_t remaining = (uint_fast8_t)(enumerator->variant.number_of_pegs - depth - 1);
+  for (size_t m = 0; m < enumerator->history_length; m++) {
+    const game_logic_feedback_t *feedback = &enumerator->history[m].feedback;
+    uint_fast8_t target_placed = feedback->number_of_correct_value_and_placement;
+    uint_fast8_t target_matched = target_placed + feedback->number_of_correct_value_only;
+    uint_fast8_t placed = enumerator->placed[depth][m] + (enumerator->history[m].guess.values[depth] == value);
+    uint_fast8_t matched = enumerator->matched[depth][m] + (enumerator->code_bins[value] < enumerator->guess_bins[m][value]);
+    if (placed > target_placed || placed + remaining < target_placed ||
+        matched > target_matched || matched + remaining < target_matched) {
+      return false;
+    }
+    enumerator->placed[depth + 1][m] = (uint8_t) placed;
+    enumerator->matched[depth + 1][m] = (uint8_t) matched;
+  }
+  enumerator->code.values[depth] = value;
+  enumerator->code_bins[value]++;
+  return true;
+}
+
+bool large_space_enumerator_next(large_space_enumerator_t *enumerator, large_space_code_t *code) {
+  const int number_of_pegs = enumerator->variant.number_of_pegs;
+  while (!enumerator->is_exhausted) {
+    if (enumerator->depth == number_of_pegs) {
+      *code = enumerator->code;
+      enumerator->depth--;
+      enumerator->code_bins[enumerator->code.values[enumerator->depth]]--;
+      return true;
+    }
+
+    int depth = enumerator->depth;
+    bool is_placed = false;
+    while (!is_placed && enumerator->next_choice[depth] < enumerator->variant.number_of_values) {
+      uint8_t value = enumerator->value_order[depth][enumerator->next_choice[depth]++];
+      is_placed = ((enumerator->domains[depth] >> value) & 1u) && place_value(enumerator, value);
+    }
+
+    if (is_placed) {
+      enumerator->depth++;
+      if (enumerator->depth < number_of_pegs) {
+        enumerator->next_choice[enumerator->depth] = 0;
+        shuffle_values(enumerator, enumerator->depth);
+      }
+    } else if (depth == 0) {
+      enumerator->is_exhausted = true;
+    } else {
+      enumerator->depth--;
+      enumerator->code_bins[enumerator->code.values[enumerator->depth]]--;
+    }
+  }
+  return false;
+}
+
+static bool add_to_sample(const large_space_variant_t *variant, large_space_code_t sample[], size_t *count,
+                          const large_space_code_t *code) {
+  for (size_t i = 0; i < *count; i++) {
+    if (memcmp(sample[i].values, code->values, variant->number_of_pegs) == 0) {
+      return false;
+    }
+  }
+  sample[(*count)++] = *code;
+  return true;
+}
+
+static size_t sample_codes(const large_space_variant_t *variant, const large_space_move_t history[],
+                           size_t history_length, uint32_t *random_state, large_space_code_t sample[], size_t sample_size) {
+  large_space_enumerator_t enumerator;
+  large_space_code_t code;
+  size_t count = 0;
+
+  if (history_length > LARGE_SPACE_MAXIMUM_HISTORY) {
+    return 0;
+  }
+  if (history_length == 0) {
+    for (size_t attempt = 0; attempt < 2 * sample_size && count < sample_size; attempt++) {
+      random_code(variant, random_state, &code);
+      add_to_sample(variant, sample, &count, &code);
+    }
+    return count;
+  }
+
+  for (size_t attempt = 0; attempt < 2 * sample_size && count < sample_size; attempt++) {
+    init_enumerator(&enumerator, variant, history, history_length, true, random_state);
+    if (!large_space_enumerator_next(&enumerator, &code)) {
+      return 0;
+    }
+    add_to_sample(variant, sample, &count, &code);
+  }
+
+  // repeated draws mean the consistent set is small, a plain enumeration picks up whatever was missed
+  if (count < sample_size) {
+    large_space_enumerator_init(&enumerator, variant, history, history_length, false);
+    while (count < sample_size && large_space_enumerator_next(&enumerator, &code)) {
+      add_to_sample(variant, sample, &count, &code);
+    }
+  }
+  return count;
+}
+
+size_t large_space_sample(const large_space_variant_t *variant, const large_space_move_t history[], size_t history_length,
+                          large_space_code_t sample[], size_t sample_size) {
+  return sample_codes(variant, history, history_length, NULL, sample, sample_size);
+}
+
+bool large_space_best_guess_seeded(const large_space_variant_t *variant, const large_space_move_t history[],
+                                   size_t history_length, size_t sample_size, uint32_t *random_state,
+                                   large_space_code_t *guess) {
+  large_space_code_t sample[MAXIMUM_SAMPLE_SIZE];
+  size_t count = sample_codes(variant, history, history_length, random_state, sample, MIN(sample_size, MAXIMUM_SAMPLE_SIZE));
+  if (count == 0) {
+    return false;
+  }
+
+  const size_t number_of_classes = (size_t)(variant->number_of_pegs + 1) * (variant->number_of_pegs + 1);
+  size_t best_index = 0;
+  uint64_t best_sum_of_squares = UINT64_MAX;
+  for (size_t i = 0; i < count && count > 2; i++) {
+    uint32_t partition_sizes[(LARGE_SPACE_MAXIMUM_PEGS + 1) * (LARGE_SPACE_MAXIMUM_PEGS + 1)];
+    memset(partition_sizes, 0, number_of_classes * sizeof(partition_sizes[0]));
+    uint64_t sum_of_squares = 0;
+    for (size_t j = 0; j < count && sum_of_squares < best_sum_of_squares; j++) {
+      game_logic_feedback_t feedback = large_space_score(variant, &sample[j], &sample[i]);
+      size_t feedback_class = (size_t) feedback.number_of_correct_value_and_placement * (variant->number_of_pegs + 1) +
+                              feedback.number_of_correct_value_only;
+      sum_of_squares += 2 * partition_sizes[feedback_class]++ + 1;
+    }
+    if (sum_of_squares < best_sum_of_squares) {
+      best_sum_of_squares = sum_of_squares;
+      best_index = i;
+    }
+  }
+  *guess = sample[best_index];
+  return true;
+}
+
+bool large_space_best_guess(const large_space_variant_t *variant, const large_space_move_t history[], size_t history_length,
+                            size_t sample_size, large_space_code_t *guess) {
+  return large_space_best_guess_seeded(variant, history, history_length, sample_size, NULL, guess);
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "liar.h"
+#include <math.h>
+#include <stdbool.h>
+
+#define WINNING_CLASS (NUMBER_OF_VALUES_TO_GUESS * (NUMBER_OF_VALUES_TO_GUESS + 1))
+// every reachable non winning class apart from the truth, (placement, value only) pairs
+// summing to at most the number of values, without the win and the impossible (N - 1, 1)
+#define NUMBER_OF_LIE_CLASSES ((NUMBER_OF_VALUES_TO_GUESS + 1) * (NUMBER_OF_VALUES_TO_GUESS + 2) / 2 - 3)
+
+static uint8_t lies_told = 0;
+
+static bool is_reachable_class(uint8_t feedback_class) {
+  game_logic_feedback_t feedback = game_logic_feedback_from_class(feedback_class);
+  uint8_t placed = feedback.number_of_correct_value_and_placement;
+  uint8_t total = placed + feedback.number_of_correct_value_only;
+  return total <= NUMBER_OF_VALUES_TO_GUESS && !(placed == NUMBER_OF_VALUES_TO_GUESS - 1 && total == NUMBER_OF_VALUES_TO_GUESS);
+}
+
+void liar_codemaker_start(void) {
+  game_logic_generate_random_answer();
+  lies_told = 0;
+}
+
+game_logic_feedback_t liar_codemaker_get_feedback(game_logic_values_t guess[]) {
+  game_logic_feedback_t feedback = game_logic_get_feedback(guess);
+  if (feedback.is_guess_correct || lies_told == LIAR_MAXIMUM_LIES ||
+      (random_value() % 1000) >= (int)(LIAR_LIE_PROBABILITY * 1000)) {
+    return feedback;
+  }
+
+  uint8_t true_class = game_logic_feedback_to_class(feedback);
+  uint8_t lie_classes[NUMBER_OF_LIE_CLASSES];
+  uint8_t number_of_lie_classes = 0;
+  for (uint8_t i = 0; i < WINNING_CLASS; i++) {
+    if (i != true_class && is_reachable_class(i)) {
+      lie_classes[number_of_lie_classes++] = i;
+    }
+  }
+  lies_told++;
+  return game_logic_feedback_from_class(lie_classes[random_value() % number_of_lie_classes]);
+}
+
+void liar_solver_init(liar_solver_t *solver, uint8_t maximum_lies, float lie_probability) {
+  for (size_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    solver->weights[i] = 1.0f / NUMBER_OF_POSSIBLE_CODES;
+    solver->lies[i] = 0;
+  }
+  solver->maximum_lies = maximum_lies;
+  solver->lie_probability = lie_probability;
+}
+
+void liar_solver_update(liar_solver_t *solver, const game_logic_values_t guess[], game_logic_feedback_t feedback) {
+  const uint8_t *classes = game_logic_score_row(game_logic_pack_code(guess));
+  const uint8_t feedback_class = game_logic_feedback_to_class(feedback);
+  const float truth_likelihood = 1.0f - solver->lie_probability;
+  const float lie_likelihood = solver->lie_probability / NUMBER_OF_LIE_CLASSES;
+  const uint8_t maximum_lies = solver->maximum_lies;
+  // one past the limit is enough to rule an answer out, counting further would wrap back under it
+  const uint8_t lie_cap = maximum_lies < UINT8_MAX ? (uint8_t)(maximum_lies + 1) : UINT8_MAX;
+  float *weights = solver->weights;
+  uint8_t *lies = solver->lies;
+
+  // branch free so the compiler can keep the whole pass in vector registers
+  float total = 0.0f;
+  for (size_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    uint8_t is_lie = classes[i] != feedback_class;
+    uint8_t can_lie = lies[i] < maximum_lies && classes[i] != WINNING_CLASS && feedback_class != WINNING_CLASS;
+    float truthful = can_lie ? truth_likelihood : 1.0f;
+    float likelihood = is_lie ? (can_lie ? lie_likelihood : 0.0f) : truthful;
+    lies[i] += is_lie & (lies[i] < lie_cap);
+    weights[i] *= likelihood;
+    total += weights[i];
+  }
+
+  if (total > 0.0f) {
+    const float scale = 1.0f / total;
+    for (size_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+      weights[i] *= scale;
+    }
+  }
+}
+
+game_logic_code_t liar_solver_best_guess(const liar_solver_t *solver) {
+  const float lie_share = solver->lie_probability / NUMBER_OF_LIE_CLASSES;
+  game_logic_code_t best_guess = 0;
+  float best_entropy = -1.0f;
+  float best_weight = -1.0f;
+
+  for (game_logic_code_t guess = 0; guess < NUMBER_OF_POSSIBLE_CODES; guess++) {
+    const uint8_t *classes = game_logic_score_row(guess);
+    float truthful_mass[NUMBER_OF_FEEDBACK_CLASSES] = {0};
+    float lying_mass[NUMBER_OF_FEEDBACK_CLASSES] = {0};
+    for (size_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+      bool can_lie = solver->lies[i] < solver->maximum_lies && classes[i] != WINNING_CLASS;
+      (can_lie ? lying_mass : truthful_mass)[classes[i]] += solver->weights[i];
+    }
+    float total_lying_mass = 0.0f;
+    for (uint8_t c = 0; c < NUMBER_OF_FEEDBACK_CLASSES; c++) {
+      total_lying_mass += lying_mass[c];
+    }
+
+    // conditional entropy of the noise is the same for every guess, so the most informative
+    // guess is the one whose feedback distribution has the highest entropy
+    float entropy = 0.0f;
+    for (uint8_t c = 0; c < NUMBER_OF_FEEDBACK_CLASSES; c++) {
+      if (!is_reachable_class(c)) {
+        continue;
+      }
+      float probability = truthful_mass[c] + (1.0f - solver->lie_probability) * lying_mass[c];
+      if (c != WINNING_CLASS) {
+        probability += lie_share * (total_lying_mass - lying_mass[c]);
+      }
+      if (probability > 0.0f) {
+        entropy -= probability * log2f(probability);
+      }
+    }
+    if (entropy > best_entropy + 1e-6f || (entropy > best_entropy - 1e-6f && solver->weights[guess] > best_weight)) {
+      best_guess = guess;
+      best_entropy = entropy;
+      best_weight = solver->weights[guess];
+    }
+  }
+  return best_guess;
+}
+
+solver_hint_t liar_get_hint(const game_logic_move_t history[], size_t history_length) {
+  liar_solver_t solver;
+  liar_solver_init(&solver, LIAR_MAXIMUM_LIES, LIAR_LIE_PROBABILITY);
+  for (size_t i = 0; i < history_length; i++) {
+    liar_solver_update(&solver, history[i].guess, history[i].feedback);
+  }
+  solver_hint_t hint = {.best_guess = liar_solver_best_guess(&solver), .remaining_candidates = 0};
+  for (size_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    hint.remaining_candidates += solver.weights[i] > 0.0f;
+  }
+  return hint;
+}
\ No newline at end of file
@@ -1,16 +1,327 @@
 #include "console_app.h"
 #include "gui_app.h"
+#include "game_mode.h"
+#include "static_solver_app.h"
+#include "secret_distribution.h"
+#include "word_list.h"
+#include "game_server.h"
+#include "shm_ipc.h"
+#include "replay_query_app.h"
+#include "stream_evaluator.h"
+#include "engine_bot.h"
+#include "engine_host.h"
+#include "tournament.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #define STRING_EQUAL 0
 
 static const char console_game_argument[] = "--console";
+static const char static_solver_argument[] = "--static-solver";
+static const char boards_argument[] = "--boards";
+static const char pegs_argument[] = "--pegs";
+static const char values_argument[] = "--values";
+static const char secrets_argument[] = "--secrets";
+static const char words_argument[] = "--words";
+static const char build_word_index_argument[] = "--build-word-index";
+static const char hard_argument[] = "--hard";
+static const char serve_argument[] = "--serve";
+static const char threads_argument[] = "--threads";
+static const char io_uring_argument[] = "--io-uring";
+static const char shared_memory_argument[] = "--shm";
+static const char idle_timeout_argument[] = "--idle-timeout";
+static const char move_time_argument[] = "--move-time";
+static const char snapshot_argument[] = "--snapshot";
+static const char journal_argument[] = "--journal";
+static const char journal_commit_argument[] = "--journal-commit-ms";
+static const char journal_batch_argument[] = "--journal-batch-kb";
+static const char journal_no_sync_argument[] = "--journal-no-sync";
+static const char build_replays_argument[] = "--build-replays";
+static const char query_replays_argument[] = "--query-replays";
+static const char verify_replays_argument[] = "--verify-replays";
+static const char stream_argument[] = "--stream";
+static const char stream_binary_argument[] = "--stream-binary";
+static const char seed_argument[] = "--seed";
+static const char engine_argument[] = "--engine";
+static const char engine_host_argument[] = "--engine-host";
+static const char games_argument[] = "--games";
+static const char tries_argument[] = "--tries";
+static const char game_milliseconds_argument[] = "--game-ms";
+static const char move_milliseconds_argument[] = "--move-ms";
+static const char tournament_argument[] = "--tournament";
+static const char strategies_argument[] = "--strategies";
+static const char sample_argument[] = "--sample";
+static const char checkpoint_argument[] = "--checkpoint";
+static const char checkpoint_milliseconds_argument[] = "--checkpoint-ms";
+
+static const struct {
+  const char *argument;
+  game_mode_t mode;
+} mode_arguments[] = {
+  {"--evil", GAME_MODE_EVIL},
+  {"--black-peg", GAME_MODE_BLACK_PEG},
+  {"--liar", GAME_MODE_LIAR},
+  {"--no-duplicates", GAME_MODE_NO_DUPLICATES},
+};
 
 int main(int argc, char *argv[]) {
-  if (argc == 2 && 
-      strncmp(argv[1], console_game_argument, sizeof(console_game_argument)) == STRING_EQUAL) {
-    return console_main();
+  bool is_console = false;
+  bool is_hard_mode = false;
+  size_t number_of_threads = 0;
+  unsigned long serve_port = 0;
+  const char *verify_path = NULL;
+  const char *shared_memory_name = NULL;
+  const char *words_path = NULL;
+  bool is_streaming = false;
+  bool is_binary_stream = false;
+  uint64_t seed = (uint64_t) time(NULL);
+  const char *engine_commands[ENGINE_HOST_MAXIMUM_BOTS];
+  size_t number_of_engines = 0;
+  engine_host_options_t engine_options = {
+    .number_of_games = ENGINE_HOST_DEFAULT_GAMES,
+    .move_milliseconds = ENGINE_HOST_DEFAULT_MOVE_MILLISECONDS
+  };
+  unsigned long number_of_tries = 0;
+  bool is_tournament = false;
+  const char *strategy_names = NULL;
+  tournament_options_t tournament_options = {.checkpoint_milliseconds = TOURNAMENT_DEFAULT_CHECKPOINT_MILLISECONDS};
+  game_server_backend_t backend = GAME_SERVER_BACKEND_EPOLL;
+  game_server_options_t server_options = {
+    .idle_seconds = GAME_SERVER_DEFAULT_IDLE_SECONDS,
+    .journal = {.commit_milliseconds = GAME_JOURNAL_DEFAULT_COMMIT_MILLISECONDS}
+  };
+  game_mode_t mode = GAME_MODE_CLASSIC;
+  size_t number_of_boards = 0;
+  unsigned long number_of_pegs = NUMBER_OF_VALUES_TO_GUESS;
+  unsigned long number_of_values = GAME_VALUE_MAX;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], static_solver_argument) == STRING_EQUAL) {
+      return static_solver_app_main();
+    }
+    if (strcmp(argv[i], build_word_index_argument) == STRING_EQUAL && i + 3 < argc) {
+      unsigned long word_length = strtoul(argv[i + 3], NULL, 10);
+      if (word_length > WORD_LIST_MAXIMUM_WORD_LENGTH ||
+          !word_list_build_index(argv[i + 1], argv[i + 2], (uint8_t) word_length)) {
+        fprintf(stderr, "Could not build a word index from %s\n", argv[i + 1]);
+        return EXIT_FAILURE;
+      }
+      return EXIT_SUCCESS;
+    }
+    if (strcmp(argv[i], build_replays_argument) == STRING_EQUAL && i + 2 < argc) {
+      return replay_query_app_build(argv[i + 1], argv[i + 2]);
+    }
+    if (strcmp(argv[i], query_replays_argument) == STRING_EQUAL && i + 1 < argc) {
+      return replay_query_app_main(argv[i + 1], argc - i - 2, argv + i + 2);
+    }
+    if (strcmp(argv[i], stream_argument) == STRING_EQUAL) {
+      is_streaming = true;
+    }
+    if (strcmp(argv[i], stream_binary_argument) == STRING_EQUAL) {
+      is_streaming = true;
+      is_binary_stream = true;
+    }
+    if (strcmp(argv[i], engine_argument) == STRING_EQUAL) {
+      return engine_bot_main();
+    }
+    if (strcmp(argv[i], engine_host_argument) == STRING_EQUAL && i + 1 < argc) {
+      if (number_of_engines == ENGINE_HOST_MAXIMUM_BOTS) {
+        fprintf(stderr, "At most %d bots can play at once\n", ENGINE_HOST_MAXIMUM_BOTS);
+        return EXIT_FAILURE;
+      }
+      engine_commands[number_of_engines++] = argv[++i];
+    }
+    if (strcmp(argv[i], games_argument) == STRING_EQUAL && i + 1 < argc) {
+      engine_options.number_of_games = (uint32_t) strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], tries_argument) == STRING_EQUAL && i + 1 < argc) {
+      number_of_tries = strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], game_milliseconds_argument) == STRING_EQUAL && i + 1 < argc) {
+      engine_options.game_milliseconds = (uint32_t) strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], move_milliseconds_argument) == STRING_EQUAL && i + 1 < argc) {
+      engine_options.move_milliseconds = (uint32_t) strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], tournament_argument) == STRING_EQUAL) {
+      is_tournament = true;
+    }
+    if (strcmp(argv[i], strategies_argument) == STRING_EQUAL && i + 1 < argc) {
+      strategy_names = argv[++i];
+    }
+    if (strcmp(argv[i], sample_argument) == STRING_EQUAL && i + 1 < argc) {
+      tournament_options.sample_size = (uint32_t) strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], checkpoint_argument) == STRING_EQUAL && i + 1 < argc) {
+      tournament_options.checkpoint_path = argv[++i];
+    }
+    if (strcmp(argv[i], checkpoint_milliseconds_argument) == STRING_EQUAL && i + 1 < argc) {
+      tournament_options.checkpoint_milliseconds = (uint32_t) strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], seed_argument) == STRING_EQUAL && i + 1 < argc) {
+      seed = strtoull(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], verify_replays_argument) == STRING_EQUAL && i + 1 < argc) {
+      verify_path = argv[++i];
+    }
+    if (strcmp(argv[i], io_uring_argument) == STRING_EQUAL) {
+      backend = GAME_SERVER_BACKEND_IO_URING;
+    }
+    if (strcmp(argv[i], threads_argument) == STRING_EQUAL && i + 1 < argc) {
+      number_of_threads = (size_t) strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], idle_timeout_argument) == STRING_EQUAL && i + 1 < argc) {
+      server_options.idle_seconds = (uint32_t) strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], move_time_argument) == STRING_EQUAL && i + 1 < argc) {
+      server_options.move_seconds = (uint32_t) strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], snapshot_argument) == STRING_EQUAL && i + 1 < argc) {
+      server_options.snapshot_path = argv[++i];
+    }
+    if (strcmp(argv[i], journal_argument) == STRING_EQUAL && i + 1 < argc) {
+      server_options.journal_path = argv[++i];
+    }
+    if (strcmp(argv[i], journal_commit_argument) == STRING_EQUAL && i + 1 < argc) {
+      server_options.journal.commit_milliseconds = (uint32_t) strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], journal_batch_argument) == STRING_EQUAL && i + 1 < argc) {
+      server_options.journal.commit_bytes = (size_t) strtoul(argv[++i], NULL, 10) * 1024;
+    }
+    if (strcmp(argv[i], journal_no_sync_argument) == STRING_EQUAL) {
+      server_options.journal.is_sync_disabled = true;
+    }
+    if (strcmp(argv[i], serve_argument) == STRING_EQUAL && i + 1 < argc) {
+      serve_port = strtoul(argv[++i], NULL, 10);
+      if (serve_port == 0 || serve_port > UINT16_MAX) {
+        fprintf(stderr, "Invalid port %s\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+    }
+    if (strcmp(argv[i], shared_memory_argument) == STRING_EQUAL && i + 1 < argc) {
+      shared_memory_name = argv[++i];
+    }
+    if (strcmp(argv[i], words_argument) == STRING_EQUAL && i + 1 < argc) {
+      words_path = argv[++i];
+    }
+    if (strcmp(argv[i], boards_argument) == STRING_EQUAL && i + 1 < argc) {
+      number_of_boards = (size_t) strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], pegs_argument) == STRING_EQUAL && i + 1 < argc) {
+      number_of_pegs = strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], values_argument) == STRING_EQUAL && i + 1 < argc) {
+      number_of_values = strtoul(argv[++i], NULL, 10);
+    }
+    if (strcmp(argv[i], secrets_argument) == STRING_EQUAL && i + 1 < argc) {
+      if (!secret_distribution_load_file(argv[++i])) {
+        fprintf(stderr, "Could not load secrets from %s\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+      mode = GAME_MODE_CUSTOM_SECRETS;
+    }
+    if (strcmp(argv[i], hard_argument) == STRING_EQUAL) {
+      is_hard_mode = true;
+    }
+    if (strncmp(argv[i], console_game_argument, sizeof(console_game_argument)) == STRING_EQUAL) {
+      is_console = true;
+    }
+    for (size_t j = 0; j < sizeof(mode_arguments) / sizeof(mode_arguments[0]); j++) {
+      if (strcmp(argv[i], mode_arguments[j].argument) == STRING_EQUAL) {
+        mode = mode_arguments[j].mode;
+      }
+    }
+  }
+
+  bool is_large_space = number_of_pegs != NUMBER_OF_VALUES_TO_GUESS || number_of_values != GAME_VALUE_MAX;
+  // the front end the arguments pick, in the order they are dispatched below, NULL for the single board
+  // games. Only those know about codemaker modes, and only they and the engine host about hard mode,
+  // anywhere else the flags would silently be dropped
+  const char *front_end = shared_memory_name != NULL ? "shared memory" :
+                          words_path != NULL ? "word" :
+                          is_streaming ? "stream" :
+                          number_of_engines > 0 ? "engine host" :
+                          is_tournament ? "tournament" :
+                          verify_path != NULL ? "replay verification" :
+                          serve_port != 0 ? "server" :
+                          number_of_boards > 0 ? "multi-board" :
+                          is_large_space ? "large space" : NULL;
+  if (is_hard_mode && front_end != NULL && number_of_engines == 0) {
+    fprintf(stderr, "Hard mode is not available in %s mode\n", front_end);
+    return EXIT_FAILURE;
+  }
+  if (mode != GAME_MODE_CLASSIC && front_end != NULL) {
+    fprintf(stderr, "The %s codemaker is not available in %s mode\n", game_mode_get_codemaker(mode)->name, front_end);
+    return EXIT_FAILURE;
+  }
+
+  if (shared_memory_name != NULL) {
+    return shm_ipc_server_main(shared_memory_name);
+  }
+
+  if (words_path != NULL) {
+    return console_word_main(words_path);
+  }
+
+  if (is_streaming) {
+    return stream_evaluator_main(is_binary_stream, seed);
+  }
+
+  if (number_of_engines > 0) {
+    bool is_standard_game = number_of_pegs == NUMBER_OF_VALUES_TO_GUESS && number_of_values == GAME_VALUE_MAX;
+    if (number_of_tries == 0) {
+      number_of_tries = is_standard_game ? ENGINE_HOST_DEFAULT_TRIES : ENGINE_HOST_DEFAULT_LARGE_SPACE_TRIES;
+    }
+    engine_options.variant.number_of_pegs = (uint8_t) (number_of_pegs > UINT8_MAX ? 0 : number_of_pegs);
+    engine_options.variant.number_of_values = (uint8_t) (number_of_values > UINT8_MAX ? 0 : number_of_values);
+    engine_options.maximum_tries = (uint8_t) (number_of_tries > UINT8_MAX ? 0 : number_of_tries);
+    engine_options.is_hard_mode = is_hard_mode;
+    engine_options.seed = seed;
+    return engine_host_main(engine_commands, number_of_engines, &engine_options);
+  }
+
+  if (is_tournament) {
+    bool is_standard_game = number_of_pegs == NUMBER_OF_VALUES_TO_GUESS && number_of_values == GAME_VALUE_MAX;
+    if (number_of_tries == 0) {
+      number_of_tries = is_standard_game ? ENGINE_HOST_DEFAULT_TRIES : ENGINE_HOST_DEFAULT_LARGE_SPACE_TRIES;
+    }
+    tournament_options.variant.number_of_pegs = (uint8_t) (number_of_pegs > UINT8_MAX ? 0 : number_of_pegs);
+    tournament_options.variant.number_of_values = (uint8_t) (number_of_values > UINT8_MAX ? 0 : number_of_values);
+    tournament_options.maximum_tries = (uint8_t) (number_of_tries > UINT8_MAX ? 0 : number_of_tries);
+    tournament_options.seed = seed;
+    tournament_options.number_of_threads = number_of_threads;
+    return tournament_main(strategy_names, &tournament_options);
+  }
+
+  if (verify_path != NULL) {
+    return replay_query_app_verify(verify_path, number_of_threads);
+  }
+
+  if (serve_port != 0) {
+    return game_server_main((uint16_t) serve_port, number_of_threads, backend, server_options);
+  }
+
+  if (number_of_boards > 0) {
+    return is_console ? console_multi_board_main(number_of_boards) : gui_multi_board_main(number_of_boards);
+  }
+
+  // only the console can show more values and placements than the standard board
+  if (is_large_space) {
+    return console_large_space_main((uint8_t) (number_of_pegs > UINT8_MAX ? 0 : number_of_pegs),
+                                    (uint8_t) (number_of_values > UINT8_MAX ? 0 : number_of_values));
+  }
+
+  if (is_hard_mode && !game_mode_get_codemaker(mode)->supports_hard_mode) {
+    fprintf(stderr, "Hard mode is not available in %s mode\n", game_mode_get_codemaker(mode)->name);
+    return EXIT_FAILURE;
+  }
+
+  if (is_console) {
+    return console_main(mode, is_hard_mode);
   }
 
-  return gui_main();
-}
+  return gui_main(mode, is_hard_mode);
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "multi_board.h"
+#include "random.h"
+
+#define WINNING_CLASS (NUMBER_OF_VALUES_TO_GUESS * (NUMBER_OF_VALUES_TO_GUESS + 1))
+#define IS_BOARD_SOLVED(solved_boards, board) (((solved_boards) >> (board)) & 1u)
+
+void multi_board_start(multi_board_game_t *game, size_t number_of_boards) {
+  if (number_of_boards == 0) {
+    number_of_boards = 1;
+  }
+  if (number_of_boards > MULTI_BOARD_MAXIMUM_BOARDS) {
+    number_of_boards = MULTI_BOARD_MAXIMUM_BOARDS;
+  }
+  game->number_of_boards = number_of_boards;
+  game->solved_boards = 0;
+  for (size_t board = 0; board < number_of_boards; board++) {
+    game_logic_values_t answer[NUMBER_OF_VALUES_TO_GUESS];
+    for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+      answer[i] = (game_logic_values_t) (random_value() % GAME_VALUE_MAX);
+    }
+    game->answers[board] = game_logic_pack_code(answer);
+  }
+}
+
+void multi_board_score(game_logic_code_t guess, const game_logic_code_t answers[], size_t number_of_answers, uint8_t classes[]) {
+  const uint8_t *row = game_logic_score_row(guess);
+  for (size_t i = 0; i < number_of_answers; i++) {
+    classes[i] = row[answers[i]];
+  }
+}
+
+void multi_board_get_feedback(multi_board_game_t *game, const game_logic_values_t guess[], game_logic_feedback_t feedback[]) {
+  uint8_t classes[MULTI_BOARD_MAXIMUM_BOARDS];
+  multi_board_score(game_logic_pack_code(guess), game->answers, game->number_of_boards, classes);
+  for (size_t board = 0; board < game->number_of_boards; board++) {
+    if (IS_BOARD_SOLVED(game->solved_boards, board)) {
+      classes[board] = game_logic_feedback_to_class((game_logic_feedback_t) {
+        .number_of_correct_value_and_placement = NUMBER_OF_VALUES_TO_GUESS
+      });
+    }
+    feedback[board] = game_logic_feedback_from_class(classes[board]);
+    game->solved_boards |= (uint32_t) feedback[board].is_guess_correct << board;
+  }
+}
+
+bool multi_board_is_solved(const multi_board_game_t *game) {
+  uint32_t all_boards = game->number_of_boards == 32 ? UINT32_MAX : (1u << game->number_of_boards) - 1;
+  return game->solved_boards == all_boards;
+}
+
+size_t multi_board_get_maximum_number_of_tries(const multi_board_game_t *game) {
+  return game->number_of_boards + MULTI_BOARD_EXTRA_TRIES;
+}
+
+void multi_board_solver_init(multi_board_solver_t *solver, size_t number_of_boards) {
+  solver->number_of_boards = number_of_boards;
+  solver->solved_boards = 0;
+  for (size_t board = 0; board < number_of_boards; board++) {
+    solver->number_of_candidates[board] = NUMBER_OF_POSSIBLE_CODES;
+    for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+      solver->candidates[board][i] = i;
+    }
+  }
+}
+
+void multi_board_solver_update(multi_board_solver_t *solver, const game_logic_values_t guess[], const game_logic_feedback_t feedback[]) {
+  const uint8_t *row = game_logic_score_row(game_logic_pack_code(guess));
+  for (size_t board = 0; board < solver->number_of_boards; board++) {
+    if (IS_BOARD_SOLVED(solver->solved_boards, board)) {
+      continue;
+    }
+    if (feedback[board].is_guess_correct) {
+      solver->solved_boards |= 1u << board;
+      continue;
+    }
+    uint8_t feedback_class = game_logic_feedback_to_class(feedback[board]);
+    uint16_t kept = 0;
+    for (uint16_t i = 0; i < solver->number_of_candidates[board]; i++) {
+      game_logic_code_t candidate = solver->candidates[board][i];
+      solver->candidates[board][kept] = candidate;
+      kept += row[candidate] == feedback_class;
+    }
+    solver->number_of_candidates[board] = kept;
+  }
+}
+
+game_logic_code_t multi_board_solver_best_guess(const multi_board_solver_t *solver) {
+  size_t unsolved_board = 0;
+  for (size_t board = 0; board < solver->number_of_boards; board++) {
+    if (!IS_BOARD_SOLVED(solver->solved_boards, board) && solver->number_of_candidates[board] > 0) {
+      if (solver->number_of_candidates[board] == 1) {
+        return solver->candidates[board][0];
+      }
+      unsolved_board = board;
+    }
+  }
+
+  // sum of squared partition sizes over a board's candidates is proportional to the expected number left
+  game_logic_code_t best_guess = solver->candidates[unsolved_board][0];
+  double best_expected = -1.0;
+  for (game_logic_code_t guess = 0; guess < NUMBER_OF_POSSIBLE_CODES; guess++) {
+    const uint8_t *row = game_logic_score_row(guess);
+    double expected = 0.0;
+    for (size_t board = 0; board < solver->number_of_boards; board++) {
+      uint16_t number_of_candidates = solver->number_of_candidates[board];
+      if (IS_BOARD_SOLVED(solver->solved_boards, board) || number_of_candidates == 0) {
+        continue;
+      }
+      uint32_t partition_sizes[NUMBER_OF_FEEDBACK_CLASSES] = {0};
+      uint64_t sum_of_squares = 0;
+      for (uint16_t i = 0; i < number_of_candidates; i++) {
+        // (n + 1)^2 - n^2 = 2n + 1, so the sum of squares builds up as partitions fill
+        sum_of_squares += 2 * partition_sizes[row[solver->candidates[board][i]]]++ + 1;
+      }
+      expected += (double) sum_of_squares / number_of_candidates;
+      // guessing a board's answer outright removes it from the expected count
+      expected -= (double) partition_sizes[WINNING_CLASS] / number_of_candidates;
+      if (best_expected >= 0.0 && expected >= best_expected) {
+        break;
+      }
+    }
+    if (best_expected < 0.0 || expected < best_expected) {
+      best_expected = expected;
+      best_guess = guess;
+    }
+  }
+  return best_guess;
+}
\ No newline at end of file
@@ -0,0 +1,380 @@
+#define _POSIX_C_SOURCE 200809L
+#include "replay_query_app.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "game_journal.h"
+#include "replay_store.h"
+#include "replay_verifier.h"
+
+#define STRING_EQUAL 0
+#define VALUE_SIZE 32
+#define HISTOGRAM_ROWS 20
+#define DIVERGENCE_ROWS 20
+
+static const char value_characters[GAME_VALUE_MAX] = {'A', 'B', 'C', 'D', 'E', 'F'};
+
+static const char *outcome_names[] = {"won", "lost", "gave_up", "timed_out", "abandoned"};
+
+typedef struct {
+  const char *name;
+  replay_store_column_t column;
+} column_name_t;
+
+static const column_name_t column_names[] = {
+  {"started", REPLAY_STORE_COLUMN_STARTED},
+  {"duration", REPLAY_STORE_COLUMN_DURATION},
+  {"secret", REPLAY_STORE_COLUMN_SECRET},
+  {"tries", REPLAY_STORE_COLUMN_TRIES},
+  {"outcome", REPLAY_STORE_COLUMN_OUTCOME},
+  {"hard", REPLAY_STORE_COLUMN_HARD_MODE},
+  {"blunders", REPLAY_STORE_COLUMN_BLUNDERS},
+  {"first_blunder", REPLAY_STORE_COLUMN_FIRST_BLUNDER},
+};
+
+typedef struct {
+  replay_store_writer_t *writer;
+  uint64_t number_of_games;
+  bool is_failed;
+} build_t;
+
+static double elapsed_milliseconds(struct timespec start, struct timespec end) {
+  return (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+}
+
+static bool is_code_column(replay_store_column_t column) {
+  return column >= REPLAY_STORE_COLUMN_SECRET && column < REPLAY_STORE_COLUMN_TRIES;
+}
+
+static bool is_feedback_column(replay_store_column_t column) {
+  return column >= REPLAY_STORE_COLUMN_FEEDBACK;
+}
+
+// guess1 to guess8 and feedback1 to feedback8 name the columns of each move
+static bool parse_column(const char *name, size_t length, replay_store_column_t *column) {
+  for (size_t i = 0; i < sizeof(column_names) / sizeof(column_names[0]); i++) {
+    if (strlen(column_names[i].name) == length && strncmp(name, column_names[i].name, length) == STRING_EQUAL) {
+      *column = column_names[i].column;
+      return true;
+    }
+  }
+  if (length < 2 || name[length - 1] < '1' || name[length - 1] > '0' + REPLAY_STORE_MAXIMUM_MOVES) {
+    return false;
+  }
+  int move = name[length - 1] - '1';
+  if (length == 6 && strncmp(name, "guess", 5) == STRING_EQUAL) {
+    *column = (replay_store_column_t)(REPLAY_STORE_COLUMN_GUESS + move);
+    return true;
+  }
+  if (length == 9 && strncmp(name, "feedback", 8) == STRING_EQUAL) {
+    *column = (replay_store_column_t)(REPLAY_STORE_COLUMN_FEEDBACK + move);
+    return true;
+  }
+  return false;
+}
+
+static bool parse_value(replay_store_column_t column, const char *text, uint64_t *value) {
+  if (is_code_column(column)) {
+    game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+    if (strlen(text) != NUMBER_OF_VALUES_TO_GUESS) {
+      return false;
+    }
+    for (size_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+      if (text[i] < value_characters[0] || text[i] > value_characters[GAME_VALUE_MAX - 1]) {
+        return false;
+      }
+      values[i] = (game_logic_values_t)(text[i] - value_characters[0]);
+    }
+    *value = game_logic_pack_code(values);
+    return true;
+  }
+  if (is_feedback_column(column)) {
+    unsigned placement, value_only;
+    char end;
+    if (sscanf(text, "%u/%u%c", &placement, &value_only, &end) != 2 ||
+        placement + value_only > NUMBER_OF_VALUES_TO_GUESS) {
+      return false;
+    }
+    game_logic_feedback_t feedback = {.number_of_correct_value_and_placement = (uint8_t) placement,
+                                      .number_of_correct_value_only = (uint8_t) value_only};
+    *value = game_logic_feedback_to_class(feedback);
+    return true;
+  }
+  if (column == REPLAY_STORE_COLUMN_OUTCOME) {
+    for (size_t i = 0; i < sizeof(outcome_names) / sizeof(outcome_names[0]); i++) {
+      if (strcmp(text, outcome_names[i]) == STRING_EQUAL) {
+        *value = i;
+        return true;
+      }
+    }
+    return false;
+  }
+  char *end;
+  *value = strtoull(text, &end, 10);
+  return *text != '\0' && *end == '\0';
+}
+
+static void format_value(replay_store_column_t column, uint64_t value, char text[]) {
+  if (is_code_column(column) && value < NUMBER_OF_POSSIBLE_CODES) {
+    game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code((game_logic_code_t) value, values);
+    snprintf(text, VALUE_SIZE, "%c%c%c%c", value_characters[values[0]], value_characters[values[1]],
+             value_characters[values[2]], value_characters[values[3]]);
+  } else if (is_feedback_column(column) && value < NUMBER_OF_FEEDBACK_CLASSES) {
+    game_logic_feedback_t feedback = game_logic_feedback_from_class((uint8_t) value);
+    snprintf(text, VALUE_SIZE, "%d/%d", feedback.number_of_correct_value_and_placement,
+             feedback.number_of_correct_value_only);
+  } else if (column == REPLAY_STORE_COLUMN_OUTCOME && value < sizeof(outcome_names) / sizeof(outcome_names[0])) {
+    snprintf(text, VALUE_SIZE, "%s", outcome_names[value]);
+  } else if ((is_code_column(column) && value == REPLAY_STORE_NO_GUESS) ||
+             (is_feedback_column(column) && value == REPLAY_STORE_NO_FEEDBACK)) {
+    snprintf(text, VALUE_SIZE, "-");
+  } else {
+    snprintf(text, VALUE_SIZE, "%llu", (unsigned long long) value);
+  }
+}
+
+// name=value, name<value, name<=value, name>value or name>=value
+static bool parse_filter(const char *term, replay_store_filter_t *filter) {
+  size_t name_length = strcspn(term, "<>=");
+  const char *operator = term + name_length;
+  if (*operator == '\0' || !parse_column(term, name_length, &filter->column)) {
+    return false;
+  }
+  bool is_inclusive = *operator != '=' && operator[1] == '=';
+  uint64_t value;
+  if (!parse_value(filter->column, operator + (is_inclusive ? 2 : 1), &value)) {
+    return false;
+  }
+  filter->low = 0;
+  filter->high = UINT64_MAX;
+  switch (*operator) {
+  case '=':
+    filter->low = value;
+    filter->high = value;
+    return true;
+  case '<':
+    if (!is_inclusive && value == 0) {
+      filter->low = 1;
+      filter->high = 0;
+      return true;
+    }
+    filter->high = is_inclusive ? value : value - 1;
+    return true;
+  default:
+    if (!is_inclusive && value == UINT64_MAX) {
+      filter->low = 1;
+      filter->high = 0;
+      return true;
+    }
+    filter->low = is_inclusive ? value : value + 1;
+    return true;
+  }
+}
+
+static void visit_game(const game_journal_game_t *game, void *argument) {
+  build_t *build = argument;
+  replay_store_game_t stored = {
+    .started = game->started,
+    .duration = game->last_time > game->started ? (uint32_t)(game->last_time - game->started) : 0,
+    .secret = game->answer,
+    .tries = game->tries,
+    .outcome = game->end_reason,
+    .is_hard_mode = game->is_hard_mode
+  };
+  memcpy(stored.guesses, game->guesses, sizeof(stored.guesses));
+  memcpy(stored.feedback, game->feedback, sizeof(stored.feedback));
+  if (!build->is_failed && !replay_store_writer_add(build->writer, &stored)) {
+    build->is_failed = true;
+  }
+  build->number_of_games++;
+}
+
+int replay_query_app_build(const char *journal_path, const char *store_path) {
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  build_t build = {.writer = replay_store_writer_create(store_path)};
+  if (build.writer == NULL) {
+    fprintf(stderr, "Could not create %s\n", store_path);
+    return EXIT_FAILURE;
+  }
+  game_journal_recovery_t recovery;
+  if (!game_journal_replay_games(journal_path, visit_game, &build, &recovery) || build.is_failed) {
+    fprintf(stderr, "Could not read the games in %s\n", journal_path);
+    replay_store_writer_destroy(build.writer);
+    return EXIT_FAILURE;
+  }
+  if (!replay_store_writer_commit(build.writer)) {
+    fprintf(stderr, "Could not write %s\n", store_path);
+    return EXIT_FAILURE;
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  printf("Stored %llu finished games from %llu journal records in %.1f ms, %llu games still in play left out\n",
+         (unsigned long long) build.number_of_games, (unsigned long long) recovery.records,
+         elapsed_milliseconds(start, end), (unsigned long long) recovery.games_in_progress);
+  return EXIT_SUCCESS;
+}
+
+static bool parse_query(int argc, char *argv[], replay_store_query_t *query) {
+  memset(query, 0, sizeof(*query));
+  query->aggregate = REPLAY_STORE_COUNT;
+  for (int i = 0; i < argc; i++) {
+    if (strcmp(argv[i], "count") == STRING_EQUAL) {
+      query->aggregate = REPLAY_STORE_COUNT;
+    } else if (strcmp(argv[i], "histogram") == STRING_EQUAL && i + 1 < argc) {
+      query->aggregate = REPLAY_STORE_HISTOGRAM;
+      if (!parse_column(argv[i + 1], strlen(argv[i + 1]), &query->column)) {
+        return false;
+      }
+      i++;
+    } else if (strcmp(argv[i], "average") == STRING_EQUAL && i + 3 < argc && strcmp(argv[i + 2], "by") == STRING_EQUAL) {
+      query->aggregate = REPLAY_STORE_AVERAGE;
+      if (!parse_column(argv[i + 1], strlen(argv[i + 1]), &query->column) ||
+          !parse_column(argv[i + 3], strlen(argv[i + 3]), &query->group_by)) {
+        return false;
+      }
+      i += 3;
+    } else if (query->number_of_filters == REPLAY_STORE_MAXIMUM_FILTERS ||
+               !parse_filter(argv[i], &query->filters[query->number_of_filters++])) {
+      fprintf(stderr, "Cannot parse %s\n", argv[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+static const uint64_t *sort_counts;
+
+static int compare_by_count(const void *left, const void *right) {
+  uint64_t left_count = sort_counts[*(const uint32_t *) left];
+  uint64_t right_count = sort_counts[*(const uint32_t *) right];
+  return left_count < right_count ? 1 : left_count > right_count ? -1 : 0;
+}
+
+static void print_histogram(const replay_store_query_t *query, const replay_store_result_t *result) {
+  uint32_t *values = malloc(REPLAY_STORE_MAXIMUM_GROUPS * sizeof(uint32_t));
+  if (values == NULL) {
+    return;
+  }
+  size_t number_of_values = 0;
+  for (uint32_t value = 0; value < REPLAY_STORE_MAXIMUM_GROUPS; value++) {
+    if (result->counts[value] > 0) {
+      values[number_of_values++] = value;
+    }
+  }
+  sort_counts = result->counts;
+  qsort(values, number_of_values, sizeof(uint32_t), compare_by_count);
+  for (size_t i = 0; i < number_of_values && i < HISTOGRAM_ROWS; i++) {
+    char text[VALUE_SIZE];
+    format_value(query->column, values[i], text);
+    printf("%-10s %12llu %6.2f%%\n", text, (unsigned long long) result->counts[values[i]],
+           100.0 * (double) result->counts[values[i]] / (double) result->games_selected);
+  }
+  free(values);
+}
+
+static void print_averages(const replay_store_query_t *query, const replay_store_result_t *result) {
+  for (uint32_t group = 0; group < REPLAY_STORE_MAXIMUM_GROUPS; group++) {
+    if (result->counts[group] == 0) {
+      continue;
+    }
+    char text[VALUE_SIZE];
+    format_value(query->group_by, group, text);
+    printf("%-10s %10.3f %12llu games\n", text, (double) result->sums[group] / (double) result->counts[group],
+           (unsigned long long) result->counts[group]);
+  }
+}
+
+int replay_query_app_main(const char *store_path, int argc, char *argv[]) {
+  replay_store_query_t query;
+  if (!parse_query(argc, argv, &query)) {
+    return EXIT_FAILURE;
+  }
+  replay_store_t *store = replay_store_open(store_path);
+  if (store == NULL) {
+    fprintf(stderr, "Could not open %s\n", store_path);
+    return EXIT_FAILURE;
+  }
+  struct timespec start, end;
+  replay_store_result_t result;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  bool is_run = replay_store_run(store, &query, &result);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  replay_store_close(store);
+  if (!is_run) {
+    fprintf(stderr, "Histograms take columns of up to 2 bytes, averages up to 4 bytes grouped by up to 2\n");
+    return EXIT_FAILURE;
+  }
+  if (query.aggregate == REPLAY_STORE_HISTOGRAM) {
+    print_histogram(&query, &result);
+  } else if (query.aggregate == REPLAY_STORE_AVERAGE) {
+    print_averages(&query, &result);
+  }
+  double milliseconds = elapsed_milliseconds(start, end);
+  printf("%llu of %llu games, %llu of %llu blocks skipped, %.1f MB read in %.1f ms, %.2f GB/s\n",
+         (unsigned long long) result.games_selected, (unsigned long long) result.games_scanned,
+         (unsigned long long) result.blocks_skipped,
+         (unsigned long long) (result.blocks_scanned + result.blocks_skipped),
+         (double) result.bytes_scanned / (1024 * 1024), milliseconds,
+         milliseconds > 0 ? (double) result.bytes_scanned / (milliseconds * 1e6) : 0.0);
+  replay_store_result_free(&result);
+  return EXIT_SUCCESS;
+}
+
+static const char *divergence_names[] = {
+  [REPLAY_VERIFIER_FEEDBACK] = "feedback",
+  [REPLAY_VERIFIER_SCORE_TABLE] = "score table",
+  [REPLAY_VERIFIER_REFUSED] = "refused in hard mode",
+  [REPLAY_VERIFIER_OUTCOME] = "outcome",
+  [REPLAY_VERIFIER_MALFORMED] = "malformed"
+};
+
+static void print_divergence(const replay_verifier_divergence_t *divergence) {
+  char recorded[VALUE_SIZE];
+  char replayed[VALUE_SIZE];
+  replay_store_column_t column = divergence->kind == REPLAY_VERIFIER_OUTCOME ? REPLAY_STORE_COLUMN_OUTCOME
+                                                                             : REPLAY_STORE_COLUMN_FEEDBACK;
+  format_value(column, divergence->recorded, recorded);
+  format_value(column, divergence->replayed, replayed);
+  printf("game %llu move %d: %s, recorded %s, replayed %s\n", (unsigned long long) divergence->game,
+         divergence->move + 1, divergence_names[divergence->kind], recorded, replayed);
+}
+
+int replay_query_app_verify(const char *store_path, size_t number_of_threads) {
+  replay_store_t *store = replay_store_open(store_path);
+  if (store == NULL) {
+    fprintf(stderr, "Could not open %s\n", store_path);
+    return EXIT_FAILURE;
+  }
+  if (number_of_threads == 0) {
+    long number_of_processors = sysconf(_SC_NPROCESSORS_ONLN);
+    number_of_threads = number_of_processors > 0 ? (size_t) number_of_processors : 1;
+  }
+  replay_verifier_result_t *result = malloc(sizeof(replay_verifier_result_t));
+  // the score table is built on first use, not while the replay is timed
+  game_logic_score_row(0);
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  bool is_run = result != NULL && replay_verifier_run(store, number_of_threads, result);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  replay_store_close(store);
+  if (!is_run) {
+    fprintf(stderr, "Out of memory\n");
+    free(result);
+    return EXIT_FAILURE;
+  }
+  for (size_t i = 0; i < result->number_of_divergences && i < DIVERGENCE_ROWS; i++) {
+    print_divergence(&result->divergences[i]);
+  }
+  double milliseconds = elapsed_milliseconds(start, end);
+  printf("%llu of %llu games diverged, %llu moves replayed in %.1f ms, %.2f million games/s\n",
+         (unsigned long long) result->games_diverged, (unsigned long long) result->games,
+         (unsigned long long) result->moves, milliseconds,
+         milliseconds > 0 ? (double) result->games / (milliseconds * 1e3) : 0.0);
+  int status = result->games_diverged == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+  free(result);
+  return status;
+}
\ No newline at end of file
@@ -0,0 +1,513 @@
+#define _GNU_SOURCE
+#include "replay_store.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+
+#define PATH_SIZE 4096
+#define HEADER_SIZE 64
+#define INITIAL_BLOCKS 64
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t number_of_columns;
+  uint32_t block_games;
+  uint64_t number_of_games;
+  uint64_t number_of_blocks;
+  uint64_t index_offset;
+  // unix seconds
+  int64_t created_at;
+} header_t;
+
+// zone map of one block
+typedef struct {
+  uint64_t minimum[REPLAY_STORE_NUMBER_OF_COLUMNS];
+  uint64_t maximum[REPLAY_STORE_NUMBER_OF_COLUMNS];
+} block_index_t;
+
+struct replay_store_writer {
+  int fd;
+  char path[PATH_SIZE];
+  char temporary_path[PATH_SIZE];
+  // every column of the block being filled, each sized for a full block
+  uint8_t *columns[REPLAY_STORE_NUMBER_OF_COLUMNS];
+  size_t games_in_block;
+  uint64_t number_of_games;
+  block_index_t *index;
+  size_t number_of_blocks;
+  size_t index_capacity;
+};
+
+struct replay_store {
+  void *map;
+  size_t map_size;
+  const header_t *header;
+  const block_index_t *index;
+  const uint8_t *blocks;
+};
+
+static size_t block_bytes(size_t number_of_games) {
+  size_t bytes = 0;
+  for (int column = 0; column < REPLAY_STORE_NUMBER_OF_COLUMNS; column++) {
+    bytes += replay_store_column_width((replay_store_column_t) column) * number_of_games;
+  }
+  return bytes;
+}
+
+// full blocks followed by the partly filled last one, the index starts right after them
+static uint64_t index_offset_of(uint64_t number_of_games) {
+  return HEADER_SIZE + block_bytes(REPLAY_STORE_BLOCK_GAMES) * (number_of_games / REPLAY_STORE_BLOCK_GAMES) +
+         block_bytes(number_of_games % REPLAY_STORE_BLOCK_GAMES);
+}
+
+// columns of a block follow each other, each as long as the block has games
+static const uint8_t* column_of_block(const replay_store_t *store, uint64_t block, replay_store_column_t column,
+                                      size_t *number_of_games) {
+  uint64_t first_game = block * REPLAY_STORE_BLOCK_GAMES;
+  uint64_t games_left = store->header->number_of_games - first_game;
+  *number_of_games = games_left < REPLAY_STORE_BLOCK_GAMES ? (size_t) games_left : REPLAY_STORE_BLOCK_GAMES;
+  const uint8_t *start = store->blocks + block * block_bytes(REPLAY_STORE_BLOCK_GAMES);
+  for (int previous = 0; previous < (int) column; previous++) {
+    start += replay_store_column_width((replay_store_column_t) previous) * *number_of_games;
+  }
+  return start;
+}
+
+size_t replay_store_column_width(replay_store_column_t column) {
+  if (column == REPLAY_STORE_COLUMN_STARTED) {
+    return sizeof(uint64_t);
+  }
+  if (column == REPLAY_STORE_COLUMN_DURATION) {
+    return sizeof(uint32_t);
+  }
+  if (column < REPLAY_STORE_COLUMN_TRIES) {
+    return sizeof(game_logic_code_t);
+  }
+  return sizeof(uint8_t);
+}
+
+static void store_value(replay_store_writer_t *writer, replay_store_column_t column, uint64_t value) {
+  uint8_t *values = writer->columns[column];
+  size_t i = writer->games_in_block;
+  switch (replay_store_column_width(column)) {
+  case sizeof(uint64_t):
+    ((uint64_t *) values)[i] = value;
+    break;
+  case sizeof(uint32_t):
+    ((uint32_t *) values)[i] = (uint32_t) value;
+    break;
+  case sizeof(uint16_t):
+    ((uint16_t *) values)[i] = (uint16_t) value;
+    break;
+  default:
+    values[i] = (uint8_t) value;
+    break;
+  }
+  block_index_t *index = &writer->index[writer->number_of_blocks];
+  if (i == 0 || value < index->minimum[column]) {
+    index->minimum[column] = value;
+  }
+  if (i == 0 || value > index->maximum[column]) {
+    index->maximum[column] = value;
+  }
+}
+
+// a guess is a blunder when it scores differently against one of the earlier guesses than the answer did,
+// so it could not have been the answer
+static void count_blunders(const replay_store_game_t *game, uint8_t *blunders, uint8_t *first_blunder) {
+  *blunders = 0;
+  *first_blunder = 0;
+  for (uint8_t move = 1; move < game->tries && move < REPLAY_STORE_MAXIMUM_MOVES; move++) {
+    if (game->guesses[move] >= NUMBER_OF_POSSIBLE_CODES) {
+      continue;
+    }
+    for (uint8_t earlier = 0; earlier < move && game->guesses[earlier] < NUMBER_OF_POSSIBLE_CODES; earlier++) {
+      if (game_logic_score_row(game->guesses[earlier])[game->guesses[move]] != game->feedback[earlier]) {
+        *first_blunder = *first_blunder == 0 ? (uint8_t)(move + 1) : *first_blunder;
+        (*blunders)++;
+        break;
+      }
+    }
+  }
+}
+
+static bool flush_block(replay_store_writer_t *writer) {
+  if (writer->games_in_block == 0) {
+    return true;
+  }
+  struct iovec chunks[REPLAY_STORE_NUMBER_OF_COLUMNS];
+  size_t length = 0;
+  for (int column = 0; column < REPLAY_STORE_NUMBER_OF_COLUMNS; column++) {
+    chunks[column].iov_base = writer->columns[column];
+    chunks[column].iov_len = replay_store_column_width((replay_store_column_t) column) * writer->games_in_block;
+    length += chunks[column].iov_len;
+  }
+  if (writev(writer->fd, chunks, REPLAY_STORE_NUMBER_OF_COLUMNS) != (ssize_t) length) {
+    return false;
+  }
+  writer->games_in_block = 0;
+  writer->number_of_blocks++;
+  return true;
+}
+
+replay_store_writer_t* replay_store_writer_create(const char *path) {
+  replay_store_writer_t *writer = calloc(1, sizeof(replay_store_writer_t));
+  if (writer == NULL) {
+    return NULL;
+  }
+  writer->fd = -1;
+  snprintf(writer->path, PATH_SIZE, "%s", path);
+  snprintf(writer->temporary_path, PATH_SIZE, "%s.tmp", path);
+  writer->index_capacity = INITIAL_BLOCKS;
+  writer->index = calloc(writer->index_capacity, sizeof(block_index_t));
+  bool is_created = writer->index != NULL;
+  for (int column = 0; column < REPLAY_STORE_NUMBER_OF_COLUMNS && is_created; column++) {
+    writer->columns[column] = malloc(replay_store_column_width((replay_store_column_t) column) * REPLAY_STORE_BLOCK_GAMES);
+    is_created = writer->columns[column] != NULL;
+  }
+  uint8_t header[HEADER_SIZE] = {0};
+  // the header is written last, a file that was never committed does not open
+  writer->fd = is_created ? open(writer->temporary_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644) : -1;
+  if (writer->fd < 0 || write(writer->fd, header, sizeof(header)) != sizeof(header)) {
+    replay_store_writer_destroy(writer);
+    return NULL;
+  }
+  return writer;
+}
+
+bool replay_store_writer_add(replay_store_writer_t *writer, const replay_store_game_t *game) {
+  if (writer->number_of_blocks == writer->index_capacity) {
+    block_index_t *index = realloc(writer->index, 2 * writer->index_capacity * sizeof(block_index_t));
+    if (index == NULL) {
+      return false;
+    }
+    writer->index = index;
+    writer->index_capacity *= 2;
+  }
+  uint8_t blunders;
+  uint8_t first_blunder;
+  count_blunders(game, &blunders, &first_blunder);
+  store_value(writer, REPLAY_STORE_COLUMN_STARTED, game->started);
+  store_value(writer, REPLAY_STORE_COLUMN_DURATION, game->duration);
+  store_value(writer, REPLAY_STORE_COLUMN_SECRET, game->secret);
+  for (uint8_t move = 0; move < REPLAY_STORE_MAXIMUM_MOVES; move++) {
+    bool is_played = move < game->tries;
+    store_value(writer, REPLAY_STORE_COLUMN_GUESS + move, is_played ? game->guesses[move] : REPLAY_STORE_NO_GUESS);
+    store_value(writer, REPLAY_STORE_COLUMN_FEEDBACK + move, is_played ? game->feedback[move] : REPLAY_STORE_NO_FEEDBACK);
+  }
+  store_value(writer, REPLAY_STORE_COLUMN_TRIES, game->tries);
+  store_value(writer, REPLAY_STORE_COLUMN_OUTCOME, game->outcome);
+  store_value(writer, REPLAY_STORE_COLUMN_HARD_MODE, game->is_hard_mode);
+  store_value(writer, REPLAY_STORE_COLUMN_BLUNDERS, blunders);
+  store_value(writer, REPLAY_STORE_COLUMN_FIRST_BLUNDER, first_blunder);
+  writer->number_of_games++;
+  if (++writer->games_in_block == REPLAY_STORE_BLOCK_GAMES) {
+    return flush_block(writer);
+  }
+  return true;
+}
+
+bool replay_store_writer_commit(replay_store_writer_t *writer) {
+  header_t header = {
+    .magic = REPLAY_STORE_MAGIC,
+    .version = REPLAY_STORE_VERSION,
+    .number_of_columns = REPLAY_STORE_NUMBER_OF_COLUMNS,
+    .block_games = REPLAY_STORE_BLOCK_GAMES,
+    .created_at = (int64_t) time(NULL)
+  };
+  bool is_committed = flush_block(writer);
+  header.number_of_games = writer->number_of_games;
+  header.number_of_blocks = writer->number_of_blocks;
+  header.index_offset = index_offset_of(writer->number_of_games);
+  size_t index_length = writer->number_of_blocks * sizeof(block_index_t);
+  is_committed = is_committed && write(writer->fd, writer->index, index_length) == (ssize_t) index_length &&
+                 pwrite(writer->fd, &header, sizeof(header), 0) == sizeof(header) && fdatasync(writer->fd) == 0 &&
+                 rename(writer->temporary_path, writer->path) == 0;
+  replay_store_writer_destroy(writer);
+  return is_committed;
+}
+
+void replay_store_writer_destroy(replay_store_writer_t *writer) {
+  if (writer == NULL) {
+    return;
+  }
+  if (writer->fd >= 0) {
+    close(writer->fd);
+    // gone already once it has been renamed into place
+    unlink(writer->temporary_path);
+  }
+  for (int column = 0; column < REPLAY_STORE_NUMBER_OF_COLUMNS; column++) {
+    free(writer->columns[column]);
+  }
+  free(writer->index);
+  free(writer);
+}
+
+replay_store_t* replay_store_open(const char *path) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat status;
+  if (fstat(fd, &status) < 0 || status.st_size < HEADER_SIZE) {
+    close(fd);
+    return NULL;
+  }
+  void *map = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return NULL;
+  }
+  const header_t *header = map;
+  uint64_t expected_blocks = (header->number_of_games + REPLAY_STORE_BLOCK_GAMES - 1) / REPLAY_STORE_BLOCK_GAMES;
+  if (header->magic != REPLAY_STORE_MAGIC || header->version != REPLAY_STORE_VERSION ||
+      header->number_of_columns != REPLAY_STORE_NUMBER_OF_COLUMNS || header->block_games != REPLAY_STORE_BLOCK_GAMES ||
+      header->number_of_blocks != expected_blocks ||
+      // every game takes bytes of its own, which keeps the offsets below from overflowing
+      header->number_of_games > (uint64_t) status.st_size ||
+      header->index_offset != index_offset_of(header->number_of_games) ||
+      header->index_offset + header->number_of_blocks * sizeof(block_index_t) > (uint64_t) status.st_size) {
+    munmap(map, (size_t) status.st_size);
+    return NULL;
+  }
+  replay_store_t *store = malloc(sizeof(replay_store_t));
+  if (store == NULL) {
+    munmap(map, (size_t) status.st_size);
+    return NULL;
+  }
+  // scans read every block front to back
+  madvise(map, (size_t) status.st_size, MADV_SEQUENTIAL);
+  store->map = map;
+  store->map_size = (size_t) status.st_size;
+  store->header = header;
+  store->index = (const block_index_t *)((const uint8_t *) map + header->index_offset);
+  store->blocks = (const uint8_t *) map + HEADER_SIZE;
+  return store;
+}
+
+void replay_store_close(replay_store_t *store) {
+  munmap(store->map, store->map_size);
+  free(store);
+}
+
+uint64_t replay_store_number_of_games(const replay_store_t *store) {
+  return store->header->number_of_games;
+}
+
+uint64_t replay_store_number_of_blocks(const replay_store_t *store) {
+  return store->header->number_of_blocks;
+}
+
+static uint64_t value_at(const uint8_t *values, size_t width, size_t i) {
+  switch (width) {
+  case sizeof(uint64_t):
+    return ((const uint64_t *) values)[i];
+  case sizeof(uint32_t):
+    return ((const uint32_t *) values)[i];
+  case sizeof(uint16_t):
+    return ((const uint16_t *) values)[i];
+  default:
+    return values[i];
+  }
+}
+
+size_t replay_store_read_block(const replay_store_t *store, uint64_t block, replay_store_game_t games[]) {
+  size_t number_of_games;
+  const uint8_t *columns[REPLAY_STORE_NUMBER_OF_COLUMNS];
+  size_t widths[REPLAY_STORE_NUMBER_OF_COLUMNS];
+  for (int column = 0; column < REPLAY_STORE_NUMBER_OF_COLUMNS; column++) {
+    columns[column] = column_of_block(store, block, (replay_store_column_t) column, &number_of_games);
+    widths[column] = replay_store_column_width((replay_store_column_t) column);
+  }
+#define VALUE(column) value_at(columns[column], widths[column], i)
+  for (size_t i = 0; i < number_of_games; i++) {
+    replay_store_game_t *game = &games[i];
+    game->started = VALUE(REPLAY_STORE_COLUMN_STARTED);
+    game->duration = (uint32_t) VALUE(REPLAY_STORE_COLUMN_DURATION);
+    game->secret = (game_logic_code_t) VALUE(REPLAY_STORE_COLUMN_SECRET);
+    game->tries = (uint8_t) VALUE(REPLAY_STORE_COLUMN_TRIES);
+    game->outcome = (uint8_t) VALUE(REPLAY_STORE_COLUMN_OUTCOME);
+    game->is_hard_mode = (uint8_t) VALUE(REPLAY_STORE_COLUMN_HARD_MODE);
+    for (uint8_t move = 0; move < REPLAY_STORE_MAXIMUM_MOVES; move++) {
+      game->guesses[move] = (game_logic_code_t) VALUE(REPLAY_STORE_COLUMN_GUESS + move);
+      game->feedback[move] = (uint8_t) VALUE(REPLAY_STORE_COLUMN_FEEDBACK + move);
+    }
+  }
+#undef VALUE
+  return number_of_games;
+}
+
+// branch free so the compiler turns each loop into vector compares over the whole column
+#define FILTER_COLUMN(type)                                                                   \
+  do {                                                                                        \
+    const type *typed = (const type *) values;                                                \
+    type low_value = (type) low;                                                              \
+    type high_value = (type) high;                                                            \
+    for (size_t i = 0; i < number_of_games; i++) {                                           \
+      mask[i] &= (uint8_t)((typed[i] >= low_value) & (typed[i] <= high_value));               \
+    }                                                                                         \
+  } while (0)
+
+static void filter_column(const uint8_t *values, size_t width, size_t number_of_games, uint64_t low, uint64_t high,
+                          uint8_t mask[]) {
+  // a bound past the column's type is clamped, it already holds for every value the column can have
+  uint64_t largest = width == sizeof(uint64_t) ? UINT64_MAX : (UINT64_C(1) << (8 * width)) - 1;
+  high = high > largest ? largest : high;
+  switch (width) {
+  case sizeof(uint64_t):
+    FILTER_COLUMN(uint64_t);
+    break;
+  case sizeof(uint32_t):
+    FILTER_COLUMN(uint32_t);
+    break;
+  case sizeof(uint16_t):
+    FILTER_COLUMN(uint16_t);
+    break;
+  default:
+    FILTER_COLUMN(uint8_t);
+    break;
+  }
+}
+
+static void widen_column(const uint8_t *values, size_t width, size_t number_of_games, uint32_t widened[]) {
+  for (size_t i = 0; i < number_of_games; i++) {
+    widened[i] = width == sizeof(uint32_t) ? ((const uint32_t *) values)[i]
+               : width == sizeof(uint16_t) ? ((const uint16_t *) values)[i] : values[i];
+  }
+}
+
+static bool is_query_valid(const replay_store_query_t *query) {
+  if (query->number_of_filters > REPLAY_STORE_MAXIMUM_FILTERS) {
+    return false;
+  }
+  for (size_t i = 0; i < query->number_of_filters; i++) {
+    if (query->filters[i].column >= REPLAY_STORE_NUMBER_OF_COLUMNS) {
+      return false;
+    }
+  }
+  switch (query->aggregate) {
+  case REPLAY_STORE_COUNT:
+    return true;
+  case REPLAY_STORE_HISTOGRAM:
+    return query->column < REPLAY_STORE_NUMBER_OF_COLUMNS && replay_store_column_width(query->column) <= sizeof(uint16_t);
+  case REPLAY_STORE_AVERAGE:
+    return query->column < REPLAY_STORE_NUMBER_OF_COLUMNS && query->group_by < REPLAY_STORE_NUMBER_OF_COLUMNS &&
+           replay_store_column_width(query->column) <= sizeof(uint32_t) &&
+           replay_store_column_width(query->group_by) <= sizeof(uint16_t);
+  }
+  return false;
+}
+
+// false when a filter rules the whole block out by its zone map, the mask is only filled when some games
+// of the block fail a filter
+static bool filter_block(const replay_store_t *store, const replay_store_query_t *query, uint64_t block,
+                         uint8_t mask[], bool *is_masked, replay_store_result_t *result) {
+  const block_index_t *index = &store->index[block];
+  *is_masked = false;
+  for (size_t i = 0; i < query->number_of_filters; i++) {
+    const replay_store_filter_t *filter = &query->filters[i];
+    if (index->maximum[filter->column] < filter->low || index->minimum[filter->column] > filter->high) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < query->number_of_filters; i++) {
+    const replay_store_filter_t *filter = &query->filters[i];
+    if (index->minimum[filter->column] >= filter->low && index->maximum[filter->column] <= filter->high) {
+      continue;
+    }
+    size_t number_of_games;
+    const uint8_t *values = column_of_block(store, block, filter->column, &number_of_games);
+    size_t width = replay_store_column_width(filter->column);
+    if (!*is_masked) {
+      memset(mask, 1, number_of_games);
+      *is_masked = true;
+    }
+    filter_column(values, width, number_of_games, filter->low, filter->high, mask);
+    result->bytes_scanned += width * number_of_games;
+  }
+  return true;
+}
+
+static void aggregate_block(const replay_store_t *store, const replay_store_query_t *query, uint64_t block,
+                            const uint8_t mask[], bool is_masked, uint32_t values[], uint32_t groups[],
+                            replay_store_result_t *result) {
+  size_t number_of_games;
+  const uint8_t *column = column_of_block(store, block, query->column, &number_of_games);
+  uint64_t selected = number_of_games;
+  if (is_masked) {
+    selected = 0;
+    for (size_t i = 0; i < number_of_games; i++) {
+      selected += mask[i];
+    }
+  }
+  result->games_selected += selected;
+  if (query->aggregate == REPLAY_STORE_COUNT || selected == 0) {
+    return;
+  }
+  size_t width = replay_store_column_width(query->column);
+  widen_column(column, width, number_of_games, values);
+  result->bytes_scanned += width * number_of_games;
+  if (query->aggregate == REPLAY_STORE_HISTOGRAM) {
+    for (size_t i = 0; i < number_of_games; i++) {
+      result->counts[values[i]] += is_masked ? mask[i] : 1;
+    }
+    return;
+  }
+  const uint8_t *group_column = column_of_block(store, block, query->group_by, &number_of_games);
+  size_t group_width = replay_store_column_width(query->group_by);
+  widen_column(group_column, group_width, number_of_games, groups);
+  result->bytes_scanned += group_width * number_of_games;
+  for (size_t i = 0; i < number_of_games; i++) {
+    uint64_t weight = is_masked ? mask[i] : 1;
+    result->counts[groups[i]] += weight;
+    result->sums[groups[i]] += weight * values[i];
+  }
+}
+
+bool replay_store_run(const replay_store_t *store, const replay_store_query_t *query, replay_store_result_t *result) {
+  memset(result, 0, sizeof(*result));
+  if (!is_query_valid(query)) {
+    return false;
+  }
+  uint8_t *mask = malloc(REPLAY_STORE_BLOCK_GAMES);
+  uint32_t *values = malloc(REPLAY_STORE_BLOCK_GAMES * sizeof(uint32_t));
+  uint32_t *groups = malloc(REPLAY_STORE_BLOCK_GAMES * sizeof(uint32_t));
+  if (query->aggregate != REPLAY_STORE_COUNT) {
+    result->counts = calloc(REPLAY_STORE_MAXIMUM_GROUPS, sizeof(uint64_t));
+    result->sums = calloc(REPLAY_STORE_MAXIMUM_GROUPS, sizeof(uint64_t));
+  }
+  bool is_run = mask != NULL && values != NULL && groups != NULL &&
+                (query->aggregate == REPLAY_STORE_COUNT || (result->counts != NULL && result->sums != NULL));
+  for (uint64_t block = 0; is_run && block < store->header->number_of_blocks; block++) {
+    bool is_masked;
+    uint64_t games_left = store->header->number_of_games - block * REPLAY_STORE_BLOCK_GAMES;
+    result->games_scanned += games_left < REPLAY_STORE_BLOCK_GAMES ? games_left : REPLAY_STORE_BLOCK_GAMES;
+    if (!filter_block(store, query, block, mask, &is_masked, result)) {
+      result->blocks_skipped++;
+      continue;
+    }
+    result->blocks_scanned++;
+    aggregate_block(store, query, block, mask, is_masked, values, groups, result);
+  }
+  free(mask);
+  free(values);
+  free(groups);
+  if (!is_run) {
+    replay_store_result_free(result);
+  }
+  return is_run;
+}
+
+void replay_store_result_free(replay_store_result_t *result) {
+  free(result->counts);
+  free(result->sums);
+  result->counts = NULL;
+  result->sums = NULL;
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include "replay_verifier.h"
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "game_journal.h"
+
+typedef struct {
+  const replay_store_t *store;
+  uint64_t next_block;
+} shared_replay_t;
+
+typedef struct {
+  shared_replay_t *shared;
+  replay_store_game_t *games;
+  uint64_t games_checked;
+  uint64_t moves;
+  uint64_t games_diverged;
+  replay_verifier_divergence_t divergences[REPLAY_VERIFIER_MAXIMUM_DIVERGENCES];
+  size_t number_of_divergences;
+} worker_t;
+
+static replay_verifier_kind_t diverge(replay_verifier_divergence_t *divergence, replay_verifier_kind_t kind,
+                                      uint8_t move, uint8_t recorded, uint8_t replayed) {
+  divergence->kind = kind;
+  divergence->move = move;
+  divergence->recorded = recorded;
+  divergence->replayed = replayed;
+  return kind;
+}
+
+replay_verifier_kind_t replay_verifier_check_game(const replay_store_game_t *game,
+                                                  replay_verifier_divergence_t *divergence) {
+  if (game->secret >= NUMBER_OF_POSSIBLE_CODES || game->tries > REPLAY_STORE_MAXIMUM_MOVES) {
+    return diverge(divergence, REPLAY_VERIFIER_MALFORMED, 0, 0, 0);
+  }
+  game_logic_values_t answer[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_unpack_code(game->secret, answer);
+  game_logic_move_t history[REPLAY_STORE_MAXIMUM_MOVES];
+  bool is_won = false;
+  for (uint8_t move = 0; move < game->tries; move++) {
+    game_logic_code_t guess = game->guesses[move];
+    uint8_t recorded = game->feedback[move];
+    if (guess >= NUMBER_OF_POSSIBLE_CODES || recorded >= NUMBER_OF_FEEDBACK_CLASSES) {
+      return diverge(divergence, REPLAY_VERIFIER_MALFORMED, move, recorded, 0);
+    }
+    if (is_won) {
+      return diverge(divergence, REPLAY_VERIFIER_OUTCOME, move, game->outcome, GAME_JOURNAL_END_WON);
+    }
+    game_logic_unpack_code(guess, history[move].guess);
+    // the same rule as the consistent set of a hard mode context, without rebuilding it for every game
+    if (game->is_hard_mode && game_logic_find_contradicted_move(history, move, history[move].guess) < move) {
+      return diverge(divergence, REPLAY_VERIFIER_REFUSED, move, recorded, REPLAY_STORE_NO_FEEDBACK);
+    }
+    history[move].feedback = game_logic_score(answer, history[move].guess);
+    uint8_t replayed = game_logic_feedback_to_class(history[move].feedback);
+    uint8_t tabled = game_logic_score_row(guess)[game->secret];
+    if (tabled != replayed) {
+      return diverge(divergence, REPLAY_VERIFIER_SCORE_TABLE, move, tabled, replayed);
+    }
+    if (replayed != recorded) {
+      return diverge(divergence, REPLAY_VERIFIER_FEEDBACK, move, recorded, replayed);
+    }
+    is_won = history[move].feedback.is_guess_correct;
+  }
+  if (is_won != (game->outcome == GAME_JOURNAL_END_WON)) {
+    uint8_t last_move = game->tries > 0 ? (uint8_t)(game->tries - 1) : 0;
+    return diverge(divergence, REPLAY_VERIFIER_OUTCOME, last_move, game->outcome,
+                   is_won ? GAME_JOURNAL_END_WON : GAME_JOURNAL_END_LOST);
+  }
+  return REPLAY_VERIFIER_AGREES;
+}
+
+// every worker takes blocks in increasing order, so the divergences it keeps are its lowest numbered ones
+static void* replay_blocks(void *argument) {
+  worker_t *worker = argument;
+  uint64_t number_of_blocks = replay_store_number_of_blocks(worker->shared->store);
+  for (;;) {
+    uint64_t block = __atomic_fetch_add(&worker->shared->next_block, 1, __ATOMIC_RELAXED);
+    if (block >= number_of_blocks) {
+      return NULL;
+    }
+    size_t number_of_games = replay_store_read_block(worker->shared->store, block, worker->games);
+    for (size_t i = 0; i < number_of_games; i++) {
+      const replay_store_game_t *game = &worker->games[i];
+      replay_verifier_divergence_t divergence;
+      worker->moves += game->tries < REPLAY_STORE_MAXIMUM_MOVES ? game->tries : REPLAY_STORE_MAXIMUM_MOVES;
+      if (replay_verifier_check_game(game, &divergence) == REPLAY_VERIFIER_AGREES) {
+        continue;
+      }
+      worker->games_diverged++;
+      if (worker->number_of_divergences < REPLAY_VERIFIER_MAXIMUM_DIVERGENCES) {
+        divergence.game = block * REPLAY_STORE_BLOCK_GAMES + i;
+        worker->divergences[worker->number_of_divergences++] = divergence;
+      }
+    }
+    worker->games_checked += number_of_games;
+  }
+}
+
+static int compare_by_game(const void *left, const void *right) {
+  uint64_t left_game = ((const replay_verifier_divergence_t *) left)->game;
+  uint64_t right_game = ((const replay_verifier_divergence_t *) right)->game;
+  return left_game < right_game ? -1 : left_game > right_game ? 1 : 0;
+}
+
+static void merge_divergences(worker_t workers[], size_t number_of_workers, replay_verifier_divergence_t merged[],
+                              replay_verifier_result_t *result) {
+  size_t number_merged = 0;
+  for (size_t i = 0; i < number_of_workers; i++) {
+    result->games += workers[i].games_checked;
+    result->moves += workers[i].moves;
+    result->games_diverged += workers[i].games_diverged;
+    memcpy(&merged[number_merged], workers[i].divergences,
+           workers[i].number_of_divergences * sizeof(replay_verifier_divergence_t));
+    number_merged += workers[i].number_of_divergences;
+  }
+  qsort(merged, number_merged, sizeof(replay_verifier_divergence_t), compare_by_game);
+  result->number_of_divergences = number_merged < REPLAY_VERIFIER_MAXIMUM_DIVERGENCES ? number_merged
+                                                                                      : REPLAY_VERIFIER_MAXIMUM_DIVERGENCES;
+  memcpy(result->divergences, merged, result->number_of_divergences * sizeof(replay_verifier_divergence_t));
+}
+
+bool replay_verifier_run(const replay_store_t *store, size_t number_of_threads, replay_verifier_result_t *result) {
+  memset(result, 0, sizeof(*result));
+  if (number_of_threads == 0) {
+    number_of_threads = 1;
+  }
+  if (number_of_threads > REPLAY_VERIFIER_MAXIMUM_THREADS) {
+    number_of_threads = REPLAY_VERIFIER_MAXIMUM_THREADS;
+  }
+  // no more threads than blocks to share out
+  uint64_t number_of_blocks = replay_store_number_of_blocks(store);
+  if (number_of_threads > number_of_blocks) {
+    number_of_threads = number_of_blocks > 0 ? (size_t) number_of_blocks : 1;
+  }
+
+  shared_replay_t shared = {.store = store};
+  worker_t *workers = calloc(number_of_threads, sizeof(worker_t));
+  if (workers == NULL) {
+    return false;
+  }
+  replay_verifier_divergence_t *merged =
+    malloc(number_of_threads * REPLAY_VERIFIER_MAXIMUM_DIVERGENCES * sizeof(replay_verifier_divergence_t));
+  bool is_allocated = merged != NULL;
+  for (size_t i = 0; i < number_of_threads && is_allocated; i++) {
+    workers[i].shared = &shared;
+    workers[i].games = malloc(REPLAY_STORE_BLOCK_GAMES * sizeof(replay_store_game_t));
+    is_allocated = workers[i].games != NULL;
+  }
+  if (is_allocated) {
+    pthread_t threads[REPLAY_VERIFIER_MAXIMUM_THREADS];
+    size_t started = 0;
+    // the calling thread is the first worker
+    for (size_t i = 1; i < number_of_threads; i++) {
+      if (pthread_create(&threads[started], NULL, replay_blocks, &workers[i]) == 0) {
+        started++;
+      }
+    }
+    replay_blocks(&workers[0]);
+    for (size_t i = 0; i < started; i++) {
+      pthread_join(threads[i], NULL);
+    }
+    merge_divergences(workers, number_of_threads, merged, result);
+  }
+  for (size_t i = 0; i < number_of_threads; i++) {
+    free(workers[i].games);
+  }
+  free(workers);
+  free(merged);
+  return is_allocated;
+}
\ No newline at end of file
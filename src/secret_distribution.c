@@ -0,0 +1,188 @@
+#include "secret_distribution.h"
+#include <ctype.h>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "random.h"
+
+#define RANDOM_FRACTION_BITS 15
+#define MAXIMUM_LINE_LENGTH 64
+
+typedef enum {
+  DISTRIBUTION_NO_DUPLICATES,
+  DISTRIBUTION_WEIGHTED
+} distribution_kind_t;
+
+// Vose alias table over the codes that can be drawn, a draw is one uniform column and one biased coin
+static distribution_kind_t kind = DISTRIBUTION_NO_DUPLICATES;
+static game_logic_code_t codes[NUMBER_OF_POSSIBLE_CODES];
+static size_t number_of_codes = 0;
+static double probabilities[NUMBER_OF_POSSIBLE_CODES];
+static uint16_t aliases[NUMBER_OF_POSSIBLE_CODES];
+
+static double random_fraction(void) {
+  return (double)(random_value() & ((1 << RANDOM_FRACTION_BITS) - 1)) / (1 << RANDOM_FRACTION_BITS);
+}
+
+static bool has_duplicates(const game_logic_values_t values[]) {
+  bool is_seen[GAME_VALUE_MAX] = {0};
+  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    if (is_seen[values[i]]) {
+      return true;
+    }
+    is_seen[values[i]] = true;
+  }
+  return false;
+}
+
+void secret_distribution_use_no_duplicates(void) {
+  kind = DISTRIBUTION_NO_DUPLICATES;
+  number_of_codes = 0;
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    game_logic_unpack_code(i, values);
+    if (!has_duplicates(values)) {
+      codes[number_of_codes++] = i;
+    }
+  }
+}
+
+bool secret_distribution_use_weights(const double weights[NUMBER_OF_POSSIBLE_CODES]) {
+  double total = 0.0;
+  size_t count = 0;
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    if (weights[i] < 0.0) {
+      return false;
+    }
+    if (weights[i] > 0.0) {
+      total += weights[i];
+      count++;
+    }
+  }
+  if (count == 0) {
+    return false;
+  }
+
+  kind = DISTRIBUTION_WEIGHTED;
+  number_of_codes = 0;
+  uint16_t small[NUMBER_OF_POSSIBLE_CODES];
+  uint16_t large[NUMBER_OF_POSSIBLE_CODES];
+  size_t number_of_small = 0;
+  size_t number_of_large = 0;
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    if (weights[i] > 0.0) {
+      probabilities[number_of_codes] = weights[i] * (double) count / total;
+      if (probabilities[number_of_codes] < 1.0) {
+        small[number_of_small++] = (uint16_t) number_of_codes;
+      } else {
+        large[number_of_large++] = (uint16_t) number_of_codes;
+      }
+      codes[number_of_codes++] = i;
+    }
+  }
+
+  // each column is topped up to 1 by borrowing from a column with too much probability
+  while (number_of_small > 0 && number_of_large > 0) {
+    uint16_t less = small[--number_of_small];
+    uint16_t more = large[--number_of_large];
+    aliases[less] = more;
+    probabilities[more] -= 1.0 - probabilities[less];
+    if (probabilities[more] < 1.0) {
+      small[number_of_small++] = more;
+    } else {
+      large[number_of_large++] = more;
+    }
+  }
+  // whatever is left over only differs from 1 by rounding
+  while (number_of_large > 0) {
+    probabilities[large[--number_of_large]] = 1.0;
+  }
+  while (number_of_small > 0) {
+    probabilities[small[--number_of_small]] = 1.0;
+  }
+  return true;
+}
+
+bool secret_distribution_load_file(const char *path) {
+  FILE *file = fopen(path, "r");
+  if (file == NULL) {
+    return false;
+  }
+  static double weights[NUMBER_OF_POSSIBLE_CODES];
+  memset(weights, 0, sizeof(weights));
+  char line[MAXIMUM_LINE_LENGTH];
+  bool is_valid = true;
+  while (is_valid && fgets(line, sizeof(line), file) != NULL) {
+    // the tail of a line that did not fit would be read as a line of its own
+    if (strchr(line, '\n') == NULL && !feof(file)) {
+      is_valid = false;
+      break;
+    }
+    if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') {
+      continue;
+    }
+    game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+    for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS && is_valid; i++) {
+      is_valid = line[i] >= 'A' && line[i] < 'A' + GAME_VALUE_MAX;
+      values[i] = (game_logic_values_t)(line[i] - 'A');
+    }
+    // the code has to end where the weight starts, ABCDE is not ABCD
+    char *rest = line + NUMBER_OF_VALUES_TO_GUESS;
+    is_valid = is_valid && (*rest == '\0' || isspace((unsigned char) *rest));
+    double weight = 1.0;
+    while (is_valid && isspace((unsigned char) *rest)) {
+      rest++;
+    }
+    if (is_valid && *rest != '\0') {
+      char *end;
+      weight = strtod(rest, &end);
+      // nan fails both comparisons
+      is_valid = end != rest && weight > 0.0 && weight <= DBL_MAX;
+      while (isspace((unsigned char) *end)) {
+        end++;
+      }
+      is_valid = is_valid && *end == '\0';
+    }
+    if (is_valid) {
+      weights[game_logic_pack_code(values)] += weight;
+    }
+  }
+  fclose(file);
+  return is_valid && secret_distribution_use_weights(weights);
+}
+
+void secret_distribution_generate_answer(void) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  if (kind == DISTRIBUTION_NO_DUPLICATES) {
+    // partial Fisher-Yates, only the first NUMBER_OF_VALUES_TO_GUESS slots are ever shuffled
+    game_logic_values_t pool[GAME_VALUE_MAX];
+    for (uint_fast8_t i = 0; i < GAME_VALUE_MAX; i++) {
+      pool[i] = (game_logic_values_t) i;
+    }
+    for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+      uint_fast8_t j = (uint_fast8_t)(i + random_value() % (GAME_VALUE_MAX - i));
+      values[i] = pool[j];
+      pool[j] = pool[i];
+    }
+  } else {
+    size_t column = (size_t) random_value() % number_of_codes;
+    game_logic_code_t code = random_fraction() < probabilities[column] ? codes[column] : codes[aliases[column]];
+    game_logic_unpack_code(code, values);
+  }
+  game_logic_set_answer(values);
+}
+
+void secret_distribution_start_no_duplicates(void) {
+  secret_distribution_use_no_duplicates();
+  secret_distribution_generate_answer();
+}
+
+size_t secret_distribution_get_codes(const game_logic_code_t **codes_out) {
+  *codes_out = codes;
+  return number_of_codes;
+}
+
+solver_hint_t secret_distribution_get_hint(const game_logic_move_t history[], size_t history_length) {
+  return solver_get_hint_in_space(codes, number_of_codes, history, history_length);
+}
\ No newline at end of file
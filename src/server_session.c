@@ -0,0 +1,579 @@
+#define _GNU_SOURCE
+#include "server_session.h"
+#include <inttypes.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/random.h>
+
+#define STRING_EQUAL 0
+#define TOKEN_DIGITS 16
+
+static const char code_characters[GAME_VALUE_MAX] = {'A', 'B', 'C', 'D', 'E', 'F'};
+
+static void respond(server_session_t *session, const char *format, ...) {
+  va_list arguments;
+  va_start(arguments, format);
+  int length = vsnprintf(session->output + session->output_length,
+                         SERVER_SESSION_OUTPUT_SIZE - session->output_length, format, arguments);
+  va_end(arguments);
+  // a response is only started with SERVER_SESSION_MAXIMUM_RESPONSE bytes free so it always fits
+  if (length > 0 && (size_t) length < SERVER_SESSION_OUTPUT_SIZE - session->output_length) {
+    session->output_length += (size_t) length;
+  }
+}
+
+static void respond_error(server_session_t *session, const char *reason) {
+  SERVER_SESSION_COUNT(session->shard->stats.errors);
+  respond(session, "ERR %s\n", reason);
+}
+
+static uint32_t next_random(uint32_t *state) {
+  // xorshift32, each thread owns its stream so rand() is never shared across threads
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+static void arm_move_clock(server_session_t *session, server_session_game_t *game) {
+  timer_wheel_t *timers = session->shard->timers;
+  if (timers != NULL && session->shard->move_timeout > 0) {
+    timer_wheel_arm(timers, &game->move_timer, timer_wheel_now(timers) + session->shard->move_timeout);
+  }
+}
+
+static server_session_t* session_of_game(server_session_game_t *game) {
+  return (server_session_t *)((char *)(game - game->slot) - offsetof(server_session_t, games));
+}
+
+static void journal(server_session_t *session, const server_session_game_t *game, game_journal_record_t *record) {
+  if (session->shard->journal == NULL) {
+    return;
+  }
+  record->slot = game->slot;
+  record->is_hard_mode = game->context.is_hard_mode;
+  record->game_id = game->id;
+  record->token = session->token;
+  record->time = game_journal_clock();
+  game_journal_append(session->shard->journal, record);
+}
+
+static void journal_start(server_session_t *session, server_session_game_t *game) {
+  game->id = session->shard->next_game_id;
+  session->shard->next_game_id += session->shard->game_id_stride;
+  game_journal_record_t record = {
+    .event = GAME_JOURNAL_EVENT_NEW,
+    .code = game_logic_pack_code(game->context.answer)
+  };
+  journal(session, game, &record);
+}
+
+static void journal_guess(server_session_t *session, server_session_game_t *game, game_logic_code_t guess,
+                          game_logic_feedback_t feedback) {
+  game_journal_record_t record = {
+    .event = GAME_JOURNAL_EVENT_GUESS,
+    .code = guess,
+    .correct_value_and_placement = (uint8_t) feedback.number_of_correct_value_and_placement,
+    .correct_value_only = (uint8_t) feedback.number_of_correct_value_only
+  };
+  journal(session, game, &record);
+}
+
+static void journal_end(server_session_t *session, server_session_game_t *game, game_journal_end_t reason) {
+  game_journal_record_t record = {
+    .event = GAME_JOURNAL_EVENT_END,
+    .end_reason = (uint8_t) reason,
+    .code = game_logic_pack_code(game->context.answer)
+  };
+  journal(session, game, &record);
+}
+
+static void start_game(server_session_t *session, server_session_game_t *game, bool is_hard_mode) {
+  if (game->is_playing) {
+    journal_end(session, game, GAME_JOURNAL_END_ABANDONED);
+  }
+  if (session->shard->random_state == 0) {
+    game_logic_context_start(&game->context, is_hard_mode);
+  } else {
+    game_logic_values_t answer[NUMBER_OF_VALUES_TO_GUESS];
+    for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+      answer[i] = (game_logic_values_t)(next_random(&session->shard->random_state) % GAME_VALUE_MAX);
+    }
+    game_logic_context_set_answer(&game->context, answer);
+    game->context.is_hard_mode = is_hard_mode;
+  }
+  SERVER_SESSION_COUNT(session->shard->stats.games_started);
+  game->tries = 0;
+  game->is_playing = true;
+  game->is_timed_out = false;
+  journal_start(session, game);
+  arm_move_clock(session, game);
+}
+
+static void end_game(server_session_t *session, server_session_game_t *game, game_journal_end_t reason) {
+  journal_end(session, game, reason);
+  game->is_playing = false;
+  if (session->shard->timers != NULL) {
+    timer_wheel_cancel(session->shard->timers, &game->move_timer);
+  }
+}
+
+typedef enum {
+  GUESS_TIMED_OUT,
+  GUESS_NO_GAME,
+  GUESS_HARD_MODE,
+  GUESS_SCORED,
+  GUESS_WON,
+  GUESS_LOST
+} guess_outcome_t;
+
+// the game rules both protocols share, only how the outcome is written differs
+static guess_outcome_t play_guess(server_session_t *session, server_session_game_t *game,
+                                  const game_logic_values_t guess[], game_logic_feedback_t *feedback) {
+  if (game->is_timed_out) {
+    game->is_timed_out = false;
+    return GUESS_TIMED_OUT;
+  }
+  if (!game->is_playing) {
+    return GUESS_NO_GAME;
+  }
+  if (game_logic_context_guess(&game->context, guess, feedback) != GAME_LOGIC_GUESS_ACCEPTED) {
+    return GUESS_HARD_MODE;
+  }
+  game->history[game->tries] = game_logic_pack_code(guess);
+  journal_guess(session, game, game->history[game->tries++], *feedback);
+  SERVER_SESSION_COUNT(session->shard->stats.guesses);
+  if (feedback->is_guess_correct) {
+    SERVER_SESSION_COUNT(session->shard->stats.games_won);
+    end_game(session, game, GAME_JOURNAL_END_WON);
+    return GUESS_WON;
+  }
+  if (game->tries == SERVER_SESSION_MAXIMUM_NUMBER_OF_TRIES) {
+    end_game(session, game, GAME_JOURNAL_END_LOST);
+    return GUESS_LOST;
+  }
+  arm_move_clock(session, game);
+  return GUESS_SCORED;
+}
+
+static bool parse_code(const char *text, size_t length, game_logic_values_t values[]) {
+  if (length != NUMBER_OF_VALUES_TO_GUESS) {
+    return false;
+  }
+  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    if (text[i] < code_characters[0] || text[i] > code_characters[GAME_VALUE_MAX - 1]) {
+      return false;
+    }
+    values[i] = (game_logic_values_t)(text[i] - code_characters[0]);
+  }
+  return true;
+}
+
+static void respond_with_answer(server_session_t *session, const char *label) {
+  const game_logic_values_t *answer = session->games[0].context.answer;
+  respond(session, "%s %c%c%c%c\n", label, code_characters[answer[0]], code_characters[answer[1]],
+          code_characters[answer[2]], code_characters[answer[3]]);
+}
+
+static void handle_guess(server_session_t *session, const char *argument, size_t length) {
+  game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+  server_session_game_t *game = &session->games[0];
+  if (!parse_code(argument, length, guess)) {
+    respond_error(session, "BAD_GUESS");
+    return;
+  }
+  game_logic_feedback_t feedback;
+  switch (play_guess(session, game, guess, &feedback)) {
+  case GUESS_TIMED_OUT:
+    respond_with_answer(session, "TIMEOUT");
+    break;
+  case GUESS_NO_GAME:
+    respond_error(session, "NO_GAME");
+    break;
+  case GUESS_HARD_MODE:
+    respond_error(session, "HARD_MODE");
+    break;
+  case GUESS_WON:
+    respond(session, "WON %d\n", game->tries);
+    break;
+  case GUESS_LOST:
+    respond_with_answer(session, "LOST");
+    break;
+  case GUESS_SCORED:
+    respond(session, "FEEDBACK %d %d\n", feedback.number_of_correct_value_and_placement,
+            feedback.number_of_correct_value_only);
+    break;
+  }
+}
+
+// tokens hand games to whoever presents them, so they come from the kernel rather than the answer stream
+static void handle_token(server_session_t *session) {
+  while (session->token == 0) {
+    if (getrandom(&session->token, sizeof(session->token), 0) != sizeof(session->token)) {
+      session->token = 0;
+      respond_error(session, "NO_TOKEN");
+      return;
+    }
+  }
+  respond(session, "TOKEN %016" PRIx64 "\n", session->token);
+}
+
+static void restore_game(server_session_t *session, server_session_game_t *game, const session_snapshot_game_t *saved) {
+  if (game->is_playing) {
+    journal_end(session, game, GAME_JOURNAL_END_ABANDONED);
+  }
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_unpack_code(saved->answer, values);
+  game_logic_context_set_answer(&game->context, values);
+  game->context.is_hard_mode = saved->is_hard_mode;
+  game->tries = 0;
+  // a game saved without the journal starts its journal history here
+  bool needs_journal_start = saved->game_id == 0 && session->shard->journal != NULL;
+  game->id = saved->game_id;
+  if (needs_journal_start) {
+    journal_start(session, game);
+  }
+  // replaying the history rebuilds the hard mode set of codes still consistent with it
+  for (uint8_t i = 0; i < saved->tries && i < SERVER_SESSION_MAXIMUM_NUMBER_OF_TRIES; i++) {
+    game_logic_feedback_t feedback;
+    game_logic_unpack_code(saved->history[i], values);
+    game_logic_context_guess(&game->context, values, &feedback);
+    game->history[game->tries++] = saved->history[i];
+    if (needs_journal_start) {
+      journal_guess(session, game, saved->history[i], feedback);
+    }
+  }
+  game->is_playing = true;
+  game->is_timed_out = false;
+  timer_wheel_t *timers = session->shard->timers;
+  if (timers != NULL && session->shard->move_timeout > 0) {
+    uint32_t left = saved->move_milliseconds > 0 ? saved->move_milliseconds : session->shard->move_timeout;
+    timer_wheel_arm(timers, &game->move_timer, timer_wheel_now(timers) + left);
+  }
+}
+
+static void handle_resume(server_session_t *session, const char *argument, size_t length) {
+  char digits[TOKEN_DIGITS + 1];
+  char *end;
+  if (length == 0 || length > TOKEN_DIGITS) {
+    respond_error(session, "BAD_ARGUMENT");
+    return;
+  }
+  memcpy(digits, argument, length);
+  digits[length] = '\0';
+  uint64_t token = strtoull(digits, &end, 16);
+  if (*end != '\0' || token == 0) {
+    respond_error(session, "BAD_ARGUMENT");
+    return;
+  }
+  int number_of_games = 0;
+  for (uint8_t slot = 0; slot < SERVER_SESSION_MAXIMUM_GAMES && session->shard->restored != NULL; slot++) {
+    const session_snapshot_game_t *saved = session_snapshot_claim(session->shard->restored, token, slot);
+    if (saved != NULL) {
+      restore_game(session, &session->games[slot], saved);
+      number_of_games++;
+    }
+  }
+  if (number_of_games == 0) {
+    respond_error(session, "UNKNOWN_TOKEN");
+    return;
+  }
+  session->token = token;
+  respond(session, "RESUMED %d\n", number_of_games);
+}
+
+static void handle_line(server_session_t *session, const char *line, size_t length) {
+  if (length > 0 && line[length - 1] == '\r') {
+    length--;
+  }
+  if (length == 0) {
+    return;
+  }
+  const char *space = memchr(line, ' ', length);
+  size_t command_length = space != NULL ? (size_t)(space - line) : length;
+  const char *argument = space != NULL ? space + 1 : line + length;
+  size_t argument_length = (size_t)(line + length - argument);
+
+  if (command_length == 3 && strncmp(line, "NEW", 3) == STRING_EQUAL) {
+    bool is_hard_mode = argument_length == 4 && strncmp(argument, "HARD", 4) == STRING_EQUAL;
+    if (argument_length != 0 && !is_hard_mode) {
+      respond_error(session, "BAD_ARGUMENT");
+      return;
+    }
+    start_game(session, &session->games[0], is_hard_mode);
+    respond(session, "READY %d\n", SERVER_SESSION_MAXIMUM_NUMBER_OF_TRIES);
+  } else if (command_length == 5 && strncmp(line, "GUESS", 5) == STRING_EQUAL) {
+    handle_guess(session, argument, argument_length);
+  } else if (command_length == 6 && strncmp(line, "GIVEUP", 6) == STRING_EQUAL) {
+    if (!session->games[0].is_playing) {
+      respond_error(session, "NO_GAME");
+      return;
+    }
+    end_game(session, &session->games[0], GAME_JOURNAL_END_GAVE_UP);
+    respond_with_answer(session, "ANSWER");
+  } else if (command_length == 8 && strncmp(line, "PROTOCOL", 8) == STRING_EQUAL) {
+    if (argument_length != 6 || strncmp(argument, "BINARY", 6) != STRING_EQUAL) {
+      respond_error(session, "BAD_ARGUMENT");
+      return;
+    }
+    session->protocol = SERVER_SESSION_PROTOCOL_BINARY;
+    respond(session, "BINARY %d\n", SERVER_SESSION_FRAME_SIZE);
+  } else if (command_length == 5 && strncmp(line, "TOKEN", 5) == STRING_EQUAL) {
+    handle_token(session);
+  } else if (command_length == 6 && strncmp(line, "RESUME", 6) == STRING_EQUAL) {
+    handle_resume(session, argument, argument_length);
+  } else if (command_length == 4 && strncmp(line, "QUIT", 4) == STRING_EQUAL) {
+    session->is_closing = true;
+    respond(session, "BYE\n");
+  } else {
+    respond_error(session, "UNKNOWN_COMMAND");
+  }
+}
+
+static void expire_move(timer_wheel_timer_t *timer, void *argument) {
+  server_session_shard_t *shard = argument;
+  server_session_game_t *game = (server_session_game_t *)((char *) timer - offsetof(server_session_game_t, move_timer));
+  journal_end(session_of_game(game), game, GAME_JOURNAL_END_TIMED_OUT);
+  game->is_playing = false;
+  game->is_timed_out = true;
+  SERVER_SESSION_COUNT(shard->stats.move_timeouts);
+}
+
+static void expire_idle(timer_wheel_timer_t *timer, void *argument) {
+  server_session_shard_t *shard = argument;
+  server_session_t *session = (server_session_t *)((char *) timer - offsetof(server_session_t, idle_timer));
+  uint64_t deadline = session->last_active + shard->idle_timeout;
+  if (deadline > timer_wheel_now(shard->timers)) {
+    timer_wheel_arm(shard->timers, &session->idle_timer, deadline);
+    return;
+  }
+  SERVER_SESSION_COUNT(shard->stats.idle_timeouts);
+  session->is_closing = true;
+  session->next_timed_out = shard->timed_out;
+  shard->timed_out = session;
+}
+
+void server_session_init(server_session_t *session, int fd, server_session_shard_t *shard) {
+  memset(session, 0, offsetof(server_session_t, input));
+  session->fd = fd;
+  session->shard = shard;
+  timer_wheel_timer_init(&session->idle_timer, expire_idle);
+  for (size_t i = 0; i < SERVER_SESSION_MAXIMUM_GAMES; i++) {
+    timer_wheel_timer_init(&session->games[i].move_timer, expire_move);
+    session->games[i].slot = (uint8_t) i;
+  }
+  if (shard->timers != NULL) {
+    session->last_active = timer_wheel_now(shard->timers);
+  }
+  if (shard->timers != NULL && shard->idle_timeout > 0) {
+    timer_wheel_arm(shard->timers, &session->idle_timer, session->last_active + shard->idle_timeout);
+  }
+}
+
+void server_session_release(server_session_t *session) {
+  for (size_t i = 0; i < SERVER_SESSION_MAXIMUM_GAMES; i++) {
+    if (session->games[i].is_playing) {
+      journal_end(session, &session->games[i], GAME_JOURNAL_END_ABANDONED);
+    }
+  }
+  timer_wheel_t *timers = session->shard->timers;
+  if (timers == NULL) {
+    return;
+  }
+  timer_wheel_cancel(timers, &session->idle_timer);
+  for (size_t i = 0; i < SERVER_SESSION_MAXIMUM_GAMES; i++) {
+    timer_wheel_cancel(timers, &session->games[i].move_timer);
+  }
+}
+
+static void reply(server_session_t *session, uint8_t reply_byte) {
+  session->output[session->output_length++] = (char) reply_byte;
+}
+
+static void reply_error(server_session_t *session, uint8_t reply_byte) {
+  SERVER_SESSION_COUNT(session->shard->stats.errors);
+  reply(session, reply_byte);
+}
+
+static void handle_frame(server_session_t *session, const uint8_t frame[]) {
+  if (frame[1] >= SERVER_SESSION_MAXIMUM_GAMES) {
+    reply_error(session, SERVER_SESSION_REPLY_BAD_REQUEST);
+    return;
+  }
+  server_session_game_t *game = &session->games[frame[1]];
+  game_logic_code_t code = (game_logic_code_t)(frame[2] | (frame[3] << 8));
+  switch (frame[0]) {
+  case SERVER_SESSION_OPERATION_NEW:
+  case SERVER_SESSION_OPERATION_NEW_HARD:
+    start_game(session, game, frame[0] == SERVER_SESSION_OPERATION_NEW_HARD);
+    reply(session, SERVER_SESSION_REPLY_READY);
+    break;
+  case SERVER_SESSION_OPERATION_GUESS: {
+    if (code >= NUMBER_OF_POSSIBLE_CODES) {
+      reply_error(session, SERVER_SESSION_REPLY_BAD_GUESS);
+      break;
+    }
+    game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(code, guess);
+    game_logic_feedback_t feedback;
+    guess_outcome_t outcome = play_guess(session, game, guess, &feedback);
+    if (outcome == GUESS_TIMED_OUT) {
+      reply(session, SERVER_SESSION_REPLY_TIMED_OUT);
+    } else if (outcome == GUESS_NO_GAME) {
+      reply_error(session, SERVER_SESSION_REPLY_NO_GAME);
+    } else if (outcome == GUESS_HARD_MODE) {
+      reply_error(session, SERVER_SESSION_REPLY_HARD_MODE);
+    } else {
+      reply(session, game_logic_feedback_to_class(feedback));
+    }
+    break;
+  }
+  case SERVER_SESSION_OPERATION_GIVEUP:
+    if (!game->is_playing) {
+      reply_error(session, SERVER_SESSION_REPLY_NO_GAME);
+      break;
+    }
+    end_game(session, game, GAME_JOURNAL_END_GAVE_UP);
+    reply(session, SERVER_SESSION_REPLY_GAVE_UP);
+    break;
+  case SERVER_SESSION_OPERATION_QUIT:
+    session->is_closing = true;
+    reply(session, SERVER_SESSION_REPLY_BYE);
+    break;
+  default:
+    reply_error(session, SERVER_SESSION_REPLY_BAD_REQUEST);
+    break;
+  }
+}
+
+// returns where the unhandled input starts
+static size_t process_lines(server_session_t *session) {
+  size_t start = 0;
+  while (!session->is_closing && session->protocol == SERVER_SESSION_PROTOCOL_TEXT &&
+         SERVER_SESSION_OUTPUT_SIZE - session->output_length >= SERVER_SESSION_MAXIMUM_RESPONSE) {
+    char *newline = memchr(session->input + start, '\n', session->input_length - start);
+    if (newline == NULL) {
+      break;
+    }
+    size_t length = (size_t)(newline - (session->input + start));
+    if (session->is_discarding) {
+      session->is_discarding = false;
+    } else {
+      handle_line(session, session->input + start, length);
+    }
+    start += length + 1;
+  }
+  // a full buffer without a line ending can never complete, report it once and skip to the next line
+  if (start == 0 && session->input_length == SERVER_SESSION_INPUT_SIZE &&
+      SERVER_SESSION_OUTPUT_SIZE - session->output_length >= SERVER_SESSION_MAXIMUM_RESPONSE &&
+      memchr(session->input, '\n', session->input_length) == NULL) {
+    if (!session->is_discarding) {
+      respond_error(session, "LINE_TOO_LONG");
+      session->is_discarding = true;
+    }
+    start = session->input_length;
+  }
+  return start;
+}
+
+static size_t process_frames(server_session_t *session, size_t start) {
+  // one reply byte per frame, the whole pipelined batch is answered without formatting anything
+  while (!session->is_closing && session->input_length - start >= SERVER_SESSION_FRAME_SIZE &&
+         session->output_length < SERVER_SESSION_OUTPUT_SIZE) {
+    handle_frame(session, (const uint8_t *) session->input + start);
+    start += SERVER_SESSION_FRAME_SIZE;
+  }
+  return start;
+}
+
+void server_session_process_input(server_session_t *session) {
+  if (session->input_length > 0 && session->shard->timers != NULL) {
+    session->last_active = timer_wheel_now(session->shard->timers);
+  }
+  size_t start = 0;
+  if (session->protocol == SERVER_SESSION_PROTOCOL_TEXT) {
+    start = process_lines(session);
+  }
+  // frames may follow the negotiation line in the same read
+  if (session->protocol == SERVER_SESSION_PROTOCOL_BINARY) {
+    start = process_frames(session, start);
+  }
+  memmove(session->input, session->input + start, session->input_length - start);
+  session->input_length -= start;
+}
+
+void server_session_consume_output(server_session_t *session, size_t length) {
+  memmove(session->output, session->output + length, session->output_length - length);
+  session->output_length -= length;
+}
+
+bool server_session_wants_input(const server_session_t *session) {
+  return !session->is_closing && session->input_length < SERVER_SESSION_INPUT_SIZE;
+}
+
+size_t server_session_save(const server_session_t *session, session_snapshot_game_t games[]) {
+  if (session->token == 0 || session->is_closing) {
+    return 0;
+  }
+  timer_wheel_t *timers = session->shard->timers;
+  uint64_t now = timers != NULL ? timer_wheel_now(timers) : 0;
+  size_t number_of_games = 0;
+  for (uint8_t slot = 0; slot < SERVER_SESSION_MAXIMUM_GAMES; slot++) {
+    const server_session_game_t *game = &session->games[slot];
+    if (!game->is_playing) {
+      continue;
+    }
+    session_snapshot_game_t *saved = &games[number_of_games++];
+    memset(saved, 0, sizeof(*saved));
+    saved->token = session->token;
+    saved->game_id = game->id;
+    saved->slot = slot;
+    saved->tries = game->tries;
+    saved->is_hard_mode = game->context.is_hard_mode;
+    saved->answer = game_logic_pack_code(game->context.answer);
+    memcpy(saved->history, game->history, game->tries * sizeof(game_logic_code_t));
+    if (timers != NULL) {
+      uint64_t idle = now - session->last_active;
+      saved->idle_milliseconds = idle > UINT32_MAX ? UINT32_MAX : (uint32_t) idle;
+      if (game->move_timer.is_armed) {
+        // an overdue clock keeps a millisecond so it still runs out straight after the restore
+        saved->move_milliseconds = game->move_timer.expires > now ? (uint32_t)(game->move_timer.expires - now) : 1;
+      }
+    }
+  }
+  return number_of_games;
+}
+
+uint64_t server_session_clock(void) {
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000 + (uint64_t) now.tv_nsec / 1000000;
+}
+
+int server_session_timer_wait(const server_session_shard_t *shard, uint64_t now) {
+  if (shard->timers == NULL) {
+    return -1;
+  }
+  uint64_t ticks = timer_wheel_ticks_until_next(shard->timers);
+  if (ticks == UINT64_MAX) {
+    return -1;
+  }
+  uint64_t due = timer_wheel_now(shard->timers) + ticks;
+  if (due <= now) {
+    return 0;
+  }
+  return due - now > INT_MAX ? INT_MAX : (int)(due - now);
+}
+
+server_session_t* server_session_run_timers(server_session_shard_t *shard, uint64_t now) {
+  shard->timed_out = NULL;
+  if (shard->timers != NULL) {
+    timer_wheel_advance(shard->timers, now, shard);
+  }
+  return shard->timed_out;
+}
\ No newline at end of file
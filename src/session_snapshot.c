@@ -0,0 +1,255 @@
+#define _GNU_SOURCE
+#include "session_snapshot.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define INITIAL_CAPACITY 1024
+#define PATH_SIZE 4096
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  // unix seconds
+  int64_t created_at;
+  uint64_t number_of_games;
+  // power of two
+  uint64_t number_of_buckets;
+  uint32_t number_of_random_states;
+  uint32_t random_states[SESSION_SNAPSHOT_MAXIMUM_RANDOM_STATES];
+} header_t;
+
+struct session_snapshot_writer {
+  session_snapshot_game_t *games;
+  size_t number_of_games;
+  size_t capacity;
+  uint32_t number_of_random_states;
+  uint32_t random_states[SESSION_SNAPSHOT_MAXIMUM_RANDOM_STATES];
+};
+
+struct session_snapshot {
+  void *map;
+  size_t map_size;
+  const header_t *header;
+  session_snapshot_game_t *buckets;
+};
+
+static uint64_t hash_key(uint64_t token, uint8_t slot) {
+  // splitmix64 finalizer, tokens are random already but the slot has to spread too
+  uint64_t x = token ^ ((uint64_t) slot * 0x9E3779B97F4A7C15u);
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9u;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBu;
+  return x ^ (x >> 31);
+}
+
+session_snapshot_writer_t* session_snapshot_writer_create(void) {
+  session_snapshot_writer_t *writer = calloc(1, sizeof(session_snapshot_writer_t));
+  if (writer == NULL) {
+    return NULL;
+  }
+  writer->games = malloc(INITIAL_CAPACITY * sizeof(session_snapshot_game_t));
+  if (writer->games == NULL) {
+    free(writer);
+    return NULL;
+  }
+  writer->capacity = INITIAL_CAPACITY;
+  return writer;
+}
+
+void session_snapshot_writer_destroy(session_snapshot_writer_t *writer) {
+  if (writer != NULL) {
+    free(writer->games);
+    free(writer);
+  }
+}
+
+bool session_snapshot_writer_add(session_snapshot_writer_t *writer, const session_snapshot_game_t *game) {
+  if (game->token == 0) {
+    return true;
+  }
+  if (writer->number_of_games == writer->capacity) {
+    session_snapshot_game_t *games = realloc(writer->games, 2 * writer->capacity * sizeof(session_snapshot_game_t));
+    if (games == NULL) {
+      return false;
+    }
+    writer->games = games;
+    writer->capacity *= 2;
+  }
+  writer->games[writer->number_of_games] = *game;
+  writer->games[writer->number_of_games].is_claimed = 0;
+  writer->number_of_games++;
+  return true;
+}
+
+void session_snapshot_writer_set_random_states(session_snapshot_writer_t *writer, const uint32_t states[],
+                                               size_t number_of_states) {
+  if (number_of_states > SESSION_SNAPSHOT_MAXIMUM_RANDOM_STATES) {
+    number_of_states = SESSION_SNAPSHOT_MAXIMUM_RANDOM_STATES;
+  }
+  memcpy(writer->random_states, states, number_of_states * sizeof(uint32_t));
+  writer->number_of_random_states = (uint32_t) number_of_states;
+}
+
+size_t session_snapshot_writer_number_of_games(const session_snapshot_writer_t *writer) {
+  return writer->number_of_games;
+}
+
+static bool write_all(int fd, const char *data, size_t length) {
+  while (length > 0) {
+    ssize_t written = write(fd, data, length);
+    if (written < 0) {
+      return false;
+    }
+    data += written;
+    length -= (size_t) written;
+  }
+  return true;
+}
+
+bool session_snapshot_writer_commit(session_snapshot_writer_t *writer, const char *path) {
+  // at most half full so probes stay short
+  uint64_t number_of_buckets = 1;
+  while (number_of_buckets < 2 * writer->number_of_games) {
+    number_of_buckets *= 2;
+  }
+  size_t size = sizeof(header_t) + number_of_buckets * sizeof(session_snapshot_game_t);
+  char *image = calloc(1, size);
+  if (image == NULL) {
+    return false;
+  }
+  header_t *header = (header_t *) image;
+  header->magic = SESSION_SNAPSHOT_MAGIC;
+  header->version = SESSION_SNAPSHOT_VERSION;
+  header->created_at = (int64_t) time(NULL);
+  header->number_of_games = writer->number_of_games;
+  header->number_of_buckets = number_of_buckets;
+  header->number_of_random_states = writer->number_of_random_states;
+  memcpy(header->random_states, writer->random_states, sizeof(header->random_states));
+  session_snapshot_game_t *buckets = (session_snapshot_game_t *)(image + sizeof(header_t));
+  for (size_t i = 0; i < writer->number_of_games; i++) {
+    const session_snapshot_game_t *game = &writer->games[i];
+    uint64_t bucket = hash_key(game->token, game->slot) & (number_of_buckets - 1);
+    while (buckets[bucket].token != 0) {
+      bucket = (bucket + 1) & (number_of_buckets - 1);
+    }
+    buckets[bucket] = *game;
+  }
+
+  char temporary_path[PATH_SIZE];
+  if (snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", path) >= (int) sizeof(temporary_path)) {
+    free(image);
+    return false;
+  }
+  int fd = open(temporary_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  bool is_written = fd >= 0 && write_all(fd, image, size) && fdatasync(fd) == 0;
+  if (fd >= 0) {
+    close(fd);
+  }
+  free(image);
+  if (!is_written || rename(temporary_path, path) != 0) {
+    unlink(temporary_path);
+    return false;
+  }
+  return true;
+}
+
+session_snapshot_t* session_snapshot_open(const char *path) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat status;
+  session_snapshot_t *snapshot = NULL;
+  if (fstat(fd, &status) == 0 && (size_t) status.st_size >= sizeof(header_t)) {
+    // private and writable so claims only ever touch this process's copy of a page
+    void *map = mmap(NULL, (size_t) status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (map != MAP_FAILED) {
+      const header_t *header = map;
+      uint64_t buckets = header->number_of_buckets;
+      bool is_valid = header->magic == SESSION_SNAPSHOT_MAGIC && header->version == SESSION_SNAPSHOT_VERSION &&
+                      buckets > 0 && (buckets & (buckets - 1)) == 0 &&
+                      buckets <= ((size_t) status.st_size - sizeof(header_t)) / sizeof(session_snapshot_game_t) &&
+                      header->number_of_games < buckets &&
+                      header->number_of_random_states <= SESSION_SNAPSHOT_MAXIMUM_RANDOM_STATES;
+      // a table with no empty bucket left would send a probe for a missing key round it forever
+      const session_snapshot_game_t *games = (const session_snapshot_game_t *)((const char *) map + sizeof(header_t));
+      uint64_t occupied = 0;
+      for (uint64_t i = 0; is_valid && i < buckets; i++) {
+        occupied += games[i].token != 0;
+      }
+      is_valid = is_valid && occupied < buckets;
+      snapshot = is_valid ? malloc(sizeof(session_snapshot_t)) : NULL;
+      if (snapshot == NULL) {
+        munmap(map, (size_t) status.st_size);
+      } else {
+        snapshot->map = map;
+        snapshot->map_size = (size_t) status.st_size;
+        snapshot->header = header;
+        snapshot->buckets = (session_snapshot_game_t *)((char *) map + sizeof(header_t));
+      }
+    }
+  }
+  close(fd);
+  return snapshot;
+}
+
+void session_snapshot_close(session_snapshot_t *snapshot) {
+  if (snapshot != NULL) {
+    munmap(snapshot->map, snapshot->map_size);
+    free(snapshot);
+  }
+}
+
+const session_snapshot_game_t* session_snapshot_claim(session_snapshot_t *snapshot, uint64_t token, uint8_t slot) {
+  if (token == 0) {
+    return NULL;
+  }
+  uint64_t mask = snapshot->header->number_of_buckets - 1;
+  uint64_t bucket = hash_key(token, slot) & mask;
+  for (uint64_t probes = 0; probes < snapshot->header->number_of_buckets; probes++, bucket = (bucket + 1) & mask) {
+    session_snapshot_game_t *game = &snapshot->buckets[bucket];
+    if (game->token == 0) {
+      return NULL;
+    }
+    if (game->token == token && game->slot == slot) {
+      uint32_t expected = 0;
+      return __atomic_compare_exchange_n(&game->is_claimed, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+             ? game : NULL;
+    }
+  }
+  return NULL;
+}
+
+uint32_t session_snapshot_random_state(const session_snapshot_t *snapshot, size_t index) {
+  return index < snapshot->header->number_of_random_states ? snapshot->header->random_states[index] : 0;
+}
+
+size_t session_snapshot_number_of_games(const session_snapshot_t *snapshot) {
+  return snapshot->header->number_of_games;
+}
+
+bool session_snapshot_add_unclaimed(const session_snapshot_t *snapshot, session_snapshot_writer_t *writer,
+                                    uint32_t maximum_idle_milliseconds) {
+  int64_t downtime = (int64_t) time(NULL) - snapshot->header->created_at;
+  uint64_t extra_idle = downtime > 0 ? (uint64_t) downtime * 1000 : 0;
+  for (uint64_t i = 0; i < snapshot->header->number_of_buckets; i++) {
+    session_snapshot_game_t game = snapshot->buckets[i];
+    if (game.token == 0 || game.is_claimed) {
+      continue;
+    }
+    uint64_t idle = game.idle_milliseconds + extra_idle;
+    if (maximum_idle_milliseconds > 0 && idle > maximum_idle_milliseconds) {
+      continue;
+    }
+    game.idle_milliseconds = idle > UINT32_MAX ? UINT32_MAX : (uint32_t) idle;
+    if (!session_snapshot_writer_add(writer, &game)) {
+      return false;
+    }
+  }
+  return true;
+}
\ No newline at end of file
@@ -0,0 +1,379 @@
+#define _GNU_SOURCE
+#include "shm_ipc.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define CACHE_LINE_SIZE 64
+#define LAYOUT_MAGIC 0x48534D4Du
+#define LAYOUT_VERSION 1
+// how often an idle server wakes up to look for clients that died without disconnecting
+#define IDLE_CHECK_SECONDS 1
+
+enum {
+  SLOT_FREE,
+  SLOT_CLAIMED,
+  SLOT_CLOSING
+};
+
+// each position has a single writer and sits on its own cache line so the two sides never share one
+typedef struct {
+  uint32_t head;
+  char head_padding[CACHE_LINE_SIZE - sizeof(uint32_t)];
+  uint32_t tail;
+  char tail_padding[CACHE_LINE_SIZE - sizeof(uint32_t)];
+} ring_positions_t;
+
+typedef struct {
+  uint32_t state;
+  int32_t owner;
+  // futex the client sleeps on while waiting for replies
+  uint32_t client_waiting;
+  uint32_t reply_sequence;
+  char padding[CACHE_LINE_SIZE - 4 * sizeof(uint32_t)];
+  ring_positions_t requests;
+  ring_positions_t replies;
+  uint8_t request_data[SHM_IPC_REQUEST_RING_SIZE];
+  uint8_t reply_data[SHM_IPC_REPLY_RING_SIZE];
+} slot_t;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t number_of_slots;
+  // futex the server sleeps on while every client is idle
+  uint32_t server_waiting;
+  uint32_t request_sequence;
+  char padding[CACHE_LINE_SIZE - 5 * sizeof(uint32_t)];
+  slot_t slots[SHM_IPC_MAXIMUM_CLIENTS];
+} layout_t;
+
+struct shm_ipc_server {
+  char name[NAME_MAX];
+  layout_t *layout;
+  bool is_stopping;
+  unsigned spin_iterations;
+  server_session_shard_t shard;
+  bool is_bound[SHM_IPC_MAXIMUM_CLIENTS];
+  server_session_t sessions[SHM_IPC_MAXIMUM_CLIENTS];
+};
+
+struct shm_ipc_client {
+  layout_t *layout;
+  slot_t *slot;
+  unsigned spin_iterations;
+};
+
+static long futex(uint32_t *address, int operation, uint32_t value, const struct timespec *timeout) {
+  // not FUTEX_PRIVATE_FLAG, the word is shared between processes
+  return syscall(SYS_futex, address, operation, value, timeout, NULL, 0);
+}
+
+static unsigned spin_iterations(void) {
+  return sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SHM_IPC_SPIN_ITERATIONS : 0;
+}
+
+// bumps the sequence and wakes the other side, only when it announced it is going to sleep
+static void wake(uint32_t *waiting, uint32_t *sequence) {
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  if (__atomic_load_n(waiting, __ATOMIC_RELAXED)) {
+    __atomic_fetch_add(sequence, 1, __ATOMIC_RELEASE);
+    futex(sequence, FUTEX_WAKE, INT_MAX, NULL);
+  }
+}
+
+static size_t ring_write(ring_positions_t *ring, uint8_t data[], size_t size, const void *bytes, size_t length) {
+  uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+  uint32_t tail = ring->tail;
+  length = MIN(length, size - (tail - head));
+  size_t offset = tail & (size - 1);
+  size_t first = MIN(length, size - offset);
+  memcpy(data + offset, bytes, first);
+  memcpy(data, (const uint8_t *) bytes + first, length - first);
+  __atomic_store_n(&ring->tail, tail + (uint32_t) length, __ATOMIC_RELEASE);
+  return length;
+}
+
+static size_t ring_read(ring_positions_t *ring, const uint8_t data[], size_t size, void *bytes, size_t maximum) {
+  uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+  uint32_t head = ring->head;
+  size_t length = MIN(maximum, (size_t)(tail - head));
+  size_t offset = head & (size - 1);
+  size_t first = MIN(length, size - offset);
+  memcpy(bytes, data + offset, first);
+  memcpy((uint8_t *) bytes + first, data, length - first);
+  __atomic_store_n(&ring->head, head + (uint32_t) length, __ATOMIC_RELEASE);
+  return length;
+}
+
+static size_t ring_room(const ring_positions_t *ring, size_t size) {
+  return size - (ring->tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE));
+}
+
+static void release_slot(shm_ipc_server_t *server, size_t index) {
+  slot_t *slot = &server->layout->slots[index];
+  // a client can close before its slot was ever serviced, then there is no session to release
+  if (server->is_bound[index]) {
+    server_session_release(&server->sessions[index]);
+    SERVER_SESSION_COUNT(server->shard.stats.sessions_closed);
+  }
+  server->is_bound[index] = false;
+  memset(&slot->requests, 0, sizeof(slot->requests));
+  memset(&slot->replies, 0, sizeof(slot->replies));
+  __atomic_store_n(&slot->owner, 0, __ATOMIC_RELAXED);
+  __atomic_store_n(&slot->state, SLOT_FREE, __ATOMIC_RELEASE);
+}
+
+static bool service_slot(shm_ipc_server_t *server, size_t index) {
+  slot_t *slot = &server->layout->slots[index];
+  uint32_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+  if (state == SLOT_FREE) {
+    return false;
+  }
+  if (state == SLOT_CLOSING) {
+    release_slot(server, index);
+    return true;
+  }
+  server_session_t *session = &server->sessions[index];
+  if (!server->is_bound[index]) {
+    // shared memory clients always speak the binary protocol, there is nothing to negotiate
+    server_session_init(session, -1, &server->shard);
+    session->protocol = SERVER_SESSION_PROTOCOL_BINARY;
+    server->is_bound[index] = true;
+    SERVER_SESSION_COUNT(server->shard.stats.sessions_accepted);
+  }
+  size_t received = ring_read(&slot->requests, slot->request_data, SHM_IPC_REQUEST_RING_SIZE,
+                              session->input + session->input_length, SERVER_SESSION_INPUT_SIZE - session->input_length);
+  session->input_length += received;
+  if (session->input_length > 0) {
+    server_session_process_input(session);
+  }
+  size_t sent = ring_write(&slot->replies, slot->reply_data, SHM_IPC_REPLY_RING_SIZE, session->output,
+                           session->output_length);
+  if (sent > 0) {
+    server_session_consume_output(session, sent);
+    wake(&slot->client_waiting, &slot->reply_sequence);
+  }
+  return received > 0 || sent > 0;
+}
+
+// a client that exits without disconnecting would hold its slot forever
+static void release_dead_clients(shm_ipc_server_t *server) {
+  for (size_t i = 0; i < SHM_IPC_MAXIMUM_CLIENTS; i++) {
+    int32_t owner = __atomic_load_n(&server->layout->slots[i].owner, __ATOMIC_RELAXED);
+    if (server->is_bound[i] && owner > 0 && kill(owner, 0) < 0 && errno == ESRCH) {
+      release_slot(server, i);
+    }
+  }
+}
+
+shm_ipc_server_t* shm_ipc_server_create(const char *name) {
+  if (strlen(name) >= NAME_MAX) {
+    return NULL;
+  }
+  shm_ipc_server_t *server = calloc(1, sizeof(shm_ipc_server_t));
+  if (server == NULL) {
+    return NULL;
+  }
+  strcpy(server->name, name);
+  server->spin_iterations = spin_iterations();
+  server->shard.random_state = (uint32_t) time(NULL) | 1u;
+  int fd = shm_open(name, O_RDWR | O_CREAT | O_TRUNC, 0600);
+  if (fd < 0 || ftruncate(fd, sizeof(layout_t)) < 0) {
+    if (fd >= 0) {
+      close(fd);
+      shm_unlink(name);
+    }
+    free(server);
+    return NULL;
+  }
+  server->layout = mmap(NULL, sizeof(layout_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (server->layout == MAP_FAILED) {
+    shm_unlink(name);
+    free(server);
+    return NULL;
+  }
+  server->layout->version = LAYOUT_VERSION;
+  server->layout->number_of_slots = SHM_IPC_MAXIMUM_CLIENTS;
+  // clients check the magic last so they never see a half initialised layout
+  __atomic_store_n(&server->layout->magic, LAYOUT_MAGIC, __ATOMIC_RELEASE);
+  return server;
+}
+
+bool shm_ipc_server_poll(shm_ipc_server_t *server) {
+  bool is_busy = false;
+  for (size_t i = 0; i < SHM_IPC_MAXIMUM_CLIENTS; i++) {
+    is_busy |= service_slot(server, i);
+  }
+  return is_busy;
+}
+
+void shm_ipc_server_run(shm_ipc_server_t *server) {
+  layout_t *layout = server->layout;
+  unsigned idle_polls = 0;
+  while (!__atomic_load_n(&server->is_stopping, __ATOMIC_ACQUIRE)) {
+    if (shm_ipc_server_poll(server)) {
+      idle_polls = 0;
+      continue;
+    }
+    if (++idle_polls < server->spin_iterations) {
+      continue;
+    }
+    // announce the sleep, then look once more so a request submitted in between is not missed
+    uint32_t sequence = __atomic_load_n(&layout->request_sequence, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&layout->server_waiting, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (!shm_ipc_server_poll(server) && !__atomic_load_n(&server->is_stopping, __ATOMIC_ACQUIRE)) {
+      struct timespec timeout = {.tv_sec = IDLE_CHECK_SECONDS};
+      if (futex(&layout->request_sequence, FUTEX_WAIT, sequence, &timeout) < 0 && errno == ETIMEDOUT) {
+        release_dead_clients(server);
+      }
+    }
+    __atomic_store_n(&layout->server_waiting, 0, __ATOMIC_RELAXED);
+    idle_polls = 0;
+  }
+}
+
+void shm_ipc_server_stop(shm_ipc_server_t *server) {
+  __atomic_store_n(&server->is_stopping, true, __ATOMIC_RELEASE);
+  __atomic_fetch_add(&server->layout->request_sequence, 1, __ATOMIC_RELEASE);
+  futex(&server->layout->request_sequence, FUTEX_WAKE, INT_MAX, NULL);
+}
+
+void shm_ipc_server_destroy(shm_ipc_server_t *server) {
+  munmap(server->layout, sizeof(layout_t));
+  shm_unlink(server->name);
+  free(server);
+}
+
+static void* run_server(void *argument) {
+  shm_ipc_server_run(argument);
+  return NULL;
+}
+
+int shm_ipc_server_main(const char *name) {
+  // the server thread inherits the blocked signals so only this thread waits for them
+  sigset_t signals;
+  sigemptyset(&signals);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, NULL);
+
+  shm_ipc_server_t *server = shm_ipc_server_create(name);
+  if (server == NULL) {
+    fprintf(stderr, "Could not create shared memory %s: %s\n", name, strerror(errno));
+    return EXIT_FAILURE;
+  }
+  pthread_t thread;
+  if (pthread_create(&thread, NULL, run_server, server) != 0) {
+    shm_ipc_server_destroy(server);
+    return EXIT_FAILURE;
+  }
+  printf("Serving games on shared memory %s\n", name);
+  fflush(stdout);
+  int signal_number;
+  while (sigwait(&signals, &signal_number) != 0) {
+  }
+  shm_ipc_server_stop(server);
+  pthread_join(thread, NULL);
+  const server_session_stats_t *stats = &server->shard.stats;
+  printf("clients %llu, games %llu started %llu won, guesses %llu, errors %llu\n",
+         (unsigned long long) stats->sessions_accepted, (unsigned long long) stats->games_started,
+         (unsigned long long) stats->games_won, (unsigned long long) stats->guesses,
+         (unsigned long long) stats->errors);
+  shm_ipc_server_destroy(server);
+  return EXIT_SUCCESS;
+}
+
+shm_ipc_client_t* shm_ipc_client_connect(const char *name) {
+  int fd = shm_open(name, O_RDWR, 0);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat status;
+  layout_t *layout = MAP_FAILED;
+  if (fstat(fd, &status) == 0 && (size_t) status.st_size == sizeof(layout_t)) {
+    layout = mmap(NULL, sizeof(layout_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if (layout == MAP_FAILED) {
+    return NULL;
+  }
+  if (__atomic_load_n(&layout->magic, __ATOMIC_ACQUIRE) != LAYOUT_MAGIC ||
+      layout->version != LAYOUT_VERSION) {
+    munmap(layout, sizeof(layout_t));
+    return NULL;
+  }
+  for (size_t i = 0; i < layout->number_of_slots && i < SHM_IPC_MAXIMUM_CLIENTS; i++) {
+    uint32_t expected = SLOT_FREE;
+    if (__atomic_compare_exchange_n(&layout->slots[i].state, &expected, SLOT_CLAIMED, false,
+                                    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+      shm_ipc_client_t *client = malloc(sizeof(shm_ipc_client_t));
+      if (client == NULL) {
+        __atomic_store_n(&layout->slots[i].state, SLOT_CLOSING, __ATOMIC_RELEASE);
+        break;
+      }
+      __atomic_store_n(&layout->slots[i].owner, (int32_t) getpid(), __ATOMIC_RELAXED);
+      client->layout = layout;
+      client->slot = &layout->slots[i];
+      client->spin_iterations = spin_iterations();
+      return client;
+    }
+  }
+  munmap(layout, sizeof(layout_t));
+  return NULL;
+}
+
+bool shm_ipc_client_submit(shm_ipc_client_t *client, const uint8_t frame[SERVER_SESSION_FRAME_SIZE]) {
+  slot_t *slot = client->slot;
+  if (ring_room(&slot->requests, SHM_IPC_REQUEST_RING_SIZE) < SERVER_SESSION_FRAME_SIZE) {
+    return false;
+  }
+  ring_write(&slot->requests, slot->request_data, SHM_IPC_REQUEST_RING_SIZE, frame, SERVER_SESSION_FRAME_SIZE);
+  wake(&client->layout->server_waiting, &client->layout->request_sequence);
+  return true;
+}
+
+size_t shm_ipc_client_receive(shm_ipc_client_t *client, uint8_t replies[], size_t maximum, bool wait) {
+  slot_t *slot = client->slot;
+  for (unsigned polls = 0;; polls++) {
+    size_t length = ring_read(&slot->replies, slot->reply_data, SHM_IPC_REPLY_RING_SIZE, replies, maximum);
+    if (length > 0 || !wait || maximum == 0) {
+      return length;
+    }
+    if (polls < client->spin_iterations) {
+      continue;
+    }
+    uint32_t sequence = __atomic_load_n(&slot->reply_sequence, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&slot->client_waiting, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    length = ring_read(&slot->replies, slot->reply_data, SHM_IPC_REPLY_RING_SIZE, replies, maximum);
+    if (length == 0) {
+      futex(&slot->reply_sequence, FUTEX_WAIT, sequence, NULL);
+    }
+    __atomic_store_n(&slot->client_waiting, 0, __ATOMIC_RELAXED);
+    if (length > 0) {
+      return length;
+    }
+  }
+}
+
+void shm_ipc_client_disconnect(shm_ipc_client_t *client) {
+  __atomic_store_n(&client->slot->state, SLOT_CLOSING, __ATOMIC_RELEASE);
+  wake(&client->layout->server_waiting, &client->layout->request_sequence);
+  munmap(client->layout, sizeof(layout_t));
+  free(client);
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#define _GNU_SOURCE
+#include "slab.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define CACHE_LINE_SIZE 64
+#define NO_OBJECT UINT32_MAX
+#define HANDLE_INDEX(handle) ((uint32_t)(handle))
+#define HANDLE_GENERATION(handle) ((uint32_t)((handle) >> 32))
+
+struct slab {
+  char name[SLAB_NAME_SIZE];
+  char *objects;
+  size_t object_size;
+  size_t capacity;
+  size_t memory_reserved;
+  // odd while the object is handed out, bumped on every alloc and free
+  uint32_t *generations;
+  // intrusive lifo so the most recently freed, still cached object is reused first
+  uint32_t *next_free;
+  uint32_t free_head;
+  // written only by the owning thread, relaxed atomics let other threads read them
+  size_t in_use;
+  size_t high_water;
+  uint64_t allocations;
+  uint64_t exhausted;
+};
+
+slab_t* slab_create(const char *name, size_t object_size, size_t capacity) {
+  if (object_size == 0 || capacity == 0 || capacity >= NO_OBJECT) {
+    return NULL;
+  }
+  slab_t *slab = calloc(1, sizeof(slab_t));
+  if (slab == NULL) {
+    return NULL;
+  }
+  snprintf(slab->name, SLAB_NAME_SIZE, "%s", name);
+  slab->object_size = (object_size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+  slab->capacity = capacity;
+  slab->memory_reserved = slab->object_size * capacity;
+  // populated now so the first connections do not pay for page faults
+  slab->objects = mmap(NULL, slab->memory_reserved, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+  slab->generations = calloc(capacity, sizeof(uint32_t));
+  slab->next_free = malloc(capacity * sizeof(uint32_t));
+  if (slab->objects == MAP_FAILED || slab->generations == NULL || slab->next_free == NULL) {
+    if (slab->objects == MAP_FAILED) {
+      slab->objects = NULL;
+    }
+    slab_destroy(slab);
+    return NULL;
+  }
+  for (size_t i = 0; i < capacity; i++) {
+    slab->next_free[i] = i + 1 < capacity ? (uint32_t)(i + 1) : NO_OBJECT;
+  }
+  slab->free_head = 0;
+  slab->memory_reserved += capacity * 2 * sizeof(uint32_t);
+  return slab;
+}
+
+void slab_destroy(slab_t *slab) {
+  if (slab == NULL) {
+    return;
+  }
+  if (slab->objects != NULL) {
+    munmap(slab->objects, slab->object_size * slab->capacity);
+  }
+  free(slab->generations);
+  free(slab->next_free);
+  free(slab);
+}
+
+void* slab_alloc(slab_t *slab, slab_handle_t *handle) {
+  uint32_t index = slab->free_head;
+  if (index == NO_OBJECT) {
+    __atomic_store_n(&slab->exhausted, slab->exhausted + 1, __ATOMIC_RELAXED);
+    return NULL;
+  }
+  slab->free_head = slab->next_free[index];
+  uint32_t generation = ++slab->generations[index];
+  if (handle != NULL) {
+    *handle = (slab_handle_t) generation << 32 | index;
+  }
+  __atomic_store_n(&slab->allocations, slab->allocations + 1, __ATOMIC_RELAXED);
+  __atomic_store_n(&slab->in_use, slab->in_use + 1, __ATOMIC_RELAXED);
+  if (slab->in_use > slab->high_water) {
+    __atomic_store_n(&slab->high_water, slab->in_use, __ATOMIC_RELAXED);
+  }
+  return slab->objects + (size_t) index * slab->object_size;
+}
+
+bool slab_free(slab_t *slab, slab_handle_t handle) {
+  if (slab_get(slab, handle) == NULL) {
+    return false;
+  }
+  uint32_t index = HANDLE_INDEX(handle);
+  slab->generations[index]++;
+  slab->next_free[index] = slab->free_head;
+  slab->free_head = index;
+  __atomic_store_n(&slab->in_use, slab->in_use - 1, __ATOMIC_RELAXED);
+  return true;
+}
+
+void* slab_get(const slab_t *slab, slab_handle_t handle) {
+  uint32_t index = HANDLE_INDEX(handle);
+  uint32_t generation = HANDLE_GENERATION(handle);
+  // handed out generations are always odd, which also rules out SLAB_INVALID_HANDLE
+  if (index >= slab->capacity || (generation & 1u) == 0 || slab->generations[index] != generation) {
+    return NULL;
+  }
+  return slab->objects + (size_t) index * slab->object_size;
+}
+
+slab_handle_t slab_handle_of(const slab_t *slab, const void *object) {
+  size_t index = (size_t)((const char *) object - slab->objects) / slab->object_size;
+  return (slab_handle_t) slab->generations[index] << 32 | index;
+}
+
+void* slab_object_at(const slab_t *slab, size_t index) {
+  if (index >= slab->capacity || (slab->generations[index] & 1u) == 0) {
+    return NULL;
+  }
+  return slab->objects + index * slab->object_size;
+}
+
+slab_stats_t slab_get_stats(const slab_t *slab) {
+  slab_stats_t stats;
+  memcpy(stats.name, slab->name, SLAB_NAME_SIZE);
+  stats.object_size = slab->object_size;
+  stats.capacity = slab->capacity;
+  stats.memory_reserved = slab->memory_reserved;
+  stats.in_use = __atomic_load_n(&slab->in_use, __ATOMIC_RELAXED);
+  stats.high_water = __atomic_load_n(&slab->high_water, __ATOMIC_RELAXED);
+  stats.allocations = __atomic_load_n(&slab->allocations, __ATOMIC_RELAXED);
+  stats.exhausted = __atomic_load_n(&slab->exhausted, __ATOMIC_RELAXED);
+  return stats;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "solver.h"
+#include <stdbool.h>
+
+size_t solver_filter_candidates(const game_logic_move_t history[], size_t history_length, game_logic_code_t candidates[]) {
+  game_logic_code_t all_codes[NUMBER_OF_POSSIBLE_CODES];
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    all_codes[i] = i;
+  }
+  return solver_filter_candidates_in_space(all_codes, NUMBER_OF_POSSIBLE_CODES, history, history_length, candidates);
+}
+
+size_t solver_filter_candidates_in_space(const game_logic_code_t space[], size_t space_size,
+                                         const game_logic_move_t history[], size_t history_length,
+                                         game_logic_code_t candidates[]) {
+  size_t count = space_size;
+  for (size_t i = 0; i < space_size; i++) {
+    candidates[i] = space[i];
+  }
+  for (size_t i = 0; i < history_length; i++) {
+    const uint8_t *row = game_logic_score_row(game_logic_pack_code(history[i].guess));
+    uint8_t feedback_class = game_logic_feedback_to_class(history[i].feedback);
+    size_t kept = 0;
+    for (size_t j = 0; j < count; j++) {
+      candidates[kept] = candidates[j];
+      kept += row[candidates[j]] == feedback_class;
+    }
+    count = kept;
+  }
+  return count;
+}
+
+game_logic_code_t solver_best_guess(const game_logic_code_t candidates[], size_t number_of_candidates) {
+  if (number_of_candidates <= 2) {
+    return number_of_candidates == 0 ? 0 : candidates[0];
+  }
+
+  bool is_candidate[NUMBER_OF_POSSIBLE_CODES] = {0};
+  for (size_t i = 0; i < number_of_candidates; i++) {
+    is_candidate[candidates[i]] = true;
+  }
+
+  game_logic_code_t best_guess = candidates[0];
+  size_t best_worst_case = SIZE_MAX;
+  bool best_is_candidate = true;
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    const uint8_t *row = game_logic_score_row(i);
+    uint16_t partition_sizes[NUMBER_OF_FEEDBACK_CLASSES] = {0};
+    size_t worst_case = 0;
+    for (size_t j = 0; j < number_of_candidates && worst_case <= best_worst_case; j++) {
+      uint8_t feedback_class = row[candidates[j]];
+      if (++partition_sizes[feedback_class] > worst_case) {
+        worst_case = partition_sizes[feedback_class];
+      }
+    }
+    if (worst_case < best_worst_case || (worst_case == best_worst_case && is_candidate[i] && !best_is_candidate)) {
+      best_guess = i;
+      best_worst_case = worst_case;
+      best_is_candidate = is_candidate[i];
+    }
+  }
+  return best_guess;
+}
+
+solver_hint_t solver_get_hint(const game_logic_move_t history[], size_t history_length) {
+  game_logic_code_t candidates[NUMBER_OF_POSSIBLE_CODES];
+  size_t count = solver_filter_candidates(history, history_length, candidates);
+  solver_hint_t hint = {
+    .best_guess = solver_best_guess(candidates, count),
+    .remaining_candidates = (uint16_t) count
+  };
+  return hint;
+}
+
+solver_hint_t solver_get_hint_in_space(const game_logic_code_t space[], size_t space_size,
+                                       const game_logic_move_t history[], size_t history_length) {
+  game_logic_code_t candidates[NUMBER_OF_POSSIBLE_CODES];
+  size_t count = solver_filter_candidates_in_space(space, space_size, history, history_length, candidates);
+  solver_hint_t hint = {
+    .best_guess = solver_best_guess(candidates, count),
+    .remaining_candidates = (uint16_t) count
+  };
+  return hint;
+}
\ No newline at end of file
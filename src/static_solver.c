@@ -0,0 +1,309 @@
+#include "static_solver.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define BITS_PER_FEEDBACK_CLASS 5
+#define SIGNATURE_TABLE_SIZE 4096
+#define SIGNATURE_TABLE_MASK (SIGNATURE_TABLE_SIZE - 1)
+#define MAXIMUM_NUMBER_OF_THREADS 64
+
+typedef struct {
+  uint64_t signatures[SIGNATURE_TABLE_SIZE];
+  uint32_t stamps[SIGNATURE_TABLE_SIZE];
+  uint32_t current_stamp;
+} signature_set_t;
+
+typedef struct {
+  uint64_t signatures[NUMBER_OF_POSSIBLE_CODES];
+  uint8_t classes[STATIC_SOLVER_MAXIMUM_GUESSES][NUMBER_OF_POSSIBLE_CODES];
+  game_logic_code_t guesses[STATIC_SOLVER_MAXIMUM_GUESSES];
+  size_t number_of_guesses;
+  signature_set_t seen;
+} search_state_t;
+
+typedef struct {
+  pthread_mutex_t lock;
+  bool is_found;
+  game_logic_code_t guesses[STATIC_SOLVER_MAXIMUM_GUESSES];
+} shared_search_t;
+
+typedef struct {
+  shared_search_t *shared;
+  size_t number_of_guesses;
+  uint32_t iterations;
+  uint32_t seed;
+} worker_t;
+
+static game_logic_values_t all_codes[NUMBER_OF_POSSIBLE_CODES][NUMBER_OF_VALUES_TO_GUESS];
+static pthread_once_t all_codes_once = PTHREAD_ONCE_INIT;
+
+static void init_all_codes(void) {
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    game_logic_unpack_code(i, all_codes[i]);
+  }
+}
+
+static uint32_t next_random(uint32_t *state) {
+  // xorshift32, each worker owns its stream so rand() is never shared across threads
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+static void score_column(game_logic_code_t guess, uint8_t column[]) {
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    column[i] = game_logic_feedback_to_class(game_logic_score(all_codes[i], all_codes[guess]));
+  }
+}
+
+static size_t count_distinct(signature_set_t *seen, const uint64_t signatures[]) {
+  // stamps let the table be reused without clearing it between counts
+  if (++seen->current_stamp == 0) {
+    memset(seen->stamps, 0, sizeof(seen->stamps));
+    seen->current_stamp = 1;
+  }
+  size_t distinct = 0;
+  for (size_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    uint64_t signature = signatures[i];
+    size_t slot = (size_t)((signature * 0x9E3779B97F4A7C15ULL) >> 52) & SIGNATURE_TABLE_MASK;
+    while (seen->stamps[slot] == seen->current_stamp && seen->signatures[slot] != signature) {
+      slot = (slot + 1) & SIGNATURE_TABLE_MASK;
+    }
+    if (seen->stamps[slot] != seen->current_stamp) {
+      seen->stamps[slot] = seen->current_stamp;
+      seen->signatures[slot] = signature;
+      distinct++;
+    }
+  }
+  return distinct;
+}
+
+static void rebuild_signatures(search_state_t *state) {
+  for (size_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    uint64_t signature = 0;
+    for (size_t j = 0; j < state->number_of_guesses; j++) {
+      signature |= (uint64_t) state->classes[j][i] << (j * BITS_PER_FEEDBACK_CLASS);
+    }
+    state->signatures[i] = signature;
+  }
+}
+
+static void apply_column(search_state_t *state, size_t index) {
+  uint_fast8_t shift = (uint_fast8_t)(index * BITS_PER_FEEDBACK_CLASS);
+  uint64_t mask = ~((uint64_t) 0x1F << shift);
+  for (size_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    state->signatures[i] = (state->signatures[i] & mask) | ((uint64_t) state->classes[index][i] << shift);
+  }
+}
+
+static void replace_guess(search_state_t *state, size_t index, game_logic_code_t guess) {
+  state->guesses[index] = guess;
+  score_column(guess, state->classes[index]);
+  apply_column(state, index);
+}
+
+static bool is_search_over(shared_search_t *shared) {
+  pthread_mutex_lock(&shared->lock);
+  bool is_found = shared->is_found;
+  pthread_mutex_unlock(&shared->lock);
+  return is_found;
+}
+
+static void* local_search(void *argument) {
+  worker_t *worker = argument;
+  search_state_t *state = calloc(1, sizeof(search_state_t));
+  if (state == NULL) {
+    return NULL;
+  }
+  uint32_t random_state = worker->seed | 1;
+
+  state->number_of_guesses = worker->number_of_guesses;
+  for (size_t i = 0; i < state->number_of_guesses; i++) {
+    state->guesses[i] = (game_logic_code_t)(next_random(&random_state) % NUMBER_OF_POSSIBLE_CODES);
+    score_column(state->guesses[i], state->classes[i]);
+  }
+  rebuild_signatures(state);
+  size_t distinct = count_distinct(&state->seen, state->signatures);
+
+  uint8_t previous_column[NUMBER_OF_POSSIBLE_CODES];
+  for (uint32_t iteration = 0; iteration < worker->iterations && distinct < NUMBER_OF_POSSIBLE_CODES; iteration++) {
+    if ((iteration & 0xFF) == 0 && is_search_over(worker->shared)) {
+      break;
+    }
+    size_t index = next_random(&random_state) % state->number_of_guesses;
+    game_logic_code_t previous_guess = state->guesses[index];
+    memcpy(previous_column, state->classes[index], sizeof(previous_column));
+
+    replace_guess(state, index, (game_logic_code_t)(next_random(&random_state) % NUMBER_OF_POSSIBLE_CODES));
+    size_t candidate_distinct = count_distinct(&state->seen, state->signatures);
+    // sideways moves keep the search walking across plateaus
+    if (candidate_distinct >= distinct) {
+      distinct = candidate_distinct;
+    } else {
+      state->guesses[index] = previous_guess;
+      memcpy(state->classes[index], previous_column, sizeof(previous_column));
+      apply_column(state, index);
+    }
+  }
+
+  if (distinct == NUMBER_OF_POSSIBLE_CODES) {
+    pthread_mutex_lock(&worker->shared->lock);
+    if (!worker->shared->is_found) {
+      worker->shared->is_found = true;
+      memcpy(worker->shared->guesses, state->guesses, state->number_of_guesses * sizeof(game_logic_code_t));
+    }
+    pthread_mutex_unlock(&worker->shared->lock);
+  }
+  free(state);
+  return NULL;
+}
+
+static bool parallel_search(const static_solver_config_t *config, size_t number_of_guesses, uint32_t seed,
+                            game_logic_code_t guesses[]) {
+  size_t number_of_threads = config->number_of_threads;
+  if (number_of_threads == 0) {
+    number_of_threads = 1;
+  }
+  if (number_of_threads > MAXIMUM_NUMBER_OF_THREADS) {
+    number_of_threads = MAXIMUM_NUMBER_OF_THREADS;
+  }
+
+  shared_search_t shared = {.is_found = false};
+  pthread_mutex_init(&shared.lock, NULL);
+  pthread_t threads[MAXIMUM_NUMBER_OF_THREADS];
+  worker_t workers[MAXIMUM_NUMBER_OF_THREADS];
+  size_t started = 0;
+  for (size_t i = 0; i < number_of_threads; i++) {
+    workers[i] = (worker_t) {
+      .shared = &shared,
+      .number_of_guesses = number_of_guesses,
+      .iterations = config->iterations_per_size,
+      .seed = seed + (uint32_t) i * 0x9E3779B9u
+    };
+    if (pthread_create(&threads[started], NULL, local_search, &workers[i]) == 0) {
+      started++;
+    }
+  }
+  if (started == 0) {
+    local_search(&workers[0]);
+  }
+  for (size_t i = 0; i < started; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  pthread_mutex_destroy(&shared.lock);
+
+  if (shared.is_found) {
+    memcpy(guesses, shared.guesses, number_of_guesses * sizeof(game_logic_code_t));
+  }
+  return shared.is_found;
+}
+
+static size_t greedy_search(game_logic_code_t guesses[]) {
+  search_state_t *state = calloc(1, sizeof(search_state_t));
+  if (state == NULL) {
+    return 0;
+  }
+  size_t distinct = 1;
+  while (distinct < NUMBER_OF_POSSIBLE_CODES && state->number_of_guesses < STATIC_SOLVER_MAXIMUM_GUESSES) {
+    size_t index = state->number_of_guesses++;
+    game_logic_code_t best_guess = 0;
+    size_t best_distinct = 0;
+    for (game_logic_code_t guess = 0; guess < NUMBER_OF_POSSIBLE_CODES; guess++) {
+      replace_guess(state, index, guess);
+      size_t candidate_distinct = count_distinct(&state->seen, state->signatures);
+      if (candidate_distinct > best_distinct) {
+        best_distinct = candidate_distinct;
+        best_guess = guess;
+      }
+    }
+    replace_guess(state, index, best_guess);
+    distinct = best_distinct;
+  }
+  size_t number_of_guesses = distinct == NUMBER_OF_POSSIBLE_CODES ? state->number_of_guesses : 0;
+  memcpy(guesses, state->guesses, number_of_guesses * sizeof(game_logic_code_t));
+  free(state);
+  return number_of_guesses;
+}
+
+static int compare_certificate_entries(const void *a, const void *b) {
+  const static_solver_certificate_entry_t *left = a;
+  const static_solver_certificate_entry_t *right = b;
+  return (left->signature > right->signature) - (left->signature < right->signature);
+}
+
+static uint64_t signature_of(const game_logic_values_t secret[], const game_logic_code_t guesses[], size_t number_of_guesses) {
+  uint64_t signature = 0;
+  for (size_t j = 0; j < number_of_guesses; j++) {
+    uint64_t feedback_class = game_logic_feedback_to_class(game_logic_score(secret, all_codes[guesses[j]]));
+    signature |= feedback_class << (j * BITS_PER_FEEDBACK_CLASS);
+  }
+  return signature;
+}
+
+static void build_certificate(static_solver_result_t *result) {
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    result->certificate[i].secret = i;
+    result->certificate[i].signature = signature_of(all_codes[i], result->guesses, result->number_of_guesses);
+  }
+  qsort(result->certificate, NUMBER_OF_POSSIBLE_CODES, sizeof(result->certificate[0]), compare_certificate_entries);
+}
+
+bool static_solver_solve(const static_solver_config_t *config, static_solver_result_t *result) {
+  pthread_once(&all_codes_once, init_all_codes);
+  memset(result, 0, sizeof(*result));
+
+  result->number_of_guesses = greedy_search(result->guesses);
+  if (result->number_of_guesses == 0) {
+    return false;
+  }
+
+  game_logic_code_t guesses[STATIC_SOLVER_MAXIMUM_GUESSES];
+  uint32_t seed = config->seed;
+  while (result->number_of_guesses > 1 &&
+         parallel_search(config, result->number_of_guesses - 1, seed, guesses)) {
+    result->number_of_guesses--;
+    memcpy(result->guesses, guesses, result->number_of_guesses * sizeof(game_logic_code_t));
+    seed = seed * 1664525u + 1013904223u;
+  }
+
+  build_certificate(result);
+  return true;
+}
+
+bool static_solver_verify(const game_logic_code_t guesses[], size_t number_of_guesses) {
+  pthread_once(&all_codes_once, init_all_codes);
+  if (number_of_guesses > STATIC_SOLVER_MAXIMUM_GUESSES) {
+    return false;
+  }
+  static_solver_result_t *result = malloc(sizeof(static_solver_result_t));
+  if (result == NULL) {
+    return false;
+  }
+  memcpy(result->guesses, guesses, number_of_guesses * sizeof(game_logic_code_t));
+  result->number_of_guesses = number_of_guesses;
+  build_certificate(result);
+  bool is_valid = true;
+  for (size_t i = 1; i < NUMBER_OF_POSSIBLE_CODES && is_valid; i++) {
+    is_valid = result->certificate[i].signature != result->certificate[i - 1].signature;
+  }
+  free(result);
+  return is_valid;
+}
+
+bool static_solver_decode(const static_solver_result_t *result, const game_logic_feedback_t feedback[],
+                          game_logic_code_t *secret) {
+  static_solver_certificate_entry_t key = {0};
+  for (size_t j = 0; j < result->number_of_guesses; j++) {
+    key.signature |= (uint64_t) game_logic_feedback_to_class(feedback[j]) << (j * BITS_PER_FEEDBACK_CLASS);
+  }
+  const static_solver_certificate_entry_t *entry = bsearch(&key, result->certificate, NUMBER_OF_POSSIBLE_CODES,
+                                                           sizeof(result->certificate[0]), compare_certificate_entries);
+  if (entry == NULL) {
+    return false;
+  }
+  *secret = entry->secret;
+  return true;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "static_solver_app.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "static_solver.h"
+
+#define ITERATIONS_PER_SIZE 20000
+
+static const char value_characters[GAME_VALUE_MAX] = {'A', 'B', 'C', 'D', 'E', 'F'};
+
+int static_solver_app_main(void) {
+  long number_of_processors = sysconf(_SC_NPROCESSORS_ONLN);
+  static_solver_config_t config = {
+    .number_of_threads = number_of_processors > 0 ? (size_t) number_of_processors : 1,
+    .iterations_per_size = ITERATIONS_PER_SIZE,
+    .seed = (uint32_t) time(NULL)
+  };
+  static_solver_result_t *result = malloc(sizeof(static_solver_result_t));
+  if (result == NULL || !static_solver_solve(&config, result)) {
+    fprintf(stderr, "No static solution found\n");
+    free(result);
+    return EXIT_FAILURE;
+  }
+
+  printf("%zu guesses identify every answer:\n", result->number_of_guesses);
+  for (size_t i = 0; i < result->number_of_guesses; i++) {
+    game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(result->guesses[i], guess);
+    for (size_t j = 0; j < NUMBER_OF_VALUES_TO_GUESS; j++) {
+      putchar(value_characters[guess[j]]);
+    }
+    putchar('\n');
+  }
+  printf("Certificate (signature answer):\n");
+  for (size_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i++) {
+    game_logic_values_t secret[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(result->certificate[i].secret, secret);
+    printf("%016llx ", (unsigned long long) result->certificate[i].signature);
+    for (size_t j = 0; j < NUMBER_OF_VALUES_TO_GUESS; j++) {
+      putchar(value_characters[secret[j]]);
+    }
+    putchar('\n');
+  }
+  free(result);
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
@@ -0,0 +1,369 @@
+#define _POSIX_C_SOURCE 200809L
+#include "stream_evaluator.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define INITIAL_SESSIONS 1024
+#define NO_FEEDBACK UINT8_MAX
+#define WINNING_CLASS (NUMBER_OF_VALUES_TO_GUESS * (NUMBER_OF_VALUES_TO_GUESS + 1))
+// one more digit could overflow a session number
+#define MAXIMUM_SESSION_DIGITS 19
+
+// a value plus one for every character that can appear in a code, zero for any other character
+static const uint8_t code_characters[UINT8_MAX + 1] = {
+  ['A'] = GAME_VALUE_ONE + 1, ['B'] = GAME_VALUE_TWO + 1, ['C'] = GAME_VALUE_THREE + 1,
+  ['D'] = GAME_VALUE_FOUR + 1, ['E'] = GAME_VALUE_FIVE + 1, ['F'] = GAME_VALUE_SIX + 1
+};
+
+// a digit plus one, zero for anything else
+static const uint8_t digit_characters[UINT8_MAX + 1] = {
+  ['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10
+};
+
+static const char error_reply[STREAM_EVALUATOR_MAXIMUM_REPLY] = {'E', 'R', 'R', '\n'};
+
+typedef struct {
+  uint64_t id;
+  uint32_t games;
+  game_logic_code_t secret;
+  uint8_t tries;
+  bool is_used;
+} session_t;
+
+struct stream_evaluator {
+  uint64_t seed;
+  // open addressing with linear probing, never more than half full
+  session_t *sessions;
+  size_t capacity;
+  char replies[NUMBER_OF_FEEDBACK_CLASSES][STREAM_EVALUATOR_MAXIMUM_REPLY];
+  stream_evaluator_stats_t stats;
+};
+
+static uint64_t mix(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xBF58476D1CE4E5B9ull;
+  value ^= value >> 27;
+  value *= 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+stream_evaluator_t* stream_evaluator_create(uint64_t seed) {
+  stream_evaluator_t *evaluator = calloc(1, sizeof(stream_evaluator_t));
+  if (evaluator == NULL) {
+    return NULL;
+  }
+  evaluator->seed = seed;
+  evaluator->capacity = INITIAL_SESSIONS;
+  evaluator->sessions = calloc(evaluator->capacity, sizeof(session_t));
+  if (evaluator->sessions == NULL) {
+    free(evaluator);
+    return NULL;
+  }
+  for (uint8_t feedback_class = 0; feedback_class < NUMBER_OF_FEEDBACK_CLASSES; feedback_class++) {
+    game_logic_feedback_t feedback = game_logic_feedback_from_class(feedback_class);
+    char *reply = evaluator->replies[feedback_class];
+    reply[0] = (char)('0' + feedback.number_of_correct_value_and_placement);
+    reply[1] = ' ';
+    reply[2] = (char)('0' + feedback.number_of_correct_value_only);
+    reply[3] = '\n';
+  }
+  return evaluator;
+}
+
+void stream_evaluator_destroy(stream_evaluator_t *evaluator) {
+  if (evaluator == NULL) {
+    return;
+  }
+  free(evaluator->sessions);
+  free(evaluator);
+}
+
+const stream_evaluator_stats_t* stream_evaluator_get_stats(const stream_evaluator_t *evaluator) {
+  return &evaluator->stats;
+}
+
+// a packed code, or NUMBER_OF_POSSIBLE_CODES when the characters are not a code
+static game_logic_code_t parse_code(const char *text) {
+  game_logic_code_t code = 0;
+  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    uint8_t value = code_characters[(uint8_t) text[i]];
+    if (value == 0) {
+      return NUMBER_OF_POSSIBLE_CODES;
+    }
+    code = (game_logic_code_t)(code * GAME_VALUE_MAX + value - 1);
+  }
+  return code;
+}
+
+static bool grow_sessions(stream_evaluator_t *evaluator) {
+  size_t capacity = evaluator->capacity * 2;
+  session_t *sessions = calloc(capacity, sizeof(session_t));
+  if (sessions == NULL) {
+    return false;
+  }
+  for (size_t i = 0; i < evaluator->capacity; i++) {
+    if (!evaluator->sessions[i].is_used) {
+      continue;
+    }
+    size_t slot = mix(evaluator->sessions[i].id) & (capacity - 1);
+    while (sessions[slot].is_used) {
+      slot = (slot + 1) & (capacity - 1);
+    }
+    sessions[slot] = evaluator->sessions[i];
+  }
+  free(evaluator->sessions);
+  evaluator->sessions = sessions;
+  evaluator->capacity = capacity;
+  return true;
+}
+
+// NULL when a new session does not fit in memory
+static session_t* find_session(stream_evaluator_t *evaluator, uint64_t id) {
+  if (2 * (evaluator->stats.sessions + 1) > evaluator->capacity && !grow_sessions(evaluator)) {
+    return NULL;
+  }
+  size_t slot = mix(id) & (evaluator->capacity - 1);
+  while (evaluator->sessions[slot].is_used && evaluator->sessions[slot].id != id) {
+    slot = (slot + 1) & (evaluator->capacity - 1);
+  }
+  session_t *session = &evaluator->sessions[slot];
+  if (!session->is_used) {
+    *session = (session_t) {.id = id, .is_used = true};
+    evaluator->stats.sessions++;
+  }
+  return session;
+}
+
+static uint8_t play_session(stream_evaluator_t *evaluator, uint64_t id, game_logic_code_t guess) {
+  session_t *session = find_session(evaluator, id);
+  if (session == NULL) {
+    return NO_FEEDBACK;
+  }
+  if (session->tries == 0) {
+    uint64_t draw = mix(evaluator->seed ^ mix(id) ^ mix(UINT64_C(0x9E3779B97F4A7C15) * (session->games + 1)));
+    session->secret = (game_logic_code_t)(draw % NUMBER_OF_POSSIBLE_CODES);
+  }
+  uint8_t feedback_class = game_logic_score_row(guess)[session->secret];
+  if (feedback_class == WINNING_CLASS || ++session->tries == STREAM_EVALUATOR_MAXIMUM_NUMBER_OF_TRIES) {
+    session->tries = 0;
+    session->games++;
+  }
+  return feedback_class;
+}
+
+// the feedback class of a request without its newline, NO_FEEDBACK when it is not one
+static uint8_t evaluate_line(stream_evaluator_t *evaluator, const char *line, size_t length) {
+  if (length == 2 * NUMBER_OF_VALUES_TO_GUESS + 1 && line[NUMBER_OF_VALUES_TO_GUESS] == ' ') {
+    game_logic_code_t secret = parse_code(line);
+    game_logic_code_t guess = parse_code(line + NUMBER_OF_VALUES_TO_GUESS + 1);
+    if (secret < NUMBER_OF_POSSIBLE_CODES && guess < NUMBER_OF_POSSIBLE_CODES) {
+      return game_logic_score_row(guess)[secret];
+    }
+  }
+  uint64_t id = 0;
+  size_t digits = 0;
+  for (uint8_t digit; digits < length && (digit = digit_characters[(uint8_t) line[digits]]) != 0; digits++) {
+    id = id * 10 + digit - 1;
+  }
+  if (digits == 0 || digits > MAXIMUM_SESSION_DIGITS || length != digits + 1 + NUMBER_OF_VALUES_TO_GUESS ||
+      line[digits] != ' ') {
+    return NO_FEEDBACK;
+  }
+  game_logic_code_t guess = parse_code(line + digits + 1);
+  return guess < NUMBER_OF_POSSIBLE_CODES ? play_session(evaluator, id, guess) : NO_FEEDBACK;
+}
+
+size_t stream_evaluator_evaluate_lines(stream_evaluator_t *evaluator, const char *input, size_t length,
+                                       char *output, size_t output_capacity, size_t *output_length) {
+  size_t used = 0;
+  size_t written = 0;
+  while (output_capacity - written >= STREAM_EVALUATOR_MAXIMUM_REPLY) {
+    // lines are scored where they were read, nothing is copied out of the input
+    const char *line = input + used;
+    const char *end = memchr(line, '\n', length - used);
+    if (end == NULL) {
+      break;
+    }
+    size_t line_length = (size_t)(end - line);
+    if (line_length > 0 && line[line_length - 1] == '\r') {
+      line_length--;
+    }
+    uint8_t feedback_class = evaluate_line(evaluator, line, line_length);
+    if (feedback_class == NO_FEEDBACK) {
+      memcpy(output + written, error_reply, STREAM_EVALUATOR_MAXIMUM_REPLY);
+      evaluator->stats.errors++;
+    } else {
+      memcpy(output + written, evaluator->replies[feedback_class], STREAM_EVALUATOR_MAXIMUM_REPLY);
+    }
+    written += STREAM_EVALUATOR_MAXIMUM_REPLY;
+    evaluator->stats.requests++;
+    used = (size_t)(end - input) + 1;
+  }
+  *output_length = written;
+  return used;
+}
+
+size_t stream_evaluator_evaluate_frames(stream_evaluator_t *evaluator, const uint8_t *input, size_t length,
+                                        uint8_t *output) {
+  size_t number_of_frames = length / STREAM_EVALUATOR_FRAME_SIZE;
+  for (size_t i = 0; i < number_of_frames; i++) {
+    const uint8_t *frame = input + i * STREAM_EVALUATOR_FRAME_SIZE;
+    game_logic_code_t secret = (game_logic_code_t)(frame[0] | frame[1] << 8);
+    game_logic_code_t guess = (game_logic_code_t)(frame[2] | frame[3] << 8);
+    if (secret < NUMBER_OF_POSSIBLE_CODES && guess < NUMBER_OF_POSSIBLE_CODES) {
+      output[i] = game_logic_score_row(guess)[secret];
+    } else {
+      output[i] = STREAM_EVALUATOR_BAD_FRAME;
+      evaluator->stats.errors++;
+    }
+  }
+  evaluator->stats.requests += number_of_frames;
+  return number_of_frames * STREAM_EVALUATOR_FRAME_SIZE;
+}
+
+static bool write_all(stream_evaluator_t *evaluator, int fd, const void *data, size_t length) {
+  const uint8_t *bytes = data;
+  while (length > 0) {
+    ssize_t written = write(fd, bytes, length);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0) {
+      return false;
+    }
+    bytes += written;
+    length -= (size_t) written;
+    evaluator->stats.bytes_written += (uint64_t) written;
+  }
+  return true;
+}
+
+// 0 at the end of the input, -1 on an error
+static ssize_t read_some(stream_evaluator_t *evaluator, int fd, void *buffer, size_t capacity) {
+  ssize_t bytes_read;
+  do {
+    bytes_read = read(fd, buffer, capacity);
+  } while (bytes_read < 0 && errno == EINTR);
+  if (bytes_read > 0) {
+    evaluator->stats.bytes_read += (uint64_t) bytes_read;
+  }
+  return bytes_read;
+}
+
+static bool run_frames(stream_evaluator_t *evaluator, int input_fd, int output_fd, uint8_t *input, uint8_t *output) {
+  size_t filled = 0;
+  for (;;) {
+    ssize_t bytes_read = read_some(evaluator, input_fd, input + filled, STREAM_EVALUATOR_BUFFER_SIZE - filled);
+    if (bytes_read <= 0) {
+      // a frame cut short by the end of the input is not answered
+      evaluator->stats.errors += bytes_read == 0 && filled > 0;
+      return bytes_read == 0;
+    }
+    filled += (size_t) bytes_read;
+    size_t used = stream_evaluator_evaluate_frames(evaluator, input, filled, output);
+    if (!write_all(evaluator, output_fd, output, used / STREAM_EVALUATOR_FRAME_SIZE)) {
+      return false;
+    }
+    memmove(input, input + used, filled - used);
+    filled -= used;
+  }
+}
+
+static bool run_lines(stream_evaluator_t *evaluator, int input_fd, int output_fd, char *input, char *output) {
+  size_t filled = 0;
+  size_t output_length = 0;
+  bool is_discarding = false;
+  for (;;) {
+    ssize_t bytes_read = read_some(evaluator, input_fd, input + filled, STREAM_EVALUATOR_BUFFER_SIZE - filled);
+    if (bytes_read < 0) {
+      return false;
+    }
+    bool is_end = bytes_read == 0;
+    filled += (size_t) bytes_read;
+    size_t used = 0;
+    if (is_discarding) {
+      // the rest of a line too long for the buffer
+      const char *end = memchr(input, '\n', filled);
+      is_discarding = end == NULL;
+      used = is_discarding ? filled : (size_t)(end - input) + 1;
+    }
+    // the last line may not have a newline, the buffer keeps a byte spare for it
+    if (is_end && !is_discarding && filled > used && input[filled - 1] != '\n') {
+      input[filled++] = '\n';
+    }
+    for (;;) {
+      size_t written;
+      used += stream_evaluator_evaluate_lines(evaluator, input + used, filled - used, output + output_length,
+                                              STREAM_EVALUATOR_BUFFER_SIZE - output_length, &written);
+      output_length += written;
+      if (STREAM_EVALUATOR_BUFFER_SIZE - output_length >= STREAM_EVALUATOR_MAXIMUM_REPLY) {
+        break;
+      }
+      if (!write_all(evaluator, output_fd, output, output_length)) {
+        return false;
+      }
+      output_length = 0;
+    }
+    memmove(input, input + used, filled - used);
+    filled -= used;
+    if (filled == STREAM_EVALUATOR_BUFFER_SIZE) {
+      memcpy(output + output_length, error_reply, STREAM_EVALUATOR_MAXIMUM_REPLY);
+      output_length += STREAM_EVALUATOR_MAXIMUM_REPLY;
+      evaluator->stats.requests++;
+      evaluator->stats.errors++;
+      filled = 0;
+      is_discarding = true;
+    }
+    // the replies to every read go out before the next one blocks, so a pipeline is never held up
+    if (output_length > 0) {
+      if (!write_all(evaluator, output_fd, output, output_length)) {
+        return false;
+      }
+      output_length = 0;
+    }
+    if (is_end) {
+      return true;
+    }
+  }
+}
+
+bool stream_evaluator_run(stream_evaluator_t *evaluator, int input_fd, int output_fd, bool is_binary) {
+  char *input = malloc(STREAM_EVALUATOR_BUFFER_SIZE + 1);
+  char *output = malloc(STREAM_EVALUATOR_BUFFER_SIZE);
+  bool is_run = input != NULL && output != NULL;
+  if (is_run) {
+    is_run = is_binary ? run_frames(evaluator, input_fd, output_fd, (uint8_t *) input, (uint8_t *) output)
+                       : run_lines(evaluator, input_fd, output_fd, input, output);
+  }
+  free(input);
+  free(output);
+  return is_run;
+}
+
+int stream_evaluator_main(bool is_binary, uint64_t seed) {
+  stream_evaluator_t *evaluator = stream_evaluator_create(seed);
+  if (evaluator == NULL) {
+    return EXIT_FAILURE;
+  }
+  // the score table is built on first use, before the clock starts
+  game_logic_score_row(0);
+  struct timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  bool is_run = stream_evaluator_run(evaluator, STDIN_FILENO, STDOUT_FILENO, is_binary);
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double milliseconds = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+  const stream_evaluator_stats_t *stats = &evaluator->stats;
+  fprintf(stderr, "%llu requests, %llu errors, %llu sessions, %.1f MB in %.1f ms, %.1f MB/s\n",
+          (unsigned long long) stats->requests, (unsigned long long) stats->errors,
+          (unsigned long long) stats->sessions, (double) stats->bytes_read / (1024 * 1024), milliseconds,
+          milliseconds > 0 ? (double) stats->bytes_read / (milliseconds * 1e3) : 0.0);
+  if (!is_run) {
+    perror("stream");
+  }
+  stream_evaluator_destroy(evaluator);
+  return is_run ? EXIT_SUCCESS : EXIT_FAILURE;
+}
\ No newline at end of file
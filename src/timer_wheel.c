@@ -0,0 +1,192 @@
+#include "timer_wheel.h"
+#include <stdlib.h>
+
+#define SLOT_BITS 6
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+#define LEVEL_SHIFT(level) (SLOT_BITS * (level))
+// level of a timer taken off the wheel whose callback has not run yet
+#define EXPIRING_LEVEL TIMER_WHEEL_LEVELS
+
+struct timer_wheel {
+  // every tick before current has been advanced over, cascades due at current are done
+  uint64_t current;
+  size_t number_of_timers;
+  uint64_t occupied[TIMER_WHEEL_LEVELS];
+  timer_wheel_timer_t *slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+  // a callback may cancel or arm any timer, including the ones still waiting here for their turn
+  timer_wheel_timer_t *expiring;
+};
+
+timer_wheel_t* timer_wheel_create(uint64_t now) {
+  timer_wheel_t *wheel = calloc(1, sizeof(timer_wheel_t));
+  if (wheel != NULL) {
+    wheel->current = now;
+  }
+  return wheel;
+}
+
+void timer_wheel_destroy(timer_wheel_t *wheel) {
+  free(wheel);
+}
+
+void timer_wheel_timer_init(timer_wheel_timer_t *timer, timer_wheel_callback_t callback) {
+  timer->next = NULL;
+  timer->previous = NULL;
+  timer->callback = callback;
+  timer->expires = 0;
+  timer->is_armed = false;
+}
+
+static void link_timer(timer_wheel_t *wheel, timer_wheel_timer_t *timer) {
+  uint64_t delta = timer->expires > wheel->current ? timer->expires - wheel->current : 0;
+  uint64_t position = wheel->current + delta;
+  if (delta >= TIMER_WHEEL_RANGE) {
+    delta = TIMER_WHEEL_RANGE - 1;
+    position = wheel->current + delta;
+  }
+  // the lowest level whose turn covers the delta, overdue timers land in the slot expired next
+  uint8_t level = delta < TIMER_WHEEL_SLOTS ? 0 : (uint8_t)((63 - __builtin_clzll(delta)) / SLOT_BITS);
+  uint8_t slot = (uint8_t)((position >> LEVEL_SHIFT(level)) & SLOT_MASK);
+  timer->level = level;
+  timer->slot = slot;
+  timer->previous = NULL;
+  timer->next = wheel->slots[level][slot];
+  if (timer->next != NULL) {
+    timer->next->previous = timer;
+  }
+  wheel->slots[level][slot] = timer;
+  wheel->occupied[level] |= (uint64_t) 1 << slot;
+}
+
+static void unlink_timer(timer_wheel_t *wheel, timer_wheel_timer_t *timer) {
+  if (timer->previous != NULL) {
+    timer->previous->next = timer->next;
+  } else if (timer->level == EXPIRING_LEVEL) {
+    wheel->expiring = timer->next;
+  } else {
+    wheel->slots[timer->level][timer->slot] = timer->next;
+    if (timer->next == NULL) {
+      wheel->occupied[timer->level] &= ~((uint64_t) 1 << timer->slot);
+    }
+  }
+  if (timer->next != NULL) {
+    timer->next->previous = timer->previous;
+  }
+}
+
+void timer_wheel_arm(timer_wheel_t *wheel, timer_wheel_timer_t *timer, uint64_t expires) {
+  if (timer->is_armed) {
+    unlink_timer(wheel, timer);
+  } else {
+    wheel->number_of_timers++;
+  }
+  timer->expires = expires;
+  timer->is_armed = true;
+  link_timer(wheel, timer);
+}
+
+void timer_wheel_cancel(timer_wheel_t *wheel, timer_wheel_timer_t *timer) {
+  if (!timer->is_armed) {
+    return;
+  }
+  unlink_timer(wheel, timer);
+  timer->is_armed = false;
+  wheel->number_of_timers--;
+}
+
+// detaches a whole slot, its bit is cleared so timers armed while it is walked go to a fresh list
+static timer_wheel_timer_t* take_slot(timer_wheel_t *wheel, uint8_t level, uint8_t slot) {
+  timer_wheel_timer_t *list = wheel->slots[level][slot];
+  wheel->slots[level][slot] = NULL;
+  wheel->occupied[level] &= ~((uint64_t) 1 << slot);
+  return list;
+}
+
+// called on entering a tick, every level whose turn starts here hands the slot for it down
+static void cascade(timer_wheel_t *wheel) {
+  for (uint8_t level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+    if ((wheel->current & (((uint64_t) 1 << LEVEL_SHIFT(level)) - 1)) != 0) {
+      continue;
+    }
+    timer_wheel_timer_t *timer = take_slot(wheel, level, (uint8_t)((wheel->current >> LEVEL_SHIFT(level)) & SLOT_MASK));
+    while (timer != NULL) {
+      timer_wheel_timer_t *next = timer->next;
+      link_timer(wheel, timer);
+      timer = next;
+    }
+  }
+}
+
+uint64_t timer_wheel_ticks_until_next(const timer_wheel_t *wheel) {
+  uint64_t ticks = UINT64_MAX;
+  for (uint8_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+    if (wheel->occupied[level] == 0) {
+      continue;
+    }
+    // rotate so bit 0 is the slot the level is at now
+    unsigned shift = LEVEL_SHIFT(level);
+    unsigned digit = (unsigned)((wheel->current >> shift) & SLOT_MASK);
+    uint64_t rotated = digit == 0 ? wheel->occupied[level]
+                                  : wheel->occupied[level] >> digit | wheel->occupied[level] << (TIMER_WHEEL_SLOTS - digit);
+    uint64_t distance;
+    if (level == 0) {
+      distance = (uint64_t) __builtin_ctzll(rotated);
+    } else {
+      // the slot a level is at was already handed down, a timer there waits for the next turn
+      rotated &= ~(uint64_t) 1;
+      distance = rotated != 0 ? (uint64_t) __builtin_ctzll(rotated) : TIMER_WHEEL_SLOTS;
+      uint64_t turn_start = ((wheel->current >> shift) + distance) << shift;
+      distance = turn_start - wheel->current;
+    }
+    if (distance < ticks) {
+      ticks = distance;
+    }
+  }
+  return ticks;
+}
+
+size_t timer_wheel_advance(timer_wheel_t *wheel, uint64_t now, void *argument) {
+  size_t expired = 0;
+  while (wheel->current <= now) {
+    uint64_t ticks = timer_wheel_ticks_until_next(wheel);
+    if (ticks > now - wheel->current) {
+      // nothing is due before now, jump straight past it
+      wheel->current = now + 1;
+      cascade(wheel);
+      break;
+    }
+    if (ticks > 0) {
+      wheel->current += ticks;
+      cascade(wheel);
+    }
+    wheel->expiring = take_slot(wheel, 0, (uint8_t)(wheel->current & SLOT_MASK));
+    for (timer_wheel_timer_t *timer = wheel->expiring; timer != NULL; timer = timer->next) {
+      timer->level = EXPIRING_LEVEL;
+    }
+    // timers armed by the callbacks for this tick or earlier go to the next one
+    wheel->current++;
+    if ((wheel->current & SLOT_MASK) == 0) {
+      cascade(wheel);
+    }
+    while (wheel->expiring != NULL) {
+      timer_wheel_timer_t *timer = wheel->expiring;
+      wheel->expiring = timer->next;
+      if (wheel->expiring != NULL) {
+        wheel->expiring->previous = NULL;
+      }
+      timer->is_armed = false;
+      wheel->number_of_timers--;
+      timer->callback(timer, argument);
+      expired++;
+    }
+  }
+  return expired;
+}
+
+uint64_t timer_wheel_now(const timer_wheel_t *wheel) {
+  return wheel->current;
+}
+
+size_t timer_wheel_number_of_timers(const timer_wheel_t *wheel) {
+  return wheel->number_of_timers;
+}
\ No newline at end of file
@@ -0,0 +1,701 @@
+#define _GNU_SOURCE
+#include "tournament.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "solver.h"
+
+#define CACHE_LINE_SIZE 64
+#define SAMPLE_SIZE 256
+#define PATH_SIZE 4096
+#define NANOSECONDS_PER_MILLISECOND UINT64_C(1000000)
+// how often the supervisor looks for stop signals between checkpoints
+#define SUPERVISOR_MILLISECONDS 100
+// outcome of a game, otherwise the tries it was won in
+#define GAME_UNPLAYED 0
+#define GAME_FAILED UINT8_MAX
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+  uint8_t number_of_pegs;
+  uint8_t number_of_values;
+  uint8_t maximum_tries;
+  uint8_t number_of_strategies;
+  uint32_t sample_size;
+  uint64_t seed;
+  uint64_t number_of_secrets;
+  char strategy_names[TOURNAMENT_MAXIMUM_STRATEGIES][TOURNAMENT_STRATEGY_NAME_SIZE];
+} checkpoint_header_t;
+
+struct tournament;
+
+typedef struct {
+  // next task in the high half and the end of the share in the low half, so the owner taking from the
+  // front and a thief splitting off the back settle it with one compare and swap
+  uint64_t range;
+  struct tournament *tournament;
+  size_t index;
+  uint64_t games_played;
+  uint64_t steals;
+} __attribute__((aligned(CACHE_LINE_SIZE))) worker_t;
+
+typedef struct tournament {
+  const tournament_options_t *options;
+  uint64_t seed;
+  uint32_t sample_size;
+  uint64_t number_of_secrets;
+  uint64_t number_of_tasks;
+  large_space_code_t openings[TOURNAMENT_MAXIMUM_STRATEGIES];
+  uint64_t opening_nanoseconds[TOURNAMENT_MAXIMUM_STRATEGIES];
+  // a task is a secret and strategy pair, secret major so every share mixes the strategies
+  uint8_t *outcomes;
+  uint64_t *cpu_nanoseconds;
+  worker_t *workers;
+  size_t number_of_workers;
+  uint64_t games_started;
+  int is_stopping;
+  pthread_mutex_t lock;
+  pthread_cond_t finished;
+  size_t number_finished;
+  // header, processor times and outcomes, in that order
+  char *checkpoint;
+  size_t checkpoint_size;
+} tournament_t;
+
+static bool is_standard_game(const large_space_variant_t *variant) {
+  return variant->number_of_pegs == NUMBER_OF_VALUES_TO_GUESS && variant->number_of_values == GAME_VALUE_MAX;
+}
+
+// the candidates left in the standard game, returns the count
+static size_t filter_standard(const large_space_move_t history[], size_t history_length,
+                              game_logic_code_t candidates[]) {
+  game_logic_move_t moves[LARGE_SPACE_MAXIMUM_HISTORY];
+  for (size_t i = 0; i < history_length; i++) {
+    for (uint_fast8_t peg = 0; peg < NUMBER_OF_VALUES_TO_GUESS; peg++) {
+      moves[i].guess[peg] = (game_logic_values_t) history[i].guess.values[peg];
+    }
+    moves[i].feedback = history[i].feedback;
+  }
+  return solver_filter_candidates(moves, history_length, candidates);
+}
+
+static void to_large_code(game_logic_code_t code, large_space_code_t *guess) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_unpack_code(code, values);
+  memset(guess, 0, sizeof(*guess));
+  for (uint_fast8_t peg = 0; peg < NUMBER_OF_VALUES_TO_GUESS; peg++) {
+    guess->values[peg] = (uint8_t) values[peg];
+  }
+}
+
+static void choose_minimax(const large_space_variant_t *variant, const large_space_move_t history[],
+                           size_t history_length, uint32_t *random_state,
+                           large_space_code_t *guess) {
+  (void) variant;
+  (void) random_state;
+  game_logic_code_t candidates[NUMBER_OF_POSSIBLE_CODES];
+  size_t number_of_candidates = filter_standard(history, history_length, candidates);
+  to_large_code(number_of_candidates > 0 ? solver_best_guess(candidates, number_of_candidates) : 0, guess);
+}
+
+// the guess that splits the candidates into the most feedback classes, ties go to candidates
+static void choose_most_parts(const large_space_variant_t *variant, const large_space_move_t history[],
+                              size_t history_length, uint32_t *random_state,
+                              large_space_code_t *guess) {
+  (void) variant;
+  (void) random_state;
+  game_logic_code_t candidates[NUMBER_OF_POSSIBLE_CODES];
+  size_t number_of_candidates = filter_standard(history, history_length, candidates);
+  if (number_of_candidates <= 2) {
+    to_large_code(number_of_candidates > 0 ? candidates[0] : 0, guess);
+    return;
+  }
+  bool is_candidate[NUMBER_OF_POSSIBLE_CODES] = {false};
+  for (size_t i = 0; i < number_of_candidates; i++) {
+    is_candidate[candidates[i]] = true;
+  }
+  game_logic_code_t best = candidates[0];
+  int best_parts = 0;
+  bool is_best_candidate = false;
+  for (game_logic_code_t code = 0; code < NUMBER_OF_POSSIBLE_CODES; code++) {
+    const uint8_t *row = game_logic_score_row(code);
+    uint32_t classes = 0;
+    for (size_t i = 0; i < number_of_candidates; i++) {
+      classes |= UINT32_C(1) << row[candidates[i]];
+    }
+    int parts = __builtin_popcount(classes);
+    if (parts > best_parts || (parts == best_parts && is_candidate[code] && !is_best_candidate)) {
+      best = code;
+      best_parts = parts;
+      is_best_candidate = is_candidate[code];
+    }
+  }
+  to_large_code(best, guess);
+}
+
+static void choose_first_consistent(const large_space_variant_t *variant, const large_space_move_t history[],
+                                    size_t history_length, uint32_t *random_state,
+                                    large_space_code_t *guess) {
+  (void) random_state;
+  large_space_enumerator_t enumerator;
+  if (!large_space_enumerator_init(&enumerator, variant, history, history_length, false) ||
+      !large_space_enumerator_next(&enumerator, guess)) {
+    // nothing agrees with the feedback, any code will do
+    memset(guess, 0, sizeof(*guess));
+  }
+}
+
+static void choose_sampled(const large_space_variant_t *variant, const large_space_move_t history[],
+                           size_t history_length, uint32_t *random_state,
+                           large_space_code_t *guess) {
+  if (!large_space_best_guess_seeded(variant, history, history_length, SAMPLE_SIZE, random_state, guess)) {
+    memset(guess, 0, sizeof(*guess));
+  }
+}
+
+static const tournament_strategy_t strategies[] = {
+  {"minimax", true, true, choose_minimax},
+  {"most-parts", true, true, choose_most_parts},
+  {"first-consistent", false, true, choose_first_consistent},
+  {"sampled", false, false, choose_sampled},
+};
+
+size_t tournament_get_strategies(const tournament_strategy_t **all) {
+  *all = strategies;
+  return sizeof(strategies) / sizeof(strategies[0]);
+}
+
+const tournament_strategy_t* tournament_find_strategy(const char *name) {
+  for (size_t i = 0; i < sizeof(strategies) / sizeof(strategies[0]); i++) {
+    if (strcmp(strategies[i].name, name) == 0) {
+      return &strategies[i];
+    }
+  }
+  return NULL;
+}
+
+static uint64_t now_nanoseconds(clockid_t clock) {
+  struct timespec now;
+  clock_gettime(clock, &now);
+  return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+static uint64_t mix(uint64_t value) {
+  value ^= value >> 30;
+  value *= 0xBF58476D1CE4E5B9ull;
+  value ^= value >> 27;
+  value *= 0x94D049BB133111EBull;
+  return value ^ (value >> 31);
+}
+
+// every code in order when the whole space is played, otherwise a draw that only depends on the seed
+static void get_secret(const tournament_t *tournament, uint64_t index, large_space_code_t *secret) {
+  const large_space_variant_t *variant = &tournament->options->variant;
+  uint64_t digits = tournament->sample_size == 0 ? index :
+                    mix(tournament->seed ^ mix(UINT64_C(0x9E3779B97F4A7C15) * (index + 1)));
+  memset(secret, 0, sizeof(*secret));
+  // the variant was checked before play, the second bound spells that out for the compiler
+  for (uint_fast8_t i = variant->number_of_pegs; i > 0 && i <= LARGE_SPACE_MAXIMUM_PEGS; i--) {
+    secret->values[i - 1] = (uint8_t)(digits % variant->number_of_values);
+    digits /= variant->number_of_values;
+  }
+}
+
+// random choices come from a stream seeded by the seed and the task alone, so a game plays out the same
+// on any worker and after a resume
+static uint32_t seed_game(const tournament_t *tournament, uint64_t task) {
+  uint32_t random_state = (uint32_t) mix(tournament->seed ^ mix(UINT64_C(0xD1B54A32D192ED03) * (task + 1)));
+  // zero is the one state xorshift never leaves
+  return random_state != 0 ? random_state : 1;
+}
+
+static uint8_t play_game(const tournament_t *tournament, uint64_t task, const large_space_code_t *secret) {
+  const tournament_options_t *options = tournament->options;
+  size_t strategy = task % options->number_of_strategies;
+  uint32_t random_state = seed_game(tournament, task);
+  large_space_move_t history[LARGE_SPACE_MAXIMUM_HISTORY];
+  for (uint8_t tries = 0; tries < options->maximum_tries; tries++) {
+    if (tries == 0 && options->strategies[strategy]->is_deterministic) {
+      history[tries].guess = tournament->openings[strategy];
+    } else {
+      options->strategies[strategy]->choose(&options->variant, history, tries, &random_state, &history[tries].guess);
+    }
+    history[tries].feedback = large_space_score(&options->variant, secret, &history[tries].guess);
+    if (history[tries].feedback.is_guess_correct) {
+      return (uint8_t)(tries + 1);
+    }
+  }
+  return GAME_FAILED;
+}
+
+static uint64_t pack_range(uint32_t next, uint32_t end) {
+  return (uint64_t) next << 32 | end;
+}
+
+static bool take(worker_t *worker, uint32_t *task) {
+  uint64_t range = __atomic_load_n(&worker->range, __ATOMIC_ACQUIRE);
+  for (;;) {
+    uint32_t next = (uint32_t)(range >> 32);
+    uint32_t end = (uint32_t) range;
+    if (next >= end) {
+      return false;
+    }
+    if (__atomic_compare_exchange_n(&worker->range, &range, pack_range(next + 1, end), false, __ATOMIC_ACQ_REL,
+                                    __ATOMIC_ACQUIRE)) {
+      *task = next;
+      return true;
+    }
+  }
+}
+
+// splits the back half off the first share found with tasks left. Tasks are only ever handed out once,
+// so a range can never come back to a value a slower thief is still comparing against
+static bool steal(worker_t *thief, uint32_t *task) {
+  tournament_t *tournament = thief->tournament;
+  for (size_t offset = 1; offset < tournament->number_of_workers; offset++) {
+    worker_t *victim = &tournament->workers[(thief->index + offset) % tournament->number_of_workers];
+    uint64_t range = __atomic_load_n(&victim->range, __ATOMIC_ACQUIRE);
+    for (;;) {
+      uint32_t next = (uint32_t)(range >> 32);
+      uint32_t end = (uint32_t) range;
+      if (next >= end) {
+        break;
+      }
+      uint32_t middle = next + (end - next) / 2;
+      if (__atomic_compare_exchange_n(&victim->range, &range, pack_range(next, middle), false, __ATOMIC_ACQ_REL,
+                                      __ATOMIC_ACQUIRE)) {
+        *task = middle;
+        __atomic_store_n(&thief->range, pack_range(middle + 1, end), __ATOMIC_RELEASE);
+        thief->steals++;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+static void* play_tasks(void *argument) {
+  worker_t *worker = argument;
+  tournament_t *tournament = worker->tournament;
+  uint64_t maximum_games = tournament->options->maximum_games;
+  size_t number_of_strategies = tournament->options->number_of_strategies;
+  uint32_t task;
+  while (!__atomic_load_n(&tournament->is_stopping, __ATOMIC_RELAXED) && (take(worker, &task) || steal(worker, &task))) {
+    // played before the checkpoint was taken
+    if (tournament->outcomes[task] != GAME_UNPLAYED) {
+      continue;
+    }
+    if (maximum_games > 0 && __atomic_fetch_add(&tournament->games_started, 1, __ATOMIC_RELAXED) >= maximum_games) {
+      __atomic_store_n(&tournament->is_stopping, 1, __ATOMIC_RELAXED);
+      break;
+    }
+    large_space_code_t secret;
+    get_secret(tournament, task / number_of_strategies, &secret);
+    uint64_t start = now_nanoseconds(CLOCK_THREAD_CPUTIME_ID);
+    uint8_t outcome = play_game(tournament, task, &secret);
+    tournament->cpu_nanoseconds[task] = now_nanoseconds(CLOCK_THREAD_CPUTIME_ID) - start;
+    // the checkpoint reads the processor time once it sees the outcome
+    __atomic_store_n(&tournament->outcomes[task], outcome, __ATOMIC_RELEASE);
+    worker->games_played++;
+  }
+  pthread_mutex_lock(&tournament->lock);
+  tournament->number_finished++;
+  pthread_cond_signal(&tournament->finished);
+  pthread_mutex_unlock(&tournament->lock);
+  return NULL;
+}
+
+static void fill_header(const tournament_t *tournament, checkpoint_header_t *header) {
+  const tournament_options_t *options = tournament->options;
+  memset(header, 0, sizeof(*header));
+  header->magic = TOURNAMENT_CHECKPOINT_MAGIC;
+  header->version = TOURNAMENT_CHECKPOINT_VERSION;
+  header->number_of_pegs = options->variant.number_of_pegs;
+  header->number_of_values = options->variant.number_of_values;
+  header->maximum_tries = options->maximum_tries;
+  header->number_of_strategies = (uint8_t) options->number_of_strategies;
+  header->sample_size = tournament->sample_size;
+  header->seed = tournament->seed;
+  header->number_of_secrets = tournament->number_of_secrets;
+  for (size_t i = 0; i < options->number_of_strategies; i++) {
+    snprintf(header->strategy_names[i], TOURNAMENT_STRATEGY_NAME_SIZE, "%s", options->strategies[i]->name);
+  }
+}
+
+// everything but the seed has to match, the seed is taken from the checkpoint
+static bool is_same_tournament(const checkpoint_header_t *expected, const checkpoint_header_t *found) {
+  checkpoint_header_t reseeded = *expected;
+  reseeded.seed = found->seed;
+  return memcmp(&reseeded, found, sizeof(reseeded)) == 0;
+}
+
+// a missing checkpoint starts a fresh tournament
+static bool load_checkpoint(tournament_t *tournament, const char *path) {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return errno == ENOENT;
+  }
+  size_t read_size = 0;
+  while (read_size < tournament->checkpoint_size) {
+    ssize_t length = read(fd, tournament->checkpoint + read_size, tournament->checkpoint_size - read_size);
+    if (length <= 0) {
+      break;
+    }
+    read_size += (size_t) length;
+  }
+  close(fd);
+  checkpoint_header_t expected;
+  fill_header(tournament, &expected);
+  const checkpoint_header_t *found = (const checkpoint_header_t *) tournament->checkpoint;
+  if (read_size != tournament->checkpoint_size || !is_same_tournament(&expected, found)) {
+    return false;
+  }
+  tournament->seed = found->seed;
+  memcpy(tournament->cpu_nanoseconds, tournament->checkpoint + sizeof(checkpoint_header_t),
+         tournament->number_of_tasks * sizeof(uint64_t));
+  memcpy(tournament->outcomes,
+         tournament->checkpoint + sizeof(checkpoint_header_t) + tournament->number_of_tasks * sizeof(uint64_t),
+         tournament->number_of_tasks);
+  for (uint64_t task = 0; task < tournament->number_of_tasks; task++) {
+    uint8_t outcome = tournament->outcomes[task];
+    if (outcome != GAME_FAILED && outcome > tournament->options->maximum_tries) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool write_all(int fd, const char *data, size_t length) {
+  while (length > 0) {
+    ssize_t written = write(fd, data, length);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written < 0) {
+      return false;
+    }
+    data += written;
+    length -= (size_t) written;
+  }
+  return true;
+}
+
+// may run while workers play, a game counts once its outcome is seen
+static bool write_checkpoint(tournament_t *tournament, const char *path) {
+  fill_header(tournament, (checkpoint_header_t *) tournament->checkpoint);
+  uint64_t *cpu_nanoseconds = (uint64_t *)(tournament->checkpoint + sizeof(checkpoint_header_t));
+  uint8_t *outcomes = (uint8_t *)(cpu_nanoseconds + tournament->number_of_tasks);
+  for (uint64_t task = 0; task < tournament->number_of_tasks; task++) {
+    outcomes[task] = __atomic_load_n(&tournament->outcomes[task], __ATOMIC_ACQUIRE);
+    cpu_nanoseconds[task] = outcomes[task] != GAME_UNPLAYED ? tournament->cpu_nanoseconds[task] : 0;
+  }
+
+  char temporary_path[PATH_SIZE];
+  if (snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", path) >= (int) sizeof(temporary_path)) {
+    return false;
+  }
+  int fd = open(temporary_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+  bool is_written = fd >= 0 && write_all(fd, tournament->checkpoint, tournament->checkpoint_size) &&
+                    fdatasync(fd) == 0;
+  if (fd >= 0) {
+    close(fd);
+  }
+  if (!is_written || rename(temporary_path, path) != 0) {
+    unlink(temporary_path);
+    return false;
+  }
+  return true;
+}
+
+// waits for the workers, checkpointing as they go and stopping them when a stop signal comes
+static void supervise(tournament_t *tournament, size_t number_started, tournament_stats_t *stats) {
+  const tournament_options_t *options = tournament->options;
+  uint64_t interval = (uint64_t) options->checkpoint_milliseconds * NANOSECONDS_PER_MILLISECOND;
+  uint64_t last_checkpoint = now_nanoseconds(CLOCK_MONOTONIC);
+  pthread_mutex_lock(&tournament->lock);
+  while (tournament->number_finished < number_started) {
+    uint64_t wake = now_nanoseconds(CLOCK_MONOTONIC) + SUPERVISOR_MILLISECONDS * NANOSECONDS_PER_MILLISECOND;
+    struct timespec deadline = {.tv_sec = (time_t)(wake / 1000000000u), .tv_nsec = (long)(wake % 1000000000u)};
+    pthread_cond_timedwait(&tournament->finished, &tournament->lock, &deadline);
+    if (tournament->number_finished == number_started) {
+      break;
+    }
+    pthread_mutex_unlock(&tournament->lock);
+    struct timespec no_wait = {0, 0};
+    if (options->stop_signals != NULL && sigtimedwait(options->stop_signals, NULL, &no_wait) > 0) {
+      __atomic_store_n(&tournament->is_stopping, 1, __ATOMIC_RELAXED);
+    }
+    uint64_t now = now_nanoseconds(CLOCK_MONOTONIC);
+    if (options->checkpoint_path != NULL && now - last_checkpoint >= interval) {
+      stats->checkpoint_failures += !write_checkpoint(tournament, options->checkpoint_path);
+      last_checkpoint = now;
+    }
+    pthread_mutex_lock(&tournament->lock);
+  }
+  pthread_mutex_unlock(&tournament->lock);
+}
+
+static void play(tournament_t *tournament, tournament_stats_t *stats) {
+  size_t number_of_workers = tournament->number_of_workers;
+  for (size_t i = 0; i < number_of_workers; i++) {
+    worker_t *worker = &tournament->workers[i];
+    worker->tournament = tournament;
+    worker->index = i;
+    worker->range = pack_range((uint32_t)(tournament->number_of_tasks * i / number_of_workers),
+                               (uint32_t)(tournament->number_of_tasks * (i + 1) / number_of_workers));
+  }
+  pthread_condattr_t attributes;
+  pthread_condattr_init(&attributes);
+  pthread_condattr_setclock(&attributes, CLOCK_MONOTONIC);
+  pthread_cond_init(&tournament->finished, &attributes);
+  pthread_condattr_destroy(&attributes);
+  pthread_mutex_init(&tournament->lock, NULL);
+
+  pthread_t threads[TOURNAMENT_MAXIMUM_THREADS];
+  size_t number_started = 0;
+  for (size_t i = 0; i < number_of_workers; i++) {
+    if (pthread_create(&threads[number_started], NULL, play_tasks, &tournament->workers[i]) == 0) {
+      number_started++;
+    }
+  }
+  if (number_started == 0) {
+    // the shares of workers that never started are stolen, the first worker takes them all here
+    play_tasks(&tournament->workers[0]);
+  }
+  supervise(tournament, number_started, stats);
+  for (size_t i = 0; i < number_started; i++) {
+    pthread_join(threads[i], NULL);
+  }
+  pthread_cond_destroy(&tournament->finished);
+  pthread_mutex_destroy(&tournament->lock);
+}
+
+static void tally(const tournament_t *tournament, tournament_result_t results[], tournament_stats_t *stats) {
+  const tournament_options_t *options = tournament->options;
+  for (size_t i = 0; i < options->number_of_strategies; i++) {
+    memset(&results[i], 0, sizeof(results[i]));
+    results[i].name = options->strategies[i]->name;
+  }
+  stats->is_complete = true;
+  for (uint64_t task = 0; task < tournament->number_of_tasks; task++) {
+    uint8_t outcome = tournament->outcomes[task];
+    tournament_result_t *result = &results[task % options->number_of_strategies];
+    if (outcome == GAME_UNPLAYED) {
+      stats->is_complete = false;
+      continue;
+    }
+    result->games++;
+    result->cpu_nanoseconds += tournament->cpu_nanoseconds[task];
+    if (outcome == GAME_FAILED) {
+      result->failures++;
+      result->moves += options->maximum_tries;
+      continue;
+    }
+    result->tries_to_win += outcome;
+    result->moves += outcome;
+    result->worst_case = outcome > result->worst_case ? outcome : result->worst_case;
+  }
+  for (size_t i = 0; i < options->number_of_strategies; i++) {
+    if (results[i].games > 0) {
+      results[i].cpu_nanoseconds += tournament->opening_nanoseconds[i];
+    }
+  }
+}
+
+static bool is_playable(const tournament_options_t *options) {
+  const large_space_variant_t *variant = &options->variant;
+  if (variant->number_of_pegs == 0 || variant->number_of_pegs > LARGE_SPACE_MAXIMUM_PEGS ||
+      variant->number_of_values < 2 || variant->number_of_values > LARGE_SPACE_MAXIMUM_VALUES ||
+      options->maximum_tries == 0 || options->maximum_tries > LARGE_SPACE_MAXIMUM_HISTORY ||
+      options->number_of_strategies == 0 || options->number_of_strategies > TOURNAMENT_MAXIMUM_STRATEGIES) {
+    return false;
+  }
+  for (size_t i = 0; i < options->number_of_strategies; i++) {
+    if (options->strategies[i] == NULL || (options->strategies[i]->is_standard_only && !is_standard_game(variant))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint64_t number_of_codes(const large_space_variant_t *variant) {
+  uint64_t codes = 1;
+  for (uint_fast8_t i = 0; i < variant->number_of_pegs; i++) {
+    codes *= variant->number_of_values;
+  }
+  return codes;
+}
+
+// the first guess of a deterministic strategy is the same in every game, each is worked out once and
+// its cost charged to the strategy once rather than to every game
+static void choose_openings(tournament_t *tournament) {
+  const tournament_options_t *options = tournament->options;
+  for (size_t i = 0; i < options->number_of_strategies; i++) {
+    if (options->strategies[i]->is_deterministic) {
+      uint32_t random_state = seed_game(tournament, i);
+      uint64_t start = now_nanoseconds(CLOCK_THREAD_CPUTIME_ID);
+      options->strategies[i]->choose(&options->variant, NULL, 0, &random_state, &tournament->openings[i]);
+      tournament->opening_nanoseconds[i] = now_nanoseconds(CLOCK_THREAD_CPUTIME_ID) - start;
+    }
+  }
+}
+
+bool tournament_run(const tournament_options_t *options, tournament_result_t results[], tournament_stats_t *stats) {
+  memset(stats, 0, sizeof(*stats));
+  if (!is_playable(options)) {
+    return false;
+  }
+  tournament_t tournament = {.options = options, .seed = options->seed, .sample_size = options->sample_size};
+  uint64_t codes = number_of_codes(&options->variant);
+  if (tournament.sample_size == 0 && codes > TOURNAMENT_MAXIMUM_SECRETS) {
+    tournament.sample_size = TOURNAMENT_DEFAULT_SAMPLE_SIZE;
+  }
+  tournament.number_of_secrets = tournament.sample_size > 0 ? tournament.sample_size : codes;
+  tournament.number_of_tasks = tournament.number_of_secrets * options->number_of_strategies;
+  // ranges hold task numbers in 32 bits
+  if (tournament.number_of_tasks >= UINT32_MAX) {
+    return false;
+  }
+  size_t number_of_workers = options->number_of_threads;
+  if (number_of_workers == 0) {
+    long processors = sysconf(_SC_NPROCESSORS_ONLN);
+    number_of_workers = processors > 0 ? (size_t) processors : 1;
+  }
+  if (number_of_workers > TOURNAMENT_MAXIMUM_THREADS) {
+    number_of_workers = TOURNAMENT_MAXIMUM_THREADS;
+  }
+  if (number_of_workers > tournament.number_of_tasks) {
+    number_of_workers = (size_t) tournament.number_of_tasks;
+  }
+  tournament.number_of_workers = number_of_workers;
+
+  tournament.checkpoint_size = sizeof(checkpoint_header_t) + tournament.number_of_tasks * (sizeof(uint64_t) + 1);
+  tournament.outcomes = calloc(tournament.number_of_tasks, 1);
+  tournament.cpu_nanoseconds = calloc(tournament.number_of_tasks, sizeof(uint64_t));
+  tournament.workers = calloc(number_of_workers, sizeof(worker_t));
+  tournament.checkpoint = options->checkpoint_path != NULL ? malloc(tournament.checkpoint_size) : NULL;
+  bool is_ready = tournament.outcomes != NULL && tournament.cpu_nanoseconds != NULL && tournament.workers != NULL &&
+                  (options->checkpoint_path == NULL || tournament.checkpoint != NULL);
+  if (is_ready && options->checkpoint_path != NULL) {
+    is_ready = load_checkpoint(&tournament, options->checkpoint_path);
+  }
+  if (is_ready) {
+    for (uint64_t task = 0; task < tournament.number_of_tasks; task++) {
+      stats->games_resumed += tournament.outcomes[task] != GAME_UNPLAYED;
+    }
+    uint64_t start = now_nanoseconds(CLOCK_MONOTONIC);
+    // the score table is built on first use, before any worker can race to build it
+    game_logic_score_row(0);
+    choose_openings(&tournament);
+    play(&tournament, stats);
+    if (options->checkpoint_path != NULL) {
+      stats->checkpoint_failures += !write_checkpoint(&tournament, options->checkpoint_path);
+    }
+    stats->wall_nanoseconds = now_nanoseconds(CLOCK_MONOTONIC) - start;
+    for (size_t i = 0; i < number_of_workers; i++) {
+      stats->games_played += tournament.workers[i].games_played;
+      stats->steals += tournament.workers[i].steals;
+    }
+    stats->number_of_secrets = tournament.number_of_secrets;
+    stats->seed = tournament.seed;
+    stats->number_of_threads = number_of_workers;
+    tally(&tournament, results, stats);
+  }
+  free(tournament.outcomes);
+  free(tournament.cpu_nanoseconds);
+  free(tournament.workers);
+  free(tournament.checkpoint);
+  return is_ready;
+}
+
+// fills the options' strategies in from a comma separated list, or every one that can play the variant
+static bool pick_strategies(const char *strategy_names, tournament_options_t *options) {
+  options->number_of_strategies = 0;
+  if (strategy_names == NULL) {
+    for (size_t i = 0; i < sizeof(strategies) / sizeof(strategies[0]); i++) {
+      if (!strategies[i].is_standard_only || is_standard_game(&options->variant)) {
+        options->strategies[options->number_of_strategies++] = &strategies[i];
+      }
+    }
+    return true;
+  }
+  const char *name = strategy_names;
+  for (;;) {
+    size_t length = strcspn(name, ",");
+    char copy[TOURNAMENT_STRATEGY_NAME_SIZE];
+    if (length >= sizeof(copy) || options->number_of_strategies == TOURNAMENT_MAXIMUM_STRATEGIES) {
+      return false;
+    }
+    memcpy(copy, name, length);
+    copy[length] = '\0';
+    const tournament_strategy_t *strategy = tournament_find_strategy(copy);
+    if (strategy == NULL) {
+      fprintf(stderr, "No strategy called %s\n", copy);
+      return false;
+    }
+    options->strategies[options->number_of_strategies++] = strategy;
+    if (name[length] == '\0') {
+      return true;
+    }
+    name += length + 1;
+  }
+}
+
+int tournament_main(const char *strategy_names, tournament_options_t *options) {
+  if (!pick_strategies(strategy_names, options)) {
+    fprintf(stderr, "Strategies are minimax, most-parts, first-consistent and sampled, up to %d at once\n",
+            TOURNAMENT_MAXIMUM_STRATEGIES);
+    return EXIT_FAILURE;
+  }
+  // workers inherit the mask, so the signals wait for the supervisor rather than ending the run
+  sigset_t stop_signals;
+  sigemptyset(&stop_signals);
+  sigaddset(&stop_signals, SIGINT);
+  sigaddset(&stop_signals, SIGTERM);
+  sigset_t previous;
+  pthread_sigmask(SIG_BLOCK, &stop_signals, &previous);
+  options->stop_signals = &stop_signals;
+  tournament_result_t results[TOURNAMENT_MAXIMUM_STRATEGIES];
+  tournament_stats_t stats;
+  bool is_run = tournament_run(options, results, &stats);
+  pthread_sigmask(SIG_SETMASK, &previous, NULL);
+  if (!is_run) {
+    fprintf(stderr, "Could not run the tournament, games have 1-%d pegs, 2-%d values and 1-%d tries, "
+            "minimax and most-parts only play the standard game", LARGE_SPACE_MAXIMUM_PEGS,
+            LARGE_SPACE_MAXIMUM_VALUES, LARGE_SPACE_MAXIMUM_HISTORY);
+    if (options->checkpoint_path != NULL) {
+      fprintf(stderr, ", and %s must be from the same tournament", options->checkpoint_path);
+    }
+    fprintf(stderr, "\n");
+    return EXIT_FAILURE;
+  }
+  printf("%-20s %8s %12s %6s %9s %12s\n", "strategy", "games", "avg guesses", "worst", "failures", "us per move");
+  for (size_t i = 0; i < options->number_of_strategies; i++) {
+    const tournament_result_t *result = &results[i];
+    uint64_t wins = result->games - result->failures;
+    printf("%-20s %8llu %12.3f %6u %8.2f%% %12.1f\n", result->name, (unsigned long long) result->games,
+           wins > 0 ? (double) result->tries_to_win / (double) wins : 0.0, result->worst_case,
+           result->games > 0 ? 100.0 * (double) result->failures / (double) result->games : 0.0,
+           result->moves > 0 ? (double) result->cpu_nanoseconds / (double) result->moves / 1e3 : 0.0);
+  }
+  printf("%llu secrets (seed %llu), %llu games played and %llu resumed on %zu threads in %.1f ms, %llu steals\n",
+         (unsigned long long) stats.number_of_secrets, (unsigned long long) stats.seed,
+         (unsigned long long) stats.games_played, (unsigned long long) stats.games_resumed, stats.number_of_threads,
+         (double) stats.wall_nanoseconds / 1e6, (unsigned long long) stats.steals);
+  if (stats.checkpoint_failures > 0) {
+    fprintf(stderr, "%llu checkpoints could not be written to %s\n", (unsigned long long) stats.checkpoint_failures,
+            options->checkpoint_path);
+  }
+  if (!stats.is_complete && options->checkpoint_path != NULL) {
+    printf("Stopped early, run again to resume from %s\n", options->checkpoint_path);
+  } else if (!stats.is_complete) {
+    printf("Stopped early\n");
+  }
+  return EXIT_SUCCESS;
+}
\ No newline at end of file
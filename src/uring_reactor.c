@@ -0,0 +1,533 @@
+#define _GNU_SOURCE
+#include "uring_reactor.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define RING_ENTRIES 1024
+#define COMPLETION_RING_ENTRIES (4 * RING_ENTRIES)
+#define BUFFER_GROUP 0
+// power of two, provided buffer rings index with a mask
+#define BUFFER_COUNT 4096
+#define BUFFER_SIZE 1024
+// multishot recv reads everything the socket has, so unlike epoll the socket cannot hold back a client
+// that pipelines without reading its responses. Received input a session may hold while it waits for
+// its output to drain, a client that pipelines further ahead is dropped
+#define MAXIMUM_HELD_BUFFERS 32
+
+// sessions are cache line aligned slab objects so the operation fits in the low bits of the user data
+#define OPERATION_MASK 3u
+#define ACCEPT_USER_DATA 0
+// below any session address
+#define WAKE_USER_DATA 4
+enum {
+  OPERATION_RECV = 1,
+  OPERATION_SEND = 2,
+  OPERATION_CANCEL = 3
+};
+
+typedef struct {
+  uint16_t buffer_id;
+  uint16_t offset;
+  uint16_t length;
+} held_buffer_t;
+
+typedef struct uring_session uring_session_t;
+
+struct uring_session {
+  // first, so the slab's objects can be walked as sessions by the server
+  server_session_t session;
+  // next session waiting for provided buffers to come back
+  uring_session_t *next_starved;
+  bool is_starved;
+  bool is_receiving;
+  bool is_sending;
+  bool is_cancelling;
+  bool is_shutting_down;
+  uint8_t number_of_held;
+  held_buffer_t held[MAXIMUM_HELD_BUFFERS];
+};
+
+struct uring_reactor {
+  int ring_fd;
+  int listen_fd;
+  int wake_fd;
+  slab_t *sessions;
+  server_session_shard_t *shard;
+
+  void *ring_map;
+  size_t ring_map_size;
+  struct io_uring_sqe *sqes;
+  size_t sqes_size;
+  unsigned *sq_head;
+  unsigned *sq_tail;
+  unsigned sq_mask;
+  unsigned sq_entries;
+  unsigned sq_local_tail;
+  unsigned *cq_head;
+  unsigned *cq_tail;
+  unsigned cq_mask;
+  struct io_uring_cqe *cqes;
+
+  struct io_uring_buf_ring *buffer_ring;
+  uint16_t buffer_ring_tail;
+  char *buffers;
+  // sessions whose recv ended with ENOBUFS, armed again once buffers are recycled
+  uring_session_t *starved;
+  bool has_recycled;
+};
+
+static int io_uring_setup(unsigned entries, struct io_uring_params *params) {
+  return (int) syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, void *argument,
+                          size_t argument_size) {
+  return (int) syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, argument, argument_size);
+}
+
+static int io_uring_register(int fd, unsigned opcode, void *argument, unsigned number_of_arguments) {
+  return (int) syscall(__NR_io_uring_register, fd, opcode, argument, number_of_arguments);
+}
+
+// a wait that runs into the timeout (milliseconds, -1 for none) fails with ETIME
+static int submit(uring_reactor_t *reactor, unsigned wait_for, int timeout) {
+  __atomic_store_n(reactor->sq_tail, reactor->sq_local_tail, __ATOMIC_RELEASE);
+  unsigned to_submit = reactor->sq_local_tail - __atomic_load_n(reactor->sq_head, __ATOMIC_ACQUIRE);
+  if (to_submit == 0 && wait_for == 0) {
+    return 0;
+  }
+  if (wait_for == 0 || timeout < 0) {
+    return io_uring_enter(reactor->ring_fd, to_submit, wait_for, wait_for > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+  }
+  struct __kernel_timespec timespec = {.tv_sec = timeout / 1000, .tv_nsec = (long long)(timeout % 1000) * 1000000};
+  struct io_uring_getevents_arg argument = {.ts = (uint64_t)(uintptr_t) &timespec};
+  return io_uring_enter(reactor->ring_fd, to_submit, wait_for, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG,
+                        &argument, sizeof(argument));
+}
+
+// submissions are only pushed to the kernel once per loop unless the queue fills up first
+static struct io_uring_sqe* get_sqe(uring_reactor_t *reactor) {
+  while (reactor->sq_local_tail - __atomic_load_n(reactor->sq_head, __ATOMIC_ACQUIRE) == reactor->sq_entries) {
+    if (submit(reactor, 0, -1) < 0 && errno != EINTR && errno != EBUSY) {
+      return NULL;
+    }
+  }
+  struct io_uring_sqe *sqe = &reactor->sqes[reactor->sq_local_tail & reactor->sq_mask];
+  reactor->sq_local_tail++;
+  memset(sqe, 0, sizeof(*sqe));
+  return sqe;
+}
+
+static void recycle_buffer(uring_reactor_t *reactor, uint16_t buffer_id) {
+  struct io_uring_buf *buffer = &reactor->buffer_ring->bufs[reactor->buffer_ring_tail & (BUFFER_COUNT - 1)];
+  buffer->addr = (uint64_t)(uintptr_t)(reactor->buffers + (size_t) buffer_id * BUFFER_SIZE);
+  buffer->len = BUFFER_SIZE;
+  buffer->bid = buffer_id;
+  reactor->buffer_ring_tail++;
+  reactor->has_recycled = true;
+  __atomic_store_n(&reactor->buffer_ring->tail, reactor->buffer_ring_tail, __ATOMIC_RELEASE);
+}
+
+static void arm_accept(uring_reactor_t *reactor) {
+  struct io_uring_sqe *sqe = get_sqe(reactor);
+  if (sqe == NULL) {
+    return;
+  }
+  sqe->opcode = IORING_OP_ACCEPT;
+  sqe->fd = reactor->listen_fd;
+  sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+  sqe->accept_flags = SOCK_CLOEXEC;
+  sqe->user_data = ACCEPT_USER_DATA;
+}
+
+static void arm_wake(uring_reactor_t *reactor) {
+  struct io_uring_sqe *sqe = get_sqe(reactor);
+  if (sqe == NULL) {
+    return;
+  }
+  sqe->opcode = IORING_OP_POLL_ADD;
+  sqe->fd = reactor->wake_fd;
+  sqe->len = IORING_POLL_ADD_MULTI;
+  sqe->poll32_events = POLLIN;
+  sqe->user_data = WAKE_USER_DATA;
+}
+
+static void handle_wake(uring_reactor_t *reactor, const struct io_uring_cqe *cqe) {
+  uint64_t count;
+  // only the wakeup matters, the hook runs on every loop anyway
+  if (read(reactor->wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+    return;
+  }
+  if ((cqe->flags & IORING_CQE_F_MORE) == 0) {
+    arm_wake(reactor);
+  }
+}
+
+static void arm_recv(uring_reactor_t *reactor, uring_session_t *session) {
+  struct io_uring_sqe *sqe = get_sqe(reactor);
+  if (sqe == NULL) {
+    return;
+  }
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = session->session.fd;
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = BUFFER_GROUP;
+  sqe->user_data = (uint64_t)(uintptr_t) session | OPERATION_RECV;
+  session->is_receiving = true;
+}
+
+static void cancel_recv(uring_reactor_t *reactor, uring_session_t *session) {
+  struct io_uring_sqe *sqe = get_sqe(reactor);
+  if (sqe == NULL) {
+    return;
+  }
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = (uint64_t)(uintptr_t) session | OPERATION_RECV;
+  sqe->user_data = (uint64_t)(uintptr_t) session | OPERATION_CANCEL;
+  session->is_cancelling = true;
+}
+
+static void send_output(uring_reactor_t *reactor, uring_session_t *session) {
+  struct io_uring_sqe *sqe = get_sqe(reactor);
+  if (sqe == NULL) {
+    return;
+  }
+  // responses are only appended while the send is in flight, the bytes it reads stay put
+  sqe->opcode = IORING_OP_SEND;
+  sqe->fd = session->session.fd;
+  sqe->addr = (uint64_t)(uintptr_t) session->session.output;
+  sqe->len = (uint32_t) session->session.output_length;
+  sqe->msg_flags = MSG_NOSIGNAL;
+  sqe->user_data = (uint64_t)(uintptr_t) session | OPERATION_SEND;
+  session->is_sending = true;
+}
+
+static void try_free_session(uring_reactor_t *reactor, uring_session_t *session) {
+  if (!session->is_shutting_down || session->is_receiving || session->is_sending || session->is_cancelling ||
+      session->is_starved) {
+    return;
+  }
+  for (uint8_t i = 0; i < session->number_of_held; i++) {
+    recycle_buffer(reactor, session->held[i].buffer_id);
+  }
+  server_session_release(&session->session);
+  close(session->session.fd);
+  slab_free(reactor->sessions, slab_handle_of(reactor->sessions, session));
+  SERVER_SESSION_COUNT(reactor->shard->stats.sessions_closed);
+}
+
+// the shutdown ends the pending recv so the session is freed once its last completion arrives
+static void shut_down_session(uring_reactor_t *reactor, uring_session_t *session) {
+  if (!session->is_shutting_down) {
+    session->is_shutting_down = true;
+    shutdown(session->session.fd, SHUT_RDWR);
+  }
+  try_free_session(reactor, session);
+}
+
+// copies held input into the session while it has room, returns false when it is still waiting on output
+static bool drain_held_buffers(uring_reactor_t *reactor, uring_session_t *session) {
+  server_session_t *protocol = &session->session;
+  while (session->number_of_held > 0) {
+    held_buffer_t *held = &session->held[0];
+    size_t room = SERVER_SESSION_INPUT_SIZE - protocol->input_length;
+    size_t length = MIN(room, (size_t) held->length);
+    if (length == 0) {
+      return false;
+    }
+    memcpy(protocol->input + protocol->input_length,
+           reactor->buffers + (size_t) held->buffer_id * BUFFER_SIZE + held->offset, length);
+    protocol->input_length += length;
+    held->offset = (uint16_t)(held->offset + length);
+    held->length = (uint16_t)(held->length - length);
+    server_session_process_input(protocol);
+    if (held->length == 0) {
+      recycle_buffer(reactor, held->buffer_id);
+      session->number_of_held--;
+      memmove(&session->held[0], &session->held[1], session->number_of_held * sizeof(held_buffer_t));
+    }
+  }
+  return true;
+}
+
+// moves the session forward after any completion
+static void service_session(uring_reactor_t *reactor, uring_session_t *session) {
+  if (session->is_shutting_down) {
+    try_free_session(reactor, session);
+    return;
+  }
+  bool is_drained = drain_held_buffers(reactor, session);
+  // output that drained may free room for lines that were waiting on it
+  server_session_process_input(&session->session);
+  if (session->session.output_length > 0 && !session->is_sending) {
+    send_output(reactor, session);
+  }
+  if (session->session.is_closing) {
+    if (session->session.output_length == 0) {
+      shut_down_session(reactor, session);
+    }
+    return;
+  }
+  bool wants_input = is_drained && server_session_wants_input(&session->session);
+  if (wants_input && !session->is_receiving && !session->is_cancelling && !session->is_starved) {
+    arm_recv(reactor, session);
+  } else if (!wants_input && session->is_receiving && !session->is_cancelling) {
+    // stop the data until the client reads its responses, it stays queued in the socket
+    cancel_recv(reactor, session);
+  }
+}
+
+static void handle_accept(uring_reactor_t *reactor, const struct io_uring_cqe *cqe) {
+  if ((cqe->flags & IORING_CQE_F_MORE) == 0) {
+    arm_accept(reactor);
+  }
+  if (cqe->res < 0) {
+    return;
+  }
+  uring_session_t *session = slab_alloc(reactor->sessions, NULL);
+  if (session == NULL) {
+    SERVER_SESSION_COUNT(reactor->shard->stats.sessions_refused);
+    close(cqe->res);
+    return;
+  }
+  session->next_starved = NULL;
+  session->is_starved = false;
+  session->is_receiving = false;
+  session->is_sending = false;
+  session->is_cancelling = false;
+  session->is_shutting_down = false;
+  session->number_of_held = 0;
+  server_session_init(&session->session, cqe->res, reactor->shard);
+  SERVER_SESSION_COUNT(reactor->shard->stats.sessions_accepted);
+  arm_recv(reactor, session);
+}
+
+static void handle_recv(uring_reactor_t *reactor, uring_session_t *session, const struct io_uring_cqe *cqe) {
+  if ((cqe->flags & IORING_CQE_F_MORE) == 0) {
+    session->is_receiving = false;
+  }
+  if (cqe->res > 0 && (cqe->flags & IORING_CQE_F_BUFFER)) {
+    uint16_t buffer_id = (uint16_t)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+    if (session->is_shutting_down || session->number_of_held == MAXIMUM_HELD_BUFFERS) {
+      // a client that keeps sending without reading its responses is dropped
+      recycle_buffer(reactor, buffer_id);
+      shut_down_session(reactor, session);
+      return;
+    }
+    session->held[session->number_of_held++] = (held_buffer_t) {buffer_id, 0, (uint16_t) cqe->res};
+  } else if (cqe->res == -ENOBUFS && !session->is_receiving && !session->is_starved) {
+    // arming straight away would only fail again until another session gives a buffer back
+    session->is_starved = true;
+    session->next_starved = reactor->starved;
+    reactor->starved = session;
+  } else if (cqe->res == 0 || (cqe->res < 0 && cqe->res != -ENOBUFS && cqe->res != -ECANCELED)) {
+    shut_down_session(reactor, session);
+    return;
+  }
+  service_session(reactor, session);
+}
+
+static void handle_send(uring_reactor_t *reactor, uring_session_t *session, const struct io_uring_cqe *cqe) {
+  session->is_sending = false;
+  if (cqe->res < 0) {
+    shut_down_session(reactor, session);
+    return;
+  }
+  server_session_consume_output(&session->session, (size_t) cqe->res);
+  service_session(reactor, session);
+}
+
+static void handle_completion(uring_reactor_t *reactor, const struct io_uring_cqe *cqe) {
+  if (cqe->user_data == ACCEPT_USER_DATA) {
+    handle_accept(reactor, cqe);
+    return;
+  }
+  if (cqe->user_data == WAKE_USER_DATA) {
+    handle_wake(reactor, cqe);
+    return;
+  }
+  uring_session_t *session = (uring_session_t *)(uintptr_t)(cqe->user_data & ~(uint64_t) OPERATION_MASK);
+  switch (cqe->user_data & OPERATION_MASK) {
+  case OPERATION_RECV:
+    handle_recv(reactor, session, cqe);
+    break;
+  case OPERATION_SEND:
+    handle_send(reactor, session, cqe);
+    break;
+  case OPERATION_CANCEL:
+    session->is_cancelling = false;
+    service_session(reactor, session);
+    break;
+  default:
+    break;
+  }
+}
+
+static bool map_rings(uring_reactor_t *reactor, const struct io_uring_params *params) {
+  // kernels without a single mapping for both rings or wait timeouts predate everything else this backend needs
+  if ((params->features & IORING_FEAT_SINGLE_MMAP) == 0 || (params->features & IORING_FEAT_NODROP) == 0 ||
+      (params->features & IORING_FEAT_EXT_ARG) == 0) {
+    return false;
+  }
+  size_t sq_size = params->sq_off.array + params->sq_entries * sizeof(unsigned);
+  size_t cq_size = params->cq_off.cqes + params->cq_entries * sizeof(struct io_uring_cqe);
+  reactor->ring_map_size = sq_size > cq_size ? sq_size : cq_size;
+  reactor->ring_map = mmap(NULL, reactor->ring_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           reactor->ring_fd, IORING_OFF_SQ_RING);
+  if (reactor->ring_map == MAP_FAILED) {
+    reactor->ring_map = NULL;
+    return false;
+  }
+  reactor->sqes_size = params->sq_entries * sizeof(struct io_uring_sqe);
+  reactor->sqes = mmap(NULL, reactor->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       reactor->ring_fd, IORING_OFF_SQES);
+  if (reactor->sqes == MAP_FAILED) {
+    reactor->sqes = NULL;
+    return false;
+  }
+  char *ring = reactor->ring_map;
+  reactor->sq_head = (unsigned *)(ring + params->sq_off.head);
+  reactor->sq_tail = (unsigned *)(ring + params->sq_off.tail);
+  reactor->sq_mask = *(unsigned *)(ring + params->sq_off.ring_mask);
+  reactor->sq_entries = params->sq_entries;
+  reactor->sq_local_tail = *reactor->sq_tail;
+  // submission slots map one to one onto the entries
+  unsigned *sq_array = (unsigned *)(ring + params->sq_off.array);
+  for (unsigned i = 0; i < params->sq_entries; i++) {
+    sq_array[i] = i;
+  }
+  reactor->cq_head = (unsigned *)(ring + params->cq_off.head);
+  reactor->cq_tail = (unsigned *)(ring + params->cq_off.tail);
+  reactor->cq_mask = *(unsigned *)(ring + params->cq_off.ring_mask);
+  reactor->cqes = (struct io_uring_cqe *)(ring + params->cq_off.cqes);
+  return true;
+}
+
+static bool register_buffers(uring_reactor_t *reactor) {
+  reactor->buffer_ring = mmap(NULL, BUFFER_COUNT * sizeof(struct io_uring_buf), PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (reactor->buffer_ring == MAP_FAILED) {
+    reactor->buffer_ring = NULL;
+    return false;
+  }
+  reactor->buffers = malloc((size_t) BUFFER_COUNT * BUFFER_SIZE);
+  if (reactor->buffers == NULL) {
+    return false;
+  }
+  struct io_uring_buf_reg registration = {
+    .ring_addr = (uint64_t)(uintptr_t) reactor->buffer_ring,
+    .ring_entries = BUFFER_COUNT,
+    .bgid = BUFFER_GROUP
+  };
+  if (io_uring_register(reactor->ring_fd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) {
+    return false;
+  }
+  for (uint16_t i = 0; i < BUFFER_COUNT; i++) {
+    recycle_buffer(reactor, i);
+  }
+  return true;
+}
+
+static void destroy(uring_reactor_t *reactor) {
+  if (reactor->buffer_ring != NULL) {
+    munmap(reactor->buffer_ring, BUFFER_COUNT * sizeof(struct io_uring_buf));
+  }
+  if (reactor->sqes != NULL) {
+    munmap(reactor->sqes, reactor->sqes_size);
+  }
+  if (reactor->ring_map != NULL) {
+    munmap(reactor->ring_map, reactor->ring_map_size);
+  }
+  if (reactor->ring_fd >= 0) {
+    close(reactor->ring_fd);
+  }
+  free(reactor->buffers);
+  slab_destroy(reactor->sessions);
+  free(reactor);
+}
+
+uring_reactor_t* uring_reactor_create(int listen_fd, int wake_fd, size_t maximum_sessions, server_session_shard_t *shard) {
+  uring_reactor_t *reactor = calloc(1, sizeof(uring_reactor_t));
+  if (reactor == NULL) {
+    return NULL;
+  }
+  reactor->listen_fd = listen_fd;
+  reactor->wake_fd = wake_fd;
+  reactor->shard = shard;
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  // multishot recv can complete many times per submission so the completion ring is larger
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = COMPLETION_RING_ENTRIES;
+  reactor->ring_fd = io_uring_setup(RING_ENTRIES, &params);
+  if (reactor->ring_fd < 0 || !map_rings(reactor, &params) || !register_buffers(reactor)) {
+    destroy(reactor);
+    return NULL;
+  }
+  reactor->sessions = slab_create("io_uring sessions", sizeof(uring_session_t), maximum_sessions);
+  if (reactor->sessions == NULL) {
+    destroy(reactor);
+    return NULL;
+  }
+  return reactor;
+}
+
+slab_t* uring_reactor_get_sessions(uring_reactor_t *reactor) {
+  return reactor->sessions;
+}
+
+static void wake_starved_sessions(uring_reactor_t *reactor) {
+  uring_session_t *session = reactor->starved;
+  reactor->starved = NULL;
+  reactor->has_recycled = false;
+  while (session != NULL) {
+    uring_session_t *next = session->next_starved;
+    session->is_starved = false;
+    session->next_starved = NULL;
+    service_session(reactor, session);
+    session = next;
+  }
+}
+
+void uring_reactor_run(uring_reactor_t *reactor, uring_reactor_hook_t hook, void *argument) {
+  arm_accept(reactor);
+  arm_wake(reactor);
+  for (;;) {
+    hook(argument);
+    int timeout = server_session_timer_wait(reactor->shard, server_session_clock());
+    if (submit(reactor, 1, timeout) < 0 && errno != EINTR && errno != EBUSY && errno != ETIME) {
+      fprintf(stderr, "io_uring_enter failed: %s\n", strerror(errno));
+      break;
+    }
+    // deadlines armed by the completions count from the wheel's clock, so it is brought up to date first
+    server_session_t *timed_out = server_session_run_timers(reactor->shard, server_session_clock());
+    while (timed_out != NULL) {
+      server_session_t *next = timed_out->next_timed_out;
+      shut_down_session(reactor, (uring_session_t *)((char *) timed_out - offsetof(uring_session_t, session)));
+      timed_out = next;
+    }
+    unsigned head = *reactor->cq_head;
+    unsigned tail = __atomic_load_n(reactor->cq_tail, __ATOMIC_ACQUIRE);
+    for (; head != tail; head++) {
+      handle_completion(reactor, &reactor->cqes[head & reactor->cq_mask]);
+    }
+    __atomic_store_n(reactor->cq_head, head, __ATOMIC_RELEASE);
+    if (reactor->starved != NULL && reactor->has_recycled) {
+      wake_starved_sessions(reactor);
+    }
+  }
+  destroy(reactor);
+}
\ No newline at end of file
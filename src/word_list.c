@@ -0,0 +1,278 @@
+#define _POSIX_C_SOURCE 200809L
+#include "word_list.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define INDEX_VERSION 1
+#define MAXIMUM_LINE_LENGTH 256
+#define LETTER_MASK ((1u << WORD_LIST_BITS_PER_LETTER) - 1)
+
+static const char index_magic[4] = {'M', 'M', 'W', 'L'};
+
+static uint8_t letter_at(uint8_t word_length, uint64_t packed, uint8_t position) {
+  return (uint8_t)((packed >> ((word_length - 1 - position) * WORD_LIST_BITS_PER_LETTER)) & LETTER_MASK);
+}
+
+static int compare_words(const void *a, const void *b) {
+  uint64_t left = *(const uint64_t *) a;
+  uint64_t right = *(const uint64_t *) b;
+  return (left > right) - (left < right);
+}
+
+bool word_list_pack(uint8_t word_length, const char *word, uint64_t *packed) {
+  if (word_length == 0 || word_length > WORD_LIST_MAXIMUM_WORD_LENGTH) {
+    return false;
+  }
+  uint64_t result = 0;
+  for (uint8_t i = 0; i < word_length; i++) {
+    char letter = word[i];
+    if (letter >= 'A' && letter <= 'Z') {
+      letter = (char)(letter - 'A' + 'a');
+    }
+    if (letter < 'a' || letter > 'z') {
+      return false;
+    }
+    result = (result << WORD_LIST_BITS_PER_LETTER) | (uint64_t)(letter - 'a');
+  }
+  // anything other than the end of the word or a line ending means the word is too long
+  char end = word[word_length];
+  if (end != '\0' && end != '\n' && end != '\r') {
+    return false;
+  }
+  *packed = result;
+  return true;
+}
+
+void word_list_unpack(uint8_t word_length, uint64_t packed, char word[]) {
+  for (uint8_t i = 0; i < word_length; i++) {
+    word[i] = (char)('a' + letter_at(word_length, packed, i));
+  }
+  word[word_length] = '\0';
+}
+
+bool word_list_build_index(const char *dictionary_path, const char *index_path, uint8_t word_length) {
+  FILE *dictionary = fopen(dictionary_path, "r");
+  if (dictionary == NULL) {
+    return false;
+  }
+  size_t capacity = 1024;
+  size_t number_of_words = 0;
+  uint64_t *words = malloc(capacity * sizeof(uint64_t));
+  char line[MAXIMUM_LINE_LENGTH];
+  while (words != NULL && fgets(line, sizeof(line), dictionary) != NULL) {
+    uint64_t packed;
+    if (!word_list_pack(word_length, line, &packed)) {
+      continue;
+    }
+    if (number_of_words == capacity) {
+      capacity *= 2;
+      uint64_t *grown = realloc(words, capacity * sizeof(uint64_t));
+      if (grown == NULL) {
+        free(words);
+        words = NULL;
+        break;
+      }
+      words = grown;
+    }
+    words[number_of_words++] = packed;
+  }
+  fclose(dictionary);
+  if (words == NULL || number_of_words == 0) {
+    free(words);
+    return false;
+  }
+
+  qsort(words, number_of_words, sizeof(uint64_t), compare_words);
+  size_t unique = 1;
+  for (size_t i = 1; i < number_of_words; i++) {
+    if (words[i] != words[unique - 1]) {
+      words[unique++] = words[i];
+    }
+  }
+  number_of_words = unique;
+
+  word_list_header_t header = {
+    .version = INDEX_VERSION,
+    .word_length = word_length,
+    .number_of_words = number_of_words,
+    .bitmap_stride = (number_of_words + 63) / 64
+  };
+  memcpy(header.magic, index_magic, sizeof(index_magic));
+  size_t bitmap_words = (size_t) word_length * WORD_LIST_ALPHABET_SIZE * header.bitmap_stride;
+  uint64_t *bitmaps = calloc(bitmap_words, sizeof(uint64_t));
+  if (bitmaps == NULL) {
+    free(words);
+    return false;
+  }
+  for (size_t i = 0; i < number_of_words; i++) {
+    for (uint8_t position = 0; position < word_length; position++) {
+      size_t bitmap = (size_t) position * WORD_LIST_ALPHABET_SIZE + letter_at(word_length, words[i], position);
+      bitmaps[bitmap * header.bitmap_stride + i / 64] |= (uint64_t) 1 << (i % 64);
+    }
+  }
+
+  FILE *index = fopen(index_path, "wb");
+  bool is_written = index != NULL &&
+                    fwrite(&header, sizeof(header), 1, index) == 1 &&
+                    fwrite(words, sizeof(uint64_t), number_of_words, index) == number_of_words &&
+                    fwrite(bitmaps, sizeof(uint64_t), bitmap_words, index) == bitmap_words;
+  if (index != NULL && fclose(index) != 0) {
+    is_written = false;
+  }
+  free(words);
+  free(bitmaps);
+  return is_written;
+}
+
+bool word_list_open(word_list_t *list, const char *index_path) {
+  memset(list, 0, sizeof(*list));
+  int fd = open(index_path, O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat status;
+  if (fstat(fd, &status) != 0 || (size_t) status.st_size < sizeof(word_list_header_t)) {
+    close(fd);
+    return false;
+  }
+  void *map = mmap(NULL, (size_t) status.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return false;
+  }
+
+  const word_list_header_t *header = map;
+  if (header->number_of_words > (size_t) status.st_size / sizeof(uint64_t)) {
+    munmap(map, (size_t) status.st_size);
+    return false;
+  }
+  size_t expected_size = sizeof(word_list_header_t) + header->number_of_words * sizeof(uint64_t) +
+                         (size_t) header->word_length * WORD_LIST_ALPHABET_SIZE * header->bitmap_stride * sizeof(uint64_t);
+  if (memcmp(header->magic, index_magic, sizeof(index_magic)) != 0 || header->version != INDEX_VERSION ||
+      header->word_length == 0 || header->word_length > WORD_LIST_MAXIMUM_WORD_LENGTH ||
+      header->bitmap_stride != (header->number_of_words + 63) / 64 || expected_size != (size_t) status.st_size) {
+    munmap(map, (size_t) status.st_size);
+    return false;
+  }
+
+  list->map = map;
+  list->map_size = (size_t) status.st_size;
+  list->header = header;
+  list->words = (const uint64_t *)(header + 1);
+  list->bitmaps = list->words + header->number_of_words;
+  return true;
+}
+
+void word_list_close(word_list_t *list) {
+  if (list->map != NULL) {
+    munmap(list->map, list->map_size);
+  }
+  memset(list, 0, sizeof(*list));
+}
+
+size_t word_list_get_size(const word_list_t *list) {
+  return (size_t) list->header->number_of_words;
+}
+
+uint8_t word_list_get_word_length(const word_list_t *list) {
+  return (uint8_t) list->header->word_length;
+}
+
+uint64_t word_list_get_word(const word_list_t *list, size_t index) {
+  return list->words[index];
+}
+
+bool word_list_contains(const word_list_t *list, uint64_t packed) {
+  return bsearch(&packed, list->words, word_list_get_size(list), sizeof(uint64_t), compare_words) != NULL;
+}
+
+const uint64_t* word_list_get_bitmap(const word_list_t *list, uint8_t position, uint8_t letter) {
+  return list->bitmaps + ((size_t) position * WORD_LIST_ALPHABET_SIZE + letter) * list->header->bitmap_stride;
+}
+
+game_logic_feedback_t word_list_score(uint8_t word_length, uint64_t answer, uint64_t guess) {
+  game_logic_feedback_t feedback = {0};
+  uint_fast8_t answer_bins[WORD_LIST_ALPHABET_SIZE] = {0};
+  uint_fast8_t guess_bins[WORD_LIST_ALPHABET_SIZE] = {0};
+
+  for (uint8_t i = 0; i < word_length; i++) {
+    uint8_t answer_letter = letter_at(word_length, answer, i);
+    uint8_t guess_letter = letter_at(word_length, guess, i);
+    answer_bins[answer_letter]++;
+    guess_bins[guess_letter]++;
+    if (answer_letter == guess_letter) {
+      feedback.number_of_correct_value_and_placement++;
+    }
+  }
+
+  for (uint_fast8_t i = 0; i < WORD_LIST_ALPHABET_SIZE; i++) {
+    feedback.number_of_correct_value_only += MIN(guess_bins[i], answer_bins[i]);
+  }
+
+  feedback.number_of_correct_value_only -= feedback.number_of_correct_value_and_placement;
+  feedback.is_guess_correct = (bool)(feedback.number_of_correct_value_and_placement == word_length);
+  return feedback;
+}
+
+size_t word_list_filter(const word_list_t *list, const word_list_move_t history[], size_t history_length, uint64_t candidates[]) {
+  const uint8_t word_length = word_list_get_word_length(list);
+  const size_t number_of_words = word_list_get_size(list);
+  const size_t stride = (size_t) list->header->bitmap_stride;
+
+  for (size_t i = 0; i < stride; i++) {
+    candidates[i] = UINT64_MAX;
+  }
+  if (number_of_words % 64 != 0) {
+    candidates[stride - 1] = ((uint64_t) 1 << (number_of_words % 64)) - 1;
+  }
+
+  for (size_t m = 0; m < history_length; m++) {
+    const game_logic_feedback_t *feedback = &history[m].feedback;
+    bool is_no_match = feedback->number_of_correct_value_and_placement + feedback->number_of_correct_value_only == 0;
+    for (uint8_t position = 0; position < word_length; position++) {
+      uint8_t letter = letter_at(word_length, history[m].guess, position);
+      if (is_no_match) {
+        // none of the guessed letters appear anywhere
+        for (uint8_t other = 0; other < word_length; other++) {
+          const uint64_t *bitmap = word_list_get_bitmap(list, other, letter);
+          for (size_t i = 0; i < stride; i++) {
+            candidates[i] &= ~bitmap[i];
+          }
+        }
+      } else if (feedback->number_of_correct_value_and_placement == 0) {
+        const uint64_t *bitmap = word_list_get_bitmap(list, position, letter);
+        for (size_t i = 0; i < stride; i++) {
+          candidates[i] &= ~bitmap[i];
+        }
+      }
+    }
+  }
+
+  size_t count = 0;
+  for (size_t i = 0; i < stride; i++) {
+    uint64_t remaining = candidates[i];
+    while (remaining != 0) {
+      uint64_t lowest = remaining & (~remaining + 1);
+      size_t index = i * 64 + (size_t) __builtin_ctzll(remaining);
+      remaining ^= lowest;
+      bool is_consistent = true;
+      for (size_t m = 0; m < history_length && is_consistent; m++) {
+        game_logic_feedback_t feedback = word_list_score(word_length, list->words[index], history[m].guess);
+        is_consistent = feedback.number_of_correct_value_and_placement == history[m].feedback.number_of_correct_value_and_placement &&
+                        feedback.number_of_correct_value_only == history[m].feedback.number_of_correct_value_only;
+      }
+      if (is_consistent) {
+        count++;
+      } else {
+        candidates[i] ^= lowest;
+      }
+    }
+  }
+  return count;
+}
\ No newline at end of file
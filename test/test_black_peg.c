@@ -0,0 +1,88 @@
+#include "unity.h"
+#include "game_logic.h"
+#include "black_peg.h"
+#include "random.h"
+
+static int mock_random_return[NUMBER_OF_VALUES_TO_GUESS];
+static size_t mock_random_return_index;
+
+int random_value(void) {
+  return mock_random_return[mock_random_return_index++];
+}
+
+static void mock_random_set_values_to_match(const game_logic_values_t *set_answer) {
+  mock_random_return_index = 0;
+  for (size_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    mock_random_return[i] = set_answer[i];
+  }
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+void test_score_agrees_with_placement_count_for_every_pair(void) {
+  game_logic_values_t answer[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i += 7) {
+    game_logic_unpack_code(i, answer);
+    for (game_logic_code_t j = 0; j < NUMBER_OF_POSSIBLE_CODES; j++) {
+      game_logic_unpack_code(j, guess);
+      TEST_ASSERT_EQUAL_UINT8(game_logic_score(answer, guess).number_of_correct_value_and_placement,
+                              black_peg_score(black_peg_pack(answer), black_peg_pack(guess)));
+    }
+  }
+}
+
+void test_feedback_has_no_value_only_pegs(void) {
+  game_logic_values_t set_answer[] = {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR};
+  mock_random_set_values_to_match(set_answer);
+  game_logic_generate_random_answer();
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_THREE, GAME_VALUE_TWO, GAME_VALUE_FOUR};
+
+  game_logic_feedback_t feedback = black_peg_get_feedback(guess);
+
+  TEST_ASSERT_EQUAL_UINT8(2, feedback.number_of_correct_value_and_placement);
+  TEST_ASSERT_EQUAL_UINT8(0, feedback.number_of_correct_value_only);
+  TEST_ASSERT_FALSE(feedback.is_guess_correct);
+}
+
+void test_feedback_for_correct_guess(void) {
+  game_logic_values_t set_answer[] = {GAME_VALUE_SIX, GAME_VALUE_FIVE, GAME_VALUE_FIVE, GAME_VALUE_SIX};
+  mock_random_set_values_to_match(set_answer);
+  game_logic_generate_random_answer();
+
+  game_logic_feedback_t feedback = black_peg_get_feedback(set_answer);
+
+  TEST_ASSERT_TRUE(feedback.is_guess_correct);
+}
+
+void test_hint_solves_every_answer(void) {
+  for (game_logic_code_t code = 0; code < NUMBER_OF_POSSIBLE_CODES; code += 37) {
+    game_logic_values_t answer[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(code, answer);
+    game_logic_move_t history[NUMBER_OF_POSSIBLE_CODES];
+    size_t history_length = 0;
+    bool is_solved = false;
+    while (!is_solved) {
+      solver_hint_t hint = black_peg_get_hint(history, history_length);
+      TEST_ASSERT_TRUE(hint.remaining_candidates > 0);
+      game_logic_unpack_code(hint.best_guess, history[history_length].guess);
+      history[history_length].feedback = game_logic_score(answer, history[history_length].guess);
+      history[history_length].feedback.number_of_correct_value_only = 0;
+      is_solved = history[history_length].feedback.is_guess_correct;
+      history_length++;
+    }
+    TEST_ASSERT_TRUE(history_length <= 8);
+  }
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_score_agrees_with_placement_count_for_every_pair);
+    RUN_TEST(test_feedback_has_no_value_only_pegs);
+    RUN_TEST(test_feedback_for_correct_guess);
+    RUN_TEST(test_hint_solves_every_answer);
+  return UNITY_END();
+}
\ No newline at end of file
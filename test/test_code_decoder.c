@@ -0,0 +1,176 @@
+#include "unity.h"
+#include "code_decoder.h"
+#include "game_logic.h"
+#include <stdio.h>
+#include <string.h>
+
+#define CLASSIC_ALPHABET "ABCDEF"
+#define LINE_SIZE 8
+#define MESSAGE_SIZE 128
+#define NUMBER_OF_BATCH_CODES 1000
+
+int random_value(void) {
+  return 0;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static void format_code(game_logic_code_t code, char line[]) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_unpack_code(code, values);
+  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    line[i] = CLASSIC_ALPHABET[values[i]];
+  }
+  line[NUMBER_OF_VALUES_TO_GUESS] = '\n';
+  line[NUMBER_OF_VALUES_TO_GUESS + 1] = '\0';
+}
+
+static void assert_error(const code_decoder_t *decoder, const char *line, code_decoder_status_t status,
+                         size_t position, const char *message) {
+  uint8_t values[CODE_DECODER_MAXIMUM_PEGS];
+  code_decoder_error_t error;
+  TEST_ASSERT_EQUAL(status, code_decoder_decode(decoder, line, values, NULL, &error));
+  TEST_ASSERT_EQUAL(status, error.status);
+  TEST_ASSERT_EQUAL_size_t(position, error.position);
+  char text[MESSAGE_SIZE];
+  code_decoder_describe_error(decoder, line, &error, text, sizeof(text));
+  TEST_ASSERT_EQUAL_STRING(message, text);
+}
+
+void test_init_refuses_repeated_characters_and_bad_sizes(void) {
+  code_decoder_t decoder;
+  TEST_ASSERT_TRUE(code_decoder_init(&decoder, CLASSIC_ALPHABET, NUMBER_OF_VALUES_TO_GUESS));
+  TEST_ASSERT_TRUE(decoder.is_contiguous);
+  TEST_ASSERT_TRUE(code_decoder_init(&decoder, "RGBYOP", NUMBER_OF_VALUES_TO_GUESS));
+  TEST_ASSERT_FALSE(decoder.is_contiguous);
+  TEST_ASSERT_FALSE(code_decoder_init(&decoder, "ABCA", NUMBER_OF_VALUES_TO_GUESS));
+  TEST_ASSERT_FALSE(code_decoder_init(&decoder, "A", NUMBER_OF_VALUES_TO_GUESS));
+  TEST_ASSERT_FALSE(code_decoder_init(&decoder, "ABCDEFGHIJKLMNOPQ", NUMBER_OF_VALUES_TO_GUESS));
+  TEST_ASSERT_FALSE(code_decoder_init(&decoder, "AB\n", NUMBER_OF_VALUES_TO_GUESS));
+  TEST_ASSERT_FALSE(code_decoder_init(&decoder, CLASSIC_ALPHABET, 0));
+  TEST_ASSERT_FALSE(code_decoder_init(&decoder, CLASSIC_ALPHABET, CODE_DECODER_MAXIMUM_PEGS + 1));
+}
+
+void test_every_classic_code_decodes_to_its_packed_code(void) {
+  code_decoder_t decoder;
+  code_decoder_init(&decoder, CLASSIC_ALPHABET, NUMBER_OF_VALUES_TO_GUESS);
+  for (game_logic_code_t code = 0; code < NUMBER_OF_POSSIBLE_CODES; code++) {
+    char line[LINE_SIZE];
+    format_code(code, line);
+    uint8_t values[NUMBER_OF_VALUES_TO_GUESS];
+    uint64_t decoded;
+    code_decoder_error_t error;
+    TEST_ASSERT_EQUAL(CODE_DECODER_OK, code_decoder_decode(&decoder, line, values, &decoded, &error));
+    TEST_ASSERT_EQUAL_UINT64(code, decoded);
+    game_logic_values_t expected[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(code, expected);
+    for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+      TEST_ASSERT_EQUAL_UINT8(expected[i], values[i]);
+    }
+  }
+}
+
+void test_lower_case_and_line_endings_are_accepted(void) {
+  code_decoder_t decoder;
+  code_decoder_init(&decoder, CLASSIC_ALPHABET, NUMBER_OF_VALUES_TO_GUESS);
+  const char *lines[] = {"aBcF", "ABCF\n", "ABCF\r\n", "abcf\r\n"};
+  for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+    uint8_t values[NUMBER_OF_VALUES_TO_GUESS];
+    uint64_t code;
+    code_decoder_error_t error;
+    TEST_ASSERT_EQUAL(CODE_DECODER_OK, code_decoder_decode(&decoder, lines[i], values, &code, &error));
+    TEST_ASSERT_EQUAL_UINT64(((0 * 6 + 1) * 6 + 2) * 6 + 5, code);
+  }
+}
+
+void test_errors_name_what_is_wrong_and_where(void) {
+  code_decoder_t decoder;
+  code_decoder_init(&decoder, CLASSIC_ALPHABET, NUMBER_OF_VALUES_TO_GUESS);
+  assert_error(&decoder, "AB\n", CODE_DECODER_TOO_SHORT, 2, "Only 2 of 4 values, enter 4 values ranging from A-F");
+  assert_error(&decoder, "", CODE_DECODER_TOO_SHORT, 0, "Only 0 of 4 values, enter 4 values ranging from A-F");
+  assert_error(&decoder, "ABCDE\n", CODE_DECODER_TOO_LONG, 4,
+               "More than 4 values, enter 4 values ranging from A-F");
+  assert_error(&decoder, "ABGD\n", CODE_DECODER_INVALID_CHARACTER, 2, "'G' at position 3 is not one of A-F");
+  assert_error(&decoder, "A BC\n", CODE_DECODER_INVALID_CHARACTER, 1, "' ' at position 2 is not one of A-F");
+  assert_error(&decoder, "\tABC", CODE_DECODER_INVALID_CHARACTER, 0, "Character 0x09 at position 1 is not one of A-F");
+  assert_error(&decoder, "AB\xC3\xA9", CODE_DECODER_INVALID_CHARACTER, 2,
+               "Character 0xC3 at position 3 is not one of A-F");
+
+  code_decoder_init(&decoder, "RGBYOP", NUMBER_OF_VALUES_TO_GUESS);
+  assert_error(&decoder, "RGBA", CODE_DECODER_INVALID_CHARACTER, 3, "'A' at position 4 is not one of RGBYOP");
+}
+
+void test_larger_games_decode_with_their_own_alphabet(void) {
+  code_decoder_t decoder;
+  TEST_ASSERT_TRUE(code_decoder_init(&decoder, "ABCDEFGHIJKLMNOP", 10));
+  uint8_t values[CODE_DECODER_MAXIMUM_PEGS];
+  uint64_t code;
+  code_decoder_error_t error;
+  TEST_ASSERT_EQUAL(CODE_DECODER_OK, code_decoder_decode(&decoder, "PONMLKJIHA\n", values, &code, &error));
+  uint64_t expected = 0;
+  for (uint_fast8_t i = 0; i < 9; i++) {
+    TEST_ASSERT_EQUAL_UINT8(15 - i, values[i]);
+    expected = expected * 16 + (15 - i);
+  }
+  TEST_ASSERT_EQUAL_UINT8(0, values[9]);
+  TEST_ASSERT_EQUAL_UINT64(expected * 16, code);
+  assert_error(&decoder, "PONMLKJIHQ\n", CODE_DECODER_INVALID_CHARACTER, 9, "'Q' at position 10 is not one of A-P");
+
+  TEST_ASSERT_TRUE(code_decoder_init(&decoder, "ABCDEFGHIJKLMNOP", CODE_DECODER_MAXIMUM_PEGS));
+  TEST_ASSERT_EQUAL(CODE_DECODER_OK, code_decoder_decode(&decoder, "PPPPPPPPPPPPPPPP", values, &code, &error));
+  TEST_ASSERT_EQUAL_UINT64(UINT64_MAX, code);
+}
+
+static void assert_batch_matches_single_guesses(const char *alphabet) {
+  code_decoder_t decoder;
+  code_decoder_init(&decoder, alphabet, NUMBER_OF_VALUES_TO_GUESS);
+  // fixed width lines, some with lower case letters and some with a bad character
+  static char text[NUMBER_OF_BATCH_CODES * (NUMBER_OF_VALUES_TO_GUESS + 1)];
+  const size_t stride = NUMBER_OF_VALUES_TO_GUESS + 1;
+  for (size_t i = 0; i < NUMBER_OF_BATCH_CODES; i++) {
+    char *line = &text[i * stride];
+    for (uint_fast8_t peg = 0; peg < NUMBER_OF_VALUES_TO_GUESS; peg++) {
+      line[peg] = alphabet[(i * 7 + peg * 3 + i / 11) % decoder.number_of_values];
+    }
+    if (i % 13 == 0) {
+      line[i % NUMBER_OF_VALUES_TO_GUESS] = '#';
+    } else if (i % 17 == 0) {
+      line[(i + 1) % NUMBER_OF_VALUES_TO_GUESS] = (char)(line[(i + 1) % NUMBER_OF_VALUES_TO_GUESS] + 'a' - 'A');
+    }
+    line[NUMBER_OF_VALUES_TO_GUESS] = '\n';
+  }
+  uint64_t codes[NUMBER_OF_BATCH_CODES];
+  uint8_t is_valid[NUMBER_OF_BATCH_CODES];
+  code_decoder_decode_batch(&decoder, text, stride, NUMBER_OF_BATCH_CODES, codes, is_valid);
+  for (size_t i = 0; i < NUMBER_OF_BATCH_CODES; i++) {
+    char line[LINE_SIZE];
+    memcpy(line, &text[i * stride], stride);
+    line[stride] = '\0';
+    uint8_t values[NUMBER_OF_VALUES_TO_GUESS];
+    uint64_t code = 0;
+    code_decoder_error_t error;
+    bool is_decoded = code_decoder_decode(&decoder, line, values, &code, &error) == CODE_DECODER_OK;
+    TEST_ASSERT_EQUAL_UINT8(is_decoded, is_valid[i]);
+    TEST_ASSERT_EQUAL_UINT64(is_decoded ? code : 0, codes[i]);
+  }
+}
+
+void test_batches_agree_with_single_guesses(void) {
+  assert_batch_matches_single_guesses(CLASSIC_ALPHABET);
+  assert_batch_matches_single_guesses("RGBYOP");
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_init_refuses_repeated_characters_and_bad_sizes);
+  RUN_TEST(test_every_classic_code_decodes_to_its_packed_code);
+  RUN_TEST(test_lower_case_and_line_endings_are_accepted);
+  RUN_TEST(test_errors_name_what_is_wrong_and_where);
+  RUN_TEST(test_larger_games_decode_with_their_own_alphabet);
+  RUN_TEST(test_batches_agree_with_single_guesses);
+  return UNITY_END();
+}
\ No newline at end of file
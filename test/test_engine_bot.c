@@ -0,0 +1,147 @@
+#include "unity.h"
+#include "engine_bot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STANDARD_TRIES 8
+#define LARGE_SPACE_TRIES 16
+// plays the standard game against every code this many apart
+#define SECRET_INTERVAL 37
+
+static const large_space_variant_t standard_variant = {.number_of_pegs = 4, .number_of_values = 6};
+
+int random_value(void) {
+  return rand();
+}
+
+void setUp(void) {
+  srand(1);
+}
+
+void tearDown(void) {
+}
+
+static size_t send(engine_bot_t *bot, const char *line, char *reply) {
+  size_t length = engine_bot_handle_line(bot, line, strlen(line), reply);
+  reply[length] = '\0';
+  return length;
+}
+
+// the code of the guess line that ends the reply
+static large_space_code_t read_guess(const code_decoder_t *decoder, const char *reply) {
+  const char *guess = strstr(reply, "guess ");
+  TEST_ASSERT_NOT_NULL(guess);
+  TEST_ASSERT_EQUAL_CHAR('\n', reply[strlen(reply) - 1]);
+  engine_protocol_message_t message;
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_GUESS, engine_protocol_parse(guess, strlen(guess) - 1, decoder, &message));
+  return message.code;
+}
+
+static bool is_consistent(const large_space_variant_t *variant, const large_space_move_t history[], size_t moves,
+                          const large_space_code_t *guess) {
+  for (size_t i = 0; i < moves; i++) {
+    game_logic_feedback_t feedback = large_space_score(variant, guess, &history[i].guess);
+    if (feedback.number_of_correct_value_and_placement != history[i].feedback.number_of_correct_value_and_placement ||
+        feedback.number_of_correct_value_only != history[i].feedback.number_of_correct_value_only) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// returns the tries the bot took, or zero when it ran out
+static size_t play_game(engine_bot_t *bot, const large_space_variant_t *variant, const large_space_code_t *secret,
+                        size_t maximum_tries, bool is_hard_mode) {
+  code_decoder_t decoder;
+  engine_protocol_init_decoder(&decoder, variant);
+  char line[ENGINE_PROTOCOL_MAXIMUM_LINE];
+  char reply[ENGINE_BOT_MAXIMUM_REPLY + 1];
+  snprintf(line, sizeof(line), "newgame pegs %d values %d tries %zu%s", variant->number_of_pegs,
+           variant->number_of_values, maximum_tries, is_hard_mode ? " hard" : "");
+  TEST_ASSERT_EQUAL_size_t(0, send(bot, line, reply));
+  large_space_move_t history[LARGE_SPACE_MAXIMUM_HISTORY];
+  for (size_t move = 0; move < maximum_tries; move++) {
+    TEST_ASSERT_TRUE(send(bot, "go movetime 1000", reply) > 0);
+    large_space_code_t guess = read_guess(&decoder, reply);
+    if (is_hard_mode) {
+      TEST_ASSERT_TRUE(is_consistent(variant, history, move, &guess));
+    }
+    game_logic_feedback_t feedback = large_space_score(variant, secret, &guess);
+    if (feedback.is_guess_correct) {
+      send(bot, "result win AAAA", reply);
+      return move + 1;
+    }
+    history[move] = (large_space_move_t) {.guess = guess, .feedback = feedback};
+    snprintf(line, sizeof(line), "feedback %d %d", feedback.number_of_correct_value_and_placement,
+             feedback.number_of_correct_value_only);
+    TEST_ASSERT_EQUAL_size_t(0, send(bot, line, reply));
+  }
+  send(bot, "result loss AAAA", reply);
+  return 0;
+}
+
+static large_space_code_t standard_code(game_logic_code_t code) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_unpack_code(code, values);
+  large_space_code_t secret = {{0}};
+  for (uint_fast8_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    secret.values[i] = (uint8_t) values[i];
+  }
+  return secret;
+}
+
+void test_handshake_and_quit(void) {
+  engine_bot_t *bot = engine_bot_create();
+  char reply[ENGINE_BOT_MAXIMUM_REPLY + 1];
+  send(bot, "mmp", reply);
+  TEST_ASSERT_EQUAL_STRING("id name " ENGINE_BOT_NAME "\nid author " ENGINE_BOT_AUTHOR "\nmmpok\n", reply);
+  send(bot, "isready", reply);
+  TEST_ASSERT_EQUAL_STRING("readyok\n", reply);
+  // nothing to guess before a game
+  TEST_ASSERT_EQUAL_size_t(0, send(bot, "go", reply));
+  TEST_ASSERT_EQUAL_size_t(0, send(bot, "setoption speed fast", reply));
+  TEST_ASSERT_FALSE(engine_bot_is_finished(bot));
+  send(bot, "quit", reply);
+  TEST_ASSERT_TRUE(engine_bot_is_finished(bot));
+  engine_bot_destroy(bot);
+}
+
+void test_the_standard_game_is_won_in_five(void) {
+  engine_bot_t *bot = engine_bot_create();
+  for (game_logic_code_t code = 0; code < NUMBER_OF_POSSIBLE_CODES; code += SECRET_INTERVAL) {
+    large_space_code_t secret = standard_code(code);
+    size_t tries = play_game(bot, &standard_variant, &secret, STANDARD_TRIES, false);
+    TEST_ASSERT_TRUE(tries >= 1 && tries <= 5);
+  }
+  engine_bot_destroy(bot);
+}
+
+void test_hard_mode_guesses_agree_with_the_feedback(void) {
+  engine_bot_t *bot = engine_bot_create();
+  for (game_logic_code_t code = 5; code < NUMBER_OF_POSSIBLE_CODES; code += SECRET_INTERVAL) {
+    large_space_code_t secret = standard_code(code);
+    TEST_ASSERT_TRUE(play_game(bot, &standard_variant, &secret, STANDARD_TRIES, true) > 0);
+  }
+  engine_bot_destroy(bot);
+}
+
+void test_larger_games_are_won(void) {
+  engine_bot_t *bot = engine_bot_create();
+  large_space_variant_t variant = {.number_of_pegs = 6, .number_of_values = 9};
+  for (int game = 0; game < 3; game++) {
+    large_space_code_t secret;
+    large_space_random_code(&variant, &secret);
+    TEST_ASSERT_TRUE(play_game(bot, &variant, &secret, LARGE_SPACE_TRIES, true) > 0);
+  }
+  engine_bot_destroy(bot);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_handshake_and_quit);
+  RUN_TEST(test_the_standard_game_is_won_in_five);
+  RUN_TEST(test_hard_mode_guesses_agree_with_the_feedback);
+  RUN_TEST(test_larger_games_are_won);
+  return UNITY_END();
+}
\ No newline at end of file
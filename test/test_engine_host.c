@@ -0,0 +1,133 @@
+#include "unity.h"
+#include "engine_host.h"
+#include <stdlib.h>
+
+// shell scripts that speak just enough of the protocol
+#define FIXED_BOT(name, guess, delay) \
+  "while read -r line; do case \"$line\" in " \
+  "mmp) echo 'id name " name "'; echo mmpok;; " \
+  "isready) echo readyok;; " \
+  "go*) sleep " delay "; echo 'info thinking'; echo 'guess " guess "';; " \
+  "quit) exit 0;; esac; done"
+// tries A and then B, which wins every game of one peg and two values
+#define COUNTING_BOT \
+  "while read -r line; do case \"$line\" in " \
+  "mmp) echo mmpok;; " \
+  "newgame*) next=A;; " \
+  "go*) echo \"guess $next\"; next=B;; " \
+  "quit) exit 0;; esac; done"
+#define NUMBER_OF_GAMES 3
+
+int random_value(void) {
+  return 0;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static engine_host_options_t standard_options(void) {
+  return (engine_host_options_t) {
+    .variant = {.number_of_pegs = 4, .number_of_values = 6},
+    .maximum_tries = 3,
+    .number_of_games = NUMBER_OF_GAMES,
+    .move_milliseconds = 2000,
+    .seed = 11
+  };
+}
+
+void test_games_are_played_to_the_end(void) {
+  engine_host_options_t options = standard_options();
+  options.variant = (large_space_variant_t) {.number_of_pegs = 1, .number_of_values = 2};
+  const char *commands[] = {COUNTING_BOT};
+  engine_host_result_t results[1];
+  engine_host_stats_t stats;
+  TEST_ASSERT_TRUE(engine_host_run(commands, 1, &options, results, &stats));
+  TEST_ASSERT_EQUAL_UINT32(NUMBER_OF_GAMES, results[0].games);
+  TEST_ASSERT_EQUAL_UINT32(NUMBER_OF_GAMES, results[0].outcomes[ENGINE_PROTOCOL_WIN]);
+  TEST_ASSERT_FALSE(results[0].is_dropped);
+  // the command stands in for a bot that gives no name
+  TEST_ASSERT_EQUAL_STRING_LEN(COUNTING_BOT, results[0].name, ENGINE_HOST_NAME_SIZE - 1);
+  TEST_ASSERT_EQUAL_UINT64(results[0].moves, stats.moves);
+  TEST_ASSERT_EQUAL_UINT64(results[0].tries_to_win, results[0].moves);
+  TEST_ASSERT_TRUE(stats.wall_nanoseconds > 0);
+}
+
+void test_every_bot_runs_at_once_and_loses_in_its_own_way(void) {
+  engine_host_options_t options = standard_options();
+  options.is_hard_mode = true;
+  const char *commands[] = {
+    FIXED_BOT("stubborn", "FFFF", "0"),
+    FIXED_BOT("misspelled", "ABCZ", "0"),
+    FIXED_BOT("slow", "ABCD", "0.3"),
+  };
+  options.move_milliseconds = 100;
+  engine_host_result_t results[3];
+  engine_host_stats_t stats;
+  TEST_ASSERT_TRUE(engine_host_run(commands, 3, &options, results, &stats));
+  for (size_t i = 0; i < 3; i++) {
+    TEST_ASSERT_EQUAL_UINT32(NUMBER_OF_GAMES, results[i].games);
+    TEST_ASSERT_FALSE(results[i].is_dropped);
+  }
+  TEST_ASSERT_EQUAL_STRING("stubborn", results[0].name);
+  // repeating a guess that missed breaks the hard mode rule, unless the secret has no F at all
+  TEST_ASSERT_EQUAL_UINT32(NUMBER_OF_GAMES, results[0].outcomes[ENGINE_PROTOCOL_ILLEGAL] +
+                                            results[0].outcomes[ENGINE_PROTOCOL_LOSS]);
+  TEST_ASSERT_EQUAL_UINT32(NUMBER_OF_GAMES, results[1].outcomes[ENGINE_PROTOCOL_ILLEGAL]);
+  TEST_ASSERT_EQUAL_UINT64(NUMBER_OF_GAMES, results[1].moves);
+  TEST_ASSERT_EQUAL_UINT32(NUMBER_OF_GAMES, results[2].outcomes[ENGINE_PROTOCOL_TIMEOUT]);
+  TEST_ASSERT_EQUAL_UINT64(0, results[2].moves);
+  TEST_ASSERT_TRUE(results[0].info_lines >= NUMBER_OF_GAMES);
+}
+
+void test_the_game_clock_runs_across_guesses(void) {
+  engine_host_options_t options = standard_options();
+  options.maximum_tries = 8;
+  options.number_of_games = 1;
+  options.game_milliseconds = 250;
+  options.move_milliseconds = 0;
+  // each guess fits the clock on its own but not all of them together
+  const char *commands[] = {FIXED_BOT("steady", "AAAA", "0.1")};
+  engine_host_result_t results[1];
+  engine_host_stats_t stats;
+  TEST_ASSERT_TRUE(engine_host_run(commands, 1, &options, results, &stats));
+  TEST_ASSERT_EQUAL_UINT32(1, results[0].outcomes[ENGINE_PROTOCOL_TIMEOUT]);
+  TEST_ASSERT_TRUE(results[0].moves >= 1 && results[0].moves < 3);
+}
+
+void test_bots_that_exit_or_never_start_are_dropped(void) {
+  engine_host_options_t options = standard_options();
+  const char *commands[] = {"exit 0", "/nonexistent/bot 2>/dev/null", "read -r line; echo mmpok; exit 0"};
+  engine_host_result_t results[3];
+  engine_host_stats_t stats;
+  TEST_ASSERT_TRUE(engine_host_run(commands, 3, &options, results, &stats));
+  for (size_t i = 0; i < 3; i++) {
+    TEST_ASSERT_TRUE(results[i].is_dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, results[i].games);
+  }
+}
+
+void test_unplayable_options_are_refused(void) {
+  engine_host_options_t options = standard_options();
+  const char *commands[] = {"exit 0"};
+  engine_host_result_t results[1];
+  engine_host_stats_t stats;
+  TEST_ASSERT_FALSE(engine_host_run(commands, 0, &options, results, &stats));
+  options.maximum_tries = 0;
+  TEST_ASSERT_FALSE(engine_host_run(commands, 1, &options, results, &stats));
+  options = standard_options();
+  options.variant.number_of_values = LARGE_SPACE_MAXIMUM_VALUES + 1;
+  TEST_ASSERT_FALSE(engine_host_run(commands, 1, &options, results, &stats));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_games_are_played_to_the_end);
+  RUN_TEST(test_every_bot_runs_at_once_and_loses_in_its_own_way);
+  RUN_TEST(test_the_game_clock_runs_across_guesses);
+  RUN_TEST(test_bots_that_exit_or_never_start_are_dropped);
+  RUN_TEST(test_unplayable_options_are_refused);
+  return UNITY_END();
+}
\ No newline at end of file
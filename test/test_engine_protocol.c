@@ -0,0 +1,144 @@
+#include "unity.h"
+#include "engine_protocol.h"
+#include <string.h>
+
+static const large_space_variant_t standard_variant = {.number_of_pegs = 4, .number_of_values = 6};
+
+int random_value(void) {
+  return 0;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static engine_protocol_type_t parse(const char *line, const code_decoder_t *decoder,
+                                    engine_protocol_message_t *message) {
+  return engine_protocol_parse(line, strlen(line), decoder, message);
+}
+
+void test_commands_without_arguments_are_recognised(void) {
+  engine_protocol_message_t message;
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MMP, parse("mmp", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_ISREADY, parse("isready", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_QUIT, parse("  quit  ", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MMPOK, parse("mmpok\r", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_READYOK, parse("readyok", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_UNKNOWN, parse("readyokay", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_UNKNOWN, parse("debug on", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_UNKNOWN, parse("", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_UNKNOWN, message.type);
+}
+
+void test_newgame_sets_the_variant(void) {
+  engine_protocol_message_t message;
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_NEWGAME, parse("newgame pegs 5 values 8 tries 12 hard", NULL, &message));
+  TEST_ASSERT_EQUAL_UINT8(5, message.variant.number_of_pegs);
+  TEST_ASSERT_EQUAL_UINT8(8, message.variant.number_of_values);
+  TEST_ASSERT_EQUAL_UINT8(12, message.maximum_tries);
+  TEST_ASSERT_TRUE(message.is_hard_mode);
+  // in any order, words the engine does not know are skipped
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_NEWGAME, parse("newgame tries 8 colours values 6 pegs 4", NULL, &message));
+  TEST_ASSERT_EQUAL_UINT8(4, message.variant.number_of_pegs);
+  TEST_ASSERT_FALSE(message.is_hard_mode);
+
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("newgame pegs 4 values 6", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("newgame pegs 11 values 6 tries 8", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("newgame pegs 4 values 17 tries 8", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("newgame pegs 4 values 1 tries 8", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("newgame pegs four values 6 tries 8", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("newgame pegs 4 values 6 tries", NULL, &message));
+}
+
+void test_go_carries_the_time_limits(void) {
+  engine_protocol_message_t message;
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_GO, parse("go", NULL, &message));
+  TEST_ASSERT_EQUAL_UINT32(0, message.game_milliseconds);
+  TEST_ASSERT_EQUAL_UINT32(0, message.move_milliseconds);
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_GO, parse("go time 60000 movetime 250", NULL, &message));
+  TEST_ASSERT_EQUAL_UINT32(60000, message.game_milliseconds);
+  TEST_ASSERT_EQUAL_UINT32(250, message.move_milliseconds);
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_GO, parse("go movetime 4294967295", NULL, &message));
+  TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, message.move_milliseconds);
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("go movetime 4294967296", NULL, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("go time -1", NULL, &message));
+}
+
+void test_codes_are_read_with_the_game_decoder(void) {
+  code_decoder_t decoder;
+  TEST_ASSERT_TRUE(engine_protocol_init_decoder(&decoder, &standard_variant));
+  engine_protocol_message_t message;
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_GUESS, parse("guess ABCF", &decoder, &message));
+  uint8_t expected[] = {0, 1, 2, 5};
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, message.code.values, 4);
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_GUESS, parse("guess abcf\r", &decoder, &message));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, message.code.values, 4);
+
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("guess ABCG", &decoder, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("guess ABC", &decoder, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("guess ABCDE", &decoder, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("guess", &decoder, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("guess ABCD", NULL, &message));
+
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_RESULT, parse("result timeout FEDA", &decoder, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_TIMEOUT, message.outcome);
+  uint8_t secret[] = {5, 4, 3, 0};
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(secret, message.code.values, 4);
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("result draw FEDA", &decoder, &message));
+}
+
+void test_feedback_is_bounded_by_the_pegs(void) {
+  code_decoder_t decoder;
+  engine_protocol_init_decoder(&decoder, &standard_variant);
+  engine_protocol_message_t message;
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_FEEDBACK, parse("feedback 1 2", &decoder, &message));
+  TEST_ASSERT_EQUAL_UINT8(1, message.feedback.number_of_correct_value_and_placement);
+  TEST_ASSERT_EQUAL_UINT8(2, message.feedback.number_of_correct_value_only);
+  TEST_ASSERT_FALSE(message.feedback.is_guess_correct);
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_FEEDBACK, parse("feedback 4 0", &decoder, &message));
+  TEST_ASSERT_TRUE(message.feedback.is_guess_correct);
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("feedback 3 2", &decoder, &message));
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_MALFORMED, parse("feedback 1", &decoder, &message));
+}
+
+void test_id_and_info_keep_their_text(void) {
+  engine_protocol_message_t message;
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_ID, parse("id name  Knuth 1977", NULL, &message));
+  TEST_ASSERT_EQUAL_size_t(16, message.text_length);
+  TEST_ASSERT_EQUAL_MEMORY("name  Knuth 1977", message.text, message.text_length);
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_INFO, parse("info candidates 252 time 3", NULL, &message));
+  TEST_ASSERT_EQUAL_MEMORY("candidates 252 time 3", message.text, message.text_length);
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_INFO, parse("info", NULL, &message));
+  TEST_ASSERT_EQUAL_size_t(0, message.text_length);
+}
+
+void test_codes_format_as_letters(void) {
+  large_space_variant_t variant = {.number_of_pegs = 10, .number_of_values = 16};
+  large_space_code_t code = {.values = {0, 15, 1, 14, 2, 13, 3, 12, 4, 11}};
+  char text[LARGE_SPACE_MAXIMUM_PEGS];
+  TEST_ASSERT_EQUAL_size_t(10, engine_protocol_format_code(&variant, &code, text));
+  TEST_ASSERT_EQUAL_MEMORY("APBOCNDMEL", text, 10);
+  TEST_ASSERT_EQUAL_STRING("illegal", engine_protocol_outcome_name(ENGINE_PROTOCOL_ILLEGAL));
+
+  code_decoder_t decoder;
+  TEST_ASSERT_TRUE(engine_protocol_init_decoder(&decoder, &variant));
+  engine_protocol_message_t message;
+  TEST_ASSERT_EQUAL(ENGINE_PROTOCOL_GUESS, parse("guess APBOCNDMEL", &decoder, &message));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(code.values, message.code.values, 10);
+  large_space_variant_t too_large = {.number_of_pegs = 11, .number_of_values = 16};
+  TEST_ASSERT_FALSE(engine_protocol_init_decoder(&decoder, &too_large));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_commands_without_arguments_are_recognised);
+  RUN_TEST(test_newgame_sets_the_variant);
+  RUN_TEST(test_go_carries_the_time_limits);
+  RUN_TEST(test_codes_are_read_with_the_game_decoder);
+  RUN_TEST(test_feedback_is_bounded_by_the_pegs);
+  RUN_TEST(test_id_and_info_keep_their_text);
+  RUN_TEST(test_codes_format_as_letters);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "unity.h"
+#include "game_logic.h"
+#include "evil_codemaker.h"
+#include "random.h"
+
+int random_value(void) {
+  return 0;
+}
+
+void setUp(void) {
+  evil_codemaker_start();
+}
+
+void tearDown(void) {}
+
+void test_start_keeps_every_code(void) {
+  TEST_ASSERT_EQUAL_size_t(NUMBER_OF_POSSIBLE_CODES, evil_codemaker_get_remaining_candidates());
+}
+
+void test_first_guess_keeps_largest_partition(void) {
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO};
+
+  game_logic_feedback_t feedback = evil_codemaker_get_feedback(guess);
+
+  // AABB splits the code space with a largest partition of 256 answers, none of which share a value with it
+  TEST_ASSERT_EQUAL_size_t(256, evil_codemaker_get_remaining_candidates());
+  TEST_ASSERT_EQUAL_UINT8(0, feedback.number_of_correct_value_only);
+  TEST_ASSERT_EQUAL_UINT8(0, feedback.number_of_correct_value_and_placement);
+}
+
+void test_remaining_answers_are_consistent_with_feedback(void) {
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR};
+
+  game_logic_feedback_t feedback = evil_codemaker_get_feedback(guess);
+  game_logic_feedback_t answer_feedback = game_logic_score(evil_codemaker_get_answer(), guess);
+
+  TEST_ASSERT_EQUAL_UINT8(feedback.number_of_correct_value_only, answer_feedback.number_of_correct_value_only);
+  TEST_ASSERT_EQUAL_UINT8(feedback.number_of_correct_value_and_placement, answer_feedback.number_of_correct_value_and_placement);
+}
+
+void test_guess_is_never_correct_while_other_answers_remain(void) {
+  game_logic_values_t answer[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_feedback_t feedback = {0};
+  size_t number_of_guesses = 0;
+
+  // keep guessing the codemaker's own answer, it can only concede once a single answer is left
+  while (!feedback.is_guess_correct) {
+    size_t remaining = evil_codemaker_get_remaining_candidates();
+    for (size_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+      answer[i] = evil_codemaker_get_answer()[i];
+    }
+    feedback = evil_codemaker_get_feedback(answer);
+    TEST_ASSERT_TRUE(!feedback.is_guess_correct || remaining == 1);
+    number_of_guesses++;
+  }
+
+  TEST_ASSERT_TRUE(number_of_guesses > 1);
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_start_keeps_every_code);
+    RUN_TEST(test_first_guess_keeps_largest_partition);
+    RUN_TEST(test_remaining_answers_are_consistent_with_feedback);
+    RUN_TEST(test_guess_is_never_correct_while_other_answers_remain);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+#include "game_journal.h"
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#define JOURNAL_PATH "build/test_games.journal"
+#define SNAPSHOT_PATH "build/test_recovered.snapshot"
+#define NUMBER_OF_RECORDS 1000
+#define JOURNAL_HEADER_SIZE 16
+
+int random_value(void) {
+  return 0;
+}
+
+static const game_journal_options_t group_commit = {.commit_milliseconds = 1};
+
+void setUp(void) {
+  remove(JOURNAL_PATH);
+}
+
+void tearDown(void) {
+  remove(JOURNAL_PATH);
+  remove(SNAPSHOT_PATH);
+}
+
+static game_journal_record_t make_record(game_journal_event_t event, uint64_t game_id, uint64_t token,
+                                         game_logic_code_t code) {
+  game_journal_record_t record = {.event = (uint8_t) event, .game_id = game_id, .token = token, .code = code,
+                                  .time = game_journal_clock()};
+  return record;
+}
+
+static void append(game_journal_t *journal, game_journal_event_t event, uint64_t game_id, uint64_t token,
+                   game_logic_code_t code) {
+  game_journal_record_t record = make_record(event, game_id, token, code);
+  game_journal_append(game_journal_get_writer(journal, 0), &record);
+}
+
+static uint64_t next_code;
+static bool is_in_order;
+
+static void check_order(const game_journal_record_t *record, void *argument) {
+  (void) argument;
+  is_in_order = is_in_order && record->game_id == next_code + 1 && record->code == next_code;
+  next_code++;
+}
+
+void test_records_are_replayed_in_order(void) {
+  game_journal_t *journal = game_journal_open(JOURNAL_PATH, group_commit, 2);
+  TEST_ASSERT_NOT_NULL(journal);
+  for (uint64_t i = 0; i < NUMBER_OF_RECORDS; i++) {
+    game_journal_record_t record = make_record(GAME_JOURNAL_EVENT_GUESS, i + 1, 0, (game_logic_code_t) i);
+    game_journal_append(game_journal_get_writer(journal, 0), &record);
+  }
+  game_journal_close(journal);
+
+  next_code = 0;
+  is_in_order = true;
+  game_journal_recovery_t recovery;
+  TEST_ASSERT_TRUE(game_journal_replay(JOURNAL_PATH, check_order, NULL, &recovery));
+  TEST_ASSERT_TRUE(is_in_order);
+  TEST_ASSERT_EQUAL_UINT64(NUMBER_OF_RECORDS, recovery.records);
+  TEST_ASSERT_EQUAL_UINT64(0, recovery.torn_bytes);
+}
+
+void test_torn_tail_is_cut_off_before_appending(void) {
+  game_journal_t *journal = game_journal_open(JOURNAL_PATH, group_commit, 1);
+  for (uint64_t i = 0; i < 3; i++) {
+    append(journal, GAME_JOURNAL_EVENT_GUESS, i + 1, 0, (game_logic_code_t) i);
+  }
+  game_journal_close(journal);
+  // a crash in the middle of the fourth record
+  FILE *file = fopen(JOURNAL_PATH, "ab");
+  fwrite("torn", 1, 4, file);
+  fclose(file);
+
+  game_journal_recovery_t recovery;
+  TEST_ASSERT_TRUE(game_journal_replay(JOURNAL_PATH, NULL, NULL, &recovery));
+  TEST_ASSERT_EQUAL_UINT64(3, recovery.records);
+  TEST_ASSERT_EQUAL_UINT64(4, recovery.torn_bytes);
+
+  journal = game_journal_open(JOURNAL_PATH, group_commit, 1);
+  append(journal, GAME_JOURNAL_EVENT_GUESS, 4, 0, 3);
+  game_journal_close(journal);
+  next_code = 0;
+  is_in_order = true;
+  TEST_ASSERT_TRUE(game_journal_replay(JOURNAL_PATH, check_order, NULL, &recovery));
+  TEST_ASSERT_TRUE(is_in_order);
+  TEST_ASSERT_EQUAL_UINT64(4, recovery.records);
+  TEST_ASSERT_EQUAL_UINT64(0, recovery.torn_bytes);
+}
+
+void test_corrupt_record_ends_the_replay(void) {
+  game_journal_t *journal = game_journal_open(JOURNAL_PATH, group_commit, 1);
+  for (uint64_t i = 0; i < 5; i++) {
+    append(journal, GAME_JOURNAL_EVENT_GUESS, i + 1, 0, (game_logic_code_t) i);
+  }
+  game_journal_close(journal);
+  FILE *file = fopen(JOURNAL_PATH, "r+b");
+  fseek(file, JOURNAL_HEADER_SIZE + 2 * (long) sizeof(game_journal_record_t) + 10, SEEK_SET);
+  fputc(0x5A, file);
+  fclose(file);
+
+  game_journal_recovery_t recovery;
+  TEST_ASSERT_TRUE(game_journal_replay(JOURNAL_PATH, NULL, NULL, &recovery));
+  TEST_ASSERT_EQUAL_UINT64(2, recovery.records);
+  TEST_ASSERT_EQUAL_UINT64(3 * sizeof(game_journal_record_t), recovery.torn_bytes);
+}
+
+void test_games_in_play_are_recovered(void) {
+  game_journal_t *journal = game_journal_open(JOURNAL_PATH, (game_journal_options_t) {0}, 1);
+  // in play with a token
+  append(journal, GAME_JOURNAL_EVENT_NEW, 1, 0, 100);
+  append(journal, GAME_JOURNAL_EVENT_GUESS, 1, 0, 7);
+  // finished
+  append(journal, GAME_JOURNAL_EVENT_NEW, 2, 0xBEEF, 200);
+  append(journal, GAME_JOURNAL_EVENT_GUESS, 2, 0xBEEF, 200);
+  append(journal, GAME_JOURNAL_EVENT_END, 2, 0xBEEF, 200);
+  // in play without a token, it cannot be handed back
+  append(journal, GAME_JOURNAL_EVENT_NEW, 3, 0, 300);
+  // the token arrives after the game started
+  append(journal, GAME_JOURNAL_EVENT_GUESS, 1, 0xCAFE, 8);
+  game_journal_close(journal);
+
+  session_snapshot_writer_t *writer = session_snapshot_writer_create();
+  game_journal_recovery_t recovery;
+  TEST_ASSERT_TRUE(game_journal_recover(JOURNAL_PATH, writer, game_journal_clock(), 0, &recovery));
+  TEST_ASSERT_EQUAL_UINT64(7, recovery.records);
+  TEST_ASSERT_EQUAL_UINT64(2, recovery.games_in_progress);
+  TEST_ASSERT_EQUAL_UINT64(1, recovery.games_recovered);
+  TEST_ASSERT_TRUE(session_snapshot_writer_commit(writer, SNAPSHOT_PATH));
+  session_snapshot_writer_destroy(writer);
+
+  session_snapshot_t *snapshot = session_snapshot_open(SNAPSHOT_PATH);
+  const session_snapshot_game_t *game = session_snapshot_claim(snapshot, 0xCAFE, 0);
+  TEST_ASSERT_NOT_NULL(game);
+  TEST_ASSERT_EQUAL_UINT64(1, game->game_id);
+  TEST_ASSERT_EQUAL_UINT16(100, game->answer);
+  TEST_ASSERT_EQUAL_UINT8(2, game->tries);
+  TEST_ASSERT_EQUAL_UINT16(7, game->history[0]);
+  TEST_ASSERT_EQUAL_UINT16(8, game->history[1]);
+  TEST_ASSERT_NULL(session_snapshot_claim(snapshot, 0xBEEF, 0));
+  session_snapshot_close(snapshot);
+}
+
+void test_many_finished_games_leave_nothing_behind(void) {
+  game_journal_t *journal = game_journal_open(JOURNAL_PATH, group_commit, 1);
+  for (uint64_t id = 1; id <= 10 * NUMBER_OF_RECORDS; id++) {
+    append(journal, GAME_JOURNAL_EVENT_NEW, id, id, 1);
+    // ends out of order so removals shift entries across the table
+    if (id % 3 == 0) {
+      append(journal, GAME_JOURNAL_EVENT_END, id - 1, id - 1, 1);
+      append(journal, GAME_JOURNAL_EVENT_END, id, id, 1);
+      append(journal, GAME_JOURNAL_EVENT_END, id - 2, id - 2, 1);
+    }
+  }
+  append(journal, GAME_JOURNAL_EVENT_NEW, UINT64_MAX, 42, 1);
+  game_journal_close(journal);
+
+  session_snapshot_writer_t *writer = session_snapshot_writer_create();
+  game_journal_recovery_t recovery;
+  TEST_ASSERT_TRUE(game_journal_recover(JOURNAL_PATH, writer, game_journal_clock(), 0, &recovery));
+  TEST_ASSERT_EQUAL_UINT64(2, recovery.games_in_progress);
+  TEST_ASSERT_EQUAL_size_t(2, session_snapshot_writer_number_of_games(writer));
+  session_snapshot_writer_destroy(writer);
+}
+
+void test_full_batches_are_committed_before_the_interval(void) {
+  game_journal_options_t options = {.commit_milliseconds = 60 * 1000, .commit_bytes = 8 * sizeof(game_journal_record_t)};
+  game_journal_t *journal = game_journal_open(JOURNAL_PATH, options, 1);
+  for (uint64_t i = 0; i < 8; i++) {
+    append(journal, GAME_JOURNAL_EVENT_GUESS, i + 1, 0, (game_logic_code_t) i);
+  }
+  struct timespec pause = {.tv_nsec = 1000000};
+  for (int i = 0; i < 1000 && game_journal_get_stats(journal).records < 8; i++) {
+    nanosleep(&pause, NULL);
+  }
+  game_journal_stats_t stats = game_journal_get_stats(journal);
+  TEST_ASSERT_EQUAL_UINT64(8, stats.records);
+  TEST_ASSERT_EQUAL_UINT64(1, stats.commits);
+  TEST_ASSERT_EQUAL_UINT64(8 * sizeof(game_journal_record_t), stats.bytes);
+  game_journal_close(journal);
+}
+
+void test_other_files_are_not_taken_for_journals(void) {
+  FILE *file = fopen(JOURNAL_PATH, "wb");
+  fputs("definitely not a game journal", file);
+  fclose(file);
+  TEST_ASSERT_NULL(game_journal_open(JOURNAL_PATH, group_commit, 1));
+  game_journal_recovery_t recovery;
+  TEST_ASSERT_FALSE(game_journal_replay(JOURNAL_PATH, NULL, NULL, &recovery));
+  remove(JOURNAL_PATH);
+  TEST_ASSERT_TRUE(game_journal_replay(JOURNAL_PATH, NULL, NULL, &recovery));
+  TEST_ASSERT_EQUAL_UINT64(0, recovery.records);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_records_are_replayed_in_order);
+  RUN_TEST(test_torn_tail_is_cut_off_before_appending);
+  RUN_TEST(test_corrupt_record_ends_the_replay);
+  RUN_TEST(test_games_in_play_are_recovered);
+  RUN_TEST(test_many_finished_games_leave_nothing_behind);
+  RUN_TEST(test_full_batches_are_committed_before_the_interval);
+  RUN_TEST(test_other_files_are_not_taken_for_journals);
+  return UNITY_END();
+}
\ No newline at end of file
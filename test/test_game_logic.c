@@ -173,6 +173,61 @@ void test_get_feedback_all_correct(void) {
   TEST_ASSERT_TRUE(feedback.is_guess_correct);
 }
 
+void test_context_accepts_any_guess_before_the_first_move(void) {
+  game_logic_context_t context;
+  game_logic_context_start(&context, true);
+
+  for (game_logic_code_t code = 0; code < NUMBER_OF_POSSIBLE_CODES; code++) {
+    game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(code, guess);
+    TEST_ASSERT_TRUE(game_logic_context_is_consistent(&context, guess));
+  }
+}
+
+void test_context_consistent_set_matches_rescoring_the_history(void) {
+  game_logic_values_t set_answer[] = {GAME_VALUE_TWO, GAME_VALUE_FOUR, GAME_VALUE_FOUR, GAME_VALUE_ONE};
+  mock_random_set_values_to_match(set_answer);
+  game_logic_context_t context;
+  game_logic_context_start(&context, false);
+  game_logic_move_t history[] = {
+    {.guess = {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO}},
+    {.guess = {GAME_VALUE_FOUR, GAME_VALUE_TWO, GAME_VALUE_FIVE, GAME_VALUE_ONE}},
+  };
+  for (size_t i = 0; i < 2; i++) {
+    TEST_ASSERT_EQUAL(GAME_LOGIC_GUESS_ACCEPTED, game_logic_context_guess(&context, history[i].guess, &history[i].feedback));
+  }
+
+  for (game_logic_code_t code = 0; code < NUMBER_OF_POSSIBLE_CODES; code++) {
+    game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(code, guess);
+    TEST_ASSERT_EQUAL(game_logic_find_contradicted_move(history, 2, guess) == 2,
+                      game_logic_context_is_consistent(&context, guess));
+  }
+  TEST_ASSERT_TRUE(game_logic_context_is_consistent(&context, set_answer));
+}
+
+void test_context_hard_mode_refuses_inconsistent_guess(void) {
+  game_logic_values_t set_answer[] = {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR};
+  mock_random_set_values_to_match(set_answer);
+  game_logic_context_t context;
+  game_logic_context_start(&context, true);
+  game_logic_values_t first_guess[] = {GAME_VALUE_FIVE, GAME_VALUE_FIVE, GAME_VALUE_SIX, GAME_VALUE_SIX};
+  game_logic_feedback_t feedback = {0};
+  TEST_ASSERT_EQUAL(GAME_LOGIC_GUESS_ACCEPTED, game_logic_context_guess(&context, first_guess, &feedback));
+  TEST_ASSERT_EQUAL_UINT8(0, feedback.number_of_correct_value_and_placement + feedback.number_of_correct_value_only);
+
+  // five was ruled out by the first guess so it cannot appear again
+  game_logic_values_t illegal_guess[] = {GAME_VALUE_FIVE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR};
+  game_logic_feedback_t untouched = {.number_of_correct_value_only = 9};
+  TEST_ASSERT_EQUAL(GAME_LOGIC_GUESS_INCONSISTENT, game_logic_context_guess(&context, illegal_guess, &untouched));
+  TEST_ASSERT_EQUAL_UINT8(9, untouched.number_of_correct_value_only);
+
+  game_logic_move_t history[] = {{.guess = {GAME_VALUE_FIVE, GAME_VALUE_FIVE, GAME_VALUE_SIX, GAME_VALUE_SIX}, .feedback = feedback}};
+  TEST_ASSERT_EQUAL_size_t(0, game_logic_find_contradicted_move(history, 1, illegal_guess));
+  TEST_ASSERT_EQUAL(GAME_LOGIC_GUESS_ACCEPTED, game_logic_context_guess(&context, set_answer, &feedback));
+  TEST_ASSERT_TRUE(feedback.is_guess_correct);
+}
+
 int main(void)
 {
   UNITY_BEGIN();
@@ -189,5 +244,8 @@ int main(void)
     RUN_TEST(test_get_feedback_for_two_correct_value_only_and_two_correct_placement_and_value_repeated_answer);
     RUN_TEST(test_get_feedback_all_incorrect);
     RUN_TEST(test_get_feedback_all_correct);
+    RUN_TEST(test_context_accepts_any_guess_before_the_first_move);
+    RUN_TEST(test_context_consistent_set_matches_rescoring_the_history);
+    RUN_TEST(test_context_hard_mode_refuses_inconsistent_guess);
   return UNITY_END();
 }
\ No newline at end of file
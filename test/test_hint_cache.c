@@ -0,0 +1,122 @@
+#include "unity.h"
+#include "game_logic.h"
+#include "hint_cache.h"
+#include "random.h"
+
+#define ONE_MEGABYTE (1024 * 1024)
+
+int random_value(void) {
+  return 0;
+}
+
+static hint_cache_t *cache;
+
+void setUp(void) {
+  cache = hint_cache_create(ONE_MEGABYTE);
+}
+
+void tearDown(void) {
+  hint_cache_destroy(cache);
+}
+
+static game_logic_move_t make_move(const game_logic_values_t answer[], const game_logic_values_t guess[]) {
+  game_logic_move_t move;
+  for (size_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    move.guess[i] = guess[i];
+  }
+  move.feedback = game_logic_score(answer, guess);
+  return move;
+}
+
+void test_cache_stays_within_memory_budget(void) {
+  hint_cache_stats_t stats = hint_cache_get_stats(cache);
+
+  TEST_ASSERT_TRUE(stats.capacity > 0);
+  TEST_ASSERT_TRUE(stats.memory_used <= ONE_MEGABYTE);
+}
+
+void test_budget_too_small_is_rejected(void) {
+  TEST_ASSERT_NULL(hint_cache_create(1));
+}
+
+void test_repeated_history_is_a_hit(void) {
+  game_logic_values_t answer[] = {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR};
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO};
+  game_logic_move_t history[] = {make_move(answer, guess)};
+
+  solver_hint_t first = hint_cache_get_hint(cache, history, 1);
+  solver_hint_t second = hint_cache_get_hint(cache, history, 1);
+  hint_cache_stats_t stats = hint_cache_get_stats(cache);
+
+  TEST_ASSERT_EQUAL_UINT16(first.best_guess, second.best_guess);
+  TEST_ASSERT_EQUAL_UINT16(first.remaining_candidates, second.remaining_candidates);
+  TEST_ASSERT_EQUAL_UINT64(1, stats.misses);
+  TEST_ASSERT_EQUAL_UINT64(1, stats.hits);
+}
+
+void test_relabelled_history_shares_entry_and_hint_is_relabelled_back(void) {
+  game_logic_values_t answer[] = {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR};
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO};
+  game_logic_values_t relabelled_answer[] = {GAME_VALUE_SIX, GAME_VALUE_THREE, GAME_VALUE_ONE, GAME_VALUE_FOUR};
+  game_logic_values_t relabelled_guess[] = {GAME_VALUE_SIX, GAME_VALUE_SIX, GAME_VALUE_THREE, GAME_VALUE_THREE};
+  game_logic_move_t history[] = {make_move(answer, guess)};
+  game_logic_move_t relabelled_history[] = {make_move(relabelled_answer, relabelled_guess)};
+
+  hint_cache_get_hint(cache, history, 1);
+  solver_hint_t hint = hint_cache_get_hint(cache, relabelled_history, 1);
+  solver_hint_t expected = solver_get_hint(relabelled_history, 1);
+  hint_cache_stats_t stats = hint_cache_get_stats(cache);
+
+  TEST_ASSERT_EQUAL_UINT64(1, stats.hits);
+  TEST_ASSERT_EQUAL_UINT16(expected.remaining_candidates, hint.remaining_candidates);
+
+  // the relabelled best guess must split the candidates just as well as the solver's own choice
+  game_logic_code_t candidates[NUMBER_OF_POSSIBLE_CODES];
+  size_t count = solver_filter_candidates(relabelled_history, 1, candidates);
+  uint16_t cached_partitions[NUMBER_OF_FEEDBACK_CLASSES] = {0};
+  uint16_t expected_partitions[NUMBER_OF_FEEDBACK_CLASSES] = {0};
+  game_logic_values_t cached_guess[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_values_t expected_guess[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_unpack_code(hint.best_guess, cached_guess);
+  game_logic_unpack_code(expected.best_guess, expected_guess);
+  uint16_t cached_worst = 0;
+  uint16_t expected_worst = 0;
+  for (size_t i = 0; i < count; i++) {
+    game_logic_values_t candidate[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(candidates[i], candidate);
+    uint8_t cached_class = game_logic_feedback_to_class(game_logic_score(candidate, cached_guess));
+    uint8_t expected_class = game_logic_feedback_to_class(game_logic_score(candidate, expected_guess));
+    if (++cached_partitions[cached_class] > cached_worst) cached_worst = cached_partitions[cached_class];
+    if (++expected_partitions[expected_class] > expected_worst) expected_worst = expected_partitions[expected_class];
+  }
+  TEST_ASSERT_EQUAL_UINT16(expected_worst, cached_worst);
+}
+
+void test_full_sets_evict_entries(void) {
+  hint_cache_destroy(cache);
+  cache = hint_cache_create(4096);
+  game_logic_values_t answer[] = {GAME_VALUE_SIX, GAME_VALUE_SIX, GAME_VALUE_SIX, GAME_VALUE_SIX};
+  game_logic_move_t history[2];
+  history[0] = make_move(answer, (game_logic_values_t[]) {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO});
+
+  for (game_logic_code_t code = 0; code < NUMBER_OF_POSSIBLE_CODES; code++) {
+    game_logic_unpack_code(code, history[1].guess);
+    history[1].feedback = game_logic_score(answer, history[1].guess);
+    hint_cache_get_hint(cache, history, 2);
+  }
+  hint_cache_stats_t stats = hint_cache_get_stats(cache);
+
+  TEST_ASSERT_TRUE(stats.evictions > 0);
+  TEST_ASSERT_TRUE(stats.insertions - stats.evictions <= stats.capacity);
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_cache_stays_within_memory_budget);
+    RUN_TEST(test_budget_too_small_is_rejected);
+    RUN_TEST(test_repeated_history_is_a_hit);
+    RUN_TEST(test_relabelled_history_shares_entry_and_hint_is_relabelled_back);
+    RUN_TEST(test_full_sets_evict_entries);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "unity.h"
+#include "game_logic.h"
+#include "large_space.h"
+#include "random.h"
+#include <stdlib.h>
+#include <string.h>
+
+int random_value(void) {
+  return rand();
+}
+
+static const large_space_variant_t standard = {.number_of_pegs = NUMBER_OF_VALUES_TO_GUESS, .number_of_values = GAME_VALUE_MAX};
+static const large_space_variant_t large = {.number_of_pegs = 8, .number_of_values = 12};
+
+void setUp(void) {
+  srand(42);
+}
+
+void tearDown(void) {}
+
+static large_space_code_t to_large_space_code(game_logic_code_t code) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  large_space_code_t large_space_code = {0};
+  game_logic_unpack_code(code, values);
+  for (size_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    large_space_code.values[i] = (uint8_t) values[i];
+  }
+  return large_space_code;
+}
+
+static large_space_move_t make_move(const large_space_variant_t *variant, const large_space_code_t *answer, const large_space_code_t *guess) {
+  large_space_move_t move = {.guess = *guess};
+  move.feedback = large_space_score(variant, answer, guess);
+  return move;
+}
+
+void test_score_matches_standard_game_scoring(void) {
+  for (game_logic_code_t i = 0; i < NUMBER_OF_POSSIBLE_CODES; i += 5) {
+    for (game_logic_code_t j = 0; j < NUMBER_OF_POSSIBLE_CODES; j += 3) {
+      large_space_code_t answer = to_large_space_code(i);
+      large_space_code_t guess = to_large_space_code(j);
+      game_logic_feedback_t feedback = large_space_score(&standard, &answer, &guess);
+      TEST_ASSERT_EQUAL_UINT8(game_logic_score_row(j)[i], game_logic_feedback_to_class(feedback));
+    }
+  }
+}
+
+void test_enumerator_yields_exactly_the_consistent_codes(void) {
+  large_space_code_t answer = to_large_space_code(700);
+  large_space_code_t guesses[] = {to_large_space_code(7), to_large_space_code(300)};
+  large_space_move_t history[] = {make_move(&standard, &answer, &guesses[0]), make_move(&standard, &answer, &guesses[1])};
+  size_t expected = 0;
+  for (game_logic_code_t code = 0; code < NUMBER_OF_POSSIBLE_CODES; code++) {
+    expected += game_logic_score_row(7)[code] == game_logic_feedback_to_class(history[0].feedback) &&
+                game_logic_score_row(300)[code] == game_logic_feedback_to_class(history[1].feedback);
+  }
+  large_space_enumerator_t enumerator;
+  large_space_code_t code;
+  size_t count = 0;
+
+  TEST_ASSERT_TRUE(large_space_enumerator_init(&enumerator, &standard, history, 2, false));
+  while (large_space_enumerator_next(&enumerator, &code)) {
+    TEST_ASSERT_EQUAL_UINT8(game_logic_feedback_to_class(history[0].feedback),
+                            game_logic_feedback_to_class(large_space_score(&standard, &code, &guesses[0])));
+    TEST_ASSERT_EQUAL_UINT8(game_logic_feedback_to_class(history[1].feedback),
+                            game_logic_feedback_to_class(large_space_score(&standard, &code, &guesses[1])));
+    count++;
+  }
+
+  TEST_ASSERT_EQUAL_size_t(expected, count);
+}
+
+void test_sample_of_large_space_is_consistent_and_distinct(void) {
+  large_space_code_t answer;
+  large_space_code_t guess;
+  large_space_move_t history[3];
+  large_space_random_code(&large, &answer);
+  for (size_t i = 0; i < 3; i++) {
+    large_space_random_code(&large, &guess);
+    history[i] = make_move(&large, &answer, &guess);
+  }
+  large_space_code_t sample[64];
+
+  size_t count = large_space_sample(&large, history, 3, sample, 64);
+
+  TEST_ASSERT_EQUAL_size_t(64, count);
+  for (size_t i = 0; i < count; i++) {
+    for (size_t m = 0; m < 3; m++) {
+      game_logic_feedback_t feedback = large_space_score(&large, &sample[i], &history[m].guess);
+      TEST_ASSERT_EQUAL_UINT8(history[m].feedback.number_of_correct_value_and_placement, feedback.number_of_correct_value_and_placement);
+      TEST_ASSERT_EQUAL_UINT8(history[m].feedback.number_of_correct_value_only, feedback.number_of_correct_value_only);
+    }
+    for (size_t j = 0; j < i; j++) {
+      TEST_ASSERT_FALSE(memcmp(sample[i].values, sample[j].values, large.number_of_pegs) == 0);
+    }
+  }
+}
+
+void test_sampling_solver_solves_large_variant(void) {
+  large_space_code_t answer;
+  large_space_random_code(&large, &answer);
+  large_space_move_t history[LARGE_SPACE_MAXIMUM_HISTORY];
+  size_t history_length = 0;
+  bool is_solved = false;
+
+  while (!is_solved && history_length < LARGE_SPACE_MAXIMUM_HISTORY) {
+    large_space_code_t guess;
+    TEST_ASSERT_TRUE(large_space_best_guess(&large, history, history_length, 64, &guess));
+    history[history_length] = make_move(&large, &answer, &guess);
+    is_solved = history[history_length].feedback.is_guess_correct;
+    history_length++;
+  }
+
+  TEST_ASSERT_TRUE(is_solved);
+}
+
+void test_histories_past_the_maximum_are_refused(void) {
+  large_space_code_t answer;
+  large_space_random_code(&large, &answer);
+  large_space_move_t history[LARGE_SPACE_MAXIMUM_HISTORY + 1];
+  for (size_t i = 0; i < LARGE_SPACE_MAXIMUM_HISTORY + 1; i++) {
+    large_space_code_t guess;
+    large_space_random_code(&large, &guess);
+    history[i] = make_move(&large, &answer, &guess);
+  }
+  large_space_enumerator_t enumerator;
+  large_space_code_t code;
+  large_space_code_t sample[8];
+
+  TEST_ASSERT_FALSE(large_space_enumerator_init(&enumerator, &large, history, LARGE_SPACE_MAXIMUM_HISTORY + 1, false));
+  TEST_ASSERT_FALSE(large_space_enumerator_next(&enumerator, &code));
+  TEST_ASSERT_EQUAL_size_t(0, large_space_sample(&large, history, LARGE_SPACE_MAXIMUM_HISTORY + 1, sample, 8));
+  TEST_ASSERT_FALSE(large_space_best_guess(&large, history, LARGE_SPACE_MAXIMUM_HISTORY + 1, 8, &code));
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_score_matches_standard_game_scoring);
+    RUN_TEST(test_enumerator_yields_exactly_the_consistent_codes);
+    RUN_TEST(test_sample_of_large_space_is_consistent_and_distinct);
+    RUN_TEST(test_sampling_solver_solves_large_variant);
+    RUN_TEST(test_histories_past_the_maximum_are_refused);
+  return UNITY_END();
+}
\ No newline at end of file
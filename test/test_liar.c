@@ -0,0 +1,129 @@
+#include "unity.h"
+#include "game_logic.h"
+#include "liar.h"
+#include "random.h"
+
+#define MOCK_RANDOM_VALUES (NUMBER_OF_VALUES_TO_GUESS + 2)
+#define ALWAYS_LIE 0
+#define NEVER_LIE 999
+
+static int mock_random_return[MOCK_RANDOM_VALUES];
+static size_t mock_random_return_index;
+
+int random_value(void) {
+  return mock_random_return[mock_random_return_index++ % MOCK_RANDOM_VALUES];
+}
+
+static void mock_random_set_answer(const game_logic_values_t *set_answer) {
+  mock_random_return_index = 0;
+  for (size_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    mock_random_return[i] = set_answer[i];
+  }
+}
+
+static void mock_random_set_lie_decision(int decision, int lie_choice) {
+  mock_random_return_index = NUMBER_OF_VALUES_TO_GUESS;
+  mock_random_return[NUMBER_OF_VALUES_TO_GUESS] = decision;
+  mock_random_return[NUMBER_OF_VALUES_TO_GUESS + 1] = lie_choice;
+}
+
+static const game_logic_values_t answer[] = {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR};
+static liar_solver_t solver;
+
+void setUp(void) {
+  mock_random_set_answer(answer);
+  liar_codemaker_start();
+  liar_solver_init(&solver, LIAR_MAXIMUM_LIES, LIAR_LIE_PROBABILITY);
+}
+
+void tearDown(void) {}
+
+void test_codemaker_lies_at_most_the_maximum_number_of_times(void) {
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO};
+  uint8_t true_class = game_logic_feedback_to_class(game_logic_score(answer, guess));
+  size_t number_of_lies = 0;
+
+  for (size_t i = 0; i < 4; i++) {
+    mock_random_set_lie_decision(ALWAYS_LIE, (int) i);
+    number_of_lies += game_logic_feedback_to_class(liar_codemaker_get_feedback(guess)) != true_class;
+  }
+
+  TEST_ASSERT_EQUAL_size_t(LIAR_MAXIMUM_LIES, number_of_lies);
+}
+
+void test_codemaker_never_lies_about_correct_guess(void) {
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR};
+  mock_random_set_lie_decision(ALWAYS_LIE, 0);
+
+  TEST_ASSERT_TRUE(liar_codemaker_get_feedback(guess).is_guess_correct);
+}
+
+void test_codemaker_tells_truth_when_not_lying(void) {
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO};
+  mock_random_set_lie_decision(NEVER_LIE, 0);
+
+  game_logic_feedback_t feedback = liar_codemaker_get_feedback(guess);
+
+  TEST_ASSERT_EQUAL_UINT8(1, feedback.number_of_correct_value_and_placement);
+  TEST_ASSERT_EQUAL_UINT8(1, feedback.number_of_correct_value_only);
+}
+
+void test_update_keeps_answer_with_one_lie_and_drops_answers_needing_two(void) {
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO};
+  game_logic_feedback_t lie = {.number_of_correct_value_only = 0, .number_of_correct_value_and_placement = 0};
+  game_logic_code_t answer_code = game_logic_pack_code(answer);
+
+  liar_solver_update(&solver, guess, lie);
+  TEST_ASSERT_TRUE(solver.weights[answer_code] > 0.0f);
+
+  liar_solver_update(&solver, guess, lie);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, solver.weights[answer_code]);
+}
+
+void test_lie_counts_stop_one_past_the_maximum(void) {
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO};
+  game_logic_feedback_t lie = {.number_of_correct_value_only = 0, .number_of_correct_value_and_placement = 0};
+  game_logic_code_t answer_code = game_logic_pack_code(answer);
+
+  for (size_t i = 0; i < 300; i++) {
+    liar_solver_update(&solver, guess, lie);
+  }
+
+  TEST_ASSERT_EQUAL_UINT8(LIAR_MAXIMUM_LIES + 1, solver.lies[answer_code]);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, solver.weights[answer_code]);
+}
+
+void test_solver_finds_answer_despite_a_lie(void) {
+  game_logic_code_t answer_code = game_logic_pack_code(answer);
+  bool is_solved = false;
+  bool has_lied = false;
+
+  for (size_t move = 0; move < 12 && !is_solved; move++) {
+    game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(liar_solver_best_guess(&solver), guess);
+    game_logic_feedback_t feedback = game_logic_score(answer, guess);
+    if (!has_lied && !feedback.is_guess_correct) {
+      // report a lie on the first move
+      feedback.number_of_correct_value_only = feedback.number_of_correct_value_only == 0;
+      feedback.number_of_correct_value_and_placement = 0;
+      has_lied = true;
+    }
+    liar_solver_update(&solver, guess, feedback);
+    is_solved = feedback.is_guess_correct;
+  }
+
+  TEST_ASSERT_TRUE(is_solved);
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, solver.weights[answer_code]);
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_codemaker_lies_at_most_the_maximum_number_of_times);
+    RUN_TEST(test_codemaker_never_lies_about_correct_guess);
+    RUN_TEST(test_codemaker_tells_truth_when_not_lying);
+    RUN_TEST(test_update_keeps_answer_with_one_lie_and_drops_answers_needing_two);
+    RUN_TEST(test_lie_counts_stop_one_past_the_maximum);
+    RUN_TEST(test_solver_finds_answer_despite_a_lie);
+  return UNITY_END();
+}
\ No newline at end of file
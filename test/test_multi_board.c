@@ -0,0 +1,90 @@
+#include "unity.h"
+#include "game_logic.h"
+#include "multi_board.h"
+#include "random.h"
+#include <stdlib.h>
+
+static int mock_random_next;
+
+// every call hands out the next value so each board gets a different answer
+int random_value(void) {
+  return mock_random_next++;
+}
+
+static multi_board_game_t game;
+static multi_board_solver_t *solver;
+
+void setUp(void) {
+  mock_random_next = 0;
+  solver = malloc(sizeof(multi_board_solver_t));
+}
+
+void tearDown(void) {
+  free(solver);
+}
+
+void test_number_of_boards_is_clamped(void) {
+  multi_board_start(&game, 100);
+  TEST_ASSERT_EQUAL_size_t(MULTI_BOARD_MAXIMUM_BOARDS, game.number_of_boards);
+
+  multi_board_start(&game, 0);
+  TEST_ASSERT_EQUAL_size_t(1, game.number_of_boards);
+}
+
+void test_score_matches_single_answer_scoring(void) {
+  multi_board_start(&game, 8);
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR};
+  uint8_t classes[MULTI_BOARD_MAXIMUM_BOARDS];
+
+  multi_board_score(game_logic_pack_code(guess), game.answers, game.number_of_boards, classes);
+
+  for (size_t board = 0; board < game.number_of_boards; board++) {
+    game_logic_values_t answer[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(game.answers[board], answer);
+    TEST_ASSERT_EQUAL_UINT8(game_logic_feedback_to_class(game_logic_score(answer, guess)), classes[board]);
+  }
+}
+
+void test_solved_board_stays_solved(void) {
+  multi_board_start(&game, 2);
+  game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_feedback_t feedback[MULTI_BOARD_MAXIMUM_BOARDS];
+  game_logic_unpack_code(game.answers[0], guess);
+
+  multi_board_get_feedback(&game, guess, feedback);
+  TEST_ASSERT_TRUE(feedback[0].is_guess_correct);
+  TEST_ASSERT_FALSE(multi_board_is_solved(&game));
+
+  game_logic_unpack_code(game.answers[1], guess);
+  multi_board_get_feedback(&game, guess, feedback);
+  TEST_ASSERT_TRUE(feedback[0].is_guess_correct);
+  TEST_ASSERT_TRUE(feedback[1].is_guess_correct);
+  TEST_ASSERT_TRUE(multi_board_is_solved(&game));
+}
+
+void test_solver_clears_four_boards_within_the_try_limit(void) {
+  multi_board_start(&game, 4);
+  multi_board_solver_init(solver, game.number_of_boards);
+  size_t tries = 0;
+
+  while (!multi_board_is_solved(&game) && tries < multi_board_get_maximum_number_of_tries(&game)) {
+    game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_feedback_t feedback[MULTI_BOARD_MAXIMUM_BOARDS];
+    game_logic_unpack_code(multi_board_solver_best_guess(solver), guess);
+    multi_board_get_feedback(&game, guess, feedback);
+    multi_board_solver_update(solver, guess, feedback);
+    tries++;
+  }
+
+  TEST_ASSERT_TRUE(multi_board_is_solved(&game));
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_number_of_boards_is_clamped);
+    RUN_TEST(test_score_matches_single_answer_scoring);
+    RUN_TEST(test_solved_board_stays_solved);
+    RUN_TEST(test_solver_clears_four_boards_within_the_try_limit);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,232 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+#include "replay_store.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STORE_PATH "build/test_replays.store"
+// spills into a third, partly filled block
+#define NUMBER_OF_GAMES (2 * REPLAY_STORE_BLOCK_GAMES + 1000)
+#define FIRST_START 1000000
+// where the header keeps the game count and the index offset, after four 32 bit fields
+#define HEADER_NUMBER_OF_GAMES_OFFSET 16
+#define HEADER_INDEX_OFFSET_OFFSET 32
+
+int random_value(void) {
+  return 0;
+}
+
+void setUp(void) {
+  remove(STORE_PATH);
+}
+
+void tearDown(void) {
+  remove(STORE_PATH);
+}
+
+static replay_store_game_t make_game(uint64_t i) {
+  replay_store_game_t game = {
+    .started = FIRST_START + i,
+    .duration = (uint32_t)(i % 5000),
+    .secret = (game_logic_code_t)(i % NUMBER_OF_POSSIBLE_CODES),
+    .tries = (uint8_t)(1 + i % REPLAY_STORE_MAXIMUM_MOVES),
+    .outcome = (uint8_t)(i % 5),
+    .is_hard_mode = (uint8_t)(i % 3 == 0)
+  };
+  for (uint8_t move = 0; move < REPLAY_STORE_MAXIMUM_MOVES; move++) {
+    game.guesses[move] = (game_logic_code_t)((i * 7 + move) % NUMBER_OF_POSSIBLE_CODES);
+    game.feedback[move] = game_logic_score_row(game.guesses[move])[game.secret];
+  }
+  return game;
+}
+
+static replay_store_t* build_store(void) {
+  replay_store_writer_t *writer = replay_store_writer_create(STORE_PATH);
+  TEST_ASSERT_NOT_NULL(writer);
+  for (uint64_t i = 0; i < NUMBER_OF_GAMES; i++) {
+    replay_store_game_t game = make_game(i);
+    TEST_ASSERT_TRUE(replay_store_writer_add(writer, &game));
+  }
+  TEST_ASSERT_TRUE(replay_store_writer_commit(writer));
+  replay_store_t *store = replay_store_open(STORE_PATH);
+  TEST_ASSERT_NOT_NULL(store);
+  TEST_ASSERT_EQUAL_UINT64(NUMBER_OF_GAMES, replay_store_number_of_games(store));
+  return store;
+}
+
+void test_count_with_filters_matches_a_full_scan(void) {
+  replay_store_t *store = build_store();
+  replay_store_query_t query = {
+    .filters = {{REPLAY_STORE_COLUMN_TRIES, 3, 5}, {REPLAY_STORE_COLUMN_HARD_MODE, 1, 1},
+                {REPLAY_STORE_COLUMN_DURATION, 0, 2499}},
+    .number_of_filters = 3,
+    .aggregate = REPLAY_STORE_COUNT
+  };
+  replay_store_result_t result;
+  TEST_ASSERT_TRUE(replay_store_run(store, &query, &result));
+  uint64_t expected = 0;
+  for (uint64_t i = 0; i < NUMBER_OF_GAMES; i++) {
+    replay_store_game_t game = make_game(i);
+    expected += game.tries >= 3 && game.tries <= 5 && game.is_hard_mode && game.duration <= 2499;
+  }
+  TEST_ASSERT_EQUAL_UINT64(expected, result.games_selected);
+  TEST_ASSERT_EQUAL_UINT64(NUMBER_OF_GAMES, result.games_scanned);
+  TEST_ASSERT_NULL(result.counts);
+  replay_store_result_free(&result);
+  replay_store_close(store);
+}
+
+void test_blocks_outside_a_range_are_skipped(void) {
+  replay_store_t *store = build_store();
+  // only the second block holds these start times
+  replay_store_query_t query = {
+    .filters = {{REPLAY_STORE_COLUMN_STARTED, FIRST_START + REPLAY_STORE_BLOCK_GAMES + 10,
+                 FIRST_START + REPLAY_STORE_BLOCK_GAMES + 19}},
+    .number_of_filters = 1,
+    .aggregate = REPLAY_STORE_COUNT
+  };
+  replay_store_result_t result;
+  TEST_ASSERT_TRUE(replay_store_run(store, &query, &result));
+  TEST_ASSERT_EQUAL_UINT64(10, result.games_selected);
+  TEST_ASSERT_EQUAL_UINT64(1, result.blocks_scanned);
+  TEST_ASSERT_EQUAL_UINT64(2, result.blocks_skipped);
+  TEST_ASSERT_EQUAL_UINT64(REPLAY_STORE_BLOCK_GAMES * sizeof(uint64_t), result.bytes_scanned);
+  replay_store_result_free(&result);
+  replay_store_close(store);
+}
+
+void test_histogram_counts_first_guesses(void) {
+  replay_store_t *store = build_store();
+  replay_store_query_t query = {
+    .filters = {{REPLAY_STORE_COLUMN_OUTCOME, 0, 0}},
+    .number_of_filters = 1,
+    .aggregate = REPLAY_STORE_HISTOGRAM,
+    .column = REPLAY_STORE_COLUMN_GUESS
+  };
+  replay_store_result_t result;
+  TEST_ASSERT_TRUE(replay_store_run(store, &query, &result));
+  uint64_t *expected = calloc(REPLAY_STORE_MAXIMUM_GROUPS, sizeof(uint64_t));
+  TEST_ASSERT_NOT_NULL(expected);
+  for (uint64_t i = 0; i < NUMBER_OF_GAMES; i++) {
+    replay_store_game_t game = make_game(i);
+    expected[game.guesses[0]] += game.outcome == 0;
+  }
+  TEST_ASSERT_EQUAL_UINT64_ARRAY(expected, result.counts, REPLAY_STORE_MAXIMUM_GROUPS);
+  free(expected);
+  replay_store_result_free(&result);
+  replay_store_close(store);
+}
+
+void test_average_tries_by_secret(void) {
+  replay_store_t *store = build_store();
+  replay_store_query_t query = {
+    .aggregate = REPLAY_STORE_AVERAGE,
+    .column = REPLAY_STORE_COLUMN_TRIES,
+    .group_by = REPLAY_STORE_COLUMN_SECRET
+  };
+  replay_store_result_t result;
+  TEST_ASSERT_TRUE(replay_store_run(store, &query, &result));
+  uint64_t counts[NUMBER_OF_POSSIBLE_CODES] = {0};
+  uint64_t sums[NUMBER_OF_POSSIBLE_CODES] = {0};
+  for (uint64_t i = 0; i < NUMBER_OF_GAMES; i++) {
+    replay_store_game_t game = make_game(i);
+    counts[game.secret]++;
+    sums[game.secret] += game.tries;
+  }
+  TEST_ASSERT_EQUAL_UINT64_ARRAY(counts, result.counts, NUMBER_OF_POSSIBLE_CODES);
+  TEST_ASSERT_EQUAL_UINT64_ARRAY(sums, result.sums, NUMBER_OF_POSSIBLE_CODES);
+  replay_store_result_free(&result);
+  replay_store_close(store);
+}
+
+void test_guesses_the_feedback_ruled_out_are_blunders(void) {
+  game_logic_code_t secret = game_logic_pack_code((game_logic_values_t[]) {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO});
+  game_logic_code_t first = game_logic_pack_code((game_logic_values_t[]) {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR});
+  // scores differently against the first guess than the secret does
+  game_logic_code_t second = game_logic_pack_code((game_logic_values_t[]) {GAME_VALUE_SIX, GAME_VALUE_SIX, GAME_VALUE_SIX, GAME_VALUE_SIX});
+  replay_store_game_t game = {.started = FIRST_START, .secret = secret, .tries = 3, .guesses = {first, second, secret}};
+  for (uint8_t move = 0; move < game.tries; move++) {
+    game.feedback[move] = game_logic_score_row(game.guesses[move])[secret];
+  }
+  replay_store_writer_t *writer = replay_store_writer_create(STORE_PATH);
+  TEST_ASSERT_NOT_NULL(writer);
+  TEST_ASSERT_TRUE(replay_store_writer_add(writer, &game));
+  TEST_ASSERT_TRUE(replay_store_writer_commit(writer));
+  replay_store_t *store = replay_store_open(STORE_PATH);
+  TEST_ASSERT_NOT_NULL(store);
+  replay_store_query_t query = {
+    .filters = {{REPLAY_STORE_COLUMN_BLUNDERS, 1, 1}, {REPLAY_STORE_COLUMN_FIRST_BLUNDER, 2, 2},
+                {REPLAY_STORE_COLUMN_GUESS + 3, REPLAY_STORE_NO_GUESS, REPLAY_STORE_NO_GUESS}},
+    .number_of_filters = 3,
+    .aggregate = REPLAY_STORE_COUNT
+  };
+  replay_store_result_t result;
+  TEST_ASSERT_TRUE(replay_store_run(store, &query, &result));
+  TEST_ASSERT_EQUAL_UINT64(1, result.games_selected);
+  replay_store_result_free(&result);
+  replay_store_close(store);
+}
+
+void test_missing_and_foreign_files_do_not_open(void) {
+  TEST_ASSERT_NULL(replay_store_open(STORE_PATH));
+  FILE *file = fopen(STORE_PATH, "wb");
+  TEST_ASSERT_NOT_NULL(file);
+  char garbage[256] = "not a replay store";
+  fwrite(garbage, 1, sizeof(garbage), file);
+  fclose(file);
+  TEST_ASSERT_NULL(replay_store_open(STORE_PATH));
+}
+
+// overwrites a field of the file's header in place
+static void patch_header(long offset, uint64_t value) {
+  FILE *file = fopen(STORE_PATH, "r+b");
+  TEST_ASSERT_NOT_NULL(file);
+  TEST_ASSERT_EQUAL_INT(0, fseek(file, offset, SEEK_SET));
+  TEST_ASSERT_EQUAL_size_t(1, fwrite(&value, sizeof(value), 1, file));
+  fclose(file);
+}
+
+void test_headers_that_disagree_with_the_blocks_do_not_open(void) {
+  replay_store_writer_t *writer = replay_store_writer_create(STORE_PATH);
+  for (uint64_t i = 0; i < 10; i++) {
+    replay_store_game_t game = make_game(i);
+    TEST_ASSERT_TRUE(replay_store_writer_add(writer, &game));
+  }
+  TEST_ASSERT_TRUE(replay_store_writer_commit(writer));
+  replay_store_t *store = replay_store_open(STORE_PATH);
+  TEST_ASSERT_NOT_NULL(store);
+  replay_store_close(store);
+  // still one block, but far more games than the file holds
+  patch_header(HEADER_NUMBER_OF_GAMES_OFFSET, REPLAY_STORE_BLOCK_GAMES);
+  TEST_ASSERT_NULL(replay_store_open(STORE_PATH));
+  patch_header(HEADER_NUMBER_OF_GAMES_OFFSET, 10);
+  TEST_ASSERT_NOT_NULL(store = replay_store_open(STORE_PATH));
+  replay_store_close(store);
+  patch_header(HEADER_INDEX_OFFSET_OFFSET, 64);
+  TEST_ASSERT_NULL(replay_store_open(STORE_PATH));
+}
+
+void test_aggregates_too_wide_for_the_groups_are_refused(void) {
+  replay_store_t *store = build_store();
+  replay_store_query_t query = {.aggregate = REPLAY_STORE_HISTOGRAM, .column = REPLAY_STORE_COLUMN_STARTED};
+  replay_store_result_t result;
+  TEST_ASSERT_FALSE(replay_store_run(store, &query, &result));
+  query = (replay_store_query_t) {
+    .aggregate = REPLAY_STORE_AVERAGE, .column = REPLAY_STORE_COLUMN_TRIES, .group_by = REPLAY_STORE_COLUMN_DURATION
+  };
+  TEST_ASSERT_FALSE(replay_store_run(store, &query, &result));
+  replay_store_close(store);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_count_with_filters_matches_a_full_scan);
+  RUN_TEST(test_blocks_outside_a_range_are_skipped);
+  RUN_TEST(test_histogram_counts_first_guesses);
+  RUN_TEST(test_average_tries_by_secret);
+  RUN_TEST(test_guesses_the_feedback_ruled_out_are_blunders);
+  RUN_TEST(test_missing_and_foreign_files_do_not_open);
+  RUN_TEST(test_headers_that_disagree_with_the_blocks_do_not_open);
+  RUN_TEST(test_aggregates_too_wide_for_the_groups_are_refused);
+  return UNITY_END();
+}
\ No newline at end of file
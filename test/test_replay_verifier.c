@@ -0,0 +1,182 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+#include "replay_verifier.h"
+#include "game_journal.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define STORE_PATH "build/test_verified.store"
+#define NUMBER_OF_GAMES (2 * REPLAY_STORE_BLOCK_GAMES + 77)
+// tampers with the feedback of every game this many apart
+#define TAMPER_INTERVAL 97
+// plays every game this many apart in hard mode
+#define HARD_MODE_INTERVAL 16
+
+int random_value(void) {
+  return 0;
+}
+
+void setUp(void) {
+  remove(STORE_PATH);
+}
+
+void tearDown(void) {
+  remove(STORE_PATH);
+}
+
+static bool is_consistent(const replay_store_game_t *game, game_logic_code_t guess) {
+  for (uint8_t move = 0; move < game->tries; move++) {
+    if (game_logic_score_row(game->guesses[move])[guess] != game->feedback[move]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// plays guesses stepping through the code space until the answer comes up or the moves run out, in hard
+// mode only the guesses the feedback so far allows
+static replay_store_game_t play_game(uint64_t i) {
+  replay_store_game_t game = {
+    .started = i,
+    .secret = (game_logic_code_t)((i * 7919) % NUMBER_OF_POSSIBLE_CODES),
+    .is_hard_mode = (uint8_t)(i % HARD_MODE_INTERVAL == 0),
+    .outcome = GAME_JOURNAL_END_LOST
+  };
+  game_logic_code_t guess = (game_logic_code_t)(i % NUMBER_OF_POSSIBLE_CODES);
+  while (game.tries < REPLAY_STORE_MAXIMUM_MOVES) {
+    if (game.is_hard_mode && !is_consistent(&game, guess)) {
+      guess = (game_logic_code_t)((guess + 1) % NUMBER_OF_POSSIBLE_CODES);
+      continue;
+    }
+    game.guesses[game.tries] = guess;
+    game.feedback[game.tries++] = game_logic_score_row(guess)[game.secret];
+    if (guess == game.secret) {
+      game.outcome = GAME_JOURNAL_END_WON;
+      break;
+    }
+    guess = (game_logic_code_t)((guess + 211) % NUMBER_OF_POSSIBLE_CODES);
+  }
+  return game;
+}
+
+static replay_store_t* build_store(bool is_tampered, uint64_t *moves) {
+  replay_store_writer_t *writer = replay_store_writer_create(STORE_PATH);
+  TEST_ASSERT_NOT_NULL(writer);
+  *moves = 0;
+  for (uint64_t i = 0; i < NUMBER_OF_GAMES; i++) {
+    replay_store_game_t game = play_game(i);
+    *moves += game.tries;
+    if (is_tampered && i % TAMPER_INTERVAL == 0) {
+      game.feedback[0] = (uint8_t)((game.feedback[0] + 1) % NUMBER_OF_FEEDBACK_CLASSES);
+    }
+    TEST_ASSERT_TRUE(replay_store_writer_add(writer, &game));
+  }
+  TEST_ASSERT_TRUE(replay_store_writer_commit(writer));
+  replay_store_t *store = replay_store_open(STORE_PATH);
+  TEST_ASSERT_NOT_NULL(store);
+  return store;
+}
+
+void test_games_played_by_the_engine_replay_without_divergence(void) {
+  uint64_t moves;
+  replay_store_t *store = build_store(false, &moves);
+  replay_verifier_result_t *result = malloc(sizeof(replay_verifier_result_t));
+  TEST_ASSERT_NOT_NULL(result);
+  TEST_ASSERT_TRUE(replay_verifier_run(store, 4, result));
+  TEST_ASSERT_EQUAL_UINT64(NUMBER_OF_GAMES, result->games);
+  TEST_ASSERT_EQUAL_UINT64(moves, result->moves);
+  TEST_ASSERT_EQUAL_UINT64(0, result->games_diverged);
+  TEST_ASSERT_EQUAL_size_t(0, result->number_of_divergences);
+  free(result);
+  replay_store_close(store);
+}
+
+void test_divergences_do_not_depend_on_the_number_of_threads(void) {
+  uint64_t moves;
+  replay_store_t *store = build_store(true, &moves);
+  replay_verifier_result_t *single = malloc(sizeof(replay_verifier_result_t));
+  replay_verifier_result_t *parallel = malloc(sizeof(replay_verifier_result_t));
+  TEST_ASSERT_NOT_NULL(single);
+  TEST_ASSERT_NOT_NULL(parallel);
+  TEST_ASSERT_TRUE(replay_verifier_run(store, 1, single));
+  TEST_ASSERT_TRUE(replay_verifier_run(store, 7, parallel));
+  uint64_t tampered = (NUMBER_OF_GAMES + TAMPER_INTERVAL - 1) / TAMPER_INTERVAL;
+  TEST_ASSERT_EQUAL_UINT64(tampered, single->games_diverged);
+  TEST_ASSERT_EQUAL_UINT64(tampered, parallel->games_diverged);
+  // more games diverged than are kept, the lowest numbered ones are
+  TEST_ASSERT_EQUAL_size_t(REPLAY_VERIFIER_MAXIMUM_DIVERGENCES, parallel->number_of_divergences);
+  TEST_ASSERT_EQUAL_size_t(single->number_of_divergences, parallel->number_of_divergences);
+  for (size_t i = 0; i < parallel->number_of_divergences; i++) {
+    const replay_verifier_divergence_t *expected = &single->divergences[i];
+    const replay_verifier_divergence_t *actual = &parallel->divergences[i];
+    TEST_ASSERT_EQUAL_UINT64(i * TAMPER_INTERVAL, actual->game);
+    TEST_ASSERT_EQUAL_INT(REPLAY_VERIFIER_FEEDBACK, actual->kind);
+    TEST_ASSERT_EQUAL_UINT8(0, actual->move);
+    TEST_ASSERT_EQUAL_UINT64(expected->game, actual->game);
+    TEST_ASSERT_EQUAL_UINT8(expected->recorded, actual->recorded);
+    TEST_ASSERT_EQUAL_UINT8(expected->replayed, actual->replayed);
+  }
+  free(single);
+  free(parallel);
+  replay_store_close(store);
+}
+
+static replay_store_game_t two_move_game(bool is_hard_mode) {
+  game_logic_code_t secret = game_logic_pack_code((game_logic_values_t[]) {
+    GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO});
+  game_logic_code_t first = game_logic_pack_code((game_logic_values_t[]) {
+    GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR});
+  // scores differently against the first guess than the secret does
+  game_logic_code_t second = game_logic_pack_code((game_logic_values_t[]) {
+    GAME_VALUE_SIX, GAME_VALUE_SIX, GAME_VALUE_SIX, GAME_VALUE_SIX});
+  replay_store_game_t game = {.secret = secret, .tries = 2, .guesses = {first, second},
+                              .is_hard_mode = (uint8_t) is_hard_mode, .outcome = GAME_JOURNAL_END_GAVE_UP};
+  game.feedback[0] = game_logic_score_row(first)[secret];
+  game.feedback[1] = game_logic_score_row(second)[secret];
+  return game;
+}
+
+void test_hard_mode_refuses_guesses_the_feedback_ruled_out(void) {
+  replay_verifier_divergence_t divergence;
+  replay_store_game_t game = two_move_game(false);
+  TEST_ASSERT_EQUAL_INT(REPLAY_VERIFIER_AGREES, replay_verifier_check_game(&game, &divergence));
+  game = two_move_game(true);
+  TEST_ASSERT_EQUAL_INT(REPLAY_VERIFIER_REFUSED, replay_verifier_check_game(&game, &divergence));
+  TEST_ASSERT_EQUAL_UINT8(1, divergence.move);
+}
+
+void test_outcomes_must_follow_from_the_moves(void) {
+  replay_verifier_divergence_t divergence;
+  replay_store_game_t game = two_move_game(false);
+  game.outcome = GAME_JOURNAL_END_WON;
+  TEST_ASSERT_EQUAL_INT(REPLAY_VERIFIER_OUTCOME, replay_verifier_check_game(&game, &divergence));
+  TEST_ASSERT_EQUAL_UINT8(GAME_JOURNAL_END_WON, divergence.recorded);
+  TEST_ASSERT_EQUAL_UINT8(GAME_JOURNAL_END_LOST, divergence.replayed);
+  // the answer guessed with a move still to come
+  game = two_move_game(false);
+  game.guesses[0] = game.secret;
+  game.feedback[0] = game_logic_score_row(game.secret)[game.secret];
+  TEST_ASSERT_EQUAL_INT(REPLAY_VERIFIER_OUTCOME, replay_verifier_check_game(&game, &divergence));
+  TEST_ASSERT_EQUAL_UINT8(1, divergence.move);
+}
+
+void test_out_of_range_recordings_are_malformed(void) {
+  replay_verifier_divergence_t divergence;
+  replay_store_game_t game = two_move_game(false);
+  game.secret = NUMBER_OF_POSSIBLE_CODES;
+  TEST_ASSERT_EQUAL_INT(REPLAY_VERIFIER_MALFORMED, replay_verifier_check_game(&game, &divergence));
+  game = two_move_game(false);
+  game.guesses[1] = REPLAY_STORE_NO_GUESS;
+  TEST_ASSERT_EQUAL_INT(REPLAY_VERIFIER_MALFORMED, replay_verifier_check_game(&game, &divergence));
+  TEST_ASSERT_EQUAL_UINT8(1, divergence.move);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_games_played_by_the_engine_replay_without_divergence);
+  RUN_TEST(test_divergences_do_not_depend_on_the_number_of_threads);
+  RUN_TEST(test_hard_mode_refuses_guesses_the_feedback_ruled_out);
+  RUN_TEST(test_outcomes_must_follow_from_the_moves);
+  RUN_TEST(test_out_of_range_recordings_are_malformed);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "unity.h"
+#include "game_logic.h"
+#include "secret_distribution.h"
+#include "random.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NUMBER_OF_DRAWS 20000
+#define NO_DUPLICATE_CODES (6 * 5 * 4 * 3)
+
+int random_value(void) {
+  return rand();
+}
+
+void setUp(void) {
+  srand(7);
+}
+
+void tearDown(void) {}
+
+static bool has_duplicates(const game_logic_values_t values[]) {
+  for (size_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    for (size_t j = i + 1; j < NUMBER_OF_VALUES_TO_GUESS; j++) {
+      if (values[i] == values[j]) return true;
+    }
+  }
+  return false;
+}
+
+void test_no_duplicates_answers_never_repeat_a_value(void) {
+  for (size_t i = 0; i < 1000; i++) {
+    secret_distribution_start_no_duplicates();
+    TEST_ASSERT_FALSE(has_duplicates(game_logic_get_answer()));
+  }
+}
+
+void test_no_duplicates_restricts_the_code_space(void) {
+  const game_logic_code_t *codes;
+  secret_distribution_use_no_duplicates();
+
+  TEST_ASSERT_EQUAL_size_t(NO_DUPLICATE_CODES, secret_distribution_get_codes(&codes));
+  TEST_ASSERT_EQUAL_UINT16(NO_DUPLICATE_CODES, secret_distribution_get_hint(NULL, 0).remaining_candidates);
+}
+
+void test_weighted_draws_follow_the_weights(void) {
+  static double weights[NUMBER_OF_POSSIBLE_CODES];
+  memset(weights, 0, sizeof(weights));
+  weights[10] = 1.0;
+  weights[20] = 3.0;
+  size_t draws_of_10 = 0;
+  size_t draws_of_20 = 0;
+
+  TEST_ASSERT_TRUE(secret_distribution_use_weights(weights));
+  for (size_t i = 0; i < NUMBER_OF_DRAWS; i++) {
+    secret_distribution_generate_answer();
+    game_logic_code_t code = game_logic_pack_code(game_logic_get_answer());
+    TEST_ASSERT_TRUE(code == 10 || code == 20);
+    draws_of_10 += code == 10;
+    draws_of_20 += code == 20;
+  }
+
+  TEST_ASSERT_UINT_WITHIN(NUMBER_OF_DRAWS / 50, NUMBER_OF_DRAWS / 4, draws_of_10);
+  TEST_ASSERT_UINT_WITHIN(NUMBER_OF_DRAWS / 50, 3 * NUMBER_OF_DRAWS / 4, draws_of_20);
+}
+
+void test_invalid_weights_are_rejected(void) {
+  static double weights[NUMBER_OF_POSSIBLE_CODES];
+  memset(weights, 0, sizeof(weights));
+  TEST_ASSERT_FALSE(secret_distribution_use_weights(weights));
+
+  weights[0] = -1.0;
+  TEST_ASSERT_FALSE(secret_distribution_use_weights(weights));
+}
+
+void test_allow_list_file_limits_answers_and_hints(void) {
+  const char *path = "build/test_secrets.txt";
+  FILE *file = fopen(path, "w");
+  TEST_ASSERT_NOT_NULL(file);
+  fprintf(file, "# allow list\nABCD\nFEDC 2.5\n\nAAAA\n");
+  fclose(file);
+  game_logic_values_t abcd[] = {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR};
+
+  TEST_ASSERT_TRUE(secret_distribution_load_file(path));
+  game_logic_move_t history[] = {{.guess = {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR}}};
+  history[0].feedback = game_logic_score(abcd, history[0].guess);
+  solver_hint_t hint = secret_distribution_get_hint(history, 1);
+  remove(path);
+
+  TEST_ASSERT_EQUAL_UINT16(1, hint.remaining_candidates);
+  TEST_ASSERT_EQUAL_UINT16(game_logic_pack_code(abcd), hint.best_guess);
+}
+
+void test_malformed_file_is_rejected(void) {
+  const char *path = "build/test_secrets.txt";
+  FILE *file = fopen(path, "w");
+  TEST_ASSERT_NOT_NULL(file);
+  fprintf(file, "ABCZ\n");
+  fclose(file);
+
+  TEST_ASSERT_FALSE(secret_distribution_load_file(path));
+  TEST_ASSERT_FALSE(secret_distribution_load_file("build/does_not_exist.txt"));
+  remove(path);
+}
+
+void test_trailing_garbage_and_bad_weights_are_rejected(void) {
+  const char *path = "build/test_secrets.txt";
+  const char *contents[] = {"ABCDE\n", "ABCD 2x\n", "ABCD 0\n", "ABCD -1\n", "ABCD nan\n", "ABCD 1 2\n"};
+  for (size_t i = 0; i < sizeof(contents) / sizeof(contents[0]); i++) {
+    FILE *file = fopen(path, "w");
+    TEST_ASSERT_NOT_NULL(file);
+    fputs(contents[i], file);
+    fclose(file);
+    TEST_ASSERT_FALSE_MESSAGE(secret_distribution_load_file(path), contents[i]);
+  }
+
+  // the tail past the buffer must not come back as a code of its own
+  FILE *file = fopen(path, "w");
+  TEST_ASSERT_NOT_NULL(file);
+  fprintf(file, "ABCD %*s\nFEDC\n", 80, "1");
+  fclose(file);
+  TEST_ASSERT_FALSE(secret_distribution_load_file(path));
+
+  file = fopen(path, "w");
+  TEST_ASSERT_NOT_NULL(file);
+  fprintf(file, "ABCD\t3\r\nFEDC");
+  fclose(file);
+  TEST_ASSERT_TRUE(secret_distribution_load_file(path));
+  remove(path);
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_no_duplicates_answers_never_repeat_a_value);
+    RUN_TEST(test_no_duplicates_restricts_the_code_space);
+    RUN_TEST(test_weighted_draws_follow_the_weights);
+    RUN_TEST(test_invalid_weights_are_rejected);
+    RUN_TEST(test_allow_list_file_limits_answers_and_hints);
+    RUN_TEST(test_malformed_file_is_rejected);
+    RUN_TEST(test_trailing_garbage_and_bad_weights_are_rejected);
+  return UNITY_END();
+}
\ No newline at end of file
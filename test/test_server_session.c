@@ -0,0 +1,300 @@
+#include "unity.h"
+#include "game_logic.h"
+#include "server_session.h"
+#include "random.h"
+#include <stdio.h>
+#include <string.h>
+
+// every answer is AAAA
+int random_value(void) {
+  return 0;
+}
+
+static server_session_t session;
+static server_session_shard_t shard;
+
+static void feed(const char *text) {
+  size_t length = strlen(text);
+  memcpy(session.input + session.input_length, text, length);
+  session.input_length += length;
+  server_session_process_input(&session);
+}
+
+static void assert_output(const char *expected) {
+  TEST_ASSERT_EQUAL_size_t(strlen(expected), session.output_length);
+  if (session.output_length > 0) {
+    TEST_ASSERT_EQUAL_MEMORY(expected, session.output, session.output_length);
+  }
+  server_session_consume_output(&session, session.output_length);
+}
+
+void setUp(void) {
+  memset(&shard, 0, sizeof(shard));
+  server_session_init(&session, -1, &shard);
+}
+
+void tearDown(void) {}
+
+void test_plays_a_game_to_the_end(void) {
+  feed("NEW\nGUESS ABCD\nGUESS AAAA\n");
+  assert_output("READY 8\nFEEDBACK 1 0\nWON 2\n");
+  TEST_ASSERT_FALSE(session.games[0].is_playing);
+
+  feed("NEW\n");
+  for (int i = 0; i < SERVER_SESSION_MAXIMUM_NUMBER_OF_TRIES - 1; i++) {
+    feed("GUESS BBBB\n");
+  }
+  server_session_consume_output(&session, session.output_length);
+  feed("GUESS BBBB\nGIVEUP\n");
+  assert_output("LOST AAAA\nERR NO_GAME\n");
+}
+
+void test_lines_can_arrive_in_pieces(void) {
+  feed("NE");
+  assert_output("");
+  feed("W\r\nGUE");
+  assert_output("READY 8\n");
+  feed("SS AABB\r\n\nGIVEUP\n");
+  assert_output("FEEDBACK 2 0\nANSWER AAAA\n");
+}
+
+void test_reports_errors_without_ending_the_game(void) {
+  feed("GUESS ABCD\nNEW EASY\nNEW\nGUESS ABC\nGUESS ABCG\nHELLO\nGUESS AAAA\n");
+  assert_output("ERR NO_GAME\nERR BAD_ARGUMENT\nREADY 8\nERR BAD_GUESS\nERR BAD_GUESS\nERR UNKNOWN_COMMAND\nWON 1\n");
+}
+
+void test_hard_mode_refuses_inconsistent_guess(void) {
+  feed("NEW HARD\nGUESS BBBB\nGUESS ABBB\nGUESS ACCC\n");
+  assert_output("READY 8\nFEEDBACK 0 0\nERR HARD_MODE\nFEEDBACK 1 0\n");
+}
+
+void test_overlong_line_is_reported_once_and_skipped(void) {
+  char line[SERVER_SESSION_INPUT_SIZE + 1];
+  memset(line, 'X', SERVER_SESSION_INPUT_SIZE);
+  line[SERVER_SESSION_INPUT_SIZE] = '\0';
+  feed(line);
+  assert_output("ERR LINE_TOO_LONG\n");
+  feed("XXXX\nQUIT\nNEW\n");
+  assert_output("BYE\n");
+  TEST_ASSERT_FALSE(server_session_wants_input(&session));
+}
+
+void test_stops_handling_lines_while_the_output_is_full(void) {
+  feed("NEW\n");
+  session.output_length = SERVER_SESSION_OUTPUT_SIZE - SERVER_SESSION_MAXIMUM_RESPONSE + 1;
+  feed("GIVEUP\n");
+  TEST_ASSERT_EQUAL_size_t(strlen("GIVEUP\n"), session.input_length);
+
+  server_session_consume_output(&session, session.output_length);
+  server_session_process_input(&session);
+  assert_output("ANSWER AAAA\n");
+  TEST_ASSERT_TRUE(server_session_wants_input(&session));
+}
+
+void test_counts_into_the_shard_stats(void) {
+  feed("NEW\nGUESS ABCD\nGUESS AAAA\nGIVEUP\n");
+  TEST_ASSERT_EQUAL_UINT64(1, shard.stats.games_started);
+  TEST_ASSERT_EQUAL_UINT64(1, shard.stats.games_won);
+  TEST_ASSERT_EQUAL_UINT64(2, shard.stats.guesses);
+  TEST_ASSERT_EQUAL_UINT64(1, shard.stats.errors);
+}
+
+void test_seeded_shard_draws_answers_from_its_own_stream(void) {
+  server_session_shard_t seeded = {.random_state = 12345};
+  server_session_init(&session, -1, &seeded);
+  feed("NEW\n");
+  uint32_t state_after_first_game = seeded.random_state;
+  feed("NEW\n");
+
+  // random_value() would have given AAAA both times
+  TEST_ASSERT_NOT_EQUAL(12345, state_after_first_game);
+  TEST_ASSERT_NOT_EQUAL(state_after_first_game, seeded.random_state);
+  TEST_ASSERT_EQUAL_UINT64(2, seeded.stats.games_started);
+  TEST_ASSERT_EQUAL_UINT64(0, shard.stats.games_started);
+}
+
+static void feed_frame(uint8_t operation, uint8_t game, game_logic_code_t code) {
+  uint8_t frame[SERVER_SESSION_FRAME_SIZE] = {operation, game, (uint8_t)(code & 0xFF), (uint8_t)(code >> 8)};
+  memcpy(session.input + session.input_length, frame, sizeof(frame));
+  session.input_length += sizeof(frame);
+}
+
+void test_binary_protocol_answers_pipelined_frames_in_one_batch(void) {
+  game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS] = {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO};
+  game_logic_values_t answer[NUMBER_OF_VALUES_TO_GUESS] = {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_ONE};
+  // the negotiation and the first frames arrive in the same read
+  memcpy(session.input, "PROTOCOL BINARY\n", 16);
+  session.input_length = 16;
+  feed_frame(SERVER_SESSION_OPERATION_NEW, 0, 0);
+  feed_frame(SERVER_SESSION_OPERATION_NEW, 3, 0);
+  feed_frame(SERVER_SESSION_OPERATION_GUESS, 0, game_logic_pack_code(guess));
+  feed_frame(SERVER_SESSION_OPERATION_GUESS, 3, game_logic_pack_code(answer));
+  feed_frame(SERVER_SESSION_OPERATION_GUESS, 3, game_logic_pack_code(answer));
+  feed_frame(SERVER_SESSION_OPERATION_GIVEUP, 0, 0);
+  feed_frame(SERVER_SESSION_OPERATION_GUESS, 1, NUMBER_OF_POSSIBLE_CODES);
+  feed_frame(SERVER_SESSION_OPERATION_GUESS, SERVER_SESSION_MAXIMUM_GAMES, 0);
+  // half a frame waits for the rest
+  memcpy(session.input + session.input_length, "\x05", 1);
+  session.input_length++;
+  server_session_process_input(&session);
+
+  const char expected[] = {'B', 'I', 'N', 'A', 'R', 'Y', ' ', '4', '\n', (char) SERVER_SESSION_REPLY_READY,
+    (char) SERVER_SESSION_REPLY_READY, 2 * (NUMBER_OF_VALUES_TO_GUESS + 1), (char) game_logic_feedback_to_class(game_logic_score(answer, answer)),
+    (char) SERVER_SESSION_REPLY_NO_GAME, (char) SERVER_SESSION_REPLY_GAVE_UP, (char) SERVER_SESSION_REPLY_BAD_GUESS,
+    (char) SERVER_SESSION_REPLY_BAD_REQUEST};
+  TEST_ASSERT_EQUAL_size_t(sizeof(expected), session.output_length);
+  TEST_ASSERT_EQUAL_MEMORY(expected, session.output, sizeof(expected));
+  TEST_ASSERT_EQUAL_size_t(1, session.input_length);
+  TEST_ASSERT_EQUAL_UINT64(3, shard.stats.errors);
+
+  server_session_consume_output(&session, session.output_length);
+  // the rest of the QUIT frame
+  memset(session.input + session.input_length, 0, 3);
+  session.input_length += 3;
+  server_session_process_input(&session);
+  assert_output("\xF2");
+  TEST_ASSERT_FALSE(server_session_wants_input(&session));
+}
+
+static void start_timed_session(uint32_t idle_timeout, uint32_t move_timeout) {
+  shard.timers = timer_wheel_create(0);
+  shard.idle_timeout = idle_timeout;
+  shard.move_timeout = move_timeout;
+  server_session_init(&session, -1, &shard);
+}
+
+static void stop_timed_session(void) {
+  server_session_release(&session);
+  TEST_ASSERT_EQUAL_size_t(0, timer_wheel_number_of_timers(shard.timers));
+  timer_wheel_destroy(shard.timers);
+}
+
+void test_move_clock_ends_a_game_that_waits_too_long(void) {
+  start_timed_session(0, 1000);
+  feed("NEW\nGUESS ABCD\n");
+  assert_output("READY 8\nFEEDBACK 1 0\n");
+
+  // every guess restarts the clock
+  TEST_ASSERT_NULL(server_session_run_timers(&shard, 999));
+  feed("GUESS BBBB\n");
+  assert_output("FEEDBACK 0 0\n");
+  TEST_ASSERT_NULL(server_session_run_timers(&shard, 1999));
+  TEST_ASSERT_TRUE(session.games[0].is_playing);
+  TEST_ASSERT_NULL(server_session_run_timers(&shard, 2000));
+  TEST_ASSERT_FALSE(session.games[0].is_playing);
+  TEST_ASSERT_EQUAL_UINT64(1, shard.stats.move_timeouts);
+  assert_output("");
+
+  feed("GUESS AAAA\nGUESS AAAA\nNEW\nGUESS AAAA\n");
+  assert_output("TIMEOUT AAAA\nERR NO_GAME\nREADY 8\nWON 1\n");
+  stop_timed_session();
+}
+
+void test_idle_session_is_closed_after_its_last_input(void) {
+  start_timed_session(5000, 0);
+  TEST_ASSERT_NULL(server_session_run_timers(&shard, 3000));
+  feed("NEW\n");
+  assert_output("READY 8\n");
+
+  // the first expiry only moves the timer to five seconds after the input
+  TEST_ASSERT_NULL(server_session_run_timers(&shard, 5000));
+  int wait = server_session_timer_wait(&shard, 5000);
+  TEST_ASSERT_TRUE(wait > 0 && wait <= 3001);
+  TEST_ASSERT_NULL(server_session_run_timers(&shard, 8000));
+  TEST_ASSERT_EQUAL_PTR(&session, server_session_run_timers(&shard, 8001));
+  TEST_ASSERT_NULL(session.next_timed_out);
+  TEST_ASSERT_TRUE(session.is_closing);
+  TEST_ASSERT_EQUAL_UINT64(1, shard.stats.idle_timeouts);
+  TEST_ASSERT_EQUAL_INT(-1, server_session_timer_wait(&shard, 8001));
+  stop_timed_session();
+}
+
+void test_saved_games_are_resumed_with_their_token(void) {
+  feed("NEW HARD\nGUESS AABB\nTOKEN\n");
+  TEST_ASSERT_TRUE(session.token != 0);
+  char token_line[64];
+  snprintf(token_line, sizeof(token_line), "READY 8\nFEEDBACK 2 0\nTOKEN %016llx\n", (unsigned long long) session.token);
+  assert_output(token_line);
+
+  session_snapshot_game_t games[SERVER_SESSION_MAXIMUM_GAMES];
+  TEST_ASSERT_EQUAL_size_t(1, server_session_save(&session, games));
+  session_snapshot_writer_t *writer = session_snapshot_writer_create();
+  session_snapshot_writer_add(writer, &games[0]);
+  TEST_ASSERT_TRUE(session_snapshot_writer_commit(writer, "build/test_server_session.snapshot"));
+  session_snapshot_writer_destroy(writer);
+
+  // a fresh session after the restart
+  uint64_t token = session.token;
+  memset(&shard, 0, sizeof(shard));
+  shard.restored = session_snapshot_open("build/test_server_session.snapshot");
+  TEST_ASSERT_NOT_NULL(shard.restored);
+  server_session_init(&session, -1, &shard);
+  char resume_line[64];
+  snprintf(resume_line, sizeof(resume_line), "RESUME %016llx\n", (unsigned long long) token);
+  feed(resume_line);
+  feed("GUESS CCCC\nGUESS AAAA\n");
+  feed(resume_line);
+  assert_output("RESUMED 1\nERR HARD_MODE\nWON 2\nERR UNKNOWN_TOKEN\n");
+  session_snapshot_close(shard.restored);
+  remove("build/test_server_session.snapshot");
+}
+
+static game_journal_record_t journaled[8];
+static size_t number_of_journaled;
+
+static void collect_record(const game_journal_record_t *record, void *argument) {
+  (void) argument;
+  if (number_of_journaled < 8) {
+    journaled[number_of_journaled] = *record;
+  }
+  number_of_journaled++;
+}
+
+void test_games_are_journaled_until_they_end(void) {
+  remove("build/test_server_session.journal");
+  game_journal_t *journal = game_journal_open("build/test_server_session.journal", (game_journal_options_t) {0}, 1);
+  TEST_ASSERT_NOT_NULL(journal);
+  shard.journal = game_journal_get_writer(journal, 0);
+  shard.next_game_id = 1;
+  shard.game_id_stride = 1;
+  feed("TOKEN\nNEW\nGUESS AABB\nGIVEUP\nNEW HARD\nGUESS BBBB\n");
+  game_journal_close(journal);
+
+  number_of_journaled = 0;
+  game_journal_recovery_t recovery;
+  TEST_ASSERT_TRUE(game_journal_replay("build/test_server_session.journal", collect_record, NULL, &recovery));
+  TEST_ASSERT_EQUAL_size_t(5, number_of_journaled);
+  TEST_ASSERT_EQUAL_UINT8(GAME_JOURNAL_EVENT_NEW, journaled[0].event);
+  TEST_ASSERT_EQUAL_UINT64(session.token, journaled[0].token);
+  TEST_ASSERT_EQUAL_UINT8(GAME_JOURNAL_EVENT_GUESS, journaled[1].event);
+  TEST_ASSERT_EQUAL_UINT8(2, journaled[1].correct_value_and_placement);
+  TEST_ASSERT_EQUAL_UINT8(GAME_JOURNAL_EVENT_END, journaled[2].event);
+  TEST_ASSERT_EQUAL_UINT8(GAME_JOURNAL_END_GAVE_UP, journaled[2].end_reason);
+  TEST_ASSERT_EQUAL_UINT64(2, journaled[3].game_id);
+  TEST_ASSERT_EQUAL_UINT8(1, journaled[3].is_hard_mode);
+
+  session_snapshot_writer_t *writer = session_snapshot_writer_create();
+  TEST_ASSERT_TRUE(game_journal_recover("build/test_server_session.journal", writer, game_journal_clock(), 0, &recovery));
+  TEST_ASSERT_EQUAL_UINT64(1, recovery.games_recovered);
+  session_snapshot_writer_destroy(writer);
+  remove("build/test_server_session.journal");
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_plays_a_game_to_the_end);
+    RUN_TEST(test_lines_can_arrive_in_pieces);
+    RUN_TEST(test_reports_errors_without_ending_the_game);
+    RUN_TEST(test_hard_mode_refuses_inconsistent_guess);
+    RUN_TEST(test_overlong_line_is_reported_once_and_skipped);
+    RUN_TEST(test_stops_handling_lines_while_the_output_is_full);
+    RUN_TEST(test_counts_into_the_shard_stats);
+    RUN_TEST(test_seeded_shard_draws_answers_from_its_own_stream);
+    RUN_TEST(test_binary_protocol_answers_pipelined_frames_in_one_batch);
+    RUN_TEST(test_move_clock_ends_a_game_that_waits_too_long);
+    RUN_TEST(test_idle_session_is_closed_after_its_last_input);
+    RUN_TEST(test_saved_games_are_resumed_with_their_token);
+    RUN_TEST(test_games_are_journaled_until_they_end);
+  return UNITY_END();
+}
\ No newline at end of file
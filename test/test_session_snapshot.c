@@ -0,0 +1,138 @@
+#include "unity.h"
+#include "session_snapshot.h"
+#include <stdio.h>
+
+#define SNAPSHOT_PATH "build/test_sessions.snapshot"
+#define NUMBER_OF_SESSIONS 1000
+
+int random_value(void) {
+  return 0;
+}
+
+static session_snapshot_writer_t *writer;
+
+void setUp(void) {
+  writer = session_snapshot_writer_create();
+}
+
+void tearDown(void) {
+  session_snapshot_writer_destroy(writer);
+  remove(SNAPSHOT_PATH);
+}
+
+static session_snapshot_game_t make_game(uint64_t token, uint8_t slot) {
+  session_snapshot_game_t game = {.token = token, .slot = slot, .tries = 2, .answer = (game_logic_code_t)(token % NUMBER_OF_POSSIBLE_CODES)};
+  game.history[0] = 7;
+  game.history[1] = (game_logic_code_t) slot;
+  return game;
+}
+
+void test_games_are_claimed_back_exactly_once(void) {
+  for (uint64_t token = 1; token <= NUMBER_OF_SESSIONS; token++) {
+    for (uint8_t slot = 0; slot < token % 3; slot++) {
+      session_snapshot_game_t game = make_game(token * 0x10001, slot);
+      TEST_ASSERT_TRUE(session_snapshot_writer_add(writer, &game));
+    }
+  }
+  size_t number_of_games = session_snapshot_writer_number_of_games(writer);
+  TEST_ASSERT_TRUE(session_snapshot_writer_commit(writer, SNAPSHOT_PATH));
+
+  session_snapshot_t *snapshot = session_snapshot_open(SNAPSHOT_PATH);
+  TEST_ASSERT_NOT_NULL(snapshot);
+  TEST_ASSERT_EQUAL_size_t(number_of_games, session_snapshot_number_of_games(snapshot));
+  for (uint64_t token = 1; token <= NUMBER_OF_SESSIONS; token++) {
+    for (uint8_t slot = 0; slot < 3; slot++) {
+      const session_snapshot_game_t *game = session_snapshot_claim(snapshot, token * 0x10001, slot);
+      if (slot >= token % 3) {
+        TEST_ASSERT_NULL(game);
+        continue;
+      }
+      TEST_ASSERT_NOT_NULL(game);
+      TEST_ASSERT_EQUAL_UINT16(token * 0x10001 % NUMBER_OF_POSSIBLE_CODES, game->answer);
+      TEST_ASSERT_EQUAL_UINT8(2, game->tries);
+      TEST_ASSERT_EQUAL_UINT16(slot, game->history[1]);
+      TEST_ASSERT_NULL(session_snapshot_claim(snapshot, token * 0x10001, slot));
+    }
+  }
+  session_snapshot_close(snapshot);
+}
+
+void test_random_states_are_kept(void) {
+  uint32_t states[] = {11, 22, 33};
+  session_snapshot_writer_set_random_states(writer, states, 3);
+  TEST_ASSERT_TRUE(session_snapshot_writer_commit(writer, SNAPSHOT_PATH));
+
+  session_snapshot_t *snapshot = session_snapshot_open(SNAPSHOT_PATH);
+  TEST_ASSERT_NOT_NULL(snapshot);
+  TEST_ASSERT_EQUAL_UINT32(22, session_snapshot_random_state(snapshot, 1));
+  TEST_ASSERT_EQUAL_UINT32(0, session_snapshot_random_state(snapshot, 3));
+  TEST_ASSERT_EQUAL_size_t(0, session_snapshot_number_of_games(snapshot));
+  TEST_ASSERT_NULL(session_snapshot_claim(snapshot, 1, 0));
+  session_snapshot_close(snapshot);
+}
+
+void test_unclaimed_games_carry_over_unless_idle_too_long(void) {
+  session_snapshot_game_t claimed = make_game(1, 0);
+  session_snapshot_game_t parked = make_game(2, 0);
+  session_snapshot_game_t stale = make_game(3, 0);
+  stale.idle_milliseconds = 60000;
+  session_snapshot_writer_add(writer, &claimed);
+  session_snapshot_writer_add(writer, &parked);
+  session_snapshot_writer_add(writer, &stale);
+  TEST_ASSERT_TRUE(session_snapshot_writer_commit(writer, SNAPSHOT_PATH));
+  session_snapshot_t *snapshot = session_snapshot_open(SNAPSHOT_PATH);
+  TEST_ASSERT_NOT_NULL(session_snapshot_claim(snapshot, 1, 0));
+
+  session_snapshot_writer_t *next = session_snapshot_writer_create();
+  TEST_ASSERT_TRUE(session_snapshot_add_unclaimed(snapshot, next, 30000));
+  session_snapshot_close(snapshot);
+  TEST_ASSERT_EQUAL_size_t(1, session_snapshot_writer_number_of_games(next));
+  TEST_ASSERT_TRUE(session_snapshot_writer_commit(next, SNAPSHOT_PATH));
+  session_snapshot_writer_destroy(next);
+
+  snapshot = session_snapshot_open(SNAPSHOT_PATH);
+  TEST_ASSERT_NOT_NULL(session_snapshot_claim(snapshot, 2, 0));
+  TEST_ASSERT_NULL(session_snapshot_claim(snapshot, 3, 0));
+  session_snapshot_close(snapshot);
+}
+
+void test_foreign_files_are_rejected(void) {
+  FILE *file = fopen(SNAPSHOT_PATH, "w");
+  TEST_ASSERT_NOT_NULL(file);
+  for (int i = 0; i < 1000; i++) {
+    fputs("not a snapshot\n", file);
+  }
+  fclose(file);
+
+  TEST_ASSERT_NULL(session_snapshot_open(SNAPSHOT_PATH));
+  TEST_ASSERT_NULL(session_snapshot_open("build/missing.snapshot"));
+}
+
+void test_tables_without_an_empty_bucket_are_rejected(void) {
+  session_snapshot_game_t game = make_game(5, 0);
+  TEST_ASSERT_TRUE(session_snapshot_writer_add(writer, &game));
+  TEST_ASSERT_TRUE(session_snapshot_writer_commit(writer, SNAPSHOT_PATH));
+  session_snapshot_t *snapshot = session_snapshot_open(SNAPSHOT_PATH);
+  TEST_ASSERT_NOT_NULL(snapshot);
+  session_snapshot_close(snapshot);
+
+  // one game makes a table of two buckets at the end of the file, fill both
+  FILE *file = fopen(SNAPSHOT_PATH, "r+b");
+  TEST_ASSERT_NOT_NULL(file);
+  session_snapshot_game_t games[2] = {make_game(6, 0), make_game(7, 0)};
+  TEST_ASSERT_EQUAL_INT(0, fseek(file, -(long) sizeof(games), SEEK_END));
+  TEST_ASSERT_EQUAL_size_t(2, fwrite(games, sizeof(games[0]), 2, file));
+  fclose(file);
+
+  TEST_ASSERT_NULL(session_snapshot_open(SNAPSHOT_PATH));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_games_are_claimed_back_exactly_once);
+  RUN_TEST(test_random_states_are_kept);
+  RUN_TEST(test_unclaimed_games_carry_over_unless_idle_too_long);
+  RUN_TEST(test_foreign_files_are_rejected);
+  RUN_TEST(test_tables_without_an_empty_bucket_are_rejected);
+  return UNITY_END();
+}
\ No newline at end of file
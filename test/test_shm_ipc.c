@@ -0,0 +1,124 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+#include "shm_ipc.h"
+#include "server_session.h"
+#include "random.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#define NUMBER_OF_PIPELINED_FRAMES 5000
+
+// the server draws answers from its own stream
+int random_value(void) {
+  return 0;
+}
+
+static char name[64];
+static shm_ipc_server_t *server;
+static pthread_t server_thread;
+
+static void* run_server(void *argument) {
+  shm_ipc_server_run(argument);
+  return NULL;
+}
+
+static void submit(shm_ipc_client_t *client, uint8_t operation, game_logic_code_t code) {
+  uint8_t frame[SERVER_SESSION_FRAME_SIZE] = {operation, 0, (uint8_t)(code & 0xFF), (uint8_t)(code >> 8)};
+  TEST_ASSERT_TRUE(shm_ipc_client_submit(client, frame));
+}
+
+static uint8_t receive_one(shm_ipc_client_t *client) {
+  uint8_t reply;
+  TEST_ASSERT_EQUAL_size_t(1, shm_ipc_client_receive(client, &reply, 1, true));
+  return reply;
+}
+
+void setUp(void) {
+  snprintf(name, sizeof(name), "/mastermind-test-%ld", (long) getpid());
+  server = shm_ipc_server_create(name);
+  TEST_ASSERT_NOT_NULL(server);
+}
+
+void tearDown(void) {
+  shm_ipc_server_destroy(server);
+}
+
+void test_client_plays_through_shared_memory(void) {
+  pthread_create(&server_thread, NULL, run_server, server);
+  shm_ipc_client_t *client = shm_ipc_client_connect(name);
+  TEST_ASSERT_NOT_NULL(client);
+
+  submit(client, SERVER_SESSION_OPERATION_NEW, 0);
+  submit(client, SERVER_SESSION_OPERATION_GUESS, 0);
+  submit(client, SERVER_SESSION_OPERATION_GIVEUP, 0);
+  TEST_ASSERT_EQUAL_HEX8(SERVER_SESSION_REPLY_READY, receive_one(client));
+  uint8_t feedback_class = receive_one(client);
+  TEST_ASSERT_LESS_THAN(NUMBER_OF_FEEDBACK_CLASSES, feedback_class);
+  bool is_won = game_logic_feedback_from_class(feedback_class).is_guess_correct;
+  TEST_ASSERT_EQUAL_HEX8(is_won ? SERVER_SESSION_REPLY_NO_GAME : SERVER_SESSION_REPLY_GAVE_UP, receive_one(client));
+
+  shm_ipc_client_disconnect(client);
+  shm_ipc_server_stop(server);
+  pthread_join(server_thread, NULL);
+}
+
+void test_pipelined_frames_wrap_around_the_rings(void) {
+  pthread_create(&server_thread, NULL, run_server, server);
+  shm_ipc_client_t *client = shm_ipc_client_connect(name);
+  TEST_ASSERT_NOT_NULL(client);
+
+  size_t submitted = 0;
+  size_t received = 0;
+  while (received < NUMBER_OF_PIPELINED_FRAMES) {
+    uint8_t frame[SERVER_SESSION_FRAME_SIZE] = {submitted % 2 == 0 ? SERVER_SESSION_OPERATION_NEW : SERVER_SESSION_OPERATION_GIVEUP};
+    while (submitted < NUMBER_OF_PIPELINED_FRAMES && shm_ipc_client_submit(client, frame)) {
+      submitted++;
+      frame[0] = submitted % 2 == 0 ? SERVER_SESSION_OPERATION_NEW : SERVER_SESSION_OPERATION_GIVEUP;
+    }
+    uint8_t replies[SHM_IPC_REPLY_RING_SIZE];
+    size_t length = shm_ipc_client_receive(client, replies, sizeof(replies), true);
+    for (size_t i = 0; i < length; i++, received++) {
+      TEST_ASSERT_EQUAL_HEX8(received % 2 == 0 ? SERVER_SESSION_REPLY_READY : SERVER_SESSION_REPLY_GAVE_UP, replies[i]);
+    }
+  }
+  TEST_ASSERT_EQUAL_size_t(NUMBER_OF_PIPELINED_FRAMES, submitted);
+
+  shm_ipc_client_disconnect(client);
+  shm_ipc_server_stop(server);
+  pthread_join(server_thread, NULL);
+}
+
+void test_slots_are_reused_after_disconnect(void) {
+  static shm_ipc_client_t *clients[SHM_IPC_MAXIMUM_CLIENTS];
+  for (size_t i = 0; i < SHM_IPC_MAXIMUM_CLIENTS; i++) {
+    clients[i] = shm_ipc_client_connect(name);
+    TEST_ASSERT_NOT_NULL(clients[i]);
+  }
+  TEST_ASSERT_NULL(shm_ipc_client_connect(name));
+
+  shm_ipc_client_disconnect(clients[3]);
+  // the slot only becomes free once the server has reset it
+  TEST_ASSERT_NULL(shm_ipc_client_connect(name));
+  shm_ipc_server_poll(server);
+  clients[3] = shm_ipc_client_connect(name);
+  TEST_ASSERT_NOT_NULL(clients[3]);
+
+  for (size_t i = 0; i < SHM_IPC_MAXIMUM_CLIENTS; i++) {
+    shm_ipc_client_disconnect(clients[i]);
+  }
+}
+
+void test_connect_fails_without_a_server(void) {
+  TEST_ASSERT_NULL(shm_ipc_client_connect("/mastermind-test-missing"));
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_client_plays_through_shared_memory);
+    RUN_TEST(test_pipelined_frames_wrap_around_the_rings);
+    RUN_TEST(test_slots_are_reused_after_disconnect);
+    RUN_TEST(test_connect_fails_without_a_server);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "unity.h"
+#include "slab.h"
+
+#define CAPACITY 4
+
+int random_value(void) {
+  return 0;
+}
+
+static slab_t *slab;
+
+void setUp(void) {
+  slab = slab_create("test", 100, CAPACITY);
+}
+
+void tearDown(void) {
+  slab_destroy(slab);
+}
+
+void test_objects_are_cache_line_sized(void) {
+  slab_stats_t stats = slab_get_stats(slab);
+
+  TEST_ASSERT_EQUAL_STRING("test", stats.name);
+  TEST_ASSERT_EQUAL(128, stats.object_size);
+  TEST_ASSERT_EQUAL(CAPACITY, stats.capacity);
+  TEST_ASSERT_TRUE(stats.memory_reserved >= CAPACITY * 128);
+}
+
+void test_alloc_fails_once_full(void) {
+  char *objects[CAPACITY];
+  for (size_t i = 0; i < CAPACITY; i++) {
+    objects[i] = slab_alloc(slab, NULL);
+    TEST_ASSERT_NOT_NULL(objects[i]);
+    for (size_t j = 0; j < i; j++) {
+      TEST_ASSERT_TRUE(objects[i] != objects[j]);
+    }
+  }
+
+  TEST_ASSERT_NULL(slab_alloc(slab, NULL));
+  slab_stats_t stats = slab_get_stats(slab);
+  TEST_ASSERT_EQUAL(CAPACITY, stats.in_use);
+  TEST_ASSERT_EQUAL(CAPACITY, stats.high_water);
+  TEST_ASSERT_EQUAL(CAPACITY, stats.allocations);
+  TEST_ASSERT_EQUAL(1, stats.exhausted);
+}
+
+void test_freed_object_is_reused_first(void) {
+  slab_handle_t first;
+  slab_handle_t second;
+  void *object = slab_alloc(slab, &first);
+  slab_alloc(slab, NULL);
+
+  TEST_ASSERT_TRUE(slab_free(slab, first));
+  TEST_ASSERT_EQUAL_PTR(object, slab_alloc(slab, &second));
+  TEST_ASSERT_TRUE(first != second);
+  TEST_ASSERT_EQUAL(2, slab_get_stats(slab).in_use);
+}
+
+void test_stale_handles_are_rejected(void) {
+  slab_handle_t handle;
+  void *object = slab_alloc(slab, &handle);
+
+  TEST_ASSERT_EQUAL_PTR(object, slab_get(slab, handle));
+  TEST_ASSERT_EQUAL_PTR(object, slab_object_at(slab, (uint32_t) handle));
+  TEST_ASSERT_NULL(slab_object_at(slab, CAPACITY - 1));
+  TEST_ASSERT_TRUE(slab_handle_of(slab, object) == handle);
+  TEST_ASSERT_TRUE(slab_free(slab, handle));
+  TEST_ASSERT_NULL(slab_get(slab, handle));
+  TEST_ASSERT_FALSE(slab_free(slab, handle));
+  slab_alloc(slab, NULL);
+  TEST_ASSERT_NULL(slab_get(slab, handle));
+  TEST_ASSERT_NULL(slab_get(slab, SLAB_INVALID_HANDLE));
+  TEST_ASSERT_EQUAL(1, slab_get_stats(slab).in_use);
+}
+
+void test_invalid_sizes_are_rejected(void) {
+  TEST_ASSERT_NULL(slab_create("empty", 0, CAPACITY));
+  TEST_ASSERT_NULL(slab_create("empty", 64, 0));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_objects_are_cache_line_sized);
+  RUN_TEST(test_alloc_fails_once_full);
+  RUN_TEST(test_freed_object_is_reused_first);
+  RUN_TEST(test_stale_handles_are_rejected);
+  RUN_TEST(test_invalid_sizes_are_rejected);
+  return UNITY_END();
+}
\ No newline at end of file
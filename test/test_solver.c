@@ -0,0 +1,104 @@
+#include "unity.h"
+#include "game_logic.h"
+#include "solver.h"
+#include "random.h"
+
+// the solver never draws random values, but game_logic.c still links against it
+int random_value(void) {
+  return 0;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static game_logic_move_t make_move(const game_logic_values_t answer[], const game_logic_values_t guess[]) {
+  game_logic_move_t move;
+  for (size_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    move.guess[i] = guess[i];
+  }
+  move.feedback = game_logic_score(answer, guess);
+  return move;
+}
+
+void test_score_matches_game_feedback(void) {
+  game_logic_values_t answer[] = {GAME_VALUE_SIX, GAME_VALUE_TWO, GAME_VALUE_FIVE, GAME_VALUE_SIX};
+  game_logic_values_t guess[] = {GAME_VALUE_SIX, GAME_VALUE_TWO, GAME_VALUE_SIX, GAME_VALUE_FIVE};
+
+  game_logic_feedback_t feedback = game_logic_score(answer, guess);
+
+  TEST_ASSERT_EQUAL_UINT8(2, feedback.number_of_correct_value_only);
+  TEST_ASSERT_EQUAL_UINT8(2, feedback.number_of_correct_value_and_placement);
+}
+
+void test_pack_and_unpack_code_round_trip(void) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  for (game_logic_code_t code = 0; code < NUMBER_OF_POSSIBLE_CODES; code++) {
+    game_logic_unpack_code(code, values);
+    TEST_ASSERT_EQUAL_UINT16(code, game_logic_pack_code(values));
+  }
+}
+
+void test_feedback_class_round_trip(void) {
+  game_logic_feedback_t feedback = {.number_of_correct_value_only = 1, .number_of_correct_value_and_placement = 2};
+
+  game_logic_feedback_t decoded = game_logic_feedback_from_class(game_logic_feedback_to_class(feedback));
+
+  TEST_ASSERT_EQUAL_UINT8(1, decoded.number_of_correct_value_only);
+  TEST_ASSERT_EQUAL_UINT8(2, decoded.number_of_correct_value_and_placement);
+  TEST_ASSERT_FALSE(decoded.is_guess_correct);
+}
+
+void test_empty_history_keeps_every_code(void) {
+  solver_hint_t hint = solver_get_hint(NULL, 0);
+
+  TEST_ASSERT_EQUAL_UINT16(NUMBER_OF_POSSIBLE_CODES, hint.remaining_candidates);
+}
+
+void test_candidates_are_consistent_with_history(void) {
+  game_logic_values_t answer[] = {GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE, GAME_VALUE_FOUR};
+  game_logic_values_t guess[] = {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_TWO};
+  game_logic_move_t history[] = {make_move(answer, guess)};
+  game_logic_code_t candidates[NUMBER_OF_POSSIBLE_CODES];
+
+  size_t count = solver_filter_candidates(history, 1, candidates);
+
+  TEST_ASSERT_TRUE(count > 0);
+  for (size_t i = 0; i < count; i++) {
+    game_logic_values_t candidate[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(candidates[i], candidate);
+    game_logic_feedback_t feedback = game_logic_score(candidate, guess);
+    TEST_ASSERT_EQUAL_UINT8(history[0].feedback.number_of_correct_value_only, feedback.number_of_correct_value_only);
+    TEST_ASSERT_EQUAL_UINT8(history[0].feedback.number_of_correct_value_and_placement, feedback.number_of_correct_value_and_placement);
+  }
+}
+
+void test_solver_finds_answer_within_five_guesses(void) {
+  game_logic_values_t answer[] = {GAME_VALUE_SIX, GAME_VALUE_ONE, GAME_VALUE_FOUR, GAME_VALUE_SIX};
+  game_logic_move_t history[5];
+  size_t history_length = 0;
+  bool is_solved = false;
+
+  while (!is_solved && history_length < 5) {
+    solver_hint_t hint = solver_get_hint(history, history_length);
+    game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_unpack_code(hint.best_guess, guess);
+    history[history_length] = make_move(answer, guess);
+    is_solved = history[history_length].feedback.is_guess_correct;
+    history_length++;
+  }
+
+  TEST_ASSERT_TRUE(is_solved);
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_score_matches_game_feedback);
+    RUN_TEST(test_pack_and_unpack_code_round_trip);
+    RUN_TEST(test_feedback_class_round_trip);
+    RUN_TEST(test_empty_history_keeps_every_code);
+    RUN_TEST(test_candidates_are_consistent_with_history);
+    RUN_TEST(test_solver_finds_answer_within_five_guesses);
+  return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "unity.h"
+#include "game_logic.h"
+#include "static_solver.h"
+#include "random.h"
+#include <stdlib.h>
+
+int random_value(void) {
+  return 0;
+}
+
+static static_solver_result_t *result;
+
+void setUp(void) {
+  result = malloc(sizeof(static_solver_result_t));
+}
+
+void tearDown(void) {
+  free(result);
+}
+
+void test_single_guess_does_not_identify_every_answer(void) {
+  game_logic_code_t guesses[] = {0};
+
+  TEST_ASSERT_FALSE(static_solver_verify(guesses, 1));
+}
+
+void test_known_six_guess_set_identifies_every_answer(void) {
+  game_logic_values_t values[][NUMBER_OF_VALUES_TO_GUESS] = {
+    {GAME_VALUE_ONE, GAME_VALUE_ONE, GAME_VALUE_TWO, GAME_VALUE_THREE},
+    {GAME_VALUE_TWO, GAME_VALUE_FOUR, GAME_VALUE_FIVE, GAME_VALUE_THREE},
+    {GAME_VALUE_FIVE, GAME_VALUE_SIX, GAME_VALUE_SIX, GAME_VALUE_TWO},
+    {GAME_VALUE_THREE, GAME_VALUE_TWO, GAME_VALUE_SIX, GAME_VALUE_FOUR},
+    {GAME_VALUE_SIX, GAME_VALUE_FIVE, GAME_VALUE_THREE, GAME_VALUE_FIVE},
+    {GAME_VALUE_THREE, GAME_VALUE_FOUR, GAME_VALUE_FOUR, GAME_VALUE_FOUR},
+  };
+  game_logic_code_t guesses[sizeof(values) / sizeof(values[0])];
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    guesses[i] = game_logic_pack_code(values[i]);
+  }
+
+  TEST_ASSERT_TRUE(static_solver_verify(guesses, sizeof(values) / sizeof(values[0])));
+  TEST_ASSERT_FALSE(static_solver_verify(guesses, sizeof(values) / sizeof(values[0]) - 1));
+}
+
+void test_solution_is_verified_and_decodes_every_answer(void) {
+  static_solver_config_t config = {.number_of_threads = 2, .iterations_per_size = 2000, .seed = 1234};
+
+  TEST_ASSERT_TRUE(static_solver_solve(&config, result));
+  TEST_ASSERT_TRUE(result->number_of_guesses <= STATIC_SOLVER_MAXIMUM_GUESSES);
+  TEST_ASSERT_TRUE(static_solver_verify(result->guesses, result->number_of_guesses));
+
+  for (game_logic_code_t code = 0; code < NUMBER_OF_POSSIBLE_CODES; code++) {
+    game_logic_values_t secret[NUMBER_OF_VALUES_TO_GUESS];
+    game_logic_feedback_t feedback[STATIC_SOLVER_MAXIMUM_GUESSES];
+    game_logic_unpack_code(code, secret);
+    for (size_t i = 0; i < result->number_of_guesses; i++) {
+      game_logic_values_t guess[NUMBER_OF_VALUES_TO_GUESS];
+      game_logic_unpack_code(result->guesses[i], guess);
+      feedback[i] = game_logic_score(secret, guess);
+    }
+    game_logic_code_t decoded;
+    TEST_ASSERT_TRUE(static_solver_decode(result, feedback, &decoded));
+    TEST_ASSERT_EQUAL_UINT16(code, decoded);
+  }
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_single_guess_does_not_identify_every_answer);
+    RUN_TEST(test_known_six_guess_set_identifies_every_answer);
+    RUN_TEST(test_solution_is_verified_and_decodes_every_answer);
+  return UNITY_END();
+}
\ No newline at end of file
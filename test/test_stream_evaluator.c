@@ -0,0 +1,237 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+#include "stream_evaluator.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define INPUT_PATH "build/test_stream_input"
+#define OUTPUT_PATH "build/test_stream_output"
+#define SEED 12345
+#define SESSION_LINE_SIZE 16
+#define OUTPUT_SIZE 4096
+
+static const char value_characters[GAME_VALUE_MAX] = {'A', 'B', 'C', 'D', 'E', 'F'};
+
+int random_value(void) {
+  return 0;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+  remove(INPUT_PATH);
+  remove(OUTPUT_PATH);
+}
+
+static void format_code(game_logic_code_t code, char text[]) {
+  game_logic_values_t values[NUMBER_OF_VALUES_TO_GUESS];
+  game_logic_unpack_code(code, values);
+  for (size_t i = 0; i < NUMBER_OF_VALUES_TO_GUESS; i++) {
+    text[i] = value_characters[values[i]];
+  }
+}
+
+static size_t evaluate(stream_evaluator_t *evaluator, const char *input, char output[]) {
+  size_t output_length;
+  size_t used = stream_evaluator_evaluate_lines(evaluator, input, strlen(input), output, OUTPUT_SIZE, &output_length);
+  output[output_length] = '\0';
+  return used;
+}
+
+void test_secret_and_guess_lines_are_scored(void) {
+  stream_evaluator_t *evaluator = stream_evaluator_create(SEED);
+  TEST_ASSERT_NOT_NULL(evaluator);
+  for (game_logic_code_t secret = 0; secret < NUMBER_OF_POSSIBLE_CODES; secret += 7) {
+    for (game_logic_code_t guess = 0; guess < NUMBER_OF_POSSIBLE_CODES; guess += 11) {
+      char line[] = "AAAA AAAA\n";
+      format_code(secret, line);
+      format_code(guess, line + NUMBER_OF_VALUES_TO_GUESS + 1);
+      game_logic_values_t secret_values[NUMBER_OF_VALUES_TO_GUESS];
+      game_logic_values_t guess_values[NUMBER_OF_VALUES_TO_GUESS];
+      game_logic_unpack_code(secret, secret_values);
+      game_logic_unpack_code(guess, guess_values);
+      game_logic_feedback_t feedback = game_logic_score(secret_values, guess_values);
+      char expected[16];
+      snprintf(expected, sizeof(expected), "%d %d\n", feedback.number_of_correct_value_and_placement,
+               feedback.number_of_correct_value_only);
+      char output[OUTPUT_SIZE];
+      TEST_ASSERT_EQUAL_size_t(strlen(line), evaluate(evaluator, line, output));
+      TEST_ASSERT_EQUAL_STRING(expected, output);
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT64(0, stream_evaluator_get_stats(evaluator)->errors);
+  stream_evaluator_destroy(evaluator);
+}
+
+void test_bad_lines_are_answered_in_order(void) {
+  stream_evaluator_t *evaluator = stream_evaluator_create(SEED);
+  TEST_ASSERT_NOT_NULL(evaluator);
+  char output[OUTPUT_SIZE];
+  const char *input = "AABB ABCD\r\nAAGB ABCD\n\nAABB ABCDE\n99999999999999999999 ABCD\n-1 ABCD\nFFFF AAAA\n";
+  TEST_ASSERT_EQUAL_size_t(strlen(input), evaluate(evaluator, input, output));
+  TEST_ASSERT_EQUAL_STRING("1 1\nERR\nERR\nERR\nERR\nERR\n0 0\n", output);
+  TEST_ASSERT_EQUAL_UINT64(7, stream_evaluator_get_stats(evaluator)->requests);
+  TEST_ASSERT_EQUAL_UINT64(5, stream_evaluator_get_stats(evaluator)->errors);
+  stream_evaluator_destroy(evaluator);
+}
+
+void test_only_complete_lines_that_fit_the_output_are_used(void) {
+  stream_evaluator_t *evaluator = stream_evaluator_create(SEED);
+  TEST_ASSERT_NOT_NULL(evaluator);
+  const char *input = "AABB ABCD\nABCD ABCD\nABCD AB";
+  char output[OUTPUT_SIZE];
+  size_t output_length;
+  TEST_ASSERT_EQUAL_size_t(20, stream_evaluator_evaluate_lines(evaluator, input, strlen(input), output, OUTPUT_SIZE,
+                                                               &output_length));
+  TEST_ASSERT_EQUAL_size_t(2 * STREAM_EVALUATOR_MAXIMUM_REPLY, output_length);
+  // room for a single reply
+  TEST_ASSERT_EQUAL_size_t(10, stream_evaluator_evaluate_lines(evaluator, input, strlen(input), output,
+                                                               STREAM_EVALUATOR_MAXIMUM_REPLY + 1, &output_length));
+  TEST_ASSERT_EQUAL_size_t(STREAM_EVALUATOR_MAXIMUM_REPLY, output_length);
+  stream_evaluator_destroy(evaluator);
+}
+
+static game_logic_code_t find_first_secret(uint64_t session) {
+  char line[SESSION_LINE_SIZE];
+  char output[OUTPUT_SIZE];
+  for (game_logic_code_t code = 0; code < NUMBER_OF_POSSIBLE_CODES; code++) {
+    stream_evaluator_t *evaluator = stream_evaluator_create(SEED);
+    TEST_ASSERT_NOT_NULL(evaluator);
+    int length = snprintf(line, sizeof(line), "%llu AAAA\n", (unsigned long long) session);
+    format_code(code, line + length - NUMBER_OF_VALUES_TO_GUESS - 1);
+    evaluate(evaluator, line, output);
+    stream_evaluator_destroy(evaluator);
+    if (strcmp(output, "4 0\n") == 0) {
+      return code;
+    }
+  }
+  TEST_FAIL_MESSAGE("no secret found");
+  return 0;
+}
+
+void test_sessions_play_games_drawn_from_the_seed(void) {
+  game_logic_code_t secret = find_first_secret(42);
+  stream_evaluator_t *evaluator = stream_evaluator_create(SEED);
+  TEST_ASSERT_NOT_NULL(evaluator);
+  char line[] = "42 AAAA\n";
+  char output[OUTPUT_SIZE];
+  format_code(secret, line + 3);
+  evaluate(evaluator, line, output);
+  TEST_ASSERT_EQUAL_STRING("4 0\n", output);
+  // the win ended the game and the next guess plays another secret
+  evaluate(evaluator, line, output);
+  TEST_ASSERT_NOT_EQUAL(0, strcmp(output, "4 0\n"));
+  // other sessions have their own games
+  TEST_ASSERT_NOT_EQUAL(secret, find_first_secret(43));
+  TEST_ASSERT_EQUAL_UINT64(1, stream_evaluator_get_stats(evaluator)->sessions);
+  stream_evaluator_destroy(evaluator);
+}
+
+void test_a_game_ends_after_the_last_try(void) {
+  game_logic_code_t secret = find_first_secret(7);
+  game_logic_code_t wrong = (game_logic_code_t)((secret + 1) % NUMBER_OF_POSSIBLE_CODES);
+  stream_evaluator_t *evaluator = stream_evaluator_create(SEED);
+  TEST_ASSERT_NOT_NULL(evaluator);
+  char wrong_line[] = "7 AAAA\n";
+  char secret_line[] = "7 AAAA\n";
+  format_code(wrong, wrong_line + 2);
+  format_code(secret, secret_line + 2);
+  char output[OUTPUT_SIZE];
+  for (int i = 0; i < STREAM_EVALUATOR_MAXIMUM_NUMBER_OF_TRIES - 1; i++) {
+    evaluate(evaluator, wrong_line, output);
+  }
+  evaluate(evaluator, secret_line, output);
+  TEST_ASSERT_EQUAL_STRING("4 0\n", output);
+
+  stream_evaluator_t *lost = stream_evaluator_create(SEED);
+  TEST_ASSERT_NOT_NULL(lost);
+  for (int i = 0; i < STREAM_EVALUATOR_MAXIMUM_NUMBER_OF_TRIES; i++) {
+    evaluate(lost, wrong_line, output);
+  }
+  evaluate(lost, secret_line, output);
+  TEST_ASSERT_NOT_EQUAL(0, strcmp(output, "4 0\n"));
+  stream_evaluator_destroy(evaluator);
+  stream_evaluator_destroy(lost);
+}
+
+void test_frames_are_scored_and_bad_ones_flagged(void) {
+  stream_evaluator_t *evaluator = stream_evaluator_create(SEED);
+  TEST_ASSERT_NOT_NULL(evaluator);
+  game_logic_code_t secret = 1000;
+  game_logic_code_t guess = 77;
+  uint8_t input[] = {
+    secret & 0xFF, secret >> 8, guess & 0xFF, guess >> 8,
+    0xFF, 0xFF, 0, 0,
+    // an unfinished frame is left for later
+    1, 0
+  };
+  uint8_t output[2];
+  TEST_ASSERT_EQUAL_size_t(2 * STREAM_EVALUATOR_FRAME_SIZE,
+                           stream_evaluator_evaluate_frames(evaluator, input, sizeof(input), output));
+  TEST_ASSERT_EQUAL_UINT8(game_logic_score_row(guess)[secret], output[0]);
+  TEST_ASSERT_EQUAL_UINT8(STREAM_EVALUATOR_BAD_FRAME, output[1]);
+  TEST_ASSERT_EQUAL_UINT64(1, stream_evaluator_get_stats(evaluator)->errors);
+  stream_evaluator_destroy(evaluator);
+}
+
+static void write_file(const char *path, const char *data, size_t length) {
+  FILE *file = fopen(path, "wb");
+  TEST_ASSERT_NOT_NULL(file);
+  TEST_ASSERT_EQUAL_size_t(length, fwrite(data, 1, length, file));
+  fclose(file);
+}
+
+static size_t run_file(stream_evaluator_t *evaluator, char output[], size_t capacity) {
+  int input_fd = open(INPUT_PATH, O_RDONLY);
+  int output_fd = open(OUTPUT_PATH, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  TEST_ASSERT_TRUE(input_fd >= 0 && output_fd >= 0);
+  TEST_ASSERT_TRUE(stream_evaluator_run(evaluator, input_fd, output_fd, false));
+  close(input_fd);
+  close(output_fd);
+  FILE *file = fopen(OUTPUT_PATH, "rb");
+  TEST_ASSERT_NOT_NULL(file);
+  size_t length = fread(output, 1, capacity - 1, file);
+  output[length] = '\0';
+  fclose(file);
+  return length;
+}
+
+void test_lines_longer_than_the_buffer_are_one_error(void) {
+  size_t long_line = STREAM_EVALUATOR_BUFFER_SIZE + 100;
+  const char head[] = "ABCD ABCD\n";
+  const char tail[] = "\nAABB ABCD\nFFFF AAAA";
+  size_t length = sizeof(head) - 1 + long_line + sizeof(tail) - 1;
+  char *input = malloc(length);
+  TEST_ASSERT_NOT_NULL(input);
+  memcpy(input, head, sizeof(head) - 1);
+  memset(input + sizeof(head) - 1, 'A', long_line);
+  memcpy(input + sizeof(head) - 1 + long_line, tail, sizeof(tail) - 1);
+  write_file(INPUT_PATH, input, length);
+  free(input);
+
+  stream_evaluator_t *evaluator = stream_evaluator_create(SEED);
+  TEST_ASSERT_NOT_NULL(evaluator);
+  char output[OUTPUT_SIZE];
+  run_file(evaluator, output, sizeof(output));
+  // the last line is answered without a newline of its own
+  TEST_ASSERT_EQUAL_STRING("4 0\nERR\n1 1\n0 0\n", output);
+  TEST_ASSERT_EQUAL_UINT64(length, stream_evaluator_get_stats(evaluator)->bytes_read);
+  TEST_ASSERT_EQUAL_UINT64(strlen(output), stream_evaluator_get_stats(evaluator)->bytes_written);
+  stream_evaluator_destroy(evaluator);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_secret_and_guess_lines_are_scored);
+  RUN_TEST(test_bad_lines_are_answered_in_order);
+  RUN_TEST(test_only_complete_lines_that_fit_the_output_are_used);
+  RUN_TEST(test_sessions_play_games_drawn_from_the_seed);
+  RUN_TEST(test_a_game_ends_after_the_last_try);
+  RUN_TEST(test_frames_are_scored_and_bad_ones_flagged);
+  RUN_TEST(test_lines_longer_than_the_buffer_are_one_error);
+  return UNITY_END();
+}
\ No newline at end of file
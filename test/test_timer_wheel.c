@@ -0,0 +1,171 @@
+#include "unity.h"
+#include "timer_wheel.h"
+#include <stddef.h>
+
+#define NUMBER_OF_RANDOM_TIMERS 2000
+
+int random_value(void) {
+  return 0;
+}
+
+typedef struct {
+  timer_wheel_timer_t timer;
+  uint64_t fired_at;
+  size_t times_fired;
+  // cancelled by this one's callback, when set
+  timer_wheel_timer_t *victim;
+} test_timer_t;
+
+static timer_wheel_t *wheel;
+static uint64_t advancing_to;
+
+void setUp(void) {
+  wheel = timer_wheel_create(0);
+}
+
+void tearDown(void) {
+  timer_wheel_destroy(wheel);
+}
+
+static void on_expiry(timer_wheel_timer_t *timer, void *argument) {
+  (void) argument;
+  test_timer_t *test_timer = (test_timer_t *)((char *) timer - offsetof(test_timer_t, timer));
+  test_timer->fired_at = advancing_to;
+  test_timer->times_fired++;
+  if (test_timer->victim != NULL) {
+    timer_wheel_cancel(wheel, test_timer->victim);
+  }
+}
+
+static size_t advance(uint64_t now) {
+  advancing_to = now;
+  return timer_wheel_advance(wheel, now, NULL);
+}
+
+static void init(test_timer_t *test_timer) {
+  test_timer->fired_at = 0;
+  test_timer->times_fired = 0;
+  test_timer->victim = NULL;
+  timer_wheel_timer_init(&test_timer->timer, on_expiry);
+}
+
+void test_timer_fires_at_its_tick(void) {
+  test_timer_t timer;
+  init(&timer);
+  timer_wheel_arm(wheel, &timer.timer, 100);
+
+  // the wheel wakes up first to move it out of the second level
+  TEST_ASSERT_EQUAL(64, timer_wheel_ticks_until_next(wheel));
+  TEST_ASSERT_EQUAL(0, advance(99));
+  TEST_ASSERT_EQUAL(100, timer_wheel_now(wheel));
+  TEST_ASSERT_EQUAL(0, timer_wheel_ticks_until_next(wheel));
+  TEST_ASSERT_EQUAL(1, advance(100));
+  TEST_ASSERT_EQUAL(1, timer.times_fired);
+  TEST_ASSERT_FALSE(timer.timer.is_armed);
+  TEST_ASSERT_EQUAL(UINT64_MAX, timer_wheel_ticks_until_next(wheel));
+  TEST_ASSERT_EQUAL(0, timer_wheel_number_of_timers(wheel));
+}
+
+void test_overdue_timer_fires_on_the_next_advance(void) {
+  test_timer_t timer;
+  init(&timer);
+  advance(500);
+  timer_wheel_arm(wheel, &timer.timer, 10);
+
+  TEST_ASSERT_EQUAL(0, timer_wheel_ticks_until_next(wheel));
+  TEST_ASSERT_EQUAL(1, advance(501));
+}
+
+void test_cancelled_and_moved_timers(void) {
+  test_timer_t cancelled;
+  test_timer_t moved;
+  init(&cancelled);
+  init(&moved);
+  timer_wheel_arm(wheel, &cancelled.timer, 50);
+  timer_wheel_arm(wheel, &moved.timer, 50);
+  timer_wheel_cancel(wheel, &cancelled.timer);
+  timer_wheel_arm(wheel, &moved.timer, 5000);
+
+  TEST_ASSERT_EQUAL(1, timer_wheel_number_of_timers(wheel));
+  TEST_ASSERT_EQUAL(0, advance(4999));
+  TEST_ASSERT_EQUAL(1, advance(5000));
+  TEST_ASSERT_EQUAL(0, cancelled.times_fired);
+  TEST_ASSERT_EQUAL(5000, moved.fired_at);
+}
+
+void test_timers_beyond_the_range_wait_in_the_top_level(void) {
+  test_timer_t timer;
+  init(&timer);
+  uint64_t expires = 3 * TIMER_WHEEL_RANGE + 12345;
+  timer_wheel_arm(wheel, &timer.timer, expires);
+
+  for (uint64_t now = 0; now < expires; now += TIMER_WHEEL_RANGE / 3) {
+    TEST_ASSERT_EQUAL(0, advance(now));
+  }
+  TEST_ASSERT_EQUAL(0, advance(expires - 1));
+  TEST_ASSERT_EQUAL(1, advance(expires));
+}
+
+void test_callback_can_cancel_a_timer_due_in_the_same_tick(void) {
+  test_timer_t first;
+  test_timer_t second;
+  init(&first);
+  init(&second);
+  timer_wheel_arm(wheel, &first.timer, 7);
+  timer_wheel_arm(wheel, &second.timer, 7);
+  // the slot is a stack, the later one runs first
+  second.victim = &first.timer;
+
+  TEST_ASSERT_EQUAL(1, advance(7));
+  TEST_ASSERT_EQUAL(0, first.times_fired);
+  TEST_ASSERT_EQUAL(0, timer_wheel_number_of_timers(wheel));
+}
+
+static uint32_t next_random(uint32_t *state) {
+  uint32_t x = *state;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return *state = x;
+}
+
+void test_random_timers_fire_exactly_once_on_time(void) {
+  static test_timer_t timers[NUMBER_OF_RANDOM_TIMERS];
+  uint32_t state = 12345;
+  for (size_t i = 0; i < NUMBER_OF_RANDOM_TIMERS; i++) {
+    init(&timers[i]);
+    // a mix of short, level crossing and beyond range deadlines
+    uint64_t scale = (uint64_t) 1 << (next_random(&state) % 27);
+    timer_wheel_arm(wheel, &timers[i].timer, next_random(&state) % scale);
+  }
+  for (size_t i = 0; i < NUMBER_OF_RANDOM_TIMERS; i += 7) {
+    timer_wheel_cancel(wheel, &timers[i].timer);
+  }
+  uint64_t now = 0;
+  while (timer_wheel_number_of_timers(wheel) > 0) {
+    uint64_t previous = now;
+    now += 1 + next_random(&state) % 100000;
+    advance(now);
+    for (size_t i = 0; i < NUMBER_OF_RANDOM_TIMERS; i++) {
+      if (i % 7 == 0) {
+        TEST_ASSERT_EQUAL(0, timers[i].times_fired);
+      } else if (timers[i].timer.expires <= now) {
+        TEST_ASSERT_EQUAL(1, timers[i].times_fired);
+        TEST_ASSERT_TRUE(timers[i].fired_at == now || timers[i].timer.expires <= previous);
+      } else {
+        TEST_ASSERT_EQUAL(0, timers[i].times_fired);
+      }
+    }
+  }
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_timer_fires_at_its_tick);
+  RUN_TEST(test_overdue_timer_fires_on_the_next_advance);
+  RUN_TEST(test_cancelled_and_moved_timers);
+  RUN_TEST(test_timers_beyond_the_range_wait_in_the_top_level);
+  RUN_TEST(test_callback_can_cancel_a_timer_due_in_the_same_tick);
+  RUN_TEST(test_random_timers_fire_exactly_once_on_time);
+  return UNITY_END();
+}
\ No newline at end of file
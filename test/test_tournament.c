@@ -0,0 +1,212 @@
+#define _POSIX_C_SOURCE 200809L
+#include "unity.h"
+#include "tournament.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECKPOINT_PATH "build/test_tournament.checkpoint"
+// Knuth's minimax strategy needs 5801 guesses to solve every code and never more than 5
+#define MINIMAX_TOTAL_GUESSES 5801
+#define MINIMAX_WORST_CASE 5
+
+int random_value(void) {
+  return 0;
+}
+
+void setUp(void) {
+  remove(CHECKPOINT_PATH);
+}
+
+void tearDown(void) {
+  remove(CHECKPOINT_PATH);
+}
+
+static tournament_options_t standard_options(const char *strategy) {
+  tournament_options_t options = {
+    .variant = {.number_of_pegs = 4, .number_of_values = 6},
+    .maximum_tries = 8,
+    .seed = 5,
+    .number_of_threads = 1,
+    .checkpoint_milliseconds = TOURNAMENT_DEFAULT_CHECKPOINT_MILLISECONDS,
+    .number_of_strategies = 1
+  };
+  options.strategies[0] = tournament_find_strategy(strategy);
+  return options;
+}
+
+static void assert_same_results(const tournament_result_t *expected, const tournament_result_t *actual) {
+  TEST_ASSERT_EQUAL_STRING(expected->name, actual->name);
+  TEST_ASSERT_EQUAL_UINT64(expected->games, actual->games);
+  TEST_ASSERT_EQUAL_UINT64(expected->failures, actual->failures);
+  TEST_ASSERT_EQUAL_UINT64(expected->tries_to_win, actual->tries_to_win);
+  TEST_ASSERT_EQUAL_UINT8(expected->worst_case, actual->worst_case);
+  TEST_ASSERT_EQUAL_UINT64(expected->moves, actual->moves);
+}
+
+void test_strategies_are_found_by_name(void) {
+  const tournament_strategy_t *strategies;
+  size_t number_of_strategies = tournament_get_strategies(&strategies);
+  TEST_ASSERT_TRUE(number_of_strategies > 0 && number_of_strategies <= TOURNAMENT_MAXIMUM_STRATEGIES);
+  for (size_t i = 0; i < number_of_strategies; i++) {
+    TEST_ASSERT_EQUAL_PTR(&strategies[i], tournament_find_strategy(strategies[i].name));
+  }
+  TEST_ASSERT_NULL(tournament_find_strategy("random"));
+}
+
+void test_minimax_solves_every_code_in_five(void) {
+  tournament_options_t options = standard_options("minimax");
+  tournament_result_t result;
+  tournament_stats_t stats;
+  TEST_ASSERT_TRUE(tournament_run(&options, &result, &stats));
+  TEST_ASSERT_TRUE(stats.is_complete);
+  TEST_ASSERT_EQUAL_UINT64(NUMBER_OF_POSSIBLE_CODES, stats.number_of_secrets);
+  TEST_ASSERT_EQUAL_UINT64(NUMBER_OF_POSSIBLE_CODES, result.games);
+  TEST_ASSERT_EQUAL_UINT64(0, result.failures);
+  TEST_ASSERT_EQUAL_UINT64(MINIMAX_TOTAL_GUESSES, result.tries_to_win);
+  TEST_ASSERT_EQUAL_UINT8(MINIMAX_WORST_CASE, result.worst_case);
+  TEST_ASSERT_TRUE(result.cpu_nanoseconds > 0);
+}
+
+void test_running_out_of_tries_is_a_failure(void) {
+  tournament_options_t options = standard_options("first-consistent");
+  options.maximum_tries = 1;
+  tournament_result_t result;
+  tournament_stats_t stats;
+  TEST_ASSERT_TRUE(tournament_run(&options, &result, &stats));
+  // only the opening itself is solved in one
+  TEST_ASSERT_EQUAL_UINT64(NUMBER_OF_POSSIBLE_CODES - 1, result.failures);
+  TEST_ASSERT_EQUAL_UINT64(1, result.tries_to_win);
+  TEST_ASSERT_EQUAL_UINT64(NUMBER_OF_POSSIBLE_CODES, result.moves);
+}
+
+void test_stolen_work_gives_the_same_results(void) {
+  tournament_options_t options = standard_options("first-consistent");
+  options.strategies[1] = tournament_find_strategy("most-parts");
+  options.number_of_strategies = 2;
+  tournament_result_t alone[2];
+  tournament_result_t shared[2];
+  tournament_stats_t stats;
+  TEST_ASSERT_TRUE(tournament_run(&options, alone, &stats));
+  options.number_of_threads = 4;
+  TEST_ASSERT_TRUE(tournament_run(&options, shared, &stats));
+  TEST_ASSERT_EQUAL_size_t(4, stats.number_of_threads);
+  TEST_ASSERT_EQUAL_UINT64(2 * NUMBER_OF_POSSIBLE_CODES, stats.games_played);
+  assert_same_results(&alone[0], &shared[0]);
+  assert_same_results(&alone[1], &shared[1]);
+}
+
+void test_sampled_games_only_depend_on_the_seed(void) {
+  tournament_options_t options = standard_options("sampled");
+  tournament_result_t alone;
+  tournament_result_t shared;
+  tournament_result_t reseeded;
+  tournament_stats_t stats;
+  TEST_ASSERT_TRUE(tournament_run(&options, &alone, &stats));
+  options.number_of_threads = 4;
+  TEST_ASSERT_TRUE(tournament_run(&options, &shared, &stats));
+  TEST_ASSERT_EQUAL_size_t(4, stats.number_of_threads);
+  assert_same_results(&alone, &shared);
+  options.seed = 6;
+  TEST_ASSERT_TRUE(tournament_run(&options, &reseeded, &stats));
+  TEST_ASSERT_NOT_EQUAL(alone.tries_to_win, reseeded.tries_to_win);
+}
+
+void test_an_interrupted_run_resumes_from_its_checkpoint(void) {
+  tournament_options_t options = standard_options("first-consistent");
+  options.number_of_threads = 2;
+  tournament_result_t expected;
+  tournament_result_t result;
+  tournament_stats_t stats;
+  TEST_ASSERT_TRUE(tournament_run(&options, &expected, &stats));
+
+  options.checkpoint_path = CHECKPOINT_PATH;
+  options.maximum_games = 500;
+  TEST_ASSERT_TRUE(tournament_run(&options, &result, &stats));
+  TEST_ASSERT_FALSE(stats.is_complete);
+  TEST_ASSERT_EQUAL_UINT64(500, stats.games_played);
+  TEST_ASSERT_EQUAL_UINT64(500, result.games);
+  TEST_ASSERT_EQUAL_UINT64(0, stats.checkpoint_failures);
+
+  options.maximum_games = 0;
+  TEST_ASSERT_TRUE(tournament_run(&options, &result, &stats));
+  TEST_ASSERT_TRUE(stats.is_complete);
+  TEST_ASSERT_EQUAL_UINT64(500, stats.games_resumed);
+  TEST_ASSERT_EQUAL_UINT64(NUMBER_OF_POSSIBLE_CODES - 500, stats.games_played);
+  assert_same_results(&expected, &result);
+}
+
+void test_a_sample_resumes_with_the_checkpoint_seed(void) {
+  tournament_options_t options = standard_options("first-consistent");
+  options.variant = (large_space_variant_t) {.number_of_pegs = 6, .number_of_values = 9};
+  options.maximum_tries = 16;
+  options.sample_size = 60;
+  tournament_result_t expected;
+  tournament_result_t result;
+  tournament_stats_t stats;
+  TEST_ASSERT_TRUE(tournament_run(&options, &expected, &stats));
+  TEST_ASSERT_EQUAL_UINT64(60, expected.games);
+
+  options.checkpoint_path = CHECKPOINT_PATH;
+  options.maximum_games = 20;
+  TEST_ASSERT_TRUE(tournament_run(&options, &result, &stats));
+  options.maximum_games = 0;
+  options.seed = 6;
+  TEST_ASSERT_TRUE(tournament_run(&options, &result, &stats));
+  TEST_ASSERT_EQUAL_UINT64(5, stats.seed);
+  TEST_ASSERT_EQUAL_UINT64(20, stats.games_resumed);
+  assert_same_results(&expected, &result);
+}
+
+void test_unplayable_tournaments_are_refused(void) {
+  tournament_result_t result;
+  tournament_stats_t stats;
+  tournament_options_t options = standard_options("minimax");
+  options.variant.number_of_values = 8;
+  TEST_ASSERT_FALSE(tournament_run(&options, &result, &stats));
+  options = standard_options("first-consistent");
+  options.maximum_tries = 0;
+  TEST_ASSERT_FALSE(tournament_run(&options, &result, &stats));
+  options = standard_options("first-consistent");
+  options.variant.number_of_pegs = LARGE_SPACE_MAXIMUM_PEGS + 1;
+  TEST_ASSERT_FALSE(tournament_run(&options, &result, &stats));
+  options = standard_options("first-consistent");
+  options.number_of_strategies = 0;
+  TEST_ASSERT_FALSE(tournament_run(&options, &result, &stats));
+}
+
+void test_a_checkpoint_from_another_tournament_is_refused(void) {
+  tournament_options_t options = standard_options("first-consistent");
+  options.checkpoint_path = CHECKPOINT_PATH;
+  options.maximum_games = 10;
+  tournament_result_t result;
+  tournament_stats_t stats;
+  TEST_ASSERT_TRUE(tournament_run(&options, &result, &stats));
+  options.maximum_tries = 9;
+  TEST_ASSERT_FALSE(tournament_run(&options, &result, &stats));
+  options = standard_options("most-parts");
+  options.checkpoint_path = CHECKPOINT_PATH;
+  TEST_ASSERT_FALSE(tournament_run(&options, &result, &stats));
+
+  FILE *file = fopen(CHECKPOINT_PATH, "wb");
+  TEST_ASSERT_NOT_NULL(file);
+  fputs("not a checkpoint", file);
+  fclose(file);
+  options = standard_options("first-consistent");
+  options.checkpoint_path = CHECKPOINT_PATH;
+  TEST_ASSERT_FALSE(tournament_run(&options, &result, &stats));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_strategies_are_found_by_name);
+  RUN_TEST(test_minimax_solves_every_code_in_five);
+  RUN_TEST(test_running_out_of_tries_is_a_failure);
+  RUN_TEST(test_stolen_work_gives_the_same_results);
+  RUN_TEST(test_sampled_games_only_depend_on_the_seed);
+  RUN_TEST(test_an_interrupted_run_resumes_from_its_checkpoint);
+  RUN_TEST(test_a_sample_resumes_with_the_checkpoint_seed);
+  RUN_TEST(test_unplayable_tournaments_are_refused);
+  RUN_TEST(test_a_checkpoint_from_another_tournament_is_refused);
+  return UNITY_END();
+}
\ No newline at end of file
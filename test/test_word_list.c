@@ -0,0 +1,107 @@
+#include "unity.h"
+#include "game_logic.h"
+#include "word_list.h"
+#include "random.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define DICTIONARY_PATH "build/test_dictionary.txt"
+#define INDEX_PATH "build/test_dictionary.idx"
+#define WORD_LENGTH 5
+
+int random_value(void) {
+  return rand();
+}
+
+static word_list_t list;
+
+static void write_dictionary(const char *contents) {
+  FILE *file = fopen(DICTIONARY_PATH, "w");
+  TEST_ASSERT_NOT_NULL(file);
+  fputs(contents, file);
+  fclose(file);
+}
+
+static uint64_t pack(const char *word) {
+  uint64_t packed = 0;
+  TEST_ASSERT_TRUE(word_list_pack(WORD_LENGTH, word, &packed));
+  return packed;
+}
+
+void setUp(void) {
+  write_dictionary("crane\nslate\nAbout\nhello\nhi\ntoolong\ncr4ne\ncrane\nstare\nroate\n");
+  TEST_ASSERT_TRUE(word_list_build_index(DICTIONARY_PATH, INDEX_PATH, WORD_LENGTH));
+  TEST_ASSERT_TRUE(word_list_open(&list, INDEX_PATH));
+}
+
+void tearDown(void) {
+  word_list_close(&list);
+  remove(DICTIONARY_PATH);
+  remove(INDEX_PATH);
+}
+
+void test_index_keeps_unique_words_of_the_right_length(void) {
+  TEST_ASSERT_EQUAL_size_t(6, word_list_get_size(&list));
+  TEST_ASSERT_TRUE(word_list_contains(&list, pack("crane")));
+  TEST_ASSERT_TRUE(word_list_contains(&list, pack("about")));
+  TEST_ASSERT_FALSE(word_list_contains(&list, pack("zzzzz")));
+  TEST_ASSERT_FALSE(word_list_pack(WORD_LENGTH, "hi", &(uint64_t) {0}));
+  TEST_ASSERT_FALSE(word_list_pack(WORD_LENGTH, "toolong", &(uint64_t) {0}));
+}
+
+void test_words_are_sorted_and_unpack(void) {
+  char word[WORD_LIST_MAXIMUM_WORD_LENGTH + 1];
+  word_list_unpack(WORD_LENGTH, word_list_get_word(&list, 0), word);
+  TEST_ASSERT_EQUAL_STRING("about", word);
+  for (size_t i = 1; i < word_list_get_size(&list); i++) {
+    TEST_ASSERT_TRUE(word_list_get_word(&list, i - 1) < word_list_get_word(&list, i));
+  }
+}
+
+void test_bitmaps_mark_letters_at_positions(void) {
+  // "about" is word 0 and starts with an a
+  TEST_ASSERT_EQUAL_UINT64(1, word_list_get_bitmap(&list, 0, 'a' - 'a')[0] & 1);
+  TEST_ASSERT_EQUAL_UINT64(0, word_list_get_bitmap(&list, 0, 'c' - 'a')[0] & 1);
+}
+
+void test_score_uses_placement_and_value_only_split(void) {
+  game_logic_feedback_t feedback = word_list_score(WORD_LENGTH, pack("crane"), pack("roate"));
+
+  TEST_ASSERT_EQUAL_UINT8(2, feedback.number_of_correct_value_and_placement);
+  TEST_ASSERT_EQUAL_UINT8(1, feedback.number_of_correct_value_only);
+  TEST_ASSERT_TRUE(word_list_score(WORD_LENGTH, pack("crane"), pack("crane")).is_guess_correct);
+}
+
+void test_filter_keeps_only_consistent_words(void) {
+  word_list_move_t history[] = {{.guess = pack("slate")}};
+  history[0].feedback = word_list_score(WORD_LENGTH, pack("crane"), history[0].guess);
+  uint64_t candidates[1];
+
+  size_t count = word_list_filter(&list, history, 1, candidates);
+
+  for (size_t i = 0; i < word_list_get_size(&list); i++) {
+    game_logic_feedback_t feedback = word_list_score(WORD_LENGTH, word_list_get_word(&list, i), history[0].guess);
+    bool is_consistent = feedback.number_of_correct_value_and_placement == history[0].feedback.number_of_correct_value_and_placement &&
+                         feedback.number_of_correct_value_only == history[0].feedback.number_of_correct_value_only;
+    TEST_ASSERT_EQUAL(is_consistent, (candidates[0] >> i) & 1);
+  }
+  TEST_ASSERT_TRUE(count >= 1);
+}
+
+void test_corrupt_index_is_rejected(void) {
+  word_list_t corrupt;
+  TEST_ASSERT_FALSE(word_list_open(&corrupt, DICTIONARY_PATH));
+  TEST_ASSERT_FALSE(word_list_open(&corrupt, "build/does_not_exist.idx"));
+}
+
+int main(void)
+{
+  UNITY_BEGIN();
+    RUN_TEST(test_index_keeps_unique_words_of_the_right_length);
+    RUN_TEST(test_words_are_sorted_and_unpack);
+    RUN_TEST(test_bitmaps_mark_letters_at_positions);
+    RUN_TEST(test_score_uses_placement_and_value_only_split);
+    RUN_TEST(test_filter_keeps_only_consistent_words);
+    RUN_TEST(test_corrupt_index_is_rejected);
+  return UNITY_END();
+}
\ No newline at end of file